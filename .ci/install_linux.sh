@@ -53,8 +53,6 @@ apt-get install -y --no-install-recommends \
   libxi-dev \
   libxmu-dev \
   libbullet-dev \
-  liblz4-dev \
-  libflann-dev \
   coinor-libipopt-dev \
   libtinyxml2-dev \
   liburdfdom-dev \
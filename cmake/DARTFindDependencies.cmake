@@ -88,6 +88,9 @@ endif()
 # Boost
 dart_find_package(Boost)
 
+# Threads
+dart_find_package(Threads)
+
 # octomap
 dart_find_package(octomap)
 if(MSVC)
@@ -87,6 +87,24 @@ void CollisionDetector::notifyCollisionObjectDestroying(
   // Do nothing
 }
 
+//==============================================================================
+std::shared_ptr<common::ThreadPool> CollisionDetector::getThreadPool(
+    std::size_t numThreads)
+{
+  if (0u == numThreads)
+    numThreads = common::ThreadPool::getHardwareConcurrency();
+
+  if (numThreads <= 1u)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(mThreadPoolMutex);
+
+  if (!mThreadPool || mThreadPool->getNumThreads() != numThreads)
+    mThreadPool = std::make_shared<common::ThreadPool>(numThreads);
+
+  return mThreadPool;
+}
+
 //==============================================================================
 CollisionDetector::CollisionObjectManager::CollisionObjectManager(
     CollisionDetector* cd)
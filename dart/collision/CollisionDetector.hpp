@@ -34,6 +34,8 @@
 #define DART_COLLISION_COLLISIONDETECTOR_HPP_
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -47,6 +49,7 @@
 #include "dart/collision/RaycastResult.hpp"
 #include "dart/collision/SmartPointer.hpp"
 #include "dart/common/Factory.hpp"
+#include "dart/common/ThreadPool.hpp"
 #include "dart/dynamics/SmartPointer.hpp"
 
 namespace dart {
@@ -206,8 +209,26 @@ protected:
   /// Notify that a CollisionObject is destroying. Do nothing by default.
   virtual void notifyCollisionObjectDestroying(CollisionObject* object);
 
+  /// Return the ThreadPool for the narrow-phase checks, which is (re)created if
+  /// it doesn't have the requested number of threads. If numThreads is zero,
+  /// the number of hardware threads is used. Returns nullptr if only one
+  /// thread is requested.
+  ///
+  /// The returned pointer keeps the ThreadPool alive, so hold it for the whole
+  /// query: a concurrent query that requests another number of threads
+  /// replaces the ThreadPool of this CollisionDetector without destroying the
+  /// one still in use.
+  std::shared_ptr<common::ThreadPool> getThreadPool(std::size_t numThreads);
+
 protected:
   std::unique_ptr<CollisionObjectManager> mCollisionObjectManager;
+
+private:
+  /// ThreadPool for the narrow-phase checks. Created on demand.
+  std::shared_ptr<common::ThreadPool> mThreadPool;
+
+  /// Mutex that protects mThreadPool from concurrent queries
+  std::mutex mThreadPoolMutex;
 };
 
 //==============================================================================
@@ -101,6 +101,14 @@ void BodyNodeCollisionFilter::removeAllBodyNodePairsFromBlackList()
   mBodyNodeBlackList.removeAllPairs();
 }
 
+//==============================================================================
+bool BodyNodeCollisionFilter::isInBlackList(
+    const dynamics::BodyNode* bodyNode1,
+    const dynamics::BodyNode* bodyNode2) const
+{
+  return mBodyNodeBlackList.contains(bodyNode1, bodyNode2);
+}
+
 //==============================================================================
 bool BodyNodeCollisionFilter::ignoresCollision(
     const collision::CollisionObject* object1,
@@ -100,6 +100,11 @@ public:
   /// Remove all the BodyNode pairs from the blacklist.
   void removeAllBodyNodePairsFromBlackList();
 
+  /// Returns true if the BodyNode pair is in the blacklist.
+  bool isInBlackList(
+      const dynamics::BodyNode* bodyNode1,
+      const dynamics::BodyNode* bodyNode2) const;
+
   // Documentation inherited
   bool ignoresCollision(
       const CollisionObject* object1,
@@ -32,7 +32,10 @@
 
 #include "dart/collision/CollisionGroup.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <utility>
 
 #include "dart/collision/CollisionDetector.hpp"
 #include "dart/collision/CollisionObject.hpp"
@@ -42,6 +45,19 @@
 namespace dart {
 namespace collision {
 
+namespace {
+
+//==============================================================================
+/// Returns true if the engine data of the collision object of shape need to be
+/// updated for every collision check because the vertices of the shape change
+/// without changing its version (e.g., SoftMeshShape).
+bool needsAlwaysUpdate(const dynamics::ConstShapePtr& shape)
+{
+  return shape && shape->checkDataVariance(dynamics::Shape::DYNAMIC_VERTICES);
+}
+
+} // namespace
+
 //==============================================================================
 CollisionGroup::CollisionGroup(const CollisionDetectorPtr& collisionDetector)
   : mCollisionDetector(collisionDetector), mUpdateAutomatically(true)
@@ -93,17 +109,12 @@ void CollisionGroup::removeShapeFrame(const dynamics::ShapeFrame* shapeFrame)
   if (!shapeFrame)
     return;
 
-  const auto search = std::find_if(
-      mObjectInfoList.begin(),
-      mObjectInfoList.end(),
-      [&](const std::unique_ptr<ObjectInfo>& info) {
-        return info->mFrame == shapeFrame;
-      });
+  const auto search = findObjectInfo(shapeFrame);
 
   if (mObjectInfoList.end() == search)
     return;
 
-  removeCollisionObjectFromEngine((*search)->mObject.get());
+  removeCollisionObject((*search)->mObject.get());
 
   // Since the user is explicitly telling us to remove this ShapeFrame, we can
   // no longer remain subscribed to any sources that were providing this
@@ -124,7 +135,7 @@ void CollisionGroup::removeShapeFrame(const dynamics::ShapeFrame* shapeFrame)
     mBodyNodeSources.erase(static_cast<const dynamics::BodyNode*>(source));
   }
 
-  mObjectInfoList.erase(search);
+  eraseObjectInfo(search);
   mObserver.removeShapeFrame(shapeFrame);
 }
 
@@ -147,6 +158,11 @@ void CollisionGroup::removeAllShapeFrames()
 {
   removeAllCollisionObjectsFromEngine();
 
+  if (mContactCache)
+    mContactCache->clear();
+
+  mDirtyObjects.clear();
+  mObjectInfoMap.clear();
   mObjectInfoList.clear();
   mObserver.removeAllShapeFrames();
 }
@@ -154,13 +170,7 @@ void CollisionGroup::removeAllShapeFrames()
 //==============================================================================
 bool CollisionGroup::hasShapeFrame(const dynamics::ShapeFrame* shapeFrame) const
 {
-  return std::find_if(
-             mObjectInfoList.begin(),
-             mObjectInfoList.end(),
-             [&](const std::unique_ptr<ObjectInfo>& info) {
-               return info->mFrame == shapeFrame;
-             })
-         != mObjectInfoList.end();
+  return mObjectInfoMap.find(shapeFrame) != mObjectInfoMap.end();
 }
 
 //==============================================================================
@@ -187,6 +197,11 @@ bool CollisionGroup::collide(
   if (mUpdateAutomatically)
     update();
 
+  // Queries that don't compute contacts neither use nor refresh the cached
+  // contacts, so they must not evict them either.
+  if (mContactCache && result && option.enableContact)
+    mContactCache->beginQuery(option.contactMargin);
+
   return mCollisionDetector->collide(this, option, result);
 }
 
@@ -199,6 +214,15 @@ bool CollisionGroup::collide(
   if (mUpdateAutomatically)
     update();
 
+  auto* cache = getContactCache(this, otherGroup);
+  if (cache && result && option.enableContact)
+  {
+    // The entries between the two groups are scoped by the group that doesn't
+    // own the cache so that they don't evict the entries within the group.
+    const bool ownsCache = (cache == mContactCache.get());
+    cache->beginQuery(option.contactMargin, ownsCache ? otherGroup : this);
+  }
+
   return mCollisionDetector->collide(this, otherGroup, option, result);
 }
 
@@ -249,6 +273,46 @@ bool CollisionGroup::getAutomaticUpdate() const
   return mUpdateAutomatically;
 }
 
+//==============================================================================
+void CollisionGroup::setContactCacheEnabled(bool enabled)
+{
+  if (!enabled)
+    mContactCache.reset();
+  else if (!mContactCache)
+    mContactCache.reset(new ContactCache());
+}
+
+//==============================================================================
+bool CollisionGroup::isContactCacheEnabled() const
+{
+  return mContactCache != nullptr;
+}
+
+//==============================================================================
+ContactCache* CollisionGroup::getContactCache()
+{
+  return mContactCache.get();
+}
+
+//==============================================================================
+const ContactCache* CollisionGroup::getContactCache() const
+{
+  return mContactCache.get();
+}
+
+//==============================================================================
+ContactCache* CollisionGroup::getContactCache(
+    CollisionGroup* group1, CollisionGroup* group2)
+{
+  if (std::less<CollisionGroup*>()(group2, group1))
+    std::swap(group1, group2);
+
+  if (group1->mContactCache)
+    return group1->mContactCache.get();
+
+  return group2->mContactCache.get();
+}
+
 //==============================================================================
 void CollisionGroup::update()
 {
@@ -266,12 +330,7 @@ void CollisionGroup::removeDeletedShapeFrames()
 {
   for (auto shapeFrame : mObserver.mDeletedFrames)
   {
-    const auto search = std::find_if(
-        mObjectInfoList.begin(),
-        mObjectInfoList.end(),
-        [&](const std::unique_ptr<ObjectInfo>& info) {
-          return info->mFrame == shapeFrame;
-        });
+    const auto search = findObjectInfo(shapeFrame);
 
     if (mObjectInfoList.end() == search)
       continue;
@@ -297,22 +356,102 @@ void CollisionGroup::removeDeletedShapeFrames()
         bodySearch->second.mObjects.erase(shapeFrame);
     }
 
-    removeCollisionObjectFromEngine((*search)->mObject.get());
-    mObjectInfoList.erase(search);
+    removeCollisionObject((*search)->mObject.get());
+    eraseObjectInfo(search);
   }
 
   mObserver.mDeletedFrames.clear();
 }
 
+//==============================================================================
+void CollisionGroup::removeCollisionObject(CollisionObject* object)
+{
+  removeCollisionObjectFromEngine(object);
+
+  if (mContactCache)
+    mContactCache->invalidate(object);
+}
+
 //==============================================================================
 void CollisionGroup::updateEngineData()
 {
-  for (const auto& info : mObjectInfoList)
+  if (mDirtyObjects.empty())
+    return;
+
+  std::vector<CollisionObject*> objects;
+  objects.reserve(mDirtyObjects.size());
+
+  for (ObjectInfo* info : mDirtyObjects)
+  {
     info->mObject->updateEngineData();
+    objects.push_back(info->mObject.get());
+  }
+
+  updateCollisionGroupEngineDataOf(objects);
 
+  // Keep the objects whose engine data need to be updated every time
+  std::size_t numRemaining = 0u;
+  for (ObjectInfo* info : mDirtyObjects)
+  {
+    info->mDirty = info->mAlwaysDirty;
+    if (info->mAlwaysDirty)
+      mDirtyObjects[numRemaining++] = info;
+  }
+  mDirtyObjects.resize(numRemaining);
+}
+
+//==============================================================================
+void CollisionGroup::updateCollisionGroupEngineDataOf(
+    const std::vector<CollisionObject*>& /*objects*/)
+{
   updateCollisionGroupEngineData();
 }
 
+//==============================================================================
+auto CollisionGroup::findObjectInfo(const dynamics::ShapeFrame* shapeFrame)
+    -> ObjectInfoList::iterator
+{
+  const auto search = mObjectInfoMap.find(shapeFrame);
+  if (search == mObjectInfoMap.end())
+    return mObjectInfoList.end();
+
+  return mObjectInfoList.begin() + search->second;
+}
+
+//==============================================================================
+void CollisionGroup::eraseObjectInfo(ObjectInfoList::iterator it)
+{
+  ObjectInfo* info = it->get();
+
+  if (info->mDirty)
+  {
+    mDirtyObjects.erase(
+        std::remove(mDirtyObjects.begin(), mDirtyObjects.end(), info),
+        mDirtyObjects.end());
+  }
+
+  mObjectInfoMap.erase(info->mFrame);
+
+  if (it + 1 != mObjectInfoList.end())
+  {
+    *it = std::move(mObjectInfoList.back());
+    mObjectInfoMap[(*it)->mFrame]
+        = static_cast<std::size_t>(it - mObjectInfoList.begin());
+  }
+
+  mObjectInfoList.pop_back();
+}
+
+//==============================================================================
+void CollisionGroup::markDirty(ObjectInfo* object)
+{
+  if (object->mDirty)
+    return;
+
+  object->mDirty = true;
+  mDirtyObjects.push_back(object);
+}
+
 //==============================================================================
 void CollisionGroup::ShapeFrameObserver::addShapeFrame(
     const dynamics::ShapeFrame* shapeFrame)
@@ -351,14 +490,14 @@ auto CollisionGroup::addShapeFrameImpl(
   if (!shapeFrame)
     return nullptr;
 
-  auto it = std::find_if(
-      mObjectInfoList.begin(),
-      mObjectInfoList.end(),
-      [&](const std::unique_ptr<ObjectInfo>& info) {
-        return info->mFrame == shapeFrame;
-      });
+  ObjectInfo* info;
 
-  if (it == mObjectInfoList.end())
+  const auto search = mObjectInfoMap.find(shapeFrame);
+  if (search != mObjectInfoMap.end())
+  {
+    info = mObjectInfoList[search->second].get();
+  }
+  else
   {
     auto collObj = mCollisionDetector->claimCollisionObject(shapeFrame);
 
@@ -375,15 +514,29 @@ auto CollisionGroup::addShapeFrameImpl(
                                                 collObj,
                                                 shape ? shape->getID() : 0,
                                                 shape ? shape->getVersion() : 0,
-                                                {}});
+                                                {},
+                                                {},
+                                                false,
+                                                needsAlwaysUpdate(shape)});
     mObserver.addShapeFrame(shapeFrame);
 
-    it = --mObjectInfoList.end();
+    info = mObjectInfoList.back().get();
+    mObjectInfoMap[shapeFrame] = mObjectInfoList.size() - 1u;
+
+    // The transform updated signal of the ShapeFrame is raised whenever the
+    // ShapeFrame or any of its parent Frames moves, so only the objects that
+    // have moved will be updated before the next collision check.
+    info->mTransformConnection
+        = const_cast<dynamics::ShapeFrame*>(shapeFrame)
+              ->onTransformUpdated.connect(
+                  [this, info](const dynamics::Entity*) { markDirty(info); });
+
+    markDirty(info);
   }
 
-  (*it)->mSources.insert(source);
+  info->mSources.insert(source);
 
-  return it->get();
+  return info;
 }
 
 //==============================================================================
@@ -393,12 +546,7 @@ void CollisionGroup::removeShapeFrameInternal(
   if (!shapeFrame)
     return;
 
-  const auto search = std::find_if(
-      mObjectInfoList.begin(),
-      mObjectInfoList.end(),
-      [&](const std::unique_ptr<ObjectInfo>& info) {
-        return info->mFrame == shapeFrame;
-      });
+  const auto search = findObjectInfo(shapeFrame);
 
   if (mObjectInfoList.end() == search)
     return;
@@ -408,8 +556,8 @@ void CollisionGroup::removeShapeFrameInternal(
 
   if (objectSources.empty())
   {
-    removeCollisionObjectFromEngine((*search)->mObject.get());
-    mObjectInfoList.erase(search);
+    removeCollisionObject((*search)->mObject.get());
+    eraseObjectInfo(search);
     mObserver.removeShapeFrame(shapeFrame);
   }
 }
@@ -620,12 +768,16 @@ bool CollisionGroup::updateShapeFrame(ObjectInfo* object)
   if (currentID != object->mLastKnownShapeID
       || currentVersion != object->mLastKnownVersion)
   {
-    removeCollisionObjectFromEngine(object->mObject.get());
+    // The shape has been changed, so the cached contacts of this object are
+    // no longer valid.
+    removeCollisionObject(object->mObject.get());
     mCollisionDetector->refreshCollisionObject(object->mObject.get());
     addCollisionObjectToEngine(object->mObject.get());
 
     object->mLastKnownShapeID = currentID;
     object->mLastKnownVersion = currentVersion;
+    object->mAlwaysDirty = needsAlwaysUpdate(shape);
+    markDirty(object);
 
     return true;
   }
@@ -38,12 +38,14 @@
 #include <vector>
 #include "dart/collision/CollisionOption.hpp"
 #include "dart/collision/CollisionResult.hpp"
+#include "dart/collision/ContactCache.hpp"
 #include "dart/collision/DistanceOption.hpp"
 #include "dart/collision/DistanceResult.hpp"
 #include "dart/collision/RaycastOption.hpp"
 #include "dart/collision/RaycastResult.hpp"
 #include "dart/collision/SmartPointer.hpp"
 #include "dart/common/Observer.hpp"
+#include "dart/common/Signal.hpp"
 #include "dart/dynamics/SmartPointer.hpp"
 
 namespace dart {
@@ -284,6 +286,37 @@ public:
   /// Get whether this CollisionGroup is set to automatically check for updates.
   bool getAutomaticUpdate() const;
 
+  /// Set whether this CollisionGroup reuses the contacts of the shape pairs
+  /// whose relative transforms have not changed since the previous collide()
+  /// call. Disabled by default.
+  ///
+  /// The cached contacts of a shape are discarded whenever the shape is
+  /// modified or removed from this CollisionGroup. The number of reused pairs
+  /// is reported by CollisionResult::getNumContactCacheHits().
+  ///
+  /// Currently, the contact cache is used by DARTCollisionDetector and
+  /// FCLCollisionDetector, and is ignored by the other collision detectors.
+  void setContactCacheEnabled(bool enabled = true);
+
+  /// Get whether this CollisionGroup reuses the contacts of the shape pairs
+  /// whose relative transforms have not changed.
+  bool isContactCacheEnabled() const;
+
+  /// Get the ContactCache of this CollisionGroup, or nullptr if the contact
+  /// cache is disabled. Use this to adjust the tolerances of the cache.
+  ContactCache* getContactCache();
+
+  /// Get the (const) ContactCache of this CollisionGroup, or nullptr if the
+  /// contact cache is disabled.
+  const ContactCache* getContactCache() const;
+
+  /// Get the ContactCache used by the collision queries between group1 and
+  /// group2, or nullptr if neither of them has the contact cache enabled. The
+  /// cache of the group with the lower address is preferred, so both orderings
+  /// of the groups reuse the same contacts.
+  static ContactCache* getContactCache(
+      CollisionGroup* group1, CollisionGroup* group2);
+
   /// Check whether this CollisionGroup's subscriptions or any of its objects
   /// need an update, and then update them if they do.
   ///
@@ -305,6 +338,10 @@ public:
 protected:
   /// Update engine data. This function should be called before the collision
   /// detection is performed by the engine in most cases.
+  ///
+  /// Only the objects whose ShapeFrames have been moved, added, or modified
+  /// since the previous call are updated, so the cost is proportional to the
+  /// number of the changed objects rather than the size of this group.
   void updateEngineData();
 
   /// Initialize the collision detection engine data such as broadphase
@@ -323,6 +360,10 @@ protected:
   /// Remove CollisionObject from the collision detection engine
   virtual void removeCollisionObjectFromEngine(CollisionObject* object) = 0;
 
+  /// Remove CollisionObject from the collision detection engine and discard
+  /// its cached contacts
+  void removeCollisionObject(CollisionObject* object);
+
   /// Remove all the CollisionObjects from the collision detection engine
   virtual void removeAllCollisionObjectsFromEngine() = 0;
 
@@ -330,6 +371,14 @@ protected:
   /// This function will be called ahead of every collision checking.
   virtual void updateCollisionGroupEngineData() = 0;
 
+  /// Update the collision detection engine data such as broadphase algorithm
+  /// for the given objects, which are the only objects whose engine data have
+  /// changed since the previous update. The default implementation calls
+  /// updateCollisionGroupEngineData(); override this if the engine can update
+  /// the objects selectively.
+  virtual void updateCollisionGroupEngineDataOf(
+      const std::vector<CollisionObject*>& objects);
+
 protected:
   /// Collision detector
   CollisionDetectorPtr mCollisionDetector;
@@ -364,6 +413,25 @@ protected:
     /// When all sources are cleared out (via unsubscribing), this object will
     /// be removed from this group.
     std::unordered_set<const void*> mSources;
+
+    /// Connection to the transform updated signal of the ShapeFrame, which
+    /// marks this object as dirty
+    common::Connection mTransformConnection;
+
+    /// Whether this object is in the list of the objects whose engine data
+    /// need to be updated
+    bool mDirty;
+
+    /// Whether the engine data of this object need to be updated for every
+    /// collision check regardless of its transform, which is the case for the
+    /// shapes with DYNAMIC_VERTICES data variance (e.g., SoftMeshShape)
+    bool mAlwaysDirty;
+
+    /// Destructor
+    ~ObjectInfo()
+    {
+      mTransformConnection.disconnect();
+    }
   };
 
   using ObjectInfoList = std::vector<std::unique_ptr<ObjectInfo>>;
@@ -371,6 +439,16 @@ protected:
   /// Information about ShapeFrames and CollisionObjects that have been added to
   /// this CollisionGroup.
   ObjectInfoList mObjectInfoList;
+
+  /// Map from ShapeFrames to the indices of their entries in mObjectInfoList
+  /// for fast lookup and removal
+  std::unordered_map<const dynamics::ShapeFrame*, std::size_t> mObjectInfoMap;
+
+  /// Objects whose engine data need to be updated before the next collision
+  /// check. Objects are added by the transform updated signals of their
+  /// ShapeFrames, when they are added to this group, and when their shapes
+  /// are refreshed.
+  std::vector<ObjectInfo*> mDirtyObjects;
   // CollisionGroup also shares the ownership of CollisionObjects across other
   // CollisionGroups for the same reason with above.
   //
@@ -435,10 +513,28 @@ private:
   void removeShapeFrameInternal(
       const dynamics::ShapeFrame* shapeFrame, const void* source);
 
+  /// Return the iterator of the ObjectInfo of shapeFrame in mObjectInfoList,
+  /// or the end iterator if shapeFrame is not in this group.
+  ObjectInfoList::iterator findObjectInfo(
+      const dynamics::ShapeFrame* shapeFrame);
+
+  /// Erase the ObjectInfo from mObjectInfoList along with its entries in
+  /// mObjectInfoMap and mDirtyObjects. The last ObjectInfo of mObjectInfoList
+  /// is moved into the erased slot, so the erasure doesn't shift the others.
+  /// The CollisionObject should be removed from the engine beforehand.
+  void eraseObjectInfo(ObjectInfoList::iterator it);
+
+  /// Add object to mDirtyObjects if it's not there yet
+  void markDirty(ObjectInfo* object);
+
   /// Set this to true to have this CollisionGroup check for updates
   /// automatically. Default is true.
   bool mUpdateAutomatically;
 
+  /// Contacts of the previous collision query. This is nullptr unless the
+  /// contact cache is enabled.
+  std::unique_ptr<ContactCache> mContactCache;
+
   /// \private This struct is used to store sources of ShapeFrames that the
   /// CollisionGroup is subscribed to, alongside the last version number of that
   /// source, as known by this CollisionGroup.
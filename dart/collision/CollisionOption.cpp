@@ -39,10 +39,18 @@ namespace collision {
 CollisionOption::CollisionOption(
     bool enableContact,
     std::size_t maxNumContacts,
-    const std::shared_ptr<CollisionFilter>& collisionFilter)
+    const std::shared_ptr<CollisionFilter>& collisionFilter,
+    std::size_t numThreads,
+    std::size_t maxNumContactsPerPair,
+    double contactMargin,
+    double continuousCollisionTimeStep)
   : enableContact(enableContact),
     maxNumContacts(maxNumContacts),
-    collisionFilter(collisionFilter)
+    maxNumContactsPerPair(maxNumContactsPerPair),
+    collisionFilter(collisionFilter),
+    numThreads(numThreads),
+    contactMargin(contactMargin),
+    continuousCollisionTimeStep(continuousCollisionTimeStep)
 {
   // Do nothing
 }
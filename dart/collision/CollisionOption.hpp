@@ -55,14 +55,58 @@ struct CollisionOption
   /// this to 1 for binary check.
   std::size_t maxNumContacts;
 
+  /// Maximum number of contacts to keep for each colliding shape pair. If a
+  /// pair has more contacts than this, they are reduced to the points that
+  /// keep the deepest penetration and span the largest support area (see
+  /// reduceContacts()). Set this to 0 to keep all the contacts, which is the
+  /// default. Four points are usually enough to support a resting face.
+  std::size_t maxNumContactsPerPair;
+
   /// CollisionFilter
   std::shared_ptr<CollisionFilter> collisionFilter;
 
+  /// Number of threads to run the narrow-phase checks of the shape pairs with.
+  /// Set this to 0 to use all the hardware threads. The contacts are merged in
+  /// the same order as the single threaded check, so the result doesn't depend
+  /// on this number. Currently, only DARTCollisionDetector and
+  /// FCLCollisionDetector support multithreading; the other collision
+  /// detectors ignore this option.
+  std::size_t numThreads;
+
+  /// Distance under which separated shape pairs are also reported as contacts
+  /// with negative penetration depth (i.e., the gap between the shapes). These
+  /// speculative contacts let the constraint solver stop fast approaching
+  /// bodies before they penetrate (see
+  /// constraint::ConstraintSolver::setSpeculativeContactMargin()). The margin
+  /// is only applied when the contact information is requested. Currently,
+  /// only DARTCollisionDetector supports this option, and only for the pairs
+  /// of boxes, spheres, and ellipsoids; the other collision detectors ignore
+  /// it. The default is 0, which reports penetrating pairs only.
+  double contactMargin;
+
+  /// Time interval over which the objects of the BodyNodes with continuous
+  /// collision checking enabled (see
+  /// dynamics::BodyNode::setContinuousCollisionCheck()) are swept with their
+  /// current velocities. If such an object is separated from another object
+  /// but hits it within the interval, a contact at the time of impact is
+  /// reported with negative penetration depth (the distance left before the
+  /// impact), so small fast objects don't pass through thin objects between
+  /// two checks. The sweep is only applied when the contact information is
+  /// requested. Currently, only DARTCollisionDetector supports this option,
+  /// and only for the pairs of boxes, spheres, and ellipsoids; the other
+  /// collision detectors ignore it. The default is 0, which disables the
+  /// continuous collision checking.
+  double continuousCollisionTimeStep;
+
   /// Constructor
   CollisionOption(
       bool enableContact = true,
       std::size_t maxNumContacts = 1000u,
-      const std::shared_ptr<CollisionFilter>& collisionFilter = nullptr);
+      const std::shared_ptr<CollisionFilter>& collisionFilter = nullptr,
+      std::size_t numThreads = 1u,
+      std::size_t maxNumContactsPerPair = 0u,
+      double contactMargin = 0.0,
+      double continuousCollisionTimeStep = 0.0);
 };
 
 } // namespace collision
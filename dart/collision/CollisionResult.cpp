@@ -40,6 +40,13 @@
 namespace dart {
 namespace collision {
 
+//==============================================================================
+CollisionResult::CollisionResult()
+  : mNumContactCacheHits(0u), mNumContactCacheMisses(0u)
+{
+  // Do nothing
+}
+
 //==============================================================================
 void CollisionResult::addContact(const Contact& contact)
 {
@@ -114,12 +121,37 @@ CollisionResult::operator bool() const
   return isCollision();
 }
 
+//==============================================================================
+std::size_t CollisionResult::getNumContactCacheHits() const
+{
+  return mNumContactCacheHits;
+}
+
+//==============================================================================
+std::size_t CollisionResult::getNumContactCacheMisses() const
+{
+  return mNumContactCacheMisses;
+}
+
+//==============================================================================
+double CollisionResult::getContactCacheHitRate() const
+{
+  const std::size_t numLookups = mNumContactCacheHits + mNumContactCacheMisses;
+  if (0u == numLookups)
+    return 0.0;
+
+  return static_cast<double>(mNumContactCacheHits)
+         / static_cast<double>(numLookups);
+}
+
 //==============================================================================
 void CollisionResult::clear()
 {
   mContacts.clear();
   mCollidingShapeFrames.clear();
   mCollidingBodyNodes.clear();
+  mNumContactCacheHits = 0u;
+  mNumContactCacheMisses = 0u;
 }
 
 //==============================================================================
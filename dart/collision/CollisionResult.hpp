@@ -48,9 +48,16 @@ class ShapeFrame;
 
 namespace collision {
 
+class ContactCache;
+
 class CollisionResult
 {
 public:
+  friend class ContactCache;
+
+  /// Constructor
+  CollisionResult();
+
   /// Add one contact
   void addContact(const Contact& contact);
 
@@ -86,6 +93,18 @@ public:
   /// Implicitly converts this CollisionResult to the value of isCollision()
   operator bool() const;
 
+  /// Return the number of shape pairs whose contacts were reused from the
+  /// ContactCache of the CollisionGroup instead of running the narrowphase
+  std::size_t getNumContactCacheHits() const;
+
+  /// Return the number of shape pairs that were looked up in the ContactCache
+  /// of the CollisionGroup but had to run the narrowphase
+  std::size_t getNumContactCacheMisses() const;
+
+  /// Return the ratio of the contact cache hits to all the contact cache
+  /// lookups, or zero if the ContactCache was not used
+  double getContactCacheHitRate() const;
+
   /// Clear all the contacts
   void clear();
 
@@ -100,6 +119,12 @@ protected:
 
   /// Set of ShapeFrames that are colliding
   std::unordered_set<const dynamics::ShapeFrame*> mCollidingShapeFrames;
+
+  /// Number of shape pairs whose contacts were reused from the ContactCache
+  std::size_t mNumContactCacheHits;
+
+  /// Number of shape pairs that were not found in the ContactCache
+  std::size_t mNumContactCacheMisses;
 };
 
 } // namespace collision
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/ContactCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <initializer_list>
+
+#include "dart/collision/CollisionObject.hpp"
+#include "dart/collision/CollisionOption.hpp"
+#include "dart/collision/CollisionResult.hpp"
+#include "dart/dynamics/Shape.hpp"
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+//==============================================================================
+void getShapeIdAndVersion(
+    const CollisionObject* object, std::size_t& id, std::size_t& version)
+{
+  // Use the same improbable values as CollisionGroup for the null shape
+  const auto shape = object->getShape();
+  id = shape ? shape->getID() : 0u;
+  version = shape ? shape->getVersion() : 0u;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+bool ContactCache::Key::operator==(const Key& other) const
+{
+  return scope == other.scope && first == other.first
+         && second == other.second;
+}
+
+//==============================================================================
+std::size_t ContactCache::KeyHash::operator()(const Key& key) const
+{
+  std::size_t hash = std::hash<const void*>()(key.scope);
+
+  for (const CollisionObject* object : {key.first, key.second})
+  {
+    const std::size_t h = std::hash<const CollisionObject*>()(object);
+    hash ^= h + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+
+  return hash;
+}
+
+//==============================================================================
+ContactCache::ContactCache(double linearTolerance, double angularTolerance)
+  : mLinearTolerance(linearTolerance),
+    mAngularTolerance(angularTolerance),
+    mScope(nullptr),
+    mQuery(0u),
+    mContactMargin(0.0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+void ContactCache::setLinearTolerance(double tolerance)
+{
+  mLinearTolerance = tolerance;
+}
+
+//==============================================================================
+double ContactCache::getLinearTolerance() const
+{
+  return mLinearTolerance;
+}
+
+//==============================================================================
+void ContactCache::setAngularTolerance(double tolerance)
+{
+  mAngularTolerance = tolerance;
+}
+
+//==============================================================================
+double ContactCache::getAngularTolerance() const
+{
+  return mAngularTolerance;
+}
+
+//==============================================================================
+bool ContactCache::fetch(
+    CollisionObject* object1,
+    CollisionObject* object2,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  const Key key = makeKey(object1, object2);
+  const auto search = mEntries.find(key);
+
+  if (search == mEntries.end()
+      || !isValid(search->second, key.first, key.second))
+  {
+    ++result.mNumContactCacheMisses;
+    return false;
+  }
+
+  Entry& entry = search->second;
+  entry.mLastQuery = mQuery;
+  ++result.mNumContactCacheHits;
+
+  // The cached contacts are expressed in the frame of the first object of the
+  // key. If the objects are given in the opposite order, the contact normals
+  // need to be flipped as well as the objects.
+  const Eigen::Isometry3d& tf = key.first->getTransform();
+  const bool swapped = (key.first != object1);
+
+  for (const auto& localContact : entry.mLocalContacts)
+  {
+    if (result.getNumContacts() >= option.maxNumContacts)
+      break;
+
+    Contact contact = localContact;
+    contact.point = tf * localContact.point;
+    contact.normal = tf.linear() * localContact.normal;
+    contact.collisionObject1 = object1;
+    contact.collisionObject2 = object2;
+
+    if (swapped)
+    {
+      contact.normal = -contact.normal;
+      std::swap(contact.triID1, contact.triID2);
+    }
+
+    result.addContact(contact);
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool ContactCache::contains(
+    const CollisionObject* object1, const CollisionObject* object2) const
+{
+  const Key key = makeKey(object1, object2);
+  const auto search = mEntries.find(key);
+
+  if (search == mEntries.end())
+    return false;
+
+  return isValid(search->second, key.first, key.second);
+}
+
+//==============================================================================
+void ContactCache::store(
+    CollisionObject* object1,
+    CollisionObject* object2,
+    const CollisionResult& result,
+    std::size_t firstContact)
+{
+  const Key key = makeKey(object1, object2);
+  const bool swapped = (key.first != object1);
+
+  const Eigen::Isometry3d& tf1 = key.first->getTransform();
+  const Eigen::Isometry3d& tf2 = key.second->getTransform();
+  const Eigen::Matrix3d rotationInv = tf1.linear().transpose();
+
+  Entry& entry = mEntries[key];
+  entry.mRelativeRotation = rotationInv * tf2.linear();
+  entry.mRelativeTranslation
+      = rotationInv * (tf2.translation() - tf1.translation());
+  getShapeIdAndVersion(key.first, entry.mShapeID1, entry.mShapeVersion1);
+  getShapeIdAndVersion(key.second, entry.mShapeID2, entry.mShapeVersion2);
+  entry.mLastQuery = mQuery;
+
+  entry.mLocalContacts.clear();
+  for (auto i = firstContact; i < result.getNumContacts(); ++i)
+  {
+    Contact localContact = result.getContact(i);
+    localContact.point
+        = rotationInv * (localContact.point - tf1.translation());
+    localContact.normal = rotationInv * localContact.normal;
+    localContact.collisionObject1 = nullptr;
+    localContact.collisionObject2 = nullptr;
+
+    if (swapped)
+    {
+      localContact.normal = -localContact.normal;
+      std::swap(localContact.triID1, localContact.triID2);
+    }
+
+    entry.mLocalContacts.push_back(localContact);
+  }
+}
+
+//==============================================================================
+void ContactCache::invalidate(const CollisionObject* object)
+{
+  for (auto it = mEntries.begin(); it != mEntries.end();)
+  {
+    if (it->first.first == object || it->first.second == object)
+      it = mEntries.erase(it);
+    else
+      ++it;
+  }
+}
+
+//==============================================================================
+void ContactCache::clear()
+{
+  mEntries.clear();
+  mQueries.clear();
+}
+
+//==============================================================================
+std::size_t ContactCache::getNumEntries() const
+{
+  return mEntries.size();
+}
+
+//==============================================================================
+void ContactCache::beginQuery(double contactMargin, const void* scope)
+{
+  if (contactMargin != mContactMargin)
+  {
+    mEntries.clear();
+    mQueries.clear();
+    mContactMargin = contactMargin;
+  }
+
+  std::size_t& query = mQueries[scope];
+
+  for (auto it = mEntries.begin(); it != mEntries.end();)
+  {
+    if (it->first.scope == scope && it->second.mLastQuery != query)
+      it = mEntries.erase(it);
+    else
+      ++it;
+  }
+
+  mScope = scope;
+  mQuery = ++query;
+}
+
+//==============================================================================
+ContactCache::Key ContactCache::makeKey(
+    const CollisionObject* object1, const CollisionObject* object2) const
+{
+  if (object2 < object1)
+    return Key{mScope, object2, object1};
+
+  return Key{mScope, object1, object2};
+}
+
+//==============================================================================
+bool ContactCache::isValid(
+    const Entry& entry,
+    const CollisionObject* first,
+    const CollisionObject* second) const
+{
+  std::size_t id;
+  std::size_t version;
+
+  getShapeIdAndVersion(first, id, version);
+  if (id != entry.mShapeID1 || version != entry.mShapeVersion1)
+    return false;
+
+  getShapeIdAndVersion(second, id, version);
+  if (id != entry.mShapeID2 || version != entry.mShapeVersion2)
+    return false;
+
+  const Eigen::Isometry3d& tf1 = first->getTransform();
+  const Eigen::Isometry3d& tf2 = second->getTransform();
+  const Eigen::Matrix3d rotationInv = tf1.linear().transpose();
+
+  const Eigen::Vector3d relativeTranslation
+      = rotationInv * (tf2.translation() - tf1.translation());
+  if ((relativeTranslation - entry.mRelativeTranslation).norm()
+      > mLinearTolerance)
+  {
+    return false;
+  }
+
+  // The angle of the rotation between the cached and the current relative
+  // rotations is computed from the trace to avoid the cost of a full
+  // axis-angle conversion.
+  const Eigen::Matrix3d relativeRotation = rotationInv * tf2.linear();
+  const double cosAngle = 0.5
+      * ((entry.mRelativeRotation.transpose() * relativeRotation).trace()
+         - 1.0);
+  const double angle = std::acos(std::max(-1.0, std::min(1.0, cosAngle)));
+
+  return angle <= mAngularTolerance;
+}
+
+} // namespace collision
+} // namespace dart
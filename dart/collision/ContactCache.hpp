@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_CONTACTCACHE_HPP_
+#define DART_COLLISION_CONTACTCACHE_HPP_
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <Eigen/Dense>
+#include "dart/collision/Contact.hpp"
+
+namespace dart {
+namespace collision {
+
+class CollisionResult;
+struct CollisionOption;
+
+/// ContactCache stores the contacts computed by the narrowphase for each pair
+/// of CollisionObjects so that they can be reused by the next collision query
+/// as long as the relative transform of the pair has not changed by more than
+/// the given tolerances and neither of the shapes has been modified.
+///
+/// The contacts are stored in the frame of the first CollisionObject of the
+/// pair, so the reused contacts follow the pair when it moves rigidly (e.g., a
+/// robot holding an object).
+///
+/// A ContactCache is usually owned by a CollisionGroup (see
+/// CollisionGroup::setContactCacheEnabled()), which invalidates the entries of
+/// the CollisionObjects whose shapes are modified or which are removed from the
+/// group.
+class ContactCache
+{
+public:
+  /// Constructor
+  explicit ContactCache(
+      double linearTolerance = 1e-6, double angularTolerance = 1e-6);
+
+  /// Set the maximum change of the relative translation between two
+  /// CollisionObjects under which the cached contacts are reused.
+  void setLinearTolerance(double tolerance);
+
+  /// Get the maximum change of the relative translation between two
+  /// CollisionObjects under which the cached contacts are reused.
+  double getLinearTolerance() const;
+
+  /// Set the maximum change of the relative rotation angle (in radian) between
+  /// two CollisionObjects under which the cached contacts are reused.
+  void setAngularTolerance(double tolerance);
+
+  /// Get the maximum change of the relative rotation angle (in radian) between
+  /// two CollisionObjects under which the cached contacts are reused.
+  double getAngularTolerance() const;
+
+  /// Look up the cached contacts of the pair (object1, object2). If a valid
+  /// entry exists, its contacts are transformed to the current transforms of
+  /// the objects, added to result (up to option.maxNumContacts), and true is
+  /// returned. Otherwise, false is returned and the caller is expected to run
+  /// the narrowphase and store the new contacts by calling store().
+  ///
+  /// The lookup is recorded as a hit or a miss in result.
+  bool fetch(
+      CollisionObject* object1,
+      CollisionObject* object2,
+      const CollisionOption& option,
+      CollisionResult& result);
+
+  /// Return true if fetch() would succeed for the pair (object1, object2).
+  /// Unlike fetch(), this doesn't record the lookup, so it can be used to
+  /// decide which pairs need the narrowphase before fetching.
+  bool contains(
+      const CollisionObject* object1, const CollisionObject* object2) const;
+
+  /// Store the contacts of result starting from the index firstContact as the
+  /// contacts of the pair (object1, object2). An empty range is also stored so
+  /// that separated pairs can be skipped as well.
+  void store(
+      CollisionObject* object1,
+      CollisionObject* object2,
+      const CollisionResult& result,
+      std::size_t firstContact);
+
+  /// Remove all the entries that involve object.
+  void invalidate(const CollisionObject* object);
+
+  /// Remove all the entries.
+  void clear();
+
+  /// Return the number of cached pairs.
+  std::size_t getNumEntries() const;
+
+  /// Mark the beginning of a new collision query. The entries of scope that
+  /// were not used by the previous query of the same scope are discarded so
+  /// that the cache does not keep the pairs that are no longer reported by the
+  /// broadphase. All the entries are discarded if contactMargin (see
+  /// CollisionOption::contactMargin) differs from the one of the previous
+  /// query since the stored contacts depend on it.
+  ///
+  /// The entries fetched and stored until the next call are bound to scope.
+  /// CollisionGroup uses nullptr for the queries within the group and the
+  /// other group for the queries between two groups, so both kinds of queries
+  /// can be interleaved without evicting the entries of each other.
+  void beginQuery(double contactMargin = 0.0, const void* scope = nullptr);
+
+protected:
+  struct Key
+  {
+    /// Scope of the query that stored the entry
+    const void* scope;
+
+    /// Object with the lower address
+    const CollisionObject* first;
+
+    /// Object with the higher address
+    const CollisionObject* second;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash
+  {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  struct Entry
+  {
+    /// Rotation of the second object relative to the first object
+    Eigen::Matrix3d mRelativeRotation;
+
+    /// Translation of the second object relative to the first object
+    Eigen::Vector3d mRelativeTranslation;
+
+    /// Shape IDs and versions of the objects when the entry was stored
+    std::size_t mShapeID1;
+    std::size_t mShapeVersion1;
+    std::size_t mShapeID2;
+    std::size_t mShapeVersion2;
+
+    /// Contacts expressed in the frame of the first object of the key
+    std::vector<Contact> mLocalContacts;
+
+    /// The query of the scope in which this entry was used the last time
+    std::size_t mLastQuery;
+  };
+
+  /// Return the key of the pair in the current scope where the first object
+  /// has the lower address.
+  Key makeKey(
+      const CollisionObject* object1, const CollisionObject* object2) const;
+
+  /// Return true if the shapes and the relative transform of the pair have not
+  /// changed since the entry was stored.
+  bool isValid(
+      const Entry& entry,
+      const CollisionObject* first,
+      const CollisionObject* second) const;
+
+  /// Linear tolerance
+  double mLinearTolerance;
+
+  /// Angular tolerance
+  double mAngularTolerance;
+
+  /// Cached entries
+  std::unordered_map<Key, Entry, KeyHash> mEntries;
+
+  /// Counters of the queries of each scope
+  std::unordered_map<const void*, std::size_t> mQueries;
+
+  /// Scope of the current query
+  const void* mScope;
+
+  /// Counter of the current query in its scope
+  std::size_t mQuery;
+
+  /// Contact margin of the current query
+  double mContactMargin;
+};
+
+} // namespace collision
+} // namespace dart
+
+#endif // DART_COLLISION_CONTACTCACHE_HPP_
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/ContactReduction.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+//==============================================================================
+/// Return the index of the unselected contact of the largest score, or
+/// numContacts if there is no unselected contact of a positive score.
+std::size_t findMaxScore(
+    const std::vector<double>& scores, const std::vector<bool>& selected)
+{
+  const auto numContacts = scores.size();
+  auto maxIndex = numContacts;
+  auto maxScore = 0.0;
+
+  for (auto i = 0u; i < numContacts; ++i)
+  {
+    if (selected[i])
+      continue;
+
+    if (scores[i] > maxScore)
+    {
+      maxScore = scores[i];
+      maxIndex = i;
+    }
+  }
+
+  return maxIndex;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+void reduceContacts(std::vector<Contact>& contacts, std::size_t maxNumContacts)
+{
+  const auto numContacts = contacts.size();
+
+  if (0u == maxNumContacts || numContacts <= maxNumContacts)
+    return;
+
+  // The contact of the deepest penetration is kept first
+  std::size_t deepest = 0u;
+  for (auto i = 1u; i < numContacts; ++i)
+  {
+    if (contacts[i].penetrationDepth > contacts[deepest].penetrationDepth)
+      deepest = i;
+  }
+
+  std::vector<bool> selected(numContacts, false);
+  selected[deepest] = true;
+  std::size_t numSelected = 1u;
+
+  // The distances are measured on the plane perpendicular to the average
+  // normal so that the depth differences don't affect the support area.
+  Eigen::Vector3d normal = Eigen::Vector3d::Zero();
+  for (const auto& contact : contacts)
+    normal += contact.normal;
+
+  if (Contact::isZeroNormal(normal))
+    normal = contacts[deepest].normal;
+  normal.normalize();
+
+  std::vector<Eigen::Vector3d> points(numContacts);
+  for (auto i = 0u; i < numContacts; ++i)
+    points[i] = contacts[i].point - normal.dot(contacts[i].point) * normal;
+
+  // Squared distance of each contact to the closest selected contact
+  std::vector<double> distances(numContacts);
+  for (auto i = 0u; i < numContacts; ++i)
+    distances[i] = (points[i] - points[deepest]).squaredNorm();
+
+  const auto select = [&](std::size_t index) {
+    selected[index] = true;
+    ++numSelected;
+
+    for (auto i = 0u; i < numContacts; ++i)
+    {
+      distances[i]
+          = std::min(distances[i], (points[i] - points[index]).squaredNorm());
+    }
+  };
+
+  // The contact farthest from the deepest contact
+  const auto second = findMaxScore(distances, selected);
+  if (second < numContacts && numSelected < maxNumContacts)
+  {
+    select(second);
+
+    // The contact forming the largest triangle with the first two
+    if (numSelected < maxNumContacts)
+    {
+      const Eigen::Vector3d edge = points[second] - points[deepest];
+      std::vector<double> areas(numContacts);
+      for (auto i = 0u; i < numContacts; ++i)
+        areas[i] = edge.cross(points[i] - points[deepest]).squaredNorm();
+
+      const auto third = findMaxScore(areas, selected);
+      if (third < numContacts)
+        select(third);
+    }
+  }
+
+  // The rest are sampled by the distances to the selected contacts, which
+  // covers the remaining corners of the support area first.
+  while (numSelected < maxNumContacts)
+  {
+    const auto next = findMaxScore(distances, selected);
+    if (next == numContacts)
+      break;
+
+    select(next);
+  }
+
+  std::size_t numKept = 0u;
+  for (auto i = 0u; i < numContacts; ++i)
+  {
+    if (selected[i])
+      contacts[numKept++] = contacts[i];
+  }
+  contacts.resize(numKept);
+}
+
+} // namespace collision
+} // namespace dart
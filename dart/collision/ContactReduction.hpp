@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_CONTACTREDUCTION_HPP_
+#define DART_COLLISION_CONTACTREDUCTION_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "dart/collision/Contact.hpp"
+
+namespace dart {
+namespace collision {
+
+/// Reduce the contacts of a single shape pair to at most maxNumContacts points
+/// that approximate the same contact manifold.
+///
+/// The contact of the deepest penetration is always kept. The remaining
+/// points are picked to span the largest area on the contact plane: the point
+/// farthest from the deepest one, then the point forming the largest triangle
+/// with the first two, and then the points farthest from the points picked so
+/// far. The kept contacts stay in their original order.
+///
+/// Nothing is done if maxNumContacts is zero or not less than the number of
+/// the contacts.
+void reduceContacts(std::vector<Contact>& contacts, std::size_t maxNumContacts);
+
+} // namespace collision
+} // namespace dart
+
+#endif // DART_COLLISION_CONTACTREDUCTION_HPP_
@@ -42,6 +42,7 @@
 
 #include "dart/collision/CollisionFilter.hpp"
 #include "dart/collision/CollisionObject.hpp"
+#include "dart/collision/ContactReduction.hpp"
 #include "dart/collision/bullet/BulletCollisionGroup.hpp"
 #include "dart/collision/bullet/BulletCollisionObject.hpp"
 #include "dart/collision/bullet/BulletTypes.hpp"
@@ -741,6 +742,13 @@ void reportContacts(
 
     const auto numContacts = contactManifold->getNumContacts();
 
+    // Bullet keeps at most four points per manifold, so the manifold only
+    // needs to be reduced further if fewer points are requested
+    std::vector<Contact> contacts;
+    const auto reduce = (0u < option.maxNumContactsPerPair
+                         && static_cast<std::size_t>(numContacts)
+                                > option.maxNumContactsPerPair);
+
     for (auto j = 0; j < numContacts; ++j)
     {
       const auto& cp = contactManifold->getContactPoint(j);
@@ -752,6 +760,12 @@ void reportContacts(
         continue;
       }
 
+      if (reduce)
+      {
+        contacts.push_back(convertContact(cp, collObj0, collObj1));
+        continue;
+      }
+
       result.addContact(convertContact(cp, collObj0, collObj1));
 
       // No need to check further collisions
@@ -761,6 +775,23 @@ void reportContacts(
         return;
       }
     }
+
+    if (!reduce)
+      continue;
+
+    reduceContacts(contacts, option.maxNumContactsPerPair);
+
+    for (const auto& contact : contacts)
+    {
+      result.addContact(contact);
+
+      // No need to check further collisions
+      if (result.getNumContacts() >= option.maxNumContacts)
+      {
+        dispatcher->setDone(true);
+        return;
+      }
+    }
   }
 }
 
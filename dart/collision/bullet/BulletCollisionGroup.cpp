@@ -113,6 +113,17 @@ void BulletCollisionGroup::updateCollisionGroupEngineData()
   mBulletCollisionWorld->updateAabbs();
 }
 
+//==============================================================================
+void BulletCollisionGroup::updateCollisionGroupEngineDataOf(
+    const std::vector<CollisionObject*>& objects)
+{
+  for (auto object : objects)
+  {
+    auto casted = static_cast<BulletCollisionObject*>(object);
+    mBulletCollisionWorld->updateSingleAabb(casted->getBulletCollisionObject());
+  }
+}
+
 //==============================================================================
 btCollisionWorld* BulletCollisionGroup::getBulletCollisionWorld()
 {
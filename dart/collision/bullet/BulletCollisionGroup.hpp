@@ -74,6 +74,10 @@ protected:
   // Documentation inherited
   void updateCollisionGroupEngineData() override;
 
+  // Documentation inherited
+  void updateCollisionGroupEngineDataOf(
+      const std::vector<CollisionObject*>& objects) override;
+
   /// Return Bullet collision world
   btCollisionWorld* getBulletCollisionWorld();
 
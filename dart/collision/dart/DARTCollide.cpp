@@ -33,13 +33,20 @@
 #include "dart/collision/dart/DARTCollide.hpp"
 #include "dart/collision/CollisionObject.hpp"
 
+#include <initializer_list>
+#include <limits>
 #include <memory>
 
+#include "dart/collision/ContactReduction.hpp"
 #include "dart/dynamics/BodyNode.hpp"
 #include "dart/dynamics/BoxShape.hpp"
+#include "dart/dynamics/CapsuleShape.hpp"
 #include "dart/dynamics/CylinderShape.hpp"
 #include "dart/dynamics/EllipsoidShape.hpp"
+#include "dart/dynamics/MeshShape.hpp"
+#include "dart/dynamics/SignedDistanceFieldShape.hpp"
 #include "dart/dynamics/SphereShape.hpp"
+#include "dart/math/Geometry.hpp"
 #include "dart/math/Helpers.hpp"
 
 namespace dart {
@@ -497,7 +504,8 @@ int dBoxBox(
     const dVector3 p2,
     const dMatrix3 R2,
     const dVector3 side2,
-    CollisionResult& result)
+    CollisionResult& result,
+    double margin)
 {
   const double fudge_factor = 1.05;
   dVector3 p, pp, normalC = {0.0, 0.0, 0.0, 0.0};
@@ -585,7 +593,8 @@ int dBoxBox(
       6);
 
   // note: cross product axes need to be scaled when s is computed.
-  // normal (n1,n2,n3) is relative to box 1.
+  // normal (n1,n2,n3) is relative to box 1. the fudge factor favors the face
+  // axes, also when the boxes are separated (positive s) within the margin.
 #undef TST
 #define TST(expr1, expr2, n1, n2, n3, cc)                                      \
   s2 = std::abs(expr1) - (expr2);                                              \
@@ -593,7 +602,7 @@ int dBoxBox(
   if (l > 0)                                                                   \
   {                                                                            \
     s2 /= l;                                                                   \
-    if (s2 * fudge_factor > s)                                                 \
+    if ((s2 > 0.0 ? s2 / fudge_factor : s2 * fudge_factor) > s)               \
     {                                                                          \
       s = s2;                                                                  \
       normalR = 0;                                                             \
@@ -669,11 +678,11 @@ int dBoxBox(
 
   if (!code)
     return 0;
-  if (s > 0.0)
+  if (s > margin)
     return 0;
 
-  // if we get to this point, the boxes interpenetrate. compute the normal
-  // in global coordinates.
+  // if we get to this point, the boxes interpenetrate or are closer than the
+  // margin. compute the normal in global coordinates.
 
   Eigen::Vector3d normal;
   Eigen::Vector3d point_vec;
@@ -933,7 +942,7 @@ int dBoxBox(
           = center[i] + k1 * Rb[i * 4 + a1] + k2 * Rb[i * 4 + a2];
     }
     dep[cnum] = Sa[codeN] - Inner(normal2, point + cnum * 3);
-    if (dep[cnum] >= 0)
+    if (dep[cnum] >= -margin)
     {
       ret[cnum * 2] = ret[j * 2];
       ret[cnum * 2 + 1] = ret[j * 2 + 1];
@@ -1009,7 +1018,8 @@ int collideBoxBox(
     const Eigen::Isometry3d& T0,
     const Eigen::Vector3d& size1,
     const Eigen::Isometry3d& T1,
-    CollisionResult& result)
+    CollisionResult& result,
+    double margin)
 {
   dVector3 halfSize0;
   dVector3 halfSize1;
@@ -1028,7 +1038,8 @@ int collideBoxBox(
   convVector(T0.translation(), p0);
   convVector(T1.translation(), p1);
 
-  return dBoxBox(o1, o2, p1, R1, halfSize1, p0, R0, halfSize0, result);
+  return dBoxBox(
+      o1, o2, p1, R1, halfSize1, p0, R0, halfSize0, result, margin);
 }
 
 int collideBoxSphere(
@@ -1038,7 +1049,8 @@ int collideBoxSphere(
     const Eigen::Isometry3d& T0,
     const double& r1,
     const Eigen::Isometry3d& T1,
-    CollisionResult& result)
+    CollisionResult& result,
+    double margin)
 {
   Eigen::Vector3d halfSize = 0.5 * size0;
   bool inside_box = true;
@@ -1124,7 +1136,7 @@ int collideBoxSphere(
   double mag = normal.norm();
   penetration = r1 - mag;
 
-  if (penetration < 0.0)
+  if (penetration < -margin)
   {
     return 0;
   }
@@ -1181,7 +1193,8 @@ int collideSphereBox(
     const Eigen::Isometry3d& T0,
     const Eigen::Vector3d& size1,
     const Eigen::Isometry3d& T1,
-    CollisionResult& result)
+    CollisionResult& result,
+    double margin)
 {
   Eigen::Vector3d size = 0.5 * size1;
   bool inside_box = true;
@@ -1264,7 +1277,7 @@ int collideSphereBox(
   double mag = normal.norm();
   penetration = r0 - mag;
 
-  if (penetration < 0.0)
+  if (penetration < -margin)
   {
     return 0;
   }
@@ -1320,7 +1333,8 @@ int collideSphereSphere(
     const Eigen::Isometry3d& c0,
     const double& _r1,
     const Eigen::Isometry3d& c1,
-    CollisionResult& result)
+    CollisionResult& result,
+    double margin)
 {
   double r0 = _r0;
   double r1 = _r1;
@@ -1328,7 +1342,7 @@ int collideSphereSphere(
   Eigen::Vector3d normal = c0.translation() - c1.translation();
   double normal_sqr = normal.squaredNorm();
 
-  if (normal_sqr > rsum * rsum)
+  if (normal_sqr > (rsum + margin) * (rsum + margin))
   {
     return 0;
   }
@@ -1529,8 +1543,326 @@ int collideCylinderPlane(
   return 0;
 }
 
+namespace {
+
+/// Maximum number of contacts generated between a sampled shape and a signed
+/// distance field. The deepest and most spread contacts are kept.
+constexpr std::size_t kMaxNumSignedDistanceFieldContacts = 8u;
+
+/// Maximum number of the surface samples of a box checked against a signed
+/// distance field. The samples are spread more sparsely than the voxels of the
+/// field only if the overlapping surface needs more samples than this.
+constexpr int kMaxNumBoxSamples = 4096;
+
 //==============================================================================
-int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
+/// Collects the contacts of spheres, or points for zero radius, with a signed
+/// distance field. The sampled shape is o1, and the field is o2.
+class SignedDistanceFieldContacts
+{
+public:
+  SignedDistanceFieldContacts(
+      CollisionObject* o1,
+      CollisionObject* o2,
+      const dynamics::SignedDistanceFieldShape& sdf,
+      const Eigen::Isometry3d& sdfTransform)
+    : mObject1(o1), mObject2(o2), mSdf(sdf), mSdfTransform(sdfTransform)
+  {
+    // Do nothing
+  }
+
+  /// Returns true if the bounding sphere (in the frame of the field) is
+  /// certainly apart from the geometry of the field.
+  bool isSeparated(const Eigen::Vector3d& center, double radius) const
+  {
+    const math::BoundingBox& box = mSdf.getBoundingBox();
+    const Eigen::Vector3d clamped
+        = center.cwiseMax(box.getMin()).cwiseMin(box.getMax());
+
+    if ((center - clamped).squaredNorm() > radius * radius)
+      return true;
+
+    // The interpolated distance can be off by up to the resolution
+    return mSdf.isInside(center)
+           && mSdf.getDistance(center) > radius + mSdf.getResolution();
+  }
+
+  /// Checks the sphere centered at the point in the frame of the field
+  void addSphere(const Eigen::Vector3d& center, double radius)
+  {
+    if (!mSdf.isInside(center))
+      return;
+
+    Eigen::Vector3d gradient;
+    const double distance = mSdf.getDistance(center, gradient);
+    if (distance >= radius)
+      return;
+
+    // The gradient vanishes on the medial axis of the geometry where the
+    // direction to the nearest surface is ambiguous.
+    const double norm = gradient.norm();
+    if (norm < DART_COLLISION_EPS)
+      return;
+
+    const Eigen::Vector3d normal = gradient / norm;
+
+    Contact contact;
+    contact.collisionObject1 = mObject1;
+    contact.collisionObject2 = mObject2;
+    contact.point
+        = mSdfTransform * (center - 0.5 * (distance + radius) * normal);
+    contact.normal = mSdfTransform.linear() * normal;
+    contact.penetrationDepth = radius - distance;
+    mContacts.push_back(contact);
+  }
+
+  /// Adds the collected contacts to the result and returns the number of them
+  int flush(CollisionResult& result)
+  {
+    reduceContacts(mContacts, kMaxNumSignedDistanceFieldContacts);
+
+    for (const auto& contact : mContacts)
+      result.addContact(contact);
+
+    return static_cast<int>(mContacts.size());
+  }
+
+private:
+  CollisionObject* mObject1;
+  CollisionObject* mObject2;
+  const dynamics::SignedDistanceFieldShape& mSdf;
+  const Eigen::Isometry3d& mSdfTransform;
+  std::vector<Contact> mContacts;
+};
+
+//==============================================================================
+/// Returns the number of samples along a length so that the samples are not
+/// farther apart than the spacing
+int computeNumSamples(double length, double spacing, int maxNumSamples)
+{
+  const int numSamples = static_cast<int>(std::ceil(length / spacing)) + 1;
+  return math::clip(numSamples, 2, maxNumSamples);
+}
+
+} // namespace
+
+//==============================================================================
+int collideSphereSignedDistanceField(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const double& r0,
+    const Eigen::Isometry3d& T0,
+    const dynamics::SignedDistanceFieldShape& sdf1,
+    const Eigen::Isometry3d& T1,
+    CollisionResult& result)
+{
+  SignedDistanceFieldContacts contacts(o1, o2, sdf1, T1);
+
+  const Eigen::Vector3d center = T1.inverse() * T0.translation();
+  if (contacts.isSeparated(center, r0))
+    return 0;
+
+  contacts.addSphere(center, r0);
+
+  return contacts.flush(result);
+}
+
+//==============================================================================
+int collideCapsuleSignedDistanceField(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const double& radius0,
+    const double& height0,
+    const Eigen::Isometry3d& T0,
+    const dynamics::SignedDistanceFieldShape& sdf1,
+    const Eigen::Isometry3d& T1,
+    CollisionResult& result)
+{
+  SignedDistanceFieldContacts contacts(o1, o2, sdf1, T1);
+
+  const Eigen::Isometry3d T10 = T1.inverse() * T0;
+  if (contacts.isSeparated(T10.translation(), 0.5 * height0 + radius0))
+    return 0;
+
+  // Sweep a sphere along the axis of the capsule
+  const double spacing = std::min(radius0, sdf1.getResolution());
+  const int numSamples = computeNumSamples(height0, spacing, 64);
+  for (int i = 0; i < numSamples; ++i)
+  {
+    const double z
+        = height0 * (static_cast<double>(i) / (numSamples - 1) - 0.5);
+    contacts.addSphere(T10 * Eigen::Vector3d(0.0, 0.0, z), radius0);
+  }
+
+  return contacts.flush(result);
+}
+
+//==============================================================================
+int collideBoxSignedDistanceField(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3d& size0,
+    const Eigen::Isometry3d& T0,
+    const dynamics::SignedDistanceFieldShape& sdf1,
+    const Eigen::Isometry3d& T1,
+    CollisionResult& result)
+{
+  SignedDistanceFieldContacts contacts(o1, o2, sdf1, T1);
+
+  const Eigen::Isometry3d T10 = T1.inverse() * T0;
+  if (contacts.isSeparated(T10.translation(), 0.5 * size0.norm()))
+    return 0;
+
+  // Only the part of the box surface within the bounding box of the field can
+  // touch the geometry, so sample the faces over the overlap of the box with
+  // the bounding box of the field expressed in the frame of the box.
+  const Eigen::Isometry3d T01 = T10.inverse();
+  const math::BoundingBox& sdfBox = sdf1.getBoundingBox();
+  const Eigen::Vector3d halfSize0 = 0.5 * size0;
+  Eigen::Vector3d lower
+      = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+  Eigen::Vector3d upper = -lower;
+  for (auto i = 0u; i < 8u; ++i)
+  {
+    const Eigen::Vector3d sdfCorner(
+        (i & 1u) ? sdfBox.getMax()[0] : sdfBox.getMin()[0],
+        (i & 2u) ? sdfBox.getMax()[1] : sdfBox.getMin()[1],
+        (i & 4u) ? sdfBox.getMax()[2] : sdfBox.getMin()[2]);
+    const Eigen::Vector3d point = T01 * sdfCorner;
+    lower = lower.cwiseMin(point);
+    upper = upper.cwiseMax(point);
+  }
+  lower = lower.cwiseMax(-halfSize0);
+  upper = upper.cwiseMin(halfSize0);
+
+  if ((lower.array() > upper.array()).any())
+    return 0;
+
+  // Sample the faces as densely as the voxels of the field so that thin
+  // features are not missed, unless it exceeds the sample budget.
+  const Eigen::Vector3d extents = upper - lower;
+  double spacing = sdf1.getResolution();
+  Eigen::Vector3i numSamples;
+  for (int attempt = 0; attempt < 2; ++attempt)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      numSamples[i]
+          = computeNumSamples(extents[i], spacing, kMaxNumBoxSamples);
+    }
+
+    int numFaceSamples = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      numFaceSamples
+          += 2 * numSamples[(i + 1) % 3] * numSamples[(i + 2) % 3];
+    }
+
+    if (numFaceSamples <= kMaxNumBoxSamples)
+      break;
+
+    spacing *= std::sqrt(
+        static_cast<double>(numFaceSamples) / kMaxNumBoxSamples);
+  }
+
+  Eigen::Vector3d step = Eigen::Vector3d::Zero();
+  for (int i = 0; i < 3; ++i)
+  {
+    if (numSamples[i] > 1)
+      step[i] = extents[i] / (numSamples[i] - 1);
+  }
+
+  for (int i = 0; i < 3; ++i)
+  {
+    const int j = (i + 1) % 3;
+    const int k = (i + 2) % 3;
+
+    for (const double side : {-1.0, 1.0})
+    {
+      // Skip the faces outside of the overlap
+      const double face = side * halfSize0[i];
+      if (face < lower[i] || face > upper[i])
+        continue;
+
+      Eigen::Vector3d point;
+      point[i] = face;
+
+      for (int u = 0; u < numSamples[j]; ++u)
+      {
+        point[j] = lower[j] + u * step[j];
+
+        for (int v = 0; v < numSamples[k]; ++v)
+        {
+          point[k] = lower[k] + v * step[k];
+          contacts.addSphere(T10 * point, 0.0);
+        }
+      }
+    }
+  }
+
+  return contacts.flush(result);
+}
+
+//==============================================================================
+int collideMeshSignedDistanceField(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MeshShape& mesh0,
+    const Eigen::Isometry3d& T0,
+    const dynamics::SignedDistanceFieldShape& sdf1,
+    const Eigen::Isometry3d& T1,
+    CollisionResult& result)
+{
+  const aiScene* scene = mesh0.getMesh();
+  if (!scene)
+    return 0;
+
+  SignedDistanceFieldContacts contacts(o1, o2, sdf1, T1);
+
+  const Eigen::Isometry3d T10 = T1.inverse() * T0;
+  const math::BoundingBox& box = mesh0.getBoundingBox();
+  if (contacts.isSeparated(
+          T10 * box.computeCenter(), box.computeHalfExtents().norm()))
+  {
+    return 0;
+  }
+
+  const Eigen::Vector3d& scale = mesh0.getScale();
+
+  for (auto i = 0u; i < scene->mNumMeshes; ++i)
+  {
+    const aiMesh* subMesh = scene->mMeshes[i];
+
+    for (auto j = 0u; j < subMesh->mNumVertices; ++j)
+    {
+      const aiVector3D& vertex = subMesh->mVertices[j];
+      const Eigen::Vector3d point(
+          vertex.x * scale[0], vertex.y * scale[1], vertex.z * scale[2]);
+      contacts.addSphere(T10 * point, 0.0);
+    }
+  }
+
+  return contacts.flush(result);
+}
+
+//==============================================================================
+int collide(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    CollisionResult& result,
+    double margin)
+{
+  return collide(
+      o1, o2, o1->getTransform(), o2->getTransform(), result, margin);
+}
+
+//==============================================================================
+int collide(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Isometry3d& T1,
+    const Eigen::Isometry3d& T2,
+    CollisionResult& result,
+    double margin)
 {
   // TODO(JS): We could make the contact point computation as optional for
   // the case that we want only binary check.
@@ -1541,8 +1873,24 @@ int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
   const auto& shapeType1 = shape1->getType();
   const auto& shapeType2 = shape2->getType();
 
-  const Eigen::Isometry3d& T1 = o1->getTransform();
-  const Eigen::Isometry3d& T2 = o2->getTransform();
+  const auto& sdfType = dynamics::SignedDistanceFieldShape::getStaticType();
+
+  if (sdfType == shapeType1 && sdfType != shapeType2)
+  {
+    // Check the pair in the reversed order, and then swap the objects back
+    CollisionResult reversedResult;
+    const int numContacts = collide(o2, o1, T2, T1, reversedResult, margin);
+
+    for (auto contact : reversedResult.getContacts())
+    {
+      std::swap(contact.collisionObject1, contact.collisionObject2);
+      std::swap(contact.triID1, contact.triID2);
+      contact.normal = -contact.normal;
+      result.addContact(contact);
+    }
+
+    return numContacts;
+  }
 
   if (dynamics::SphereShape::getStaticType() == shapeType1)
   {
@@ -1555,14 +1903,28 @@ int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
           = static_cast<const dynamics::SphereShape*>(shape2.get());
 
       return collideSphereSphere(
-          o1, o2, sphere0->getRadius(), T1, sphere1->getRadius(), T2, result);
+          o1,
+          o2,
+          sphere0->getRadius(),
+          T1,
+          sphere1->getRadius(),
+          T2,
+          result,
+          margin);
     }
     else if (dynamics::BoxShape::getStaticType() == shapeType2)
     {
       const auto* box1 = static_cast<const dynamics::BoxShape*>(shape2.get());
 
       return collideSphereBox(
-          o1, o2, sphere0->getRadius(), T1, box1->getSize(), T2, result);
+          o1,
+          o2,
+          sphere0->getRadius(),
+          T1,
+          box1->getSize(),
+          T2,
+          result,
+          margin);
     }
     else if (dynamics::EllipsoidShape::getStaticType() == shapeType2)
     {
@@ -1576,7 +1938,17 @@ int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
           T1,
           ellipsoid1->getRadii()[0],
           T2,
-          result);
+          result,
+          margin);
+    }
+    else if (sdfType == shapeType2)
+    {
+      const auto* sdf1
+          = static_cast<const dynamics::SignedDistanceFieldShape*>(
+              shape2.get());
+
+      return collideSphereSignedDistanceField(
+          o1, o2, sphere0->getRadius(), T1, *sdf1, T2, result);
     }
   }
   else if (dynamics::BoxShape::getStaticType() == shapeType1)
@@ -1589,14 +1961,21 @@ int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
           = static_cast<const dynamics::SphereShape*>(shape2.get());
 
       return collideBoxSphere(
-          o1, o2, box0->getSize(), T1, sphere1->getRadius(), T2, result);
+          o1,
+          o2,
+          box0->getSize(),
+          T1,
+          sphere1->getRadius(),
+          T2,
+          result,
+          margin);
     }
     else if (dynamics::BoxShape::getStaticType() == shapeType2)
     {
       const auto* box1 = static_cast<const dynamics::BoxShape*>(shape2.get());
 
       return collideBoxBox(
-          o1, o2, box0->getSize(), T1, box1->getSize(), T2, result);
+          o1, o2, box0->getSize(), T1, box1->getSize(), T2, result, margin);
     }
     else if (dynamics::EllipsoidShape::getStaticType() == shapeType2)
     {
@@ -1604,7 +1983,23 @@ int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
           = static_cast<const dynamics::EllipsoidShape*>(shape2.get());
 
       return collideBoxSphere(
-          o1, o2, box0->getSize(), T1, ellipsoid1->getRadii()[0], T2, result);
+          o1,
+          o2,
+          box0->getSize(),
+          T1,
+          ellipsoid1->getRadii()[0],
+          T2,
+          result,
+          margin);
+    }
+    else if (sdfType == shapeType2)
+    {
+      const auto* sdf1
+          = static_cast<const dynamics::SignedDistanceFieldShape*>(
+              shape2.get());
+
+      return collideBoxSignedDistanceField(
+          o1, o2, box0->getSize(), T1, *sdf1, T2, result);
     }
   }
   else if (dynamics::EllipsoidShape::getStaticType() == shapeType1)
@@ -1624,14 +2019,22 @@ int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
           T1,
           sphere1->getRadius(),
           T2,
-          result);
+          result,
+          margin);
     }
     else if (dynamics::BoxShape::getStaticType() == shapeType2)
     {
       const auto* box1 = static_cast<const dynamics::BoxShape*>(shape2.get());
 
       return collideSphereBox(
-          o1, o2, ellipsoid0->getRadii()[0], T1, box1->getSize(), T2, result);
+          o1,
+          o2,
+          ellipsoid0->getRadii()[0],
+          T1,
+          box1->getSize(),
+          T2,
+          result,
+          margin);
     }
     else if (dynamics::EllipsoidShape::getStaticType() == shapeType2)
     {
@@ -1645,9 +2048,55 @@ int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
           T1,
           ellipsoid1->getRadii()[0],
           T2,
+          result,
+          margin);
+    }
+    else if (sdfType == shapeType2)
+    {
+      const auto* sdf1
+          = static_cast<const dynamics::SignedDistanceFieldShape*>(
+              shape2.get());
+
+      return collideSphereSignedDistanceField(
+          o1, o2, ellipsoid0->getRadii()[0], T1, *sdf1, T2, result);
+    }
+  }
+  else if (dynamics::CapsuleShape::getStaticType() == shapeType1)
+  {
+    const auto* capsule0
+        = static_cast<const dynamics::CapsuleShape*>(shape1.get());
+
+    if (sdfType == shapeType2)
+    {
+      const auto* sdf1
+          = static_cast<const dynamics::SignedDistanceFieldShape*>(
+              shape2.get());
+
+      return collideCapsuleSignedDistanceField(
+          o1,
+          o2,
+          capsule0->getRadius(),
+          capsule0->getHeight(),
+          T1,
+          *sdf1,
+          T2,
           result);
     }
   }
+  else if (dynamics::MeshShape::getStaticType() == shapeType1)
+  {
+    const auto* mesh0 = static_cast<const dynamics::MeshShape*>(shape1.get());
+
+    if (sdfType == shapeType2)
+    {
+      const auto* sdf1
+          = static_cast<const dynamics::SignedDistanceFieldShape*>(
+              shape2.get());
+
+      return collideMeshSignedDistanceField(
+          o1, o2, *mesh0, T1, *sdf1, T2, result);
+    }
+  }
 
   dterr << "[DARTCollisionDetector] Attempting to check for an "
         << "unsupported shape pair: [" << shape1->getType() << "] - ["
@@ -1656,5 +2105,156 @@ int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result)
   return false;
 }
 
+namespace {
+
+//==============================================================================
+bool isSweepSupported(const dynamics::Shape& shape)
+{
+  const auto& type = shape.getType();
+
+  return type == dynamics::SphereShape::getStaticType()
+         || type == dynamics::BoxShape::getStaticType()
+         || type == dynamics::EllipsoidShape::getStaticType();
+}
+
+//==============================================================================
+Eigen::Isometry3d getSweptTransform(
+    const Eigen::Isometry3d& transform,
+    const Eigen::Vector3d& linearVelocity,
+    const Eigen::Vector3d& angularVelocity,
+    double time)
+{
+  Eigen::Isometry3d result = transform;
+  result.translation() += time * linearVelocity;
+  result.linear()
+      = math::expMapRot(time * angularVelocity) * transform.linear();
+
+  return result;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+int collideSwept(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    double timeStep,
+    CollisionResult& result)
+{
+  const auto& shape1 = *o1->getShape();
+  const auto& shape2 = *o2->getShape();
+
+  if (!isSweepSupported(shape1) || !isSweepSupported(shape2))
+    return 0;
+
+  const auto* frame1 = o1->getShapeFrame();
+  const auto* frame2 = o2->getShapeFrame();
+  const Eigen::Vector3d v1 = frame1->getLinearVelocity();
+  const Eigen::Vector3d w1 = frame1->getAngularVelocity();
+  const Eigen::Vector3d v2 = frame2->getLinearVelocity();
+  const Eigen::Vector3d w2 = frame2->getAngularVelocity();
+
+  // Upper bound of the relative motion of the surface points, and the distance
+  // the objects can move between two samples without skipping over each other
+  const auto& box1 = shape1.getBoundingBox();
+  const auto& box2 = shape2.getBoundingBox();
+  const double radius1 = std::max(box1.getMin().norm(), box1.getMax().norm());
+  const double radius2 = std::max(box2.getMin().norm(), box2.getMax().norm());
+  const double motion
+      = timeStep
+        * ((v1 - v2).norm() + w1.norm() * radius1 + w2.norm() * radius2);
+  const double spacing = 0.5
+                         * std::max(
+                             (box1.getMax() - box1.getMin()).minCoeff(),
+                             (box2.getMax() - box2.getMin()).minCoeff());
+
+  // The next discrete check finds the collision if the objects move less than
+  // the spacing
+  if (spacing <= 0.0 || motion <= spacing)
+    return 0;
+
+  const int maxNumSamples = 64;
+  const int numBisections = 8;
+  const int numSamples = std::min(
+      static_cast<int>(std::ceil(motion / spacing)), maxNumSamples);
+
+  const Eigen::Isometry3d& T1 = o1->getTransform();
+  const Eigen::Isometry3d& T2 = o2->getTransform();
+
+  // Find the first sample where the objects collide
+  CollisionResult impactResult;
+  double separatedTime = 0.0;
+  double impactTime = -1.0;
+  for (int i = 1; i <= numSamples; ++i)
+  {
+    const double time = timeStep * i / numSamples;
+    if (collide(
+            o1,
+            o2,
+            getSweptTransform(T1, v1, w1, time),
+            getSweptTransform(T2, v2, w2, time),
+            impactResult))
+    {
+      impactTime = time;
+      break;
+    }
+    separatedTime = time;
+  }
+
+  if (impactTime < 0.0)
+    return 0;
+
+  // Narrow down the time of impact so that the contacts are close to the
+  // first touch
+  CollisionResult sampleResult;
+  for (int i = 0; i < numBisections; ++i)
+  {
+    const double time = 0.5 * (separatedTime + impactTime);
+    sampleResult.clear();
+    if (collide(
+            o1,
+            o2,
+            getSweptTransform(T1, v1, w1, time),
+            getSweptTransform(T2, v2, w2, time),
+            sampleResult))
+    {
+      impactTime = time;
+      std::swap(impactResult, sampleResult);
+    }
+    else
+    {
+      separatedTime = time;
+    }
+  }
+
+  // Express the contacts in the current configuration. The distance left
+  // before the impact is the approach of the objects along the normal minus
+  // the penetration at the time of impact.
+  const Eigen::Isometry3d back1
+      = T1 * getSweptTransform(T1, v1, w1, impactTime).inverse();
+  const Eigen::Isometry3d back2
+      = T2 * getSweptTransform(T2, v2, w2, impactTime).inverse();
+
+  for (auto contact : impactResult.getContacts())
+  {
+    const Eigen::Vector3d point1 = back1 * contact.point;
+    const Eigen::Vector3d point2 = back2 * contact.point;
+    const Eigen::Vector3d displacement1 = contact.point - point1;
+    const Eigen::Vector3d displacement2 = contact.point - point2;
+    const double approach
+        = -contact.normal.dot(displacement1 - displacement2);
+
+    // Put the contact on the object that moves more
+    contact.point = (displacement1.squaredNorm() >= displacement2.squaredNorm())
+                        ? point1
+                        : point2;
+    contact.penetrationDepth
+        = -std::max(approach - contact.penetrationDepth, 0.0);
+    result.addContact(contact);
+  }
+
+  return static_cast<int>(impactResult.getNumContacts());
+}
+
 } // namespace collision
 } // namespace dart
@@ -38,9 +38,46 @@
 #include "dart/collision/CollisionDetector.hpp"
 
 namespace dart {
+
+namespace dynamics {
+class MeshShape;
+class SignedDistanceFieldShape;
+} // namespace dynamics
+
 namespace collision {
 
-int collide(CollisionObject* o1, CollisionObject* o2, CollisionResult& result);
+/// Check the pair (o1, o2) and add the contacts to result. Separated pairs of
+/// boxes, spheres, and ellipsoids closer than margin are also reported with
+/// negative penetration depth; the other shape pairs ignore margin.
+int collide(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    CollisionResult& result,
+    double margin = 0.0);
+
+/// Same as above, but checks the objects at the given transforms instead of
+/// their current transforms.
+int collide(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Isometry3d& T1,
+    const Eigen::Isometry3d& T2,
+    CollisionResult& result,
+    double margin = 0.0);
+
+/// Sweep the separated objects o1 and o2 with the current velocities of their
+/// frames over timeStep, and add the contacts at the time of impact to result
+/// if they collide within it. The contacts are expressed in the current
+/// configuration on the object that moves more, and their penetration depth
+/// is the negated distance the objects approach each other before the impact.
+/// The sweep is sampled finely enough that the objects can't skip over each
+/// other, up to a fixed number of samples. Only boxes, spheres, and
+/// ellipsoids are supported; the other shape pairs are ignored.
+int collideSwept(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    double timeStep,
+    CollisionResult& result);
 
 int collideBoxBox(
     CollisionObject* o1,
@@ -49,7 +86,8 @@ int collideBoxBox(
     const Eigen::Isometry3d& T0,
     const Eigen::Vector3d& size1,
     const Eigen::Isometry3d& T1,
-    CollisionResult& result);
+    CollisionResult& result,
+    double margin = 0.0);
 
 int collideBoxSphere(
     CollisionObject* o1,
@@ -58,7 +96,8 @@ int collideBoxSphere(
     const Eigen::Isometry3d& T0,
     const double& r1,
     const Eigen::Isometry3d& T1,
-    CollisionResult& result);
+    CollisionResult& result,
+    double margin = 0.0);
 
 int collideSphereBox(
     CollisionObject* o1,
@@ -67,7 +106,8 @@ int collideSphereBox(
     const Eigen::Isometry3d& T0,
     const Eigen::Vector3d& size1,
     const Eigen::Isometry3d& T1,
-    CollisionResult& result);
+    CollisionResult& result,
+    double margin = 0.0);
 
 int collideSphereSphere(
     CollisionObject* o1,
@@ -76,7 +116,8 @@ int collideSphereSphere(
     const Eigen::Isometry3d& c0,
     const double& r1,
     const Eigen::Isometry3d& c1,
-    CollisionResult& result);
+    CollisionResult& result,
+    double margin = 0.0);
 
 int collideCylinderSphere(
     CollisionObject* o1,
@@ -98,6 +139,45 @@ int collideCylinderPlane(
     const Eigen::Isometry3d& T1,
     CollisionResult& result);
 
+int collideSphereSignedDistanceField(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const double& r0,
+    const Eigen::Isometry3d& T0,
+    const dynamics::SignedDistanceFieldShape& sdf1,
+    const Eigen::Isometry3d& T1,
+    CollisionResult& result);
+
+int collideCapsuleSignedDistanceField(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const double& radius0,
+    const double& height0,
+    const Eigen::Isometry3d& T0,
+    const dynamics::SignedDistanceFieldShape& sdf1,
+    const Eigen::Isometry3d& T1,
+    CollisionResult& result);
+
+int collideBoxSignedDistanceField(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3d& size0,
+    const Eigen::Isometry3d& T0,
+    const dynamics::SignedDistanceFieldShape& sdf1,
+    const Eigen::Isometry3d& T1,
+    CollisionResult& result);
+
+/// The vertices of the mesh are checked against the signed distance field, so
+/// the mesh should be dense enough compared to the resolution of the field.
+int collideMeshSignedDistanceField(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const dynamics::MeshShape& mesh0,
+    const Eigen::Isometry3d& T0,
+    const dynamics::SignedDistanceFieldShape& sdf1,
+    const Eigen::Isometry3d& T1,
+    CollisionResult& result);
+
 } // namespace collision
 } // namespace dart
 
@@ -32,14 +32,23 @@
 
 #include "dart/collision/dart/DARTCollisionDetector.hpp"
 
+#include <algorithm>
+
 #include "dart/collision/CollisionFilter.hpp"
 #include "dart/collision/CollisionObject.hpp"
+#include "dart/collision/ContactCache.hpp"
+#include "dart/collision/ContactReduction.hpp"
 #include "dart/collision/dart/DARTCollide.hpp"
 #include "dart/collision/dart/DARTCollisionGroup.hpp"
 #include "dart/collision/dart/DARTCollisionObject.hpp"
 #include "dart/dynamics/BoxShape.hpp"
+#include "dart/dynamics/CapsuleShape.hpp"
 #include "dart/dynamics/EllipsoidShape.hpp"
+#include "dart/dynamics/MeshShape.hpp"
+#include "dart/dynamics/BodyNode.hpp"
 #include "dart/dynamics/ShapeFrame.hpp"
+#include "dart/dynamics/ShapeNode.hpp"
+#include "dart/dynamics/SignedDistanceFieldShape.hpp"
 #include "dart/dynamics/SphereShape.hpp"
 
 namespace dart {
@@ -47,11 +56,43 @@ namespace collision {
 
 namespace {
 
+using ObjectPair = std::pair<CollisionObject*, CollisionObject*>;
+
 bool checkPair(
     CollisionObject* o1,
     CollisionObject* o2,
     const CollisionOption& option,
-    CollisionResult* result = nullptr);
+    CollisionResult* result = nullptr,
+    ContactCache* cache = nullptr);
+
+bool checkPairs(
+    common::ThreadPool& pool,
+    const std::vector<ObjectPair>& pairs,
+    const CollisionOption& option,
+    CollisionResult* result,
+    ContactCache* cache);
+
+bool mergePairResult(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const CollisionOption& option,
+    CollisionResult* result,
+    ContactCache* cache,
+    const CollisionResult& pairResult);
+
+bool isSweptPair(
+    const CollisionObject* o1,
+    const CollisionObject* o2,
+    const CollisionOption& option,
+    const CollisionResult* result);
+
+void narrowPhase(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const CollisionOption& option,
+    const CollisionResult* result,
+    bool swept,
+    CollisionResult& pairResult);
 
 bool isClose(
     const Eigen::Vector3d& pos1, const Eigen::Vector3d& pos2, double tol);
@@ -143,6 +184,22 @@ bool DARTCollisionDetector::collide(
 
   auto collisionFound = false;
   const auto& filter = option.collisionFilter;
+  auto* cache = group->getContactCache();
+
+  if (const auto pool = getThreadPool(option.numThreads))
+  {
+    std::vector<ObjectPair> pairs;
+    for (auto i = 0u; i < objects.size() - 1; ++i)
+    {
+      for (auto j = i + 1u; j < objects.size(); ++j)
+      {
+        if (!filter || !filter->ignoresCollision(objects[i], objects[j]))
+          pairs.emplace_back(objects[i], objects[j]);
+      }
+    }
+
+    return checkPairs(*pool, pairs, option, result, cache);
+  }
 
   for (auto i = 0u; i < objects.size() - 1; ++i)
   {
@@ -155,7 +212,7 @@ bool DARTCollisionDetector::collide(
       if (filter && filter->ignoresCollision(collObj1, collObj2))
         continue;
 
-      collisionFound = checkPair(collObj1, collObj2, option, result);
+      collisionFound = checkPair(collObj1, collObj2, option, result, cache);
 
       if (result)
       {
@@ -205,6 +262,22 @@ bool DARTCollisionDetector::collide(
 
   auto collisionFound = false;
   const auto& filter = option.collisionFilter;
+  auto* cache = CollisionGroup::getContactCache(group1, group2);
+
+  if (const auto pool = getThreadPool(option.numThreads))
+  {
+    std::vector<ObjectPair> pairs;
+    for (auto* collObj1 : objects1)
+    {
+      for (auto* collObj2 : objects2)
+      {
+        if (!filter || !filter->ignoresCollision(collObj1, collObj2))
+          pairs.emplace_back(collObj1, collObj2);
+      }
+    }
+
+    return checkPairs(*pool, pairs, option, result, cache);
+  }
 
   for (auto i = 0u; i < objects1.size(); ++i)
   {
@@ -217,7 +290,7 @@ bool DARTCollisionDetector::collide(
       if (filter && filter->ignoresCollision(collObj1, collObj2))
         continue;
 
-      collisionFound = checkPair(collObj1, collObj2, option, result);
+      collisionFound = checkPair(collObj1, collObj2, option, result, cache);
 
       if (result)
       {
@@ -292,12 +365,25 @@ void warnUnsupportedShapeType(const dynamics::ShapeFrame* shapeFrame)
       return;
   }
 
+  if (shapeType == dynamics::SignedDistanceFieldShape::getStaticType())
+    return;
+
+  if (shapeType == dynamics::CapsuleShape::getStaticType()
+      || shapeType == dynamics::MeshShape::getStaticType())
+  {
+    dterr << "[DARTCollisionDetector] Attempting to create shape type ["
+          << shapeType << "] that is supported by DARTCollisionDetector only "
+          << "against SignedDistanceFieldShape. This shape will always get "
+          << "penetrated by the other objects.\n";
+    return;
+  }
+
   dterr << "[DARTCollisionDetector] Attempting to create shape type ["
         << shapeType << "] that is not supported "
-        << "by DARTCollisionDetector. Currently, only BoxShape and "
-        << "EllipsoidShape (only when all the radii are equal) are "
-        << "supported. This shape will always get penetrated by other "
-        << "objects.\n";
+        << "by DARTCollisionDetector. Currently, only BoxShape, "
+        << "EllipsoidShape (only when all the radii are equal), and "
+        << "SignedDistanceFieldShape are supported. This shape will always "
+        << "get penetrated by other objects.\n";
 }
 
 //==============================================================================
@@ -323,22 +409,183 @@ bool checkPair(
     CollisionObject* o1,
     CollisionObject* o2,
     const CollisionOption& option,
-    CollisionResult* result)
+    CollisionResult* result,
+    ContactCache* cache)
 {
+  // The contact cache is only used when the contact information is requested
+  // since binary checks are cheap enough.
+  // The swept pairs aren't cached either since their contacts depend on the
+  // velocities as well as the transforms.
+  const auto swept = isSweptPair(o1, o2, option, result);
+  if (!result || !option.enableContact || swept)
+    cache = nullptr;
+
+  const auto numPrevContacts = result ? result->getNumContacts() : 0u;
+
+  if (cache && cache->fetch(o1, o2, option, *result))
+    return result->getNumContacts() > numPrevContacts;
+
   CollisionResult pairResult;
 
   // Perform narrow-phase detection
-  collide(o1, o2, pairResult);
+  narrowPhase(o1, o2, option, result, swept, pairResult);
+
+  return mergePairResult(o1, o2, option, result, cache, pairResult);
+}
+
+//==============================================================================
+bool checkPairs(
+    common::ThreadPool& pool,
+    const std::vector<ObjectPair>& pairs,
+    const CollisionOption& option,
+    CollisionResult* result,
+    ContactCache* cache)
+{
+  if (!result || !option.enableContact)
+    cache = nullptr;
+
+  // The pairs are processed in batches so that the narrowphase of the
+  // remaining pairs can be skipped once the maximum number of contacts is
+  // reached.
+  const auto batchSize = 32u * pool.getNumThreads();
+  std::vector<CollisionResult> pairResults(std::min(batchSize, pairs.size()));
+  std::vector<char> cached(pairResults.size());
+  std::vector<char> swept(pairResults.size());
+
+  auto collisionFound = false;
+
+  for (std::size_t begin = 0u; begin < pairs.size(); begin += batchSize)
+  {
+    const auto size = std::min(batchSize, pairs.size() - begin);
+
+    for (auto k = 0u; k < size; ++k)
+    {
+      const auto& pair = pairs[begin + k];
+      swept[k] = isSweptPair(pair.first, pair.second, option, result);
+      cached[k]
+          = cache && !swept[k] && cache->contains(pair.first, pair.second);
+    }
+
+    // Narrow-phase checks of the pairs that are not in the cache
+    pool.parallelFor(size, [&](std::size_t k, std::size_t /*threadIndex*/) {
+      const auto& pair = pairs[begin + k];
+      pairResults[k].clear();
+      if (!cached[k])
+      {
+        narrowPhase(
+            pair.first, pair.second, option, result, swept[k], pairResults[k]);
+      }
+    });
+
+    // Merge the results in the order of the pairs so that the result is the
+    // same as the single threaded check
+    for (auto k = 0u; k < size; ++k)
+    {
+      auto* o1 = pairs[begin + k].first;
+      auto* o2 = pairs[begin + k].second;
+      const auto numPrevContacts = result ? result->getNumContacts() : 0u;
+      auto* pairCache = swept[k] ? nullptr : cache;
+
+      if (pairCache && pairCache->fetch(o1, o2, option, *result))
+      {
+        if (result->getNumContacts() > numPrevContacts)
+          collisionFound = true;
+      }
+      else if (mergePairResult(
+                   o1, o2, option, result, pairCache, pairResults[k]))
+      {
+        collisionFound = true;
+      }
 
+      if (result)
+      {
+        if (result->getNumContacts() >= option.maxNumContacts)
+          return true;
+      }
+      else
+      {
+        // If no result is passed, stop checking when the first contact is found
+        if (collisionFound)
+          return true;
+      }
+    }
+  }
+
+  return collisionFound;
+}
+
+//==============================================================================
+bool mergePairResult(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const CollisionOption& option,
+    CollisionResult* result,
+    ContactCache* cache,
+    const CollisionResult& pairResult)
+{
   // Early return for binary check
   if (!result)
     return pairResult.isCollision();
 
+  const auto numPrevContacts = result->getNumContacts();
+
   postProcess(o1, o2, option, *result, pairResult);
 
+  // Don't cache the contacts of the pair if some of them were dropped due to
+  // the maximum number of contacts.
+  if (cache && result->getNumContacts() < option.maxNumContacts)
+    cache->store(o1, o2, *result, numPrevContacts);
+
   return pairResult.isCollision();
 }
 
+//==============================================================================
+bool isContinuousCollisionChecked(const CollisionObject* object)
+{
+  const auto* shapeNode = object->getShapeFrame()->asShapeNode();
+
+  return shapeNode
+         && shapeNode->getBodyNodePtr()->getContinuousCollisionCheck();
+}
+
+//==============================================================================
+bool isSweptPair(
+    const CollisionObject* o1,
+    const CollisionObject* o2,
+    const CollisionOption& option,
+    const CollisionResult* result)
+{
+  if (!result || !option.enableContact
+      || option.continuousCollisionTimeStep <= 0.0)
+  {
+    return false;
+  }
+
+  return isContinuousCollisionChecked(o1) || isContinuousCollisionChecked(o2);
+}
+
+//==============================================================================
+void narrowPhase(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const CollisionOption& option,
+    const CollisionResult* result,
+    bool swept,
+    CollisionResult& pairResult)
+{
+  // The contact margin is only applied when the contact information is
+  // requested so that the binary checks still report the penetrating pairs
+  // only.
+  const auto margin
+      = (result && option.enableContact) ? option.contactMargin : 0.0;
+  collide(o1, o2, pairResult, margin);
+
+  // Sweep the separated pairs of fast objects so that they don't pass through
+  // each other between two checks
+  if (swept && !pairResult.isCollision())
+    collideSwept(o1, o2, option.continuousCollisionTimeStep, pairResult);
+}
+
 //==============================================================================
 bool isClose(
     const Eigen::Vector3d& pos1, const Eigen::Vector3d& pos2, double tol)
@@ -357,14 +604,26 @@ void postProcess(
   if (!pairResult.isCollision())
     return;
 
+  // Reduce the contact manifold of the pair if requested
+  std::vector<Contact> reducedContacts;
+  if (0u < option.maxNumContactsPerPair
+      && pairResult.getNumContacts() > option.maxNumContactsPerPair)
+  {
+    reducedContacts = pairResult.getContacts();
+    reduceContacts(reducedContacts, option.maxNumContactsPerPair);
+  }
+  const auto& pairContacts = reducedContacts.empty()
+                                 ? pairResult.getContacts()
+                                 : reducedContacts;
+
   // Don't add repeated points
   const auto tol = 3.0e-12;
 
-  for (auto pairContact : pairResult.getContacts())
+  for (const auto& pairContact : pairContacts)
   {
     auto foundClose = false;
 
-    for (auto totalContact : totalResult.getContacts())
+    for (const auto& totalContact : totalResult.getContacts())
     {
       if (isClose(pairContact.point, totalContact.point, tol))
       {
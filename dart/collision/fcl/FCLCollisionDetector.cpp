@@ -36,6 +36,8 @@
 
 #include "dart/collision/CollisionFilter.hpp"
 #include "dart/collision/CollisionObject.hpp"
+#include "dart/collision/ContactCache.hpp"
+#include "dart/collision/ContactReduction.hpp"
 #include "dart/collision/DistanceFilter.hpp"
 #include "dart/collision/fcl/FCLCollisionGroup.hpp"
 #include "dart/collision/fcl/FCLCollisionObject.hpp"
@@ -59,9 +61,29 @@ namespace collision {
 
 namespace {
 
+struct FCLCollisionCallbackData;
+
+using FCLObjectPair = std::pair<fcl::CollisionObject*, fcl::CollisionObject*>;
+
 bool collisionCallback(
     fcl::CollisionObject* o1, fcl::CollisionObject* o2, void* cdata);
 
+bool fetchCachedContacts(
+    fcl::CollisionObject* o1,
+    fcl::CollisionObject* o2,
+    FCLCollisionCallbackData& collData);
+
+void mergeFCLResult(
+    fcl::CollisionObject* o1,
+    fcl::CollisionObject* o2,
+    const fcl::CollisionResult& fclResult,
+    FCLCollisionCallbackData& collData);
+
+void collidePairs(
+    common::ThreadPool& pool,
+    const std::vector<FCLObjectPair>& pairs,
+    FCLCollisionCallbackData& collData);
+
 bool distanceCallback(
     fcl::CollisionObject* o1,
     fcl::CollisionObject* o2,
@@ -170,6 +192,14 @@ struct FCLCollisionCallbackData
   /// Whether the collision iteration can stop
   bool done;
 
+  /// Contact cache of the collision group, or nullptr if it's disabled
+  ContactCache* cache;
+
+  /// If not nullptr, the callback only collects the pairs that pass the
+  /// broadphase and the filter into this list instead of checking them, so
+  /// that the narrowphase can be run by multiple threads afterward.
+  std::vector<FCLObjectPair>* pairs;
+
   bool isCollision() const
   {
     if (result)
@@ -184,13 +214,16 @@ struct FCLCollisionCallbackData
       CollisionResult* result,
       FCLCollisionDetector::PrimitiveShape type = FCLCollisionDetector::MESH,
       FCLCollisionDetector::ContactPointComputationMethod method
-      = FCLCollisionDetector::DART)
+      = FCLCollisionDetector::DART,
+      ContactCache* cache = nullptr)
     : option(option),
       result(result),
       foundCollision(false),
       primitiveShapeType(type),
       contactPointComputationMethod(method),
-      done(false)
+      done(false),
+      cache((result && option.enableContact) ? cache : nullptr),
+      pairs(nullptr)
   {
     convertOption(option, fclRequest);
 
@@ -624,11 +657,28 @@ bool FCLCollisionDetector::collide(
   casted->updateEngineData();
 
   FCLCollisionCallbackData collData(
-      option, result, mPrimitiveShapeType, mContactPointComputationMethod);
+      option,
+      result,
+      mPrimitiveShapeType,
+      mContactPointComputationMethod,
+      group->getContactCache());
 
   const auto* collMgr = casted->getFCLCollisionManager();
   assert(collMgr);
-  collMgr->collide(&collData, collisionCallback);
+
+  if (const auto pool = getThreadPool(option.numThreads))
+  {
+    std::vector<FCLObjectPair> pairs;
+    collData.pairs = &pairs;
+    collMgr->collide(&collData, collisionCallback);
+    collData.pairs = nullptr;
+
+    collidePairs(*pool, pairs, collData);
+  }
+  else
+  {
+    collMgr->collide(&collData, collisionCallback);
+  }
 
   return collData.isCollision();
 }
@@ -658,12 +708,28 @@ bool FCLCollisionDetector::collide(
   casted2->updateEngineData();
 
   FCLCollisionCallbackData collData(
-      option, result, mPrimitiveShapeType, mContactPointComputationMethod);
+      option,
+      result,
+      mPrimitiveShapeType,
+      mContactPointComputationMethod,
+      CollisionGroup::getContactCache(group1, group2));
 
   auto broadPhaseAlg1 = casted1->getFCLCollisionManager();
   auto broadPhaseAlg2 = casted2->getFCLCollisionManager();
 
-  broadPhaseAlg1->collide(broadPhaseAlg2, &collData, collisionCallback);
+  if (const auto pool = getThreadPool(option.numThreads))
+  {
+    std::vector<FCLObjectPair> pairs;
+    collData.pairs = &pairs;
+    broadPhaseAlg1->collide(broadPhaseAlg2, &collData, collisionCallback);
+    collData.pairs = nullptr;
+
+    collidePairs(*pool, pairs, collData);
+  }
+  else
+  {
+    broadPhaseAlg1->collide(broadPhaseAlg2, &collData, collisionCallback);
+  }
 
   return collData.isCollision();
 }
@@ -1047,56 +1113,190 @@ bool collisionCallback(
 
   const auto& fclRequest = collData->fclRequest;
   auto& fclResult = collData->fclResult;
-  auto* result = collData->result;
   const auto& option = collData->option;
   const auto& filter = option.collisionFilter;
 
+  auto collisionObject1 = static_cast<FCLCollisionObject*>(o1->getUserData());
+  auto collisionObject2 = static_cast<FCLCollisionObject*>(o2->getUserData());
+  assert(collisionObject1);
+  assert(collisionObject2);
+
   // Filtering
   if (filter)
   {
-    auto collisionObject1 = static_cast<FCLCollisionObject*>(o1->getUserData());
-    auto collisionObject2 = static_cast<FCLCollisionObject*>(o2->getUserData());
-    assert(collisionObject1);
-    assert(collisionObject2);
-
     if (filter->ignoresCollision(collisionObject2, collisionObject1))
       return collData->done;
   }
 
+  // Defer the narrowphase to collidePairs()
+  if (collData->pairs)
+  {
+    collData->pairs->emplace_back(o1, o2);
+    return false;
+  }
+
+  // Reuse the contacts of the previous query if the pair hasn't moved
+  if (fetchCachedContacts(o1, o2, *collData))
+    return collData->done;
+
   // Clear previous results
   fclResult.clear();
 
   // Perform narrow-phase detection
   ::fcl::collide(o1, o2, fclRequest, fclResult);
 
+  mergeFCLResult(o1, o2, fclResult, *collData);
+
+  return collData->done;
+}
+
+//==============================================================================
+bool fetchCachedContacts(
+    fcl::CollisionObject* o1,
+    fcl::CollisionObject* o2,
+    FCLCollisionCallbackData& collData)
+{
+  auto* cache = collData.cache;
+  if (!cache)
+    return false;
+
+  auto* result = collData.result;
+  auto collisionObject1 = static_cast<FCLCollisionObject*>(o1->getUserData());
+  auto collisionObject2 = static_cast<FCLCollisionObject*>(o2->getUserData());
+
+  const auto& option = collData.option;
+
+  if (!cache->fetch(collisionObject1, collisionObject2, option, *result))
+    return false;
+
+  if (result->getNumContacts() >= option.maxNumContacts)
+    collData.done = true;
+
+  return true;
+}
+
+//==============================================================================
+void mergeFCLResult(
+    fcl::CollisionObject* o1,
+    fcl::CollisionObject* o2,
+    const fcl::CollisionResult& fclResult,
+    FCLCollisionCallbackData& collData)
+{
+  auto* result = collData.result;
+  const auto& option = collData.option;
+
   if (result)
   {
+    const auto numPrevContacts = result->getNumContacts();
+
+    // The contacts of the pair are collected separately first if the contact
+    // manifold needs to be reduced
+    CollisionResult pairResult;
+    const auto reduce = (0u < option.maxNumContactsPerPair);
+    auto& postProcessResult = reduce ? pairResult : *result;
+
     // Post processing -- converting fcl contact information to ours if needed
-    if (FCLCollisionDetector::DART == collData->contactPointComputationMethod
-        && FCLCollisionDetector::MESH == collData->primitiveShapeType)
+    if (FCLCollisionDetector::DART == collData.contactPointComputationMethod
+        && FCLCollisionDetector::MESH == collData.primitiveShapeType)
     {
-      postProcessDART(fclResult, o1, o2, option, *result);
+      postProcessDART(fclResult, o1, o2, option, postProcessResult);
     }
     else
     {
-      postProcessFCL(fclResult, o1, o2, option, *result);
+      postProcessFCL(fclResult, o1, o2, option, postProcessResult);
+    }
+
+    if (reduce && pairResult.isCollision())
+    {
+      auto contacts = pairResult.getContacts();
+      reduceContacts(contacts, option.maxNumContactsPerPair);
+
+      for (const auto& contact : contacts)
+      {
+        if (result->getNumContacts() >= option.maxNumContacts)
+          break;
+
+        result->addContact(contact);
+      }
     }
 
     // Check satisfaction of the stopping conditions
     if (result->getNumContacts() >= option.maxNumContacts)
-      collData->done = true;
+    {
+      collData.done = true;
+    }
+    else if (collData.cache)
+    {
+      collData.cache->store(
+          static_cast<FCLCollisionObject*>(o1->getUserData()),
+          static_cast<FCLCollisionObject*>(o2->getUserData()),
+          *result,
+          numPrevContacts);
+    }
   }
   else
   {
     // If no result is passed, stop checking when the first contact is found
     if (fclResult.isCollision())
     {
-      collData->foundCollision = true;
-      collData->done = true;
+      collData.foundCollision = true;
+      collData.done = true;
     }
   }
+}
 
-  return collData->done;
+//==============================================================================
+void collidePairs(
+    common::ThreadPool& pool,
+    const std::vector<FCLObjectPair>& pairs,
+    FCLCollisionCallbackData& collData)
+{
+  auto* cache = collData.cache;
+
+  // The pairs are processed in batches so that the narrowphase of the
+  // remaining pairs can be skipped once the stopping condition is met.
+  const auto batchSize = 32u * pool.getNumThreads();
+  std::vector<fcl::CollisionResult> fclResults(
+      std::min(batchSize, pairs.size()));
+  std::vector<char> cached(fclResults.size());
+
+  for (std::size_t begin = 0u; begin < pairs.size(); begin += batchSize)
+  {
+    const auto size = std::min(batchSize, pairs.size() - begin);
+
+    for (auto k = 0u; k < size; ++k)
+    {
+      const auto& pair = pairs[begin + k];
+      auto o1 = static_cast<FCLCollisionObject*>(pair.first->getUserData());
+      auto o2 = static_cast<FCLCollisionObject*>(pair.second->getUserData());
+      cached[k] = cache && cache->contains(o1, o2);
+    }
+
+    // Narrow-phase checks of the pairs that are not in the cache
+    pool.parallelFor(size, [&](std::size_t k, std::size_t /*threadIndex*/) {
+      const auto& pair = pairs[begin + k];
+      fclResults[k].clear();
+      if (!cached[k])
+      {
+        ::fcl::collide(
+            pair.first, pair.second, collData.fclRequest, fclResults[k]);
+      }
+    });
+
+    // Merge the results in the order of the pairs so that the result is the
+    // same as the single threaded check
+    for (auto k = 0u; k < size; ++k)
+    {
+      auto* o1 = pairs[begin + k].first;
+      auto* o2 = pairs[begin + k].second;
+
+      if (!fetchCachedContacts(o1, o2, collData))
+        mergeFCLResult(o1, o2, fclResults[k], collData);
+
+      if (collData.done)
+        return;
+    }
+  }
 }
 
 //==============================================================================
@@ -100,6 +100,22 @@ void FCLCollisionGroup::updateCollisionGroupEngineData()
   mBroadPhaseAlg->update();
 }
 
+//==============================================================================
+void FCLCollisionGroup::updateCollisionGroupEngineDataOf(
+    const std::vector<CollisionObject*>& objects)
+{
+  std::vector<dart::collision::fcl::CollisionObject*> fclObjects;
+  fclObjects.reserve(objects.size());
+
+  for (auto object : objects)
+  {
+    auto casted = static_cast<FCLCollisionObject*>(object);
+    fclObjects.push_back(casted->getFCLCollisionObject());
+  }
+
+  mBroadPhaseAlg->update(fclObjects);
+}
+
 //==============================================================================
 FCLCollisionGroup::FCLCollisionManager*
 FCLCollisionGroup::getFCLCollisionManager()
@@ -78,6 +78,10 @@ protected:
   // Documentation inherited
   void updateCollisionGroupEngineData() override;
 
+  // Documentation inherited
+  void updateCollisionGroupEngineDataOf(
+      const std::vector<CollisionObject*>& objects) override;
+
   /// Return FCL collision manager that is also a broad-phase algorithm
   FCLCollisionManager* getFCLCollisionManager();
 
@@ -35,6 +35,7 @@
 #include <ode/ode.h>
 
 #include "dart/collision/CollisionFilter.hpp"
+#include "dart/collision/ContactReduction.hpp"
 #include "dart/collision/ode/OdeCollisionGroup.hpp"
 #include "dart/collision/ode/OdeCollisionObject.hpp"
 #include "dart/collision/ode/OdeTypes.hpp"
@@ -310,6 +311,28 @@ void reportContacts(
     return;
   }
 
+  // Reduce the contact manifold of the pair if requested
+  if (0u < option.maxNumContactsPerPair
+      && static_cast<std::size_t>(numContacts) > option.maxNumContactsPerPair)
+  {
+    std::vector<Contact> contacts;
+    contacts.reserve(static_cast<std::size_t>(numContacts));
+    for (auto i = 0; i < numContacts; ++i)
+      contacts.push_back(convertContact(contactGeoms[i], b1, b2, option));
+
+    reduceContacts(contacts, option.maxNumContactsPerPair);
+
+    for (const auto& contact : contacts)
+    {
+      result.addContact(contact);
+
+      if (result.getNumContacts() >= option.maxNumContacts)
+        return;
+    }
+
+    return;
+  }
+
   for (auto i = 0; i < numContacts; ++i)
   {
     result.addContact(convertContact(contactGeoms[i], b1, b2, option));
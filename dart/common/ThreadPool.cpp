@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/common/ThreadPool.hpp"
+
+namespace dart {
+namespace common {
+
+//==============================================================================
+ThreadPool::ThreadPool(std::size_t numThreads)
+  : mFunction(nullptr),
+    mSize(0u),
+    mNextIndex(0u),
+    mGeneration(0u),
+    mNumActiveWorkers(0u),
+    mStop(false)
+{
+  if (0u == numThreads)
+    numThreads = getHardwareConcurrency();
+
+  // The calling thread of parallelFor() works as the thread of index 0
+  mWorkers.reserve(numThreads - 1u);
+  for (std::size_t i = 1u; i < numThreads; ++i)
+    mWorkers.emplace_back(&ThreadPool::runWorker, this, i);
+}
+
+//==============================================================================
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mJobCondition.notify_all();
+
+  for (auto& worker : mWorkers)
+    worker.join();
+}
+
+//==============================================================================
+std::size_t ThreadPool::getNumThreads() const
+{
+  return mWorkers.size() + 1u;
+}
+
+//==============================================================================
+void ThreadPool::parallelFor(std::size_t size, const IndexFunction& func)
+{
+  if (0u == size)
+    return;
+
+  // Run serially if there is no worker or only one index to process
+  if (mWorkers.empty() || 1u == size)
+  {
+    for (std::size_t i = 0u; i < size; ++i)
+      func(i, 0u);
+    return;
+  }
+
+  std::lock_guard<std::mutex> dispatchLock(mDispatchMutex);
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFunction = &func;
+    mSize = size;
+    mNextIndex = 0u;
+    mNumActiveWorkers = mWorkers.size();
+    ++mGeneration;
+  }
+  mJobCondition.notify_all();
+
+  processIndices(0u);
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  mDoneCondition.wait(lock, [this]() { return 0u == mNumActiveWorkers; });
+  mFunction = nullptr;
+}
+
+//==============================================================================
+std::size_t ThreadPool::getHardwareConcurrency()
+{
+  const std::size_t numThreads = std::thread::hardware_concurrency();
+
+  return numThreads > 0u ? numThreads : 1u;
+}
+
+//==============================================================================
+void ThreadPool::runWorker(std::size_t threadIndex)
+{
+  std::size_t lastGeneration = 0u;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mJobCondition.wait(lock, [&]() {
+        return mStop || mGeneration != lastGeneration;
+      });
+
+      if (mStop)
+        return;
+
+      lastGeneration = mGeneration;
+    }
+
+    processIndices(threadIndex);
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      --mNumActiveWorkers;
+    }
+    mDoneCondition.notify_one();
+  }
+}
+
+//==============================================================================
+void ThreadPool::processIndices(std::size_t threadIndex)
+{
+  const IndexFunction& func = *mFunction;
+
+  for (std::size_t i = mNextIndex++; i < mSize; i = mNextIndex++)
+    func(i, threadIndex);
+}
+
+} // namespace common
+} // namespace dart
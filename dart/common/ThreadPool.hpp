@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COMMON_THREADPOOL_HPP_
+#define DART_COMMON_THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dart {
+namespace common {
+
+/// ThreadPool keeps a fixed number of worker threads alive so that data
+/// parallel loops can be dispatched without the cost of spawning threads each
+/// time.
+///
+/// The thread that calls parallelFor() takes part in the computation as the
+/// thread of index 0, so a ThreadPool of one thread runs everything serially
+/// on the calling thread.
+class ThreadPool
+{
+public:
+  /// The function to be called for each index. The second argument is the
+  /// index of the thread calling the function, which is in
+  /// [0, getNumThreads()), so it can be used to access per-thread buffers.
+  using IndexFunction
+      = std::function<void(std::size_t index, std::size_t threadIndex)>;
+
+  /// Constructor. If numThreads is zero, the number of hardware threads is
+  /// used.
+  explicit ThreadPool(std::size_t numThreads = 0u);
+
+  /// Destructor. Waits for the worker threads to finish.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Return the number of threads including the calling thread
+  std::size_t getNumThreads() const;
+
+  /// Call func(index, threadIndex) for every index in [0, size) and block until
+  /// all the calls return. The indices are distributed to the threads
+  /// dynamically, so func must not depend on which thread processes an index
+  /// other than through threadIndex.
+  ///
+  /// Calls to parallelFor() from multiple threads are serialized. func must not
+  /// throw, and must not call parallelFor() of the same ThreadPool.
+  void parallelFor(std::size_t size, const IndexFunction& func);
+
+  /// Return the number of hardware threads, or one if it is unknown
+  static std::size_t getHardwareConcurrency();
+
+private:
+  /// Main loop of the worker threads
+  void runWorker(std::size_t threadIndex);
+
+  /// Process the indices of the current job until there is no index left
+  void processIndices(std::size_t threadIndex);
+
+  /// Worker threads
+  std::vector<std::thread> mWorkers;
+
+  /// Mutex that serializes the calls to parallelFor()
+  std::mutex mDispatchMutex;
+
+  /// Mutex for the job state shared with the workers
+  std::mutex mMutex;
+
+  /// Notifies the workers of a new job or of the termination
+  std::condition_variable mJobCondition;
+
+  /// Notifies the dispatching thread that the workers are done
+  std::condition_variable mDoneCondition;
+
+  /// The function of the current job
+  const IndexFunction* mFunction;
+
+  /// The number of indices of the current job
+  std::size_t mSize;
+
+  /// The next index to be processed
+  std::atomic<std::size_t> mNextIndex;
+
+  /// Incremented for each job so that the workers can detect a new job
+  std::size_t mGeneration;
+
+  /// The number of workers that haven't finished the current job
+  std::size_t mNumActiveWorkers;
+
+  /// Whether the workers should terminate
+  bool mStop;
+};
+
+} // namespace common
+} // namespace dart
+
+#endif // DART_COMMON_THREADPOOL_HPP_
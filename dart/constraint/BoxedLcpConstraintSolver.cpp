@@ -144,6 +144,20 @@ ConstBoxedLcpSolverPtr BoxedLcpConstraintSolver::getSecondaryBoxedLcpSolver()
   return mSecondaryBoxedLcpSolver;
 }
 
+//==============================================================================
+void BoxedLcpConstraintSolver::setLcpRecorder(
+    std::shared_ptr<BoxedLcpRecorder> recorder)
+{
+  mLcpRecorder = std::move(recorder);
+}
+
+//==============================================================================
+std::shared_ptr<BoxedLcpRecorder> BoxedLcpConstraintSolver::getLcpRecorder()
+    const
+{
+  return mLcpRecorder;
+}
+
 //==============================================================================
 void BoxedLcpConstraintSolver::solveConstrainedGroup(ConstrainedGroup& group)
 {
@@ -253,6 +267,16 @@ void BoxedLcpConstraintSolver::solveConstrainedGroup(ConstrainedGroup& group)
     mHiBackup = mHi;
     mFIndexBackup = mFIndex;
   }
+  if (mLcpRecorder)
+  {
+    // Capture the terms before solving because the solvers modify them.
+    mRecordedProblem.A = mA.leftCols(n);
+    mRecordedProblem.b = mB;
+    mRecordedProblem.lo = mLo;
+    mRecordedProblem.hi = mHi;
+    mRecordedProblem.findex = mFIndex;
+    mRecordedProblem.initialX = mX;
+  }
   const bool earlyTermination = (mSecondaryBoxedLcpSolver != nullptr);
   assert(mBoxedLcpSolver);
   bool success = mBoxedLcpSolver->solve(
@@ -271,6 +295,8 @@ void BoxedLcpConstraintSolver::solveConstrainedGroup(ConstrainedGroup& group)
   if (success && mX.hasNaN())
     success = false;
 
+  const bool primarySucceeded = success;
+
   if (!success && mSecondaryBoxedLcpSolver)
   {
     mSecondaryBoxedLcpSolver->solve(
@@ -296,6 +322,18 @@ void BoxedLcpConstraintSolver::solveConstrainedGroup(ConstrainedGroup& group)
     mX.setZero();
   }
 
+  if (mLcpRecorder)
+  {
+    mRecordedProblem.x = mX;
+    mRecordedProblem.primarySolverType = mBoxedLcpSolver->getType();
+    mRecordedProblem.secondarySolverType
+        = mSecondaryBoxedLcpSolver ? mSecondaryBoxedLcpSolver->getType() : "";
+    mRecordedProblem.primarySucceeded = primarySucceeded;
+    mRecordedProblem.usedSecondary
+        = !primarySucceeded && mSecondaryBoxedLcpSolver != nullptr;
+    mLcpRecorder->record(mRecordedProblem);
+  }
+
   // Print LCP formulation
   //  dtdbg << "After solve:" << std::endl;
   //  print(n, A, x, lo, hi, b, w, findex);
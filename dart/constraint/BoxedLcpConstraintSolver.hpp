@@ -33,6 +33,7 @@
 #ifndef DART_CONSTRAINT_BOXEDLCPCONSTRAINTSOLVER_HPP_
 #define DART_CONSTRAINT_BOXEDLCPCONSTRAINTSOLVER_HPP_
 
+#include "dart/constraint/BoxedLcpCorpus.hpp"
 #include "dart/constraint/ConstraintSolver.hpp"
 #include "dart/constraint/SmartPointer.hpp"
 
@@ -97,6 +98,13 @@ public:
   /// failed
   ConstBoxedLcpSolverPtr getSecondaryBoxedLcpSolver() const;
 
+  /// Sets the recorder that captures every boxed LCP problem solved by this
+  /// solver. Pass nullptr to stop recording, which is the default.
+  void setLcpRecorder(std::shared_ptr<BoxedLcpRecorder> recorder);
+
+  /// Returns the recorder that captures the boxed LCP problems
+  std::shared_ptr<BoxedLcpRecorder> getLcpRecorder() const;
+
 protected:
   // Documentation inherited.
   void solveConstrainedGroup(ConstrainedGroup& group) override;
@@ -154,6 +162,12 @@ protected:
   /// Cache data for boxed LCP formulation
   Eigen::VectorXi mOffset;
 
+  /// Recorder of the boxed LCP problems. Recording is disabled when nullptr.
+  std::shared_ptr<BoxedLcpRecorder> mLcpRecorder;
+
+  /// Cache data for recording the boxed LCP problem
+  BoxedLcpProblem mRecordedProblem;
+
 #ifndef NDEBUG
 private:
   /// Return true if the matrix is symmetric
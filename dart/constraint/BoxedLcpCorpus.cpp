@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/constraint/BoxedLcpCorpus.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "dart/external/odelcpsolver/common.h"
+
+#include "dart/common/Console.hpp"
+
+namespace dart {
+namespace constraint {
+
+namespace {
+
+constexpr char kFileMagic[8] = {'D', 'A', 'R', 'T', 'L', 'C', 'P', '\0'};
+constexpr std::uint32_t kFileVersion = 1u;
+
+constexpr std::uint8_t kPrimarySucceededFlag = 1u << 0;
+constexpr std::uint8_t kUsedSecondaryFlag = 1u << 1;
+
+/// Maximum dimension of a recorded problem. Larger dimensions are treated as a
+/// corrupted file rather than allocated.
+constexpr std::int32_t kMaxDimension = 1 << 15;
+
+//==============================================================================
+template <typename T>
+void write(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//==============================================================================
+template <typename T>
+void write(std::ostream& stream, const T* data, std::size_t size)
+{
+  stream.write(
+      reinterpret_cast<const char*>(data),
+      static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+//==============================================================================
+void write(std::ostream& stream, const std::string& value)
+{
+  write(stream, static_cast<std::uint16_t>(value.size()));
+  write(stream, value.data(), value.size());
+}
+
+//==============================================================================
+template <typename T>
+bool read(std::istream& stream, T& value)
+{
+  stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return static_cast<bool>(stream);
+}
+
+//==============================================================================
+template <typename T>
+bool read(std::istream& stream, T* data, std::size_t size)
+{
+  stream.read(
+      reinterpret_cast<char*>(data),
+      static_cast<std::streamsize>(size * sizeof(T)));
+  return static_cast<bool>(stream);
+}
+
+//==============================================================================
+bool read(std::istream& stream, std::string& value)
+{
+  std::uint16_t size;
+  if (!read(stream, size))
+    return false;
+
+  value.resize(size);
+  return read(stream, &value[0], size);
+}
+
+//==============================================================================
+/// Returns the number of bytes between the current position of stream and its
+/// end, or the maximum size if the stream can't tell its position
+std::size_t getNumRemainingBytes(std::istream& stream)
+{
+  const std::istream::pos_type current = stream.tellg();
+  if (current < 0)
+    return std::numeric_limits<std::size_t>::max();
+
+  stream.seekg(0, std::ios::end);
+  const std::istream::pos_type end = stream.tellg();
+  stream.seekg(current);
+
+  if (end < current)
+    return 0u;
+
+  return static_cast<std::size_t>(end - current);
+}
+
+//==============================================================================
+bool readProblem(std::istream& stream, BoxedLcpProblem& problem)
+{
+  std::int32_t n;
+  std::uint8_t flags;
+  if (!read(stream, n) || !read(stream, flags) || n < 0 || n > kMaxDimension)
+    return false;
+
+  if (!read(stream, problem.primarySolverType)
+      || !read(stream, problem.secondarySolverType))
+    return false;
+
+  // Check that the file holds the whole problem before allocating it: the
+  // upper triangle of A, five vectors, and findex
+  const auto dim = static_cast<std::size_t>(n);
+  const std::size_t numBytes
+      = (dim * (dim + 1u) / 2u + 5u * dim) * sizeof(double)
+        + dim * sizeof(std::int32_t);
+  if (numBytes > getNumRemainingBytes(stream))
+    return false;
+
+  problem.primarySucceeded = (flags & kPrimarySucceededFlag) != 0u;
+  problem.usedSecondary = (flags & kUsedSecondaryFlag) != 0u;
+
+  problem.A.resize(n, n);
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = i; j < n; ++j)
+    {
+      if (!read(stream, problem.A(i, j)))
+        return false;
+
+      problem.A(j, i) = problem.A(i, j);
+    }
+  }
+
+  problem.b.resize(n);
+  problem.lo.resize(n);
+  problem.hi.resize(n);
+  problem.findex.resize(n);
+  problem.initialX.resize(n);
+  problem.x.resize(n);
+
+  std::vector<std::int32_t> findex(static_cast<std::size_t>(n));
+
+  if (!read(stream, problem.b.data(), n) || !read(stream, problem.lo.data(), n)
+      || !read(stream, problem.hi.data(), n)
+      || !read(stream, findex.data(), findex.size())
+      || !read(stream, problem.initialX.data(), n)
+      || !read(stream, problem.x.data(), n))
+  {
+    return false;
+  }
+
+  for (int i = 0; i < n; ++i)
+    problem.findex[i] = findex[static_cast<std::size_t>(i)];
+
+  return true;
+}
+
+} // namespace
+
+//==============================================================================
+int BoxedLcpProblem::getDimension() const
+{
+  return static_cast<int>(b.size());
+}
+
+//==============================================================================
+BoxedLcpRecorder::BoxedLcpRecorder(const std::string& path)
+  : mFile(path, std::ios::binary | std::ios::trunc), mNumRecords(0u)
+{
+  if (!mFile)
+  {
+    dtwarn << "[BoxedLcpRecorder] Failed to open file '" << path << "'. No "
+           << "problem will be recorded.\n";
+    return;
+  }
+
+  mFile.write(kFileMagic, sizeof(kFileMagic));
+  write(mFile, kFileVersion);
+}
+
+//==============================================================================
+bool BoxedLcpRecorder::isOpen() const
+{
+  return mFile.is_open() && mFile.good();
+}
+
+//==============================================================================
+void BoxedLcpRecorder::record(const BoxedLcpProblem& problem)
+{
+  if (!isOpen())
+    return;
+
+  const int n = problem.getDimension();
+  assert(problem.A.rows() == n && problem.A.cols() == n);
+  assert(problem.lo.size() == n && problem.hi.size() == n);
+  assert(problem.findex.size() == n);
+  assert(problem.initialX.size() == n && problem.x.size() == n);
+
+  std::uint8_t flags = 0u;
+  if (problem.primarySucceeded)
+    flags |= kPrimarySucceededFlag;
+  if (problem.usedSecondary)
+    flags |= kUsedSecondaryFlag;
+
+  write(mFile, static_cast<std::int32_t>(n));
+  write(mFile, flags);
+  write(mFile, problem.primarySolverType);
+  write(mFile, problem.secondarySolverType);
+
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = i; j < n; ++j)
+      write(mFile, problem.A(i, j));
+  }
+
+  const std::size_t size = static_cast<std::size_t>(n);
+  write(mFile, problem.b.data(), size);
+  write(mFile, problem.lo.data(), size);
+  write(mFile, problem.hi.data(), size);
+  for (int i = 0; i < n; ++i)
+    write(mFile, static_cast<std::int32_t>(problem.findex[i]));
+  write(mFile, problem.initialX.data(), size);
+  write(mFile, problem.x.data(), size);
+
+  ++mNumRecords;
+}
+
+//==============================================================================
+std::size_t BoxedLcpRecorder::getNumRecords() const
+{
+  return mNumRecords;
+}
+
+//==============================================================================
+void BoxedLcpRecorder::flush()
+{
+  mFile.flush();
+}
+
+//==============================================================================
+bool loadBoxedLcpCorpus(
+    const std::string& path, std::vector<BoxedLcpProblem>& problems)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+  {
+    dtwarn << "[loadBoxedLcpCorpus] Failed to open file '" << path << "'.\n";
+    return false;
+  }
+
+  char magic[sizeof(kFileMagic)];
+  std::uint32_t version;
+  if (!read(file, magic, sizeof(magic)) || !read(file, version)
+      || !std::equal(magic, magic + sizeof(magic), kFileMagic)
+      || version != kFileVersion)
+  {
+    dtwarn << "[loadBoxedLcpCorpus] File '" << path << "' is not a boxed LCP "
+           << "corpus of a supported version.\n";
+    return false;
+  }
+
+  while (file.peek() != std::ifstream::traits_type::eof())
+  {
+    BoxedLcpProblem problem;
+    if (!readProblem(file, problem))
+    {
+      dtwarn << "[loadBoxedLcpCorpus] File '" << path << "' is corrupted "
+             << "after " << problems.size() << " problems.\n";
+      return false;
+    }
+
+    problems.push_back(std::move(problem));
+  }
+
+  return true;
+}
+
+//==============================================================================
+BoxedLcpReplayResult replayBoxedLcpProblem(
+    BoxedLcpSolver& solver,
+    const BoxedLcpProblem& problem,
+    bool earlyTermination)
+{
+  const int n = problem.getDimension();
+  const int nSkip = dPAD(n);
+
+  // The solvers expect A in the row-major order with the padded stride, and
+  // they are allowed to modify all the terms.
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> A
+      = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>::
+          Zero(n, nSkip);
+  A.leftCols(n) = problem.A;
+  Eigen::VectorXd b = problem.b;
+  Eigen::VectorXd lo = problem.lo;
+  Eigen::VectorXd hi = problem.hi;
+  Eigen::VectorXi findex = problem.findex;
+
+  BoxedLcpReplayResult result;
+  result.x = problem.initialX;
+
+  if (0 == n)
+  {
+    result.success = true;
+    return result;
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  result.success = solver.solve(
+      n,
+      A.data(),
+      result.x.data(),
+      b.data(),
+      0,
+      lo.data(),
+      hi.data(),
+      findex.data(),
+      earlyTermination);
+  const auto end = std::chrono::steady_clock::now();
+
+  result.time = std::chrono::duration<double>(end - begin).count();
+  result.numIterations = solver.getLastNumIterations();
+
+  if (result.x.hasNaN())
+  {
+    result.success = false;
+    result.residual = std::numeric_limits<double>::infinity();
+    result.complementarityError = std::numeric_limits<double>::infinity();
+    return result;
+  }
+
+  computeBoxedLcpErrors(
+      problem, result.x, result.residual, result.complementarityError);
+
+  return result;
+}
+
+//==============================================================================
+void computeBoxedLcpErrors(
+    const BoxedLcpProblem& problem,
+    const Eigen::VectorXd& x,
+    double& residual,
+    double& complementarityError)
+{
+  const Eigen::VectorXd w = problem.A * x - problem.b;
+
+  residual = 0.0;
+  complementarityError = 0.0;
+
+  for (int i = 0; i < problem.getDimension(); ++i)
+  {
+    double lo = problem.lo[i];
+    double hi = problem.hi[i];
+
+    const int normalIndex = problem.findex[i];
+    if (normalIndex >= 0)
+    {
+      hi = std::abs(problem.hi[i] * x[normalIndex]);
+      lo = -hi;
+    }
+
+    const double projected = std::min(std::max(x[i] - w[i], lo), hi);
+    residual = std::max(residual, std::abs(x[i] - projected));
+
+    // w > 0 pushes x to the lower bound and w < 0 to the upper bound
+    double distance = 0.0;
+    if (w[i] > 0.0 && std::isfinite(lo))
+      distance = std::abs(x[i] - lo);
+    else if (w[i] < 0.0 && std::isfinite(hi))
+      distance = std::abs(hi - x[i]);
+
+    complementarityError
+        = std::max(complementarityError, std::abs(w[i]) * distance);
+  }
+}
+
+} // namespace constraint
+} // namespace dart
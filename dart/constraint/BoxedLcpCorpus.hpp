@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_CONSTRAINT_BOXEDLCPCORPUS_HPP_
+#define DART_CONSTRAINT_BOXEDLCPCORPUS_HPP_
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dart/constraint/BoxedLcpSolver.hpp"
+
+namespace dart {
+namespace constraint {
+
+/// A boxed LCP problem captured from BoxedLcpConstraintSolver along with the
+/// solution that was applied to the constraints. The problem is
+/// A * x = b + w with the bounds as described in BoxedLcpSolver::solve().
+struct BoxedLcpProblem
+{
+  /// A term of the LCP formulation, which is symmetric
+  Eigen::MatrixXd A;
+
+  /// b term of the LCP formulation
+  Eigen::VectorXd b;
+
+  /// Lower bounds of x
+  Eigen::VectorXd lo;
+
+  /// Upper bounds of x, or the friction coefficients for the friction
+  /// constraints
+  Eigen::VectorXd hi;
+
+  /// Indices to the normal contact constraints of the friction constraints,
+  /// or -1 for the other constraints
+  Eigen::VectorXi findex;
+
+  /// Initial guess of x passed to the solver
+  Eigen::VectorXd initialX;
+
+  /// Solution applied to the constraints
+  Eigen::VectorXd x;
+
+  /// Type of the primary solver
+  std::string primarySolverType;
+
+  /// Type of the secondary solver, or empty if there was none
+  std::string secondarySolverType;
+
+  /// Whether the primary solver succeeded
+  bool primarySucceeded{false};
+
+  /// Whether the solution is from the secondary solver
+  bool usedSecondary{false};
+
+  /// Returns the dimension of the problem
+  int getDimension() const;
+};
+
+/// BoxedLcpRecorder writes boxed LCP problems to a compact binary corpus file.
+/// Only the upper triangle of A is stored since A is symmetric.
+///
+/// Pass a recorder to BoxedLcpConstraintSolver::setLcpRecorder() to capture
+/// the problems solved during the simulation, and use loadBoxedLcpCorpus() and
+/// replayBoxedLcpProblem() to re-solve them with other solvers.
+class BoxedLcpRecorder
+{
+public:
+  /// Constructor. Opens the file discarding its contents.
+  explicit BoxedLcpRecorder(const std::string& path);
+
+  /// Returns true if the file is ready to be written
+  bool isOpen() const;
+
+  /// Appends the problem to the corpus
+  void record(const BoxedLcpProblem& problem);
+
+  /// Returns the number of the recorded problems
+  std::size_t getNumRecords() const;
+
+  /// Flushes the recorded problems to the file
+  void flush();
+
+private:
+  /// Corpus file
+  std::ofstream mFile;
+
+  /// Number of the recorded problems
+  std::size_t mNumRecords;
+};
+
+/// Loads the problems from a corpus file written by BoxedLcpRecorder.
+///
+/// \return False if the file cannot be read or is corrupted. The problems
+/// read before the error are still appended to problems.
+bool loadBoxedLcpCorpus(
+    const std::string& path, std::vector<BoxedLcpProblem>& problems);
+
+/// Statistics of re-solving a boxed LCP problem
+struct BoxedLcpReplayResult
+{
+  /// Whether the solver reported success
+  bool success{false};
+
+  /// Wall-clock time spent by the solver in seconds
+  double time{0.0};
+
+  /// Number of iterations reported by the solver
+  int numIterations{0};
+
+  /// Infinity norm of the natural residual, x - clamp(x - w, lo, hi)
+  double residual{0.0};
+
+  /// Largest product of the magnitude of w and the distance of x to the bound
+  /// that w pushes against
+  double complementarityError{0.0};
+
+  /// Solution
+  Eigen::VectorXd x;
+};
+
+/// Re-solves the problem with the solver starting from the initial guess that
+/// was used when the problem was captured.
+BoxedLcpReplayResult replayBoxedLcpProblem(
+    BoxedLcpSolver& solver,
+    const BoxedLcpProblem& problem,
+    bool earlyTermination = false);
+
+/// Computes the natural residual and the complementarity error of x, which
+/// are both zero for an exact solution. The bounds of the friction
+/// constraints are computed from the normal impulses in x.
+void computeBoxedLcpErrors(
+    const BoxedLcpProblem& problem,
+    const Eigen::VectorXd& x,
+    double& residual,
+    double& complementarityError);
+
+} // namespace constraint
+} // namespace dart
+
+#endif // DART_CONSTRAINT_BOXEDLCPCORPUS_HPP_
@@ -101,6 +101,10 @@ public:
       bool earlyTermination = false)
       = 0;
 
+  /// Returns the number of iterations taken by the last call of solve(), or
+  /// zero if this solver doesn't report it.
+  virtual int getLastNumIterations() const;
+
 #ifndef NDEBUG
   virtual bool canSolve(int n, const double* A) = 0;
 #endif
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/constraint/CompliantContactConstraintSolver.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "dart/collision/CollisionObject.hpp"
+#include "dart/common/Console.hpp"
+#include "dart/constraint/ConstrainedGroup.hpp"
+#include "dart/constraint/ContactConstraint.hpp"
+#include "dart/dynamics/BodyNode.hpp"
+#include "dart/math/Helpers.hpp"
+
+namespace dart {
+namespace constraint {
+
+//==============================================================================
+CompliantContactConstraintSolver::Option::Option(
+    double stiffness,
+    double damping,
+    double frictionRegularizationVelocity,
+    std::size_t numThreads)
+  : mStiffness(stiffness),
+    mDamping(damping),
+    mFrictionRegularizationVelocity(frictionRegularizationVelocity),
+    mNumThreads(numThreads)
+{
+  // Do nothing
+}
+
+//==============================================================================
+CompliantContactConstraintSolver::CompliantContactConstraintSolver(
+    const Option& option)
+  : BoxedLcpConstraintSolver(), mOption(option)
+{
+  // Do nothing
+}
+
+//==============================================================================
+void CompliantContactConstraintSolver::setOption(const Option& option)
+{
+  if (option.mStiffness < 0.0 || option.mDamping < 0.0
+      || option.mFrictionRegularizationVelocity <= 0.0)
+  {
+    dtwarn << "[CompliantContactConstraintSolver::setOption] The stiffness "
+           << "and the damping must be non-negative, and the friction "
+           << "regularization velocity must be positive. Ignoring the "
+           << "option.\n";
+    return;
+  }
+
+  mOption = option;
+}
+
+//==============================================================================
+const CompliantContactConstraintSolver::Option&
+CompliantContactConstraintSolver::getOption() const
+{
+  return mOption;
+}
+
+//==============================================================================
+std::size_t CompliantContactConstraintSolver::getLastNumContacts() const
+{
+  return mCompliantContacts.size();
+}
+
+//==============================================================================
+void CompliantContactConstraintSolver::solveConstrainedGroups()
+{
+  // Take the contact constraints out of the constrained groups so that the
+  // boxed LCPs only contain the other constraints
+  mCompliantContacts.clear();
+  for (std::size_t i = 0u; i < mNumConstrainedGroups; ++i)
+  {
+    ConstrainedGroup& group = mConstrainedGroups[i];
+
+    mOtherConstraints.clear();
+    for (std::size_t j = 0u; j < group.getNumConstraints(); ++j)
+    {
+      const ConstraintBasePtr& constraint = group.getConstraint(j);
+      if (constraint->getType() == ContactConstraint::getStaticType())
+      {
+        mCompliantContacts.push_back(
+            static_cast<ContactConstraint*>(constraint.get()));
+      }
+      else
+      {
+        mOtherConstraints.push_back(constraint);
+      }
+    }
+
+    if (mOtherConstraints.size() == group.getNumConstraints())
+      continue;
+
+    group.removeAllConstraints();
+    for (const auto& constraint : mOtherConstraints)
+      group.addConstraint(constraint);
+  }
+  mOtherConstraints.clear();
+
+  // The impulse tests of the boxed LCPs clear the constraint impulses of the
+  // skeletons, so the contact impulses are applied after them.
+  ConstraintSolver::solveConstrainedGroups();
+
+  // The velocities of the BodyNodes are updated on demand, which must not
+  // happen concurrently
+  for (auto* contactConstraint : mCompliantContacts)
+  {
+    contactConstraint->mBodyNodeA->getSpatialVelocity();
+    contactConstraint->mBodyNodeB->getSpatialVelocity();
+  }
+
+  const std::size_t numContacts = mCompliantContacts.size();
+  mContactImpulses.resize(numContacts);
+  std::size_t numThreads = mOption.mNumThreads;
+  if (0u == numThreads)
+    numThreads = common::ThreadPool::getHardwareConcurrency();
+
+  if (numThreads > 1u && numContacts > 1u)
+  {
+    if (!mThreadPool || mThreadPool->getNumThreads() != numThreads)
+      mThreadPool.reset(new common::ThreadPool(numThreads));
+
+    mThreadPool->parallelFor(
+        numContacts, [&](std::size_t index, std::size_t /*threadIndex*/) {
+          computeContactImpulse(
+              *mCompliantContacts[index], mContactImpulses[index]);
+        });
+  }
+  else
+  {
+    for (std::size_t i = 0u; i < numContacts; ++i)
+      computeContactImpulse(*mCompliantContacts[i], mContactImpulses[i]);
+  }
+
+  // Several contacts can act on the same BodyNode, so the impulses are
+  // applied serially
+  for (std::size_t i = 0u; i < numContacts; ++i)
+  {
+    if (mContactImpulses[i].isZero())
+      continue;
+
+    ContactConstraint* contactConstraint = mCompliantContacts[i];
+    contactConstraint->applyImpulse(mContactImpulses[i].data());
+    contactConstraint->excite();
+  }
+}
+
+//==============================================================================
+void CompliantContactConstraintSolver::computeContactImpulse(
+    ContactConstraint& contactConstraint, Eigen::Vector3d& impulse) const
+{
+  impulse.setZero();
+
+  const double depth = contactConstraint.mContact.penetrationDepth;
+  if (depth <= 0.0)
+    return;
+
+  // Negative relative velocities along the normal and the friction directions,
+  // so the first element is the approaching speed
+  Eigen::Vector3d relVel = Eigen::Vector3d::Zero();
+  contactConstraint.getRelVelocity(relVel.data());
+
+  const double restitution = math::clip(
+      contactConstraint.mIsBounceOn ? contactConstraint.mRestitutionCoeff : 0.0,
+      0.0,
+      1.0);
+  const double damping = mOption.mDamping * (1.0 - restitution);
+  const double normalForce
+      = std::max(mOption.mStiffness * depth + damping * relVel[0], 0.0);
+  impulse[0] = normalForce * mTimeStep;
+
+  if (!contactConstraint.mIsFrictionOn)
+    return;
+
+  // Regularized Coulomb friction opposing the slip velocity
+  const double regularization = mOption.mFrictionRegularizationVelocity;
+  const double slipSpeed = std::sqrt(
+      relVel[1] * relVel[1] + relVel[2] * relVel[2]
+      + regularization * regularization);
+  const double scale = normalForce * mTimeStep / slipSpeed;
+  impulse[1] = contactConstraint.mPrimaryFrictionCoeff * relVel[1] * scale;
+  impulse[2] = contactConstraint.mSecondaryFrictionCoeff * relVel[2] * scale;
+}
+
+} // namespace constraint
+} // namespace dart
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_CONSTRAINT_COMPLIANTCONTACTCONSTRAINTSOLVER_HPP_
+#define DART_CONSTRAINT_COMPLIANTCONTACTCONSTRAINTSOLVER_HPP_
+
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/common/ThreadPool.hpp"
+#include "dart/constraint/BoxedLcpConstraintSolver.hpp"
+
+namespace dart {
+namespace constraint {
+
+/// CompliantContactConstraintSolver resolves the contacts with a compliant
+/// contact model instead of the LCP.
+///
+/// Each contact is treated as a spring-damper along the contact normal, where
+/// the spring acts on the penetration depth and the damper on the approaching
+/// speed. The normal force is never adhesive. Friction follows a regularized
+/// Coulomb model: the friction force opposes the slip velocity and reaches the
+/// Coulomb limit smoothly as the slip speed exceeds the regularization
+/// velocity. The friction and restitution coefficients are looked up from the
+/// ShapeNodes the same way as ContactConstraint does. The restitution
+/// coefficient scales the damping down, so a coefficient of one gives an
+/// undamped, elastic contact.
+///
+/// The contact forces only depend on the state of the bodies at the beginning
+/// of the step, so the cost is linear in the number of the contacts, and the
+/// forces can be computed in parallel (see Option::mNumThreads). They are
+/// applied as constraint impulses (force times time step). The
+/// other constraints, such as joint limits, are still solved by the boxed LCP
+/// solvers of BoxedLcpConstraintSolver, without the contacts.
+///
+/// The contact forces are explicit, so the stiffness and the damping need to
+/// be chosen with the time step and the masses of the bodies in mind: the
+/// simulation becomes unstable if stiffness * timeStep^2 or
+/// damping * timeStep, summed over the contacts of a body and divided by its
+/// mass, gets close to one. The same holds for the friction force divided by
+/// the regularization velocity, which acts as a viscous damping for small
+/// slip speeds.
+class CompliantContactConstraintSolver : public BoxedLcpConstraintSolver
+{
+public:
+  struct Option
+  {
+    /// Normal stiffness of a contact in N/m
+    double mStiffness;
+
+    /// Normal damping of a contact in N*s/m
+    double mDamping;
+
+    /// Slip speed in m/s at which the friction force reaches about 70% of the
+    /// Coulomb limit
+    double mFrictionRegularizationVelocity;
+
+    /// Number of threads to compute the contact forces with. Set this to 0 to
+    /// use all the hardware threads. The forces are applied in the same order
+    /// regardless of this number.
+    std::size_t mNumThreads;
+
+    Option(
+        double stiffness = 1e5,
+        double damping = 1e2,
+        double frictionRegularizationVelocity = 0.05,
+        std::size_t numThreads = 1u);
+  };
+
+  /// Constructor
+  explicit CompliantContactConstraintSolver(const Option& option = Option());
+
+  /// Sets options
+  void setOption(const Option& option);
+
+  /// Returns options
+  const Option& getOption() const;
+
+  /// Returns the number of the contacts resolved by the compliant model in the
+  /// last solve()
+  std::size_t getLastNumContacts() const;
+
+protected:
+  // Documentation inherited.
+  void solveConstrainedGroups() override;
+
+  /// Computes the impulses of a contact along the contact normal and the
+  /// friction directions of the contact constraint
+  void computeContactImpulse(
+      ContactConstraint& contactConstraint, Eigen::Vector3d& impulse) const;
+
+  /// Solver options
+  Option mOption;
+
+  /// Contact constraints resolved by the compliant model in the last solve()
+  std::vector<ContactConstraint*> mCompliantContacts;
+
+  /// Impulses of mCompliantContacts
+  std::vector<Eigen::Vector3d> mContactImpulses;
+
+  /// Cache data for the constraints of a group other than the contacts
+  std::vector<ConstraintBasePtr> mOtherConstraints;
+
+  /// ThreadPool for the contact forces. Created on demand.
+  std::unique_ptr<common::ThreadPool> mThreadPool;
+};
+
+} // namespace constraint
+} // namespace dart
+
+#endif // DART_CONSTRAINT_COMPLIANTCONTACTCONSTRAINTSOLVER_HPP_
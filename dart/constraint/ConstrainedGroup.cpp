@@ -125,5 +125,19 @@ std::size_t ConstrainedGroup::getTotalDimension() const
   return totalDim;
 }
 
+//==============================================================================
+std::size_t ConstrainedGroup::getNumSkeletons() const
+{
+  return mSkeletons.size();
+}
+
+//==============================================================================
+std::shared_ptr<dynamics::Skeleton> ConstrainedGroup::getSkeleton(
+    std::size_t index) const
+{
+  assert(index < mSkeletons.size());
+  return mSkeletons[index];
+}
+
 } // namespace constraint
 } // namespace dart
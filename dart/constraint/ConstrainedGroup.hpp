@@ -92,6 +92,12 @@ public:
   /// Get total dimension of contraints in this group
   std::size_t getTotalDimension() const;
 
+  /// Returns the number of skeletons coupled by the constraints in this group
+  std::size_t getNumSkeletons() const;
+
+  /// Returns a skeleton coupled by the constraints in this group
+  std::shared_ptr<dynamics::Skeleton> getSkeleton(std::size_t index) const;
+
   //----------------------------------------------------------------------------
   // Friendship
   //----------------------------------------------------------------------------
@@ -107,6 +113,9 @@ private:
   /// List of constraints
   std::vector<ConstraintBasePtr> mConstraints;
 
+  /// List of skeletons coupled by the constraints
+  std::vector<std::shared_ptr<dynamics::Skeleton>> mSkeletons;
+
   ///
   std::shared_ptr<dynamics::Skeleton> mRootSkeleton;
 };
@@ -72,6 +72,14 @@ void ConstraintBase::uniteSkeletons()
   // Do nothing
 }
 
+//==============================================================================
+bool ConstraintBase::getCoupledBodyNodes(
+    dynamics::BodyNode*& /*bodyNode1*/,
+    dynamics::BodyNode*& /*bodyNode2*/) const
+{
+  return false;
+}
+
 //==============================================================================
 dynamics::SkeletonPtr ConstraintBase::compressPath(
     dynamics::SkeletonPtr _skeleton)
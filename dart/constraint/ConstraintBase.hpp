@@ -40,6 +40,7 @@
 namespace dart {
 
 namespace dynamics {
+class BodyNode;
 class Skeleton;
 } // namespace dynamics
 
@@ -110,6 +111,16 @@ public:
   ///
   virtual void uniteSkeletons();
 
+  /// Gets the BodyNodes whose motions are coupled by this constraint, which
+  /// ConstraintSolver uses to build the constrained groups. bodyNode2 is set to
+  /// nullptr if the constraint acts on a single BodyNode.
+  ///
+  /// Returns false if the constraint doesn't provide the BodyNodes, in which
+  /// case the group is built from uniteSkeletons() and getRootSkeleton(). The
+  /// default implementation returns false.
+  virtual bool getCoupledBodyNodes(
+      dynamics::BodyNode*& bodyNode1, dynamics::BodyNode*& bodyNode2) const;
+
   ///
   static dynamics::SkeletonPtr compressPath(dynamics::SkeletonPtr skeleton);
 
@@ -32,6 +32,9 @@
 
 #include "dart/constraint/ConstraintSolver.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 #include "dart/collision/CollisionFilter.hpp"
 #include "dart/collision/CollisionGroup.hpp"
 #include "dart/collision/CollisionObject.hpp"
@@ -57,13 +60,20 @@ namespace constraint {
 
 using namespace dynamics;
 
+//==============================================================================
+constexpr std::size_t ConstraintSolver::kNoIslandNode;
+
 //==============================================================================
 ConstraintSolver::ConstraintSolver(double timeStep)
   : mCollisionDetector(collision::FCLCollisionDetector::create()),
     mCollisionGroup(mCollisionDetector->createCollisionGroupAsSharedPtr()),
     mCollisionOption(collision::CollisionOption(
         true, 1000u, std::make_shared<collision::BodyNodeCollisionFilter>())),
-    mTimeStep(timeStep)
+    mTimeStep(timeStep),
+    mSpeculativeContactMargin(0.0),
+    mContinuousCollisionEnabled(false),
+    mNumConstrainedGroups(0u),
+    mSplitTreesIntoGroups(false)
 {
   assert(timeStep > 0.0);
 
@@ -82,7 +92,11 @@ ConstraintSolver::ConstraintSolver()
     mCollisionGroup(mCollisionDetector->createCollisionGroupAsSharedPtr()),
     mCollisionOption(collision::CollisionOption(
         true, 1000u, std::make_shared<collision::BodyNodeCollisionFilter>())),
-    mTimeStep(0.001)
+    mTimeStep(0.001),
+    mSpeculativeContactMargin(0.0),
+    mContinuousCollisionEnabled(false),
+    mNumConstrainedGroups(0u),
+    mSplitTreesIntoGroups(false)
 {
   auto cd = std::static_pointer_cast<collision::FCLCollisionDetector>(
       mCollisionDetector);
@@ -249,6 +263,9 @@ void ConstraintSolver::setTimeStep(double _timeStep)
 {
   assert(_timeStep > 0.0 && "Time step should be positive value.");
   mTimeStep = _timeStep;
+
+  if (mContinuousCollisionEnabled)
+    mCollisionOption.continuousCollisionTimeStep = mTimeStep;
 }
 
 //==============================================================================
@@ -358,6 +375,65 @@ LCPSolver* ConstraintSolver::getLCPSolver() const
   return nullptr;
 }
 
+//==============================================================================
+void ConstraintSolver::setSpeculativeContactMargin(double margin)
+{
+  if (margin < 0.0)
+  {
+    dtwarn << "[ConstraintSolver::setSpeculativeContactMargin] Attempting to "
+           << "set negative margin (" << margin << "). Using 0 instead.\n";
+    margin = 0.0;
+  }
+
+  mSpeculativeContactMargin = margin;
+  mCollisionOption.contactMargin = margin;
+}
+
+//==============================================================================
+double ConstraintSolver::getSpeculativeContactMargin() const
+{
+  return mSpeculativeContactMargin;
+}
+
+//==============================================================================
+void ConstraintSolver::setContinuousCollisionEnabled(bool enabled)
+{
+  mContinuousCollisionEnabled = enabled;
+  mCollisionOption.continuousCollisionTimeStep = enabled ? mTimeStep : 0.0;
+}
+
+//==============================================================================
+bool ConstraintSolver::isContinuousCollisionEnabled() const
+{
+  return mContinuousCollisionEnabled;
+}
+
+//==============================================================================
+void ConstraintSolver::setSplitTreesIntoGroups(bool split)
+{
+  mSplitTreesIntoGroups = split;
+}
+
+//==============================================================================
+bool ConstraintSolver::isSplittingTreesIntoGroups() const
+{
+  return mSplitTreesIntoGroups;
+}
+
+//==============================================================================
+std::size_t ConstraintSolver::getNumConstrainedGroups() const
+{
+  return mNumConstrainedGroups;
+}
+
+//==============================================================================
+const ConstrainedGroup& ConstraintSolver::getConstrainedGroup(
+    std::size_t index) const
+{
+  assert(index < mNumConstrainedGroups);
+  return mConstrainedGroups[index];
+}
+
 //==============================================================================
 void ConstraintSolver::solve()
 {
@@ -501,12 +577,28 @@ void ConstraintSolver::updateConstraints()
     shapeFrame2->asShapeNode()->getBodyNodePtr()->setColliding(true);
     DART_SUPPRESS_DEPRECATED_END
 
+    // Sleeping and immobile bodies don't respond to contacts, so a contact
+    // between them doesn't couple any island. It is still kept in the
+    // collision result, from which World wakes up the sleeping skeletons
+    // touched by moving ones.
+    if (!shapeFrame1->asShapeNode()->getBodyNodePtr()->isReactive()
+        && !shapeFrame2->asShapeNode()->getBodyNodePtr()->isReactive())
+    {
+      continue;
+    }
+
     // If penetration depth is negative, then the collision isn't really
-    // happening and the contact point should be ignored.
-    // TODO(MXG): Investigate ways to leverage the proximity information of a
-    //            negative penetration to improve collision handling.
+    // happening. The contact is only kept as a speculative contact if the
+    // bodies are about to collide within this time step, which includes the
+    // contacts found by the continuous collision checking.
     if (contact.penetrationDepth < 0.0)
-      continue;
+    {
+      if ((mSpeculativeContactMargin <= 0.0 && !mContinuousCollisionEnabled)
+          || isSoftContact(contact) || !isSpeculativeContactNeeded(contact))
+      {
+        continue;
+      }
+    }
 
     if (isSoftContact(contact))
     {
@@ -550,6 +642,9 @@ void ConstraintSolver::updateConstraints()
   // Create new joint constraints
   for (const auto& skel : mSkeletons)
   {
+    if (skel->isSleeping())
+      continue;
+
     const std::size_t numJoints = skel->getNumJoints();
     for (std::size_t i = 0; i < numJoints; i++)
     {
@@ -630,64 +725,294 @@ void ConstraintSolver::updateConstraints()
 //==============================================================================
 void ConstraintSolver::buildConstrainedGroups()
 {
-  // Clear constrained groups
-  mConstrainedGroups.clear();
+  // Clear the constrained groups of the last step. The group objects are kept
+  // so that their storage is reused.
+  for (std::size_t i = 0u; i < mNumConstrainedGroups; ++i)
+  {
+    mConstrainedGroups[i].mConstraints.clear();
+    mConstrainedGroups[i].mSkeletons.clear();
+    mConstrainedGroups[i].mRootSkeleton.reset();
+  }
+  mNumConstrainedGroups = 0u;
+  mSplitSkeletons.clear();
 
   // Exit if there is no active constraint
   if (mActiveConstraints.empty())
     return;
 
   //----------------------------------------------------------------------------
-  // Unite skeletons according to constraints's relationships
+  // Assign island nodes to the skeletons, or to their trees
   //----------------------------------------------------------------------------
-  for (const auto& activeConstraint : mActiveConstraints)
-    activeConstraint->uniteSkeletons();
+  mIslandNodeOffsets.resize(mSkeletons.size() + 1u);
+  mIslandNodeOffsets[0] = 0u;
+  for (std::size_t i = 0u; i < mSkeletons.size(); ++i)
+  {
+    const auto& skeleton = mSkeletons[i];
+    skeleton->mUnionIndex = i;
+
+    std::size_t numNodes = 1u;
+    if (mSplitTreesIntoGroups && skeleton->getNumSoftBodyNodes() == 0u)
+      numNodes = std::max(skeleton->getNumTrees(), numNodes);
+
+    mIslandNodeOffsets[i + 1] = mIslandNodeOffsets[i] + numNodes;
+  }
+
+  const std::size_t numNodes = mIslandNodeOffsets.back();
+  mIslandParents.resize(numNodes);
+  std::iota(mIslandParents.begin(), mIslandParents.end(), 0u);
+  mIslandSizes.assign(numNodes, 1u);
 
   //----------------------------------------------------------------------------
-  // Build constraint groups
+  // Unite islands according to constraints's relationships
   //----------------------------------------------------------------------------
-  for (const auto& activeConstraint : mActiveConstraints)
+  bool hasUnitedSkeletons = false;
+  mConstraintIslandNodes.resize(mActiveConstraints.size());
+  for (std::size_t i = 0u; i < mActiveConstraints.size(); ++i)
   {
-    bool found = false;
-    const auto& skel = activeConstraint->getRootSkeleton();
+    const auto& activeConstraint = mActiveConstraints[i];
 
-    for (const auto& constrainedGroup : mConstrainedGroups)
+    dynamics::BodyNode* bodyNode1 = nullptr;
+    dynamics::BodyNode* bodyNode2 = nullptr;
+    if (!activeConstraint->getCoupledBodyNodes(bodyNode1, bodyNode2))
     {
-      if (constrainedGroup.mRootSkeleton == skel)
-      {
-        found = true;
-        break;
-      }
+      // Fall back to uniting skeletons for the constraints that don't provide
+      // their BodyNodes. The island nodes are assigned below.
+      activeConstraint->uniteSkeletons();
+      mConstraintIslandNodes[i] = kNoIslandNode;
+      hasUnitedSkeletons = true;
+      continue;
     }
 
-    if (found)
-      continue;
+    const bool isReactive1 = bodyNode1 && bodyNode1->isReactive();
+    const bool isReactive2 = bodyNode2 && bodyNode2->isReactive();
+    std::size_t node1
+        = isReactive1 ? getIslandNode(bodyNode1) : kNoIslandNode;
+    const std::size_t node2
+        = isReactive2 ? getIslandNode(bodyNode2) : kNoIslandNode;
+
+    if (node1 != kNoIslandNode && node2 != kNoIslandNode)
+      uniteIslands(node1, node2);
+    else if (node1 == kNoIslandNode)
+      node1 = node2;
 
-    ConstrainedGroup newConstGroup;
-    newConstGroup.mRootSkeleton = skel;
-    skel->mUnionIndex = mConstrainedGroups.size();
-    mConstrainedGroups.push_back(newConstGroup);
+    // The constraint acts on BodyNodes of skeletons that are not added to
+    // this solver, so it forms a group by itself.
+    if (node1 == kNoIslandNode)
+      node1 = addIslandNode();
+
+    mConstraintIslandNodes[i] = node1;
   }
 
-  // Add active constraints to constrained groups
-  for (const auto& activeConstraint : mActiveConstraints)
+  if (hasUnitedSkeletons)
   {
-    const auto& skel = activeConstraint->getRootSkeleton();
-    mConstrainedGroups[skel->mUnionIndex].addConstraint(activeConstraint);
+    // Unite all the trees of the united skeletons since the constraints don't
+    // tell which trees they act on
+    for (std::size_t i = 0u; i < mSkeletons.size(); ++i)
+    {
+      const auto root = ConstraintBase::getRootSkeleton(mSkeletons[i]);
+      if (root == mSkeletons[i])
+        continue;
+
+      uniteSkeletonIslands(i);
+      uniteSkeletonIslands(root->mUnionIndex);
+      uniteIslands(
+          mIslandNodeOffsets[i], mIslandNodeOffsets[root->mUnionIndex]);
+    }
+
+    for (std::size_t i = 0u; i < mActiveConstraints.size(); ++i)
+    {
+      if (mConstraintIslandNodes[i] != kNoIslandNode)
+        continue;
+
+      const auto root = mActiveConstraints[i]->getRootSkeleton();
+      const std::size_t index = root->mUnionIndex;
+      if (index < mSkeletons.size() && mSkeletons[index] == root)
+      {
+        uniteSkeletonIslands(index);
+        mConstraintIslandNodes[i] = mIslandNodeOffsets[index];
+      }
+      else
+      {
+        mConstraintIslandNodes[i] = addIslandNode();
+      }
+    }
+
+    // Reset union since we don't need union information anymore.
+    for (auto& skeleton : mSkeletons)
+      skeleton->resetUnion();
   }
 
   //----------------------------------------------------------------------------
-  // Reset union since we don't need union information anymore.
+  // Build constraint groups
   //----------------------------------------------------------------------------
-  for (auto& skeleton : mSkeletons)
-    skeleton->resetUnion();
+  mIslandGroupIndices.assign(mIslandParents.size(), kNoIslandNode);
+
+  // Add active constraints to constrained groups
+  for (std::size_t i = 0u; i < mActiveConstraints.size(); ++i)
+  {
+    const std::size_t root = findIsland(mConstraintIslandNodes[i]);
+    std::size_t& groupIndex = mIslandGroupIndices[root];
+
+    if (groupIndex == kNoIslandNode)
+    {
+      groupIndex = mNumConstrainedGroups++;
+      if (mConstrainedGroups.size() < mNumConstrainedGroups)
+        mConstrainedGroups.emplace_back();
+
+      // The root skeleton is the skeleton of the island root, which is only
+      // used to identify the group.
+      if (root < mIslandNodeOffsets.back())
+      {
+        const auto it = std::upper_bound(
+            mIslandNodeOffsets.begin(), mIslandNodeOffsets.end(), root);
+        mConstrainedGroups[groupIndex].mRootSkeleton
+            = mSkeletons[static_cast<std::size_t>(
+                it - mIslandNodeOffsets.begin() - 1)];
+      }
+    }
+
+    mConstrainedGroups[groupIndex].addConstraint(mActiveConstraints[i]);
+  }
+
+  // Add the skeletons coupled by the constraints to constrained groups. A
+  // skeleton whose trees are in different groups is added to each of them.
+  for (std::size_t i = 0u; i < mSkeletons.size(); ++i)
+  {
+    const auto& skeleton = mSkeletons[i];
+    std::size_t numGroups = 0u;
+
+    for (std::size_t node = mIslandNodeOffsets[i];
+         node < mIslandNodeOffsets[i + 1];
+         ++node)
+    {
+      const std::size_t groupIndex = mIslandGroupIndices[findIsland(node)];
+      if (groupIndex == kNoIslandNode)
+        continue;
+
+      auto& skeletons = mConstrainedGroups[groupIndex].mSkeletons;
+      if (!skeletons.empty() && skeletons.back() == skeleton)
+        continue;
+
+      skeletons.push_back(skeleton);
+      ++numGroups;
+    }
+
+    if (numGroups > 1u)
+      mSplitSkeletons.push_back(skeleton.get());
+  }
 }
 
 //==============================================================================
 void ConstraintSolver::solveConstrainedGroups()
 {
-  for (auto& constraintGroup : mConstrainedGroups)
-    solveConstrainedGroup(constraintGroup);
+  if (mSplitSkeletons.empty())
+  {
+    for (std::size_t i = 0u; i < mNumConstrainedGroups; ++i)
+      solveConstrainedGroup(mConstrainedGroups[i]);
+
+    return;
+  }
+
+  // The impulse tests of a constrained group clear the constraint impulses of
+  // all the BodyNodes of the skeletons in the group, which would discard the
+  // impulses applied to the other trees of a split skeleton by the previous
+  // groups. So the impulses are collected after solving each group and put
+  // back once all the groups are solved.
+  std::size_t numBodyNodes = 0u;
+  for (const auto* skeleton : mSplitSkeletons)
+    numBodyNodes += skeleton->getNumBodyNodes();
+  mSplitSkeletonImpulses.assign(numBodyNodes, Eigen::Vector6d::Zero());
+
+  for (std::size_t i = 0u; i < mNumConstrainedGroups; ++i)
+  {
+    solveConstrainedGroup(mConstrainedGroups[i]);
+
+    std::size_t index = 0u;
+    for (auto* skeleton : mSplitSkeletons)
+    {
+      for (std::size_t j = 0u; j < skeleton->getNumBodyNodes(); ++j)
+      {
+        auto* bodyNode = skeleton->getBodyNode(j);
+        mSplitSkeletonImpulses[index++] += bodyNode->getConstraintImpulse();
+        bodyNode->clearConstraintImpulse();
+      }
+    }
+  }
+
+  std::size_t index = 0u;
+  for (auto* skeleton : mSplitSkeletons)
+  {
+    for (std::size_t j = 0u; j < skeleton->getNumBodyNodes(); ++j)
+      skeleton->getBodyNode(j)->setConstraintImpulse(
+          mSplitSkeletonImpulses[index++]);
+
+    skeleton->setImpulseApplied(true);
+  }
+}
+
+//==============================================================================
+std::size_t ConstraintSolver::getIslandNode(
+    const dynamics::BodyNode* bodyNode) const
+{
+  const dynamics::Skeleton* skeleton = bodyNode->getSkeleton().get();
+  const std::size_t index = skeleton->mUnionIndex;
+  if (index >= mSkeletons.size() || mSkeletons[index].get() != skeleton)
+    return kNoIslandNode;
+
+  const std::size_t offset = mIslandNodeOffsets[index];
+  if (mIslandNodeOffsets[index + 1] - offset == 1u)
+    return offset;
+
+  return offset + bodyNode->getTreeIndex();
+}
+
+//==============================================================================
+std::size_t ConstraintSolver::addIslandNode()
+{
+  mIslandParents.push_back(mIslandParents.size());
+  mIslandSizes.push_back(1u);
+
+  return mIslandParents.size() - 1u;
+}
+
+//==============================================================================
+std::size_t ConstraintSolver::findIsland(std::size_t node)
+{
+  // Path halving
+  while (mIslandParents[node] != node)
+  {
+    mIslandParents[node] = mIslandParents[mIslandParents[node]];
+    node = mIslandParents[node];
+  }
+
+  return node;
+}
+
+//==============================================================================
+void ConstraintSolver::uniteIslands(std::size_t node1, std::size_t node2)
+{
+  std::size_t root1 = findIsland(node1);
+  std::size_t root2 = findIsland(node2);
+  if (root1 == root2)
+    return;
+
+  // Union by size
+  if (mIslandSizes[root1] < mIslandSizes[root2])
+    std::swap(root1, root2);
+
+  mIslandParents[root2] = root1;
+  mIslandSizes[root1] += mIslandSizes[root2];
+}
+
+//==============================================================================
+void ConstraintSolver::uniteSkeletonIslands(std::size_t skeletonIndex)
+{
+  for (std::size_t node = mIslandNodeOffsets[skeletonIndex] + 1u;
+       node < mIslandNodeOffsets[skeletonIndex + 1];
+       ++node)
+  {
+    uniteIslands(mIslandNodeOffsets[skeletonIndex], node);
+  }
 }
 
 //==============================================================================
@@ -710,5 +1035,33 @@ bool ConstraintSolver::isSoftContact(const collision::Contact& contact) const
   return bodyNode1IsSoft || bodyNode2IsSoft;
 }
 
+//==============================================================================
+bool ConstraintSolver::isSpeculativeContactNeeded(
+    const collision::Contact& contact) const
+{
+  const auto* bodyNode1 = contact.collisionObject1->getShapeFrame()
+                              ->asShapeNode()
+                              ->getBodyNodePtr()
+                              .get();
+  const auto* bodyNode2 = contact.collisionObject2->getShapeFrame()
+                              ->asShapeNode()
+                              ->getBodyNodePtr()
+                              .get();
+
+  // The velocities are the ones before the constraint impulses are applied,
+  // which already include the effect of the external forces in this step.
+  const Eigen::Vector3d velocity1 = bodyNode1->getLinearVelocity(
+      bodyNode1->getTransform().inverse() * contact.point);
+  const Eigen::Vector3d velocity2 = bodyNode2->getLinearVelocity(
+      bodyNode2->getTransform().inverse() * contact.point);
+
+  // The normal points from the second body to the first body, so the bodies
+  // approach each other when the relative normal velocity is negative.
+  const double approachSpeed = contact.normal.dot(velocity2 - velocity1);
+  const double gap = -contact.penetrationDepth;
+
+  return approachSpeed * mTimeStep >= gap;
+}
+
 } // namespace constraint
 } // namespace dart
@@ -39,6 +39,7 @@
 
 #include "dart/collision/CollisionDetector.hpp"
 #include "dart/common/Deprecated.hpp"
+#include "dart/common/Memory.hpp"
 #include "dart/constraint/ConstrainedGroup.hpp"
 #include "dart/constraint/ConstraintBase.hpp"
 #include "dart/constraint/SmartPointer.hpp"
@@ -46,6 +47,7 @@
 namespace dart {
 
 namespace dynamics {
+class BodyNode;
 class Skeleton;
 class ShapeNodeCollisionObject;
 } // namespace dynamics
@@ -177,6 +179,57 @@ public:
   DART_DEPRECATED(6.7)
   LCPSolver* getLCPSolver() const;
 
+  /// Enables speculative contacts for the separated pairs closer than margin.
+  /// The collision detector reports such pairs with negative penetration
+  /// depth (see collision::CollisionOption::contactMargin), and a contact
+  /// constraint is created for the ones that approach each other fast enough
+  /// to close the gap within the time step. The constraint stops the bodies
+  /// at the surface instead of letting them penetrate, which allows larger
+  /// time steps without tunneling or deep penetration. The margin should be
+  /// larger than the distance the fastest bodies travel in a time step.
+  /// Restitution is only applied once the bodies touch. Set this to 0 to
+  /// disable speculative contacts, which is the default.
+  ///
+  /// Currently, only DARTCollisionDetector reports the separated pairs, and
+  /// only for boxes, spheres, and ellipsoids.
+  void setSpeculativeContactMargin(double margin);
+
+  /// Returns the margin of the speculative contacts.
+  double getSpeculativeContactMargin() const;
+
+  /// Enables continuous collision checking for the BodyNodes that request it
+  /// (see dynamics::BodyNode::setContinuousCollisionCheck()). Their collision
+  /// shapes are swept with their velocities over the time step, and the
+  /// contacts at the time of impact become contact constraints that stop them
+  /// at the surface of the objects they would otherwise pass through. The
+  /// other bodies are checked discretely as usual, so only the flagged bodies
+  /// pay for the sweep. Disabled by default.
+  ///
+  /// Currently, only DARTCollisionDetector supports the sweep, and only for
+  /// boxes, spheres, and ellipsoids.
+  void setContinuousCollisionEnabled(bool enabled);
+
+  /// Returns whether continuous collision checking is enabled.
+  bool isContinuousCollisionEnabled() const;
+
+  /// Sets whether the trees of a skeleton can be put into separate
+  /// constrained groups. The trees of a skeleton don't share degrees of
+  /// freedom, so constraints acting on different trees are independent unless
+  /// another constraint couples them. Splitting them keeps the LCPs small, for
+  /// example when several free objects are modeled as one skeleton. Skeletons
+  /// with soft bodies are always kept in a single group. Disabled by default.
+  void setSplitTreesIntoGroups(bool split);
+
+  /// Returns whether the trees of a skeleton can be put into separate
+  /// constrained groups.
+  bool isSplittingTreesIntoGroups() const;
+
+  /// Returns the number of constrained groups built by the last solve().
+  std::size_t getNumConstrainedGroups() const;
+
+  /// Returns a constrained group built by the last solve().
+  const ConstrainedGroup& getConstrainedGroup(std::size_t index) const;
+
   /// Solve constraint impulses and apply them to the skeletons
   void solve();
 
@@ -207,11 +260,36 @@ protected:
   void buildConstrainedGroups();
 
   /// Solve constrained groups
-  void solveConstrainedGroups();
+  virtual void solveConstrainedGroups();
 
   /// Return true if at least one of colliding body is soft body
   bool isSoftContact(const collision::Contact& contact) const;
 
+  /// Returns true if the bodies of a speculative contact (negative penetration
+  /// depth) approach each other fast enough to close the gap within the time
+  /// step.
+  bool isSpeculativeContactNeeded(const collision::Contact& contact) const;
+
+  /// Returns the island node of a BodyNode, which is a skeleton or, if the
+  /// trees of the skeleton are split, a tree of the skeleton. Returns
+  /// kNoIslandNode if the skeleton is not added to this solver.
+  std::size_t getIslandNode(const dynamics::BodyNode* bodyNode) const;
+
+  /// Adds an island node that doesn't belong to any skeleton in this solver
+  std::size_t addIslandNode();
+
+  /// Returns the root of the island that contains the node
+  std::size_t findIsland(std::size_t node);
+
+  /// Unites the islands that contain the nodes
+  void uniteIslands(std::size_t node1, std::size_t node2);
+
+  /// Unites the island nodes of all the trees of a skeleton
+  void uniteSkeletonIslands(std::size_t skeletonIndex);
+
+  /// Island node index for BodyNodes that have no island node
+  static constexpr std::size_t kNoIslandNode = static_cast<std::size_t>(-1);
+
   using CollisionDetector = collision::CollisionDetector;
 
   /// Collision detector
@@ -229,6 +307,12 @@ protected:
   /// Time step
   double mTimeStep;
 
+  /// Margin of the speculative contacts. Zero disables them.
+  double mSpeculativeContactMargin;
+
+  /// Whether continuous collision checking is enabled
+  bool mContinuousCollisionEnabled;
+
   /// Skeleton list
   std::vector<dynamics::SkeletonPtr> mSkeletons;
 
@@ -257,8 +341,38 @@ protected:
   /// Active constraints
   std::vector<ConstraintBasePtr> mActiveConstraints;
 
-  /// Constraint group list
+  /// Constraint group list. Only the first mNumConstrainedGroups groups are
+  /// in use; the rest are kept to reuse their storage in the next step.
   std::vector<ConstrainedGroup> mConstrainedGroups;
+
+  /// Number of constrained groups built by the last solve()
+  std::size_t mNumConstrainedGroups;
+
+  /// Whether the trees of a skeleton can be put into separate groups
+  bool mSplitTreesIntoGroups;
+
+  /// Parents of the island nodes in the union-find forest
+  std::vector<std::size_t> mIslandParents;
+
+  /// Number of nodes of the islands, valid for the root nodes only
+  std::vector<std::size_t> mIslandSizes;
+
+  /// Index of the first island node of each skeleton. The last element is the
+  /// number of the island nodes of the skeletons.
+  std::vector<std::size_t> mIslandNodeOffsets;
+
+  /// Island node of each active constraint
+  std::vector<std::size_t> mConstraintIslandNodes;
+
+  /// Constrained group index of each island root
+  std::vector<std::size_t> mIslandGroupIndices;
+
+  /// Skeletons whose trees are put into more than one constrained group
+  std::vector<dynamics::Skeleton*> mSplitSkeletons;
+
+  /// Constraint impulses of the BodyNodes of mSplitSkeletons accumulated over
+  /// the constrained groups
+  common::aligned_vector<Eigen::Vector6d> mSplitSkeletonImpulses;
 };
 
 } // namespace constraint
@@ -441,9 +441,15 @@ void ContactConstraint::getInformation(ConstraintInfo* info)
     //------------------------------------------------------------------------
     // Bouncing
     //------------------------------------------------------------------------
-    // A. Penetration correction
+    // A. Penetration correction. A speculative contact (negative penetration
+    // depth) lets the bodies close the gap within this time step but not
+    // penetrate.
     double bouncingVelocity = mContact.penetrationDepth - mErrorAllowance;
-    if (bouncingVelocity < 0.0)
+    if (mContact.penetrationDepth < 0.0)
+    {
+      bouncingVelocity = mContact.penetrationDepth * info->invTimeStep;
+    }
+    else if (bouncingVelocity < 0.0)
     {
       bouncingVelocity = 0.0;
     }
@@ -454,8 +460,8 @@ void ContactConstraint::getInformation(ConstraintInfo* info)
         bouncingVelocity = mMaxErrorReductionVelocity;
     }
 
-    // B. Restitution
-    if (mIsBounceOn)
+    // B. Restitution, which doesn't apply until the bodies touch
+    if (mIsBounceOn && mContact.penetrationDepth >= 0.0)
     {
       double& negativeRelativeVel = info->b[0];
       double restitutionVel = negativeRelativeVel * mRestitutionCoeff;
@@ -498,9 +504,15 @@ void ContactConstraint::getInformation(ConstraintInfo* info)
     //------------------------------------------------------------------------
     // Bouncing
     //------------------------------------------------------------------------
-    // A. Penetration correction
+    // A. Penetration correction. A speculative contact (negative penetration
+    // depth) lets the bodies close the gap within this time step but not
+    // penetrate.
     double bouncingVelocity = mContact.penetrationDepth - DART_ERROR_ALLOWANCE;
-    if (bouncingVelocity < 0.0)
+    if (mContact.penetrationDepth < 0.0)
+    {
+      bouncingVelocity = mContact.penetrationDepth * info->invTimeStep;
+    }
+    else if (bouncingVelocity < 0.0)
     {
       bouncingVelocity = 0.0;
     }
@@ -511,8 +523,8 @@ void ContactConstraint::getInformation(ConstraintInfo* info)
         bouncingVelocity = mMaxErrorReductionVelocity;
     }
 
-    // B. Restitution
-    if (mIsBounceOn)
+    // B. Restitution, which doesn't apply until the bodies touch
+    if (mIsBounceOn && mContact.penetrationDepth >= 0.0)
     {
       double& negativeRelativeVel = info->b[0];
       double restitutionVel = negativeRelativeVel * mRestitutionCoeff;
@@ -718,6 +730,16 @@ void ContactConstraint::getRelVelocity(double* relVel)
   relVelMap -= mSpatialNormalB.transpose() * mBodyNodeB->getSpatialVelocity();
 }
 
+//==============================================================================
+bool ContactConstraint::getCoupledBodyNodes(
+    dynamics::BodyNode*& bodyNode1, dynamics::BodyNode*& bodyNode2) const
+{
+  bodyNode1 = mBodyNodeA;
+  bodyNode2 = mBodyNodeB;
+
+  return true;
+}
+
 //==============================================================================
 bool ContactConstraint::isActive() const
 {
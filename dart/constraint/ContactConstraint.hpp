@@ -46,7 +46,11 @@ class Skeleton;
 
 namespace constraint {
 
-/// ContactConstraint represents a contact constraint between two bodies
+/// ContactConstraint represents a contact constraint between two bodies.
+///
+/// A contact with negative penetration depth is treated as a speculative
+/// contact between separated bodies: it only prevents the bodies from
+/// approaching each other by more than the gap within the time step.
 class ContactConstraint : public ConstraintBase
 {
 public:
@@ -102,6 +106,7 @@ public:
 
   friend class ConstraintSolver;
   friend class ConstrainedGroup;
+  friend class CompliantContactConstraintSolver;
 
 protected:
   //----------------------------------------------------------------------------
@@ -135,6 +140,11 @@ protected:
   // Documentation inherited
   void uniteSkeletons() override;
 
+  // Documentation inherited
+  bool getCoupledBodyNodes(
+      dynamics::BodyNode*& bodyNode1,
+      dynamics::BodyNode*& bodyNode2) const override;
+
   // Documentation inherited
   bool isActive() const override;
 
@@ -33,6 +33,7 @@
 #include "dart/constraint/DantzigBoxedLcpSolver.hpp"
 
 #include "dart/external/odelcpsolver/lcp.h"
+#include "dart/external/odelcpsolver/matrix.h"
 
 namespace dart {
 namespace constraint {
@@ -62,8 +63,33 @@ bool DantzigBoxedLcpSolver::solve(
     int* findex,
     bool earlyTermination)
 {
-  return external::ode::dSolveLCP(
+  // The kernel selection is per thread, so solvers with different settings
+  // can run concurrently.
+  const int previous
+      = external::ode::dSetSimdKernelsEnabled(mUseSimdKernels ? 1 : 0);
+  const bool success = external::ode::dSolveLCP(
       n, A, x, b, nullptr, 0, lo, hi, findex, earlyTermination);
+  external::ode::dSetSimdKernelsEnabled(previous);
+
+  return success;
+}
+
+//==============================================================================
+void DantzigBoxedLcpSolver::setUseSimdKernels(bool useSimdKernels)
+{
+  mUseSimdKernels = useSimdKernels;
+}
+
+//==============================================================================
+bool DantzigBoxedLcpSolver::getUseSimdKernels() const
+{
+  return mUseSimdKernels;
+}
+
+//==============================================================================
+bool DantzigBoxedLcpSolver::isSimdKernelSupported()
+{
+  return external::ode::dSimdKernelsSupported() != 0;
 }
 
 #ifndef NDEBUG
@@ -33,6 +33,7 @@
 #ifndef DART_CONSTRAINT_DANTZIGBOXEDLCPSOLVER_HPP_
 #define DART_CONSTRAINT_DANTZIGBOXEDLCPSOLVER_HPP_
 
+#include "dart/config.hpp"
 #include "dart/constraint/BoxedLcpSolver.hpp"
 
 namespace dart {
@@ -63,6 +64,23 @@ public:
   // Documentation inherited.
   bool canSolve(int n, const double* A) override;
 #endif
+
+  /// Sets whether solve() uses the SIMD (AVX2/NEON) factorization and
+  /// triangular solve kernels. They are faster from about 100 constraints on,
+  /// but their results differ from the scalar kernels by rounding. The scalar
+  /// kernels are used regardless when the CPU doesn't support the SIMD ones.
+  /// The default is DART_ENABLE_SIMD.
+  void setUseSimdKernels(bool useSimdKernels);
+
+  /// Returns whether solve() uses the SIMD kernels when they are supported.
+  bool getUseSimdKernels() const;
+
+  /// Returns true if the SIMD kernels are supported by this build and CPU.
+  static bool isSimdKernelSupported();
+
+protected:
+  /// Whether to use the SIMD kernels
+  bool mUseSimdKernels{DART_ENABLE_SIMD != 0};
 };
 
 } // namespace constraint
@@ -172,5 +172,15 @@ dynamics::BodyNode* JointConstraint::getBodyNode2() const
   return mBodyNode2;
 }
 
+//==============================================================================
+bool JointConstraint::getCoupledBodyNodes(
+    dynamics::BodyNode*& bodyNode1, dynamics::BodyNode*& bodyNode2) const
+{
+  bodyNode1 = mBodyNode1;
+  bodyNode2 = mBodyNode2;
+
+  return true;
+}
+
 } // namespace constraint
 } // namespace dart
@@ -90,6 +90,11 @@ public:
   /// Get the second BodyNode that this constraint is associated with
   dynamics::BodyNode* getBodyNode2() const;
 
+  // Documentation inherited
+  bool getCoupledBodyNodes(
+      dynamics::BodyNode*& bodyNode1,
+      dynamics::BodyNode*& bodyNode2) const override;
+
 protected:
   /// First body node
   dynamics::BodyNode* mBodyNode1;
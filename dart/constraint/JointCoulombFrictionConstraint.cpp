@@ -281,6 +281,16 @@ dynamics::SkeletonPtr JointCoulombFrictionConstraint::getRootSkeleton() const
   return mJoint->getSkeleton()->mUnionRootSkeleton.lock();
 }
 
+//==============================================================================
+bool JointCoulombFrictionConstraint::getCoupledBodyNodes(
+    dynamics::BodyNode*& bodyNode1, dynamics::BodyNode*& bodyNode2) const
+{
+  bodyNode1 = mBodyNode;
+  bodyNode2 = nullptr;
+
+  return true;
+}
+
 //==============================================================================
 bool JointCoulombFrictionConstraint::isActive() const
 {
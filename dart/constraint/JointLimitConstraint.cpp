@@ -460,6 +460,16 @@ dynamics::SkeletonPtr JointLimitConstraint::getRootSkeleton() const
   return mJoint->getSkeleton()->mUnionRootSkeleton.lock();
 }
 
+//==============================================================================
+bool JointLimitConstraint::getCoupledBodyNodes(
+    dynamics::BodyNode*& bodyNode1, dynamics::BodyNode*& bodyNode2) const
+{
+  bodyNode1 = mBodyNode;
+  bodyNode2 = nullptr;
+
+  return true;
+}
+
 //==============================================================================
 bool JointLimitConstraint::isActive() const
 {
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/constraint/LemkeBoxedLcpSolver.hpp"
+
+#include "dart/external/odelcpsolver/common.h"
+#include "dart/math/Constants.hpp"
+
+namespace dart {
+namespace constraint {
+
+//==============================================================================
+const std::string& LemkeBoxedLcpSolver::getType() const
+{
+  return getStaticType();
+}
+
+//==============================================================================
+const std::string& LemkeBoxedLcpSolver::getStaticType()
+{
+  static const std::string type = "LemkeBoxedLcpSolver";
+  return type;
+}
+
+//==============================================================================
+bool LemkeBoxedLcpSolver::solve(
+    int n,
+    double* A,
+    double* x,
+    double* b,
+    int nub,
+    double* lo,
+    double* hi,
+    int* findex,
+    bool /*earlyTermination*/)
+{
+  if (nub > 0)
+    return false;
+
+  for (int i = 0; i < n; ++i)
+  {
+    if (lo[i] != 0.0 || hi[i] != math::constantsd::inf() || findex[i] >= 0)
+      return false;
+  }
+
+  const int nskip = dPAD(n);
+
+  // A is stored by rows with the leading dimension nskip
+  mCacheM.resize(n, n);
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+      mCacheM(i, j) = A[nskip * i + j];
+  }
+  mCacheQ = -Eigen::Map<const Eigen::VectorXd>(b, n);
+
+  const int err = mSolver.solve(mCacheM, mCacheQ, mCacheZ, mWarmStart);
+  if (err != lcpsolver::LemkeSolver::SUCCESS)
+    return false;
+
+  Eigen::Map<Eigen::VectorXd>(x, n) = mCacheZ;
+
+  return true;
+}
+
+//==============================================================================
+int LemkeBoxedLcpSolver::getLastNumIterations() const
+{
+  return mSolver.getLastNumIterations();
+}
+
+#ifndef NDEBUG
+//==============================================================================
+bool LemkeBoxedLcpSolver::canSolve(int /*n*/, const double* /*A*/)
+{
+  // Whether the problem is supported depends on the bounds, which are checked
+  // in solve().
+  return true;
+}
+#endif
+
+//==============================================================================
+void LemkeBoxedLcpSolver::setOption(
+    const lcpsolver::LemkeSolver::Option& option)
+{
+  mSolver.setOption(option);
+}
+
+//==============================================================================
+const lcpsolver::LemkeSolver::Option& LemkeBoxedLcpSolver::getOption() const
+{
+  return mSolver.getOption();
+}
+
+//==============================================================================
+void LemkeBoxedLcpSolver::setWarmStart(bool warmStart)
+{
+  mWarmStart = warmStart;
+}
+
+//==============================================================================
+bool LemkeBoxedLcpSolver::getWarmStart() const
+{
+  return mWarmStart;
+}
+
+} // namespace constraint
+} // namespace dart
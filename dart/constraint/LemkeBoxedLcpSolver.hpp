@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_CONSTRAINT_LEMKEBOXEDLCPSOLVER_HPP_
+#define DART_CONSTRAINT_LEMKEBOXEDLCPSOLVER_HPP_
+
+#include "dart/constraint/BoxedLcpSolver.hpp"
+#include "dart/lcpsolver/LemkeSolver.hpp"
+
+namespace dart {
+namespace constraint {
+
+/// Adapter that solves pure complementarity problems with
+/// lcpsolver::LemkeSolver. A problem is supported when every variable has
+/// lo = 0, hi = inf and no friction index, i.e., 0 <= x, 0 <= w = A x - b and
+/// x^T w = 0. solve() returns false for any other problem, so this solver is
+/// meant as the primary solver with a general one, such as
+/// PgsBoxedLcpSolver, as the secondary solver.
+class LemkeBoxedLcpSolver : public BoxedLcpSolver
+{
+public:
+  // Documentation inherited.
+  const std::string& getType() const override;
+
+  /// Returns type for this class
+  static const std::string& getStaticType();
+
+  // Documentation inherited.
+  bool solve(
+      int n,
+      double* A,
+      double* x,
+      double* b,
+      int nub,
+      double* lo,
+      double* hi,
+      int* findex,
+      bool earlyTermination) override;
+
+  // Documentation inherited.
+  int getLastNumIterations() const override;
+
+#ifndef NDEBUG
+  // Documentation inherited.
+  bool canSolve(int n, const double* A) override;
+#endif
+
+  /// Sets options of the Lemke solver
+  void setOption(const lcpsolver::LemkeSolver::Option& option);
+
+  /// Returns options of the Lemke solver.
+  const lcpsolver::LemkeSolver::Option& getOption() const;
+
+  /// Sets whether to start from the final basis of the last problem of the
+  /// same dimension. This is on by default.
+  void setWarmStart(bool warmStart);
+
+  /// Returns whether to start from the final basis of the last problem.
+  bool getWarmStart() const;
+
+protected:
+  /// Lemke solver, which also keeps the workspaces and the last basis
+  lcpsolver::LemkeSolver mSolver;
+
+  /// Whether to warm start from the last basis
+  bool mWarmStart{true};
+
+  /// Cache of A in column-major order
+  Eigen::MatrixXd mCacheM;
+
+  /// Cache of -b
+  Eigen::VectorXd mCacheQ;
+
+  /// Cache of the solution
+  Eigen::VectorXd mCacheZ;
+};
+
+} // namespace constraint
+} // namespace dart
+
+#endif // DART_CONSTRAINT_LEMKEBOXEDLCPSOLVER_HPP_
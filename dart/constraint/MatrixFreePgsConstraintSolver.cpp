@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/constraint/MatrixFreePgsConstraintSolver.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "dart/common/Console.hpp"
+#include "dart/constraint/ConstraintBase.hpp"
+#include "dart/dynamics/DegreeOfFreedom.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+
+namespace dart {
+namespace constraint {
+
+//==============================================================================
+MatrixFreePgsConstraintSolver::Option::Option(
+    int maxIteration,
+    double deltaXThreshold,
+    double relaxation,
+    double epsilonForDivision)
+  : mMaxIteration(maxIteration),
+    mDeltaXThreshold(deltaXThreshold),
+    mRelaxation(relaxation),
+    mEpsilonForDivision(epsilonForDivision)
+{
+  // Do nothing
+}
+
+//==============================================================================
+MatrixFreePgsConstraintSolver::MatrixFreePgsConstraintSolver(
+    const Option& option)
+  : ConstraintSolver(), mOption(option), mLastNumIterations(0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+void MatrixFreePgsConstraintSolver::setOption(const Option& option)
+{
+  mOption = option;
+}
+
+//==============================================================================
+const MatrixFreePgsConstraintSolver::Option&
+MatrixFreePgsConstraintSolver::getOption() const
+{
+  return mOption;
+}
+
+//==============================================================================
+int MatrixFreePgsConstraintSolver::getLastNumIterations() const
+{
+  return mLastNumIterations;
+}
+
+//==============================================================================
+void MatrixFreePgsConstraintSolver::solveConstrainedGroup(
+    ConstrainedGroup& group)
+{
+  const std::size_t numConstraints = group.getNumConstraints();
+  const int n = static_cast<int>(group.getTotalDimension());
+
+  // If there is no constraint, then just return.
+  if (0 == n)
+    return;
+
+  // Assign the segments of the generalized velocity change vector to the
+  // skeletons
+  mSkeletonOffsets.clear();
+  int numDofs = 0;
+  for (std::size_t i = 0; i < group.getNumSkeletons(); ++i)
+  {
+    const auto& skeleton = group.getSkeleton(i);
+    mSkeletonOffsets[skeleton.get()] = numDofs;
+    numDofs += static_cast<int>(skeleton->getNumDofs());
+  }
+  mVelocityChanges.setZero(numDofs);
+
+  mX.resize(n);
+  mB.resize(n);
+  mW.setZero(n);
+  mLo.resize(n);
+  mHi.resize(n);
+  mFIndex.setConstant(n, -1);
+  mDiagonal.resize(n);
+  mCfm.resize(n);
+  mOffsets.resize(numConstraints);
+  mRowDataOffsets.resize(static_cast<std::size_t>(n));
+  mSegments.clear();
+  mSegmentBegins.clear();
+  mJacobians.clear();
+  mWeights.clear();
+
+  // Fill the constraint information and the row data of each constraint
+  ConstraintInfo constInfo;
+  constInfo.invTimeStep = 1.0 / mTimeStep;
+  int offset = 0;
+  for (std::size_t i = 0; i < numConstraints; ++i)
+  {
+    const ConstraintBasePtr& constraint = group.getConstraint(i);
+    mOffsets[i] = offset;
+
+    constInfo.x = mX.data() + offset;
+    constInfo.lo = mLo.data() + offset;
+    constInfo.hi = mHi.data() + offset;
+    constInfo.b = mB.data() + offset;
+    constInfo.findex = mFIndex.data() + offset;
+    constInfo.w = mW.data() + offset;
+    constraint->getInformation(&constInfo);
+
+    // Adjust findex for global index
+    for (std::size_t j = 0; j < constraint->getDimension(); ++j)
+    {
+      if (mFIndex[offset + j] >= 0)
+        mFIndex[offset + j] += offset;
+    }
+
+    computeRowData(group, i, offset);
+
+    offset += static_cast<int>(constraint->getDimension());
+  }
+  mSegmentBegins.push_back(static_cast<int>(mSegments.size()));
+
+  // Apply the initial guess to the velocity changes
+  for (std::size_t i = 0; i < numConstraints; ++i)
+  {
+    const auto dim = group.getConstraint(i)->getDimension();
+    for (std::size_t j = 0; j < dim; ++j)
+    {
+      const int row = mOffsets[i] + static_cast<int>(j);
+      if (mX[row] == 0.0)
+        continue;
+
+      int data = mRowDataOffsets[row];
+      for (int s = mSegmentBegins[i]; s < mSegmentBegins[i + 1]; ++s)
+      {
+        const auto& segment = mSegments[s];
+        mVelocityChanges.segment(segment.first, segment.second)
+            += mX[row]
+               * Eigen::Map<const Eigen::VectorXd>(
+                   mWeights.data() + data, segment.second);
+        data += segment.second;
+      }
+    }
+  }
+
+  // Projected Gauss-Seidel iterations
+  mLastNumIterations = 0;
+  for (int iter = 0; iter < mOption.mMaxIteration; ++iter)
+  {
+    double maxDeltaX = 0.0;
+
+    for (std::size_t i = 0; i < numConstraints; ++i)
+    {
+      const auto dim = group.getConstraint(i)->getDimension();
+      for (std::size_t j = 0; j < dim; ++j)
+      {
+        const int row = mOffsets[i] + static_cast<int>(j);
+        const double diagonal = mDiagonal[row];
+        if (diagonal < mOption.mEpsilonForDivision)
+          continue;
+
+        double lo = mLo[row];
+        double hi = mHi[row];
+        if (mFIndex[row] >= 0)
+        {
+          hi = std::abs(mHi[row] * mX[mFIndex[row]]);
+          lo = -hi;
+        }
+
+        // Compute the row of (A * x - b) from the velocity changes
+        double w = mCfm[row] * mX[row] - mB[row];
+        int data = mRowDataOffsets[row];
+        for (int s = mSegmentBegins[i]; s < mSegmentBegins[i + 1]; ++s)
+        {
+          const auto& segment = mSegments[s];
+          w += Eigen::Map<const Eigen::VectorXd>(
+                   mJacobians.data() + data, segment.second)
+                   .dot(mVelocityChanges.segment(
+                       segment.first, segment.second));
+          data += segment.second;
+        }
+
+        const double newX = std::min(
+            std::max(mX[row] - mOption.mRelaxation * w / diagonal, lo), hi);
+        const double deltaX = newX - mX[row];
+        if (deltaX == 0.0)
+          continue;
+
+        mX[row] = newX;
+        maxDeltaX = std::max(maxDeltaX, std::abs(deltaX));
+
+        // Apply the impulse change to the velocity changes
+        data = mRowDataOffsets[row];
+        for (int s = mSegmentBegins[i]; s < mSegmentBegins[i + 1]; ++s)
+        {
+          const auto& segment = mSegments[s];
+          mVelocityChanges.segment(segment.first, segment.second)
+              += deltaX
+                 * Eigen::Map<const Eigen::VectorXd>(
+                     mWeights.data() + data, segment.second);
+          data += segment.second;
+        }
+      }
+    }
+
+    mLastNumIterations = iter + 1;
+    if (maxDeltaX < mOption.mDeltaXThreshold)
+      break;
+  }
+
+  if (mX.hasNaN())
+  {
+    dterr << "[MatrixFreePgsConstraintSolver] The solution includes NAN "
+          << "values: " << mX.transpose() << ". We're setting it zero for "
+          << "safety.\n";
+    mX.setZero();
+  }
+
+  // Apply constraint impulses
+  for (std::size_t i = 0; i < numConstraints; ++i)
+  {
+    const ConstraintBasePtr& constraint = group.getConstraint(i);
+    constraint->applyImpulse(mX.data() + mOffsets[i]);
+    constraint->excite();
+  }
+}
+
+//==============================================================================
+void MatrixFreePgsConstraintSolver::computeRowData(
+    ConstrainedGroup& group, std::size_t constraintIndex, int rowOffset)
+{
+  const ConstraintBasePtr& constraint = group.getConstraint(constraintIndex);
+  const auto dim = constraint->getDimension();
+
+  // Find the skeletons that the constraint acts on, which are flagged by
+  // exciting the constraint.
+  constraint->excite();
+  mAffectedSkeletons.clear();
+  mSegmentBegins.push_back(static_cast<int>(mSegments.size()));
+  int size = 0;
+  for (std::size_t i = 0; i < group.getNumSkeletons(); ++i)
+  {
+    dynamics::Skeleton* skeleton = group.getSkeleton(i).get();
+    if (!skeleton->isImpulseApplied())
+      continue;
+
+    const int numDofs = static_cast<int>(skeleton->getNumDofs());
+    mAffectedSkeletons.push_back(skeleton);
+    mSegments.emplace_back(mSkeletonOffsets[skeleton], numDofs);
+    size += numDofs;
+  }
+
+  mVelocityChangeCache.resize(static_cast<int>(dim));
+  for (std::size_t j = 0; j < dim; ++j)
+  {
+    const int row = rowOffset + static_cast<int>(j);
+    const auto data = mJacobians.size();
+    mRowDataOffsets[row] = static_cast<int>(data);
+    mJacobians.resize(data + size);
+    mWeights.resize(data + size);
+
+    // The impulse test gives the generalized velocity change W = M^-1 * J^T,
+    // from which J^T = M * W is recovered. The degrees of freedom that don't
+    // respond to impulses have zero velocity changes, so their terms in J
+    // don't contribute.
+    constraint->applyUnitImpulse(j);
+    constraint->getVelocityChange(mVelocityChangeCache.data(), true);
+
+    double* weights = mWeights.data() + data;
+    double* jacobians = mJacobians.data() + data;
+    double diagonalWithoutCfm = 0.0;
+    for (auto* skeleton : mAffectedSkeletons)
+    {
+      const int numDofs = static_cast<int>(skeleton->getNumDofs());
+      Eigen::Map<Eigen::VectorXd> W(weights, numDofs);
+      Eigen::Map<Eigen::VectorXd> J(jacobians, numDofs);
+      for (int k = 0; k < numDofs; ++k)
+        W[k] = skeleton->getDof(k)->getVelocityChange();
+      J.noalias() = skeleton->getMassMatrix() * W;
+      diagonalWithoutCfm += J.dot(W);
+
+      weights += numDofs;
+      jacobians += numDofs;
+    }
+
+    mDiagonal[row] = mVelocityChangeCache[j];
+    mCfm[row] = mDiagonal[row] - diagonalWithoutCfm;
+  }
+
+  constraint->unexcite();
+}
+
+} // namespace constraint
+} // namespace dart
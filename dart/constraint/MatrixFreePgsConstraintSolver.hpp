@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_CONSTRAINT_MATRIXFREEPGSCONSTRAINTSOLVER_HPP_
+#define DART_CONSTRAINT_MATRIXFREEPGSCONSTRAINTSOLVER_HPP_
+
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/constraint/ConstraintSolver.hpp"
+
+namespace dart {
+namespace constraint {
+
+/// MatrixFreePgsConstraintSolver solves the constrained groups with projected
+/// Gauss-Seidel (PGS) iterations without building the dense LCP matrix A.
+///
+/// For each constraint row, the solver stores the generalized Jacobian row J
+/// and the generalized velocity change W = M^-1 * J^T of the skeletons that
+/// the row acts on, both obtained from a single impulse test of the row. The
+/// iterations then apply the impulse updates incrementally to the generalized
+/// velocity changes of the skeletons (sequential impulses), so the memory and
+/// the cost per iteration are linear in the number of the constraints rather
+/// than quadratic. The friction bounds are scaled by the normal impulses using
+/// the friction indices in the same manner as BoxedLcpSolver.
+class MatrixFreePgsConstraintSolver : public ConstraintSolver
+{
+public:
+  struct Option
+  {
+    /// Maximum number of the iterations
+    int mMaxIteration;
+
+    /// The iterations terminate when the largest change of the impulses in
+    /// an iteration is smaller than this value
+    double mDeltaXThreshold;
+
+    /// Relaxation factor of the impulse updates. Values greater than one
+    /// correspond to the successive over-relaxation.
+    double mRelaxation;
+
+    /// Diagonal terms smaller than this value are treated as singular, and
+    /// the corresponding rows are skipped
+    double mEpsilonForDivision;
+
+    Option(
+        int maxIteration = 30,
+        double deltaXThreshold = 1e-6,
+        double relaxation = 1.0,
+        double epsilonForDivision = 1e-9);
+  };
+
+  /// Constructor
+  explicit MatrixFreePgsConstraintSolver(const Option& option = Option());
+
+  /// Sets options
+  void setOption(const Option& option);
+
+  /// Returns options
+  const Option& getOption() const;
+
+  /// Returns the number of iterations taken to solve the last constrained
+  /// group
+  int getLastNumIterations() const;
+
+protected:
+  // Documentation inherited.
+  void solveConstrainedGroup(ConstrainedGroup& group) override;
+
+  /// Computes J and W of all the rows of the constraint
+  void computeRowData(
+      ConstrainedGroup& group, std::size_t constraintIndex, int rowOffset);
+
+  /// Solver options
+  Option mOption;
+
+  /// Number of iterations taken to solve the last constrained group
+  int mLastNumIterations;
+
+  /// Offsets of the skeletons in the generalized velocity change vector
+  std::unordered_map<const dynamics::Skeleton*, int> mSkeletonOffsets;
+
+  /// Generalized velocity changes of the skeletons in the group
+  Eigen::VectorXd mVelocityChanges;
+
+  /// Segments of the generalized velocity change vector that each constraint
+  /// acts on, stored as (offset, size) pairs
+  std::vector<std::pair<int, int>> mSegments;
+
+  /// Index to the first segment of each constraint. The last element is the
+  /// total number of the segments.
+  std::vector<int> mSegmentBegins;
+
+  /// Offset of the J and W terms of each row in mJacobians and mWeights
+  std::vector<int> mRowDataOffsets;
+
+  /// Generalized Jacobian rows of the constraints
+  std::vector<double> mJacobians;
+
+  /// Generalized velocity changes due to unit impulses of the rows
+  std::vector<double> mWeights;
+
+  /// Diagonal terms of A including constraint force mixing
+  Eigen::VectorXd mDiagonal;
+
+  /// Constraint force mixing terms added to the diagonal of A
+  Eigen::VectorXd mCfm;
+
+  /// Offsets of the constraints in the rows
+  std::vector<int> mOffsets;
+
+  /// Cache data for the constraint information
+  Eigen::VectorXd mX;
+
+  /// Cache data for the constraint information
+  Eigen::VectorXd mB;
+
+  /// Cache data for the constraint information
+  Eigen::VectorXd mW;
+
+  /// Cache data for the constraint information
+  Eigen::VectorXd mLo;
+
+  /// Cache data for the constraint information
+  Eigen::VectorXd mHi;
+
+  /// Cache data for the constraint information
+  Eigen::VectorXi mFIndex;
+
+  /// Cache data for the velocity changes of the impulse tests
+  Eigen::VectorXd mVelocityChangeCache;
+
+  /// Cache data for the skeletons affected by a constraint
+  std::vector<dynamics::Skeleton*> mAffectedSkeletons;
+};
+
+} // namespace constraint
+} // namespace dart
+
+#endif // DART_CONSTRAINT_MATRIXFREEPGSCONSTRAINTSOLVER_HPP_
@@ -292,6 +292,16 @@ dynamics::SkeletonPtr MimicMotorConstraint::getRootSkeleton() const
   return mJoint->getSkeleton()->mUnionRootSkeleton.lock();
 }
 
+//==============================================================================
+bool MimicMotorConstraint::getCoupledBodyNodes(
+    dynamics::BodyNode*& bodyNode1, dynamics::BodyNode*& bodyNode2) const
+{
+  bodyNode1 = mBodyNode;
+  bodyNode2 = nullptr;
+
+  return true;
+}
+
 //==============================================================================
 bool MimicMotorConstraint::isActive() const
 {
@@ -110,6 +110,11 @@ protected:
   // Documentation inherited
   dynamics::SkeletonPtr getRootSkeleton() const override;
 
+  // Documentation inherited
+  bool getCoupledBodyNodes(
+      dynamics::BodyNode*& bodyNode1,
+      dynamics::BodyNode*& bodyNode2) const override;
+
   // Documentation inherited
   bool isActive() const override;
 
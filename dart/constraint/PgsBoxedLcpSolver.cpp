@@ -87,6 +87,8 @@ bool PgsBoxedLcpSolver::solve(
 {
   const int nskip = dPAD(n);
 
+  mLastNumIterations = 1;
+
   // If all the variables are unbounded then we can just factor, solve, and
   // return.R
   if (nub >= n)
@@ -177,6 +179,8 @@ bool PgsBoxedLcpSolver::solve(
 
   for (int iter = 1; iter < mOption.mMaxIteration; ++iter)
   {
+    ++mLastNumIterations;
+
     if (mOption.mRandomizeConstraintOrder)
     {
       if ((iter & 7) == 0)
@@ -244,6 +248,12 @@ bool PgsBoxedLcpSolver::solve(
   return possibleToTerminate;
 }
 
+//==============================================================================
+int PgsBoxedLcpSolver::getLastNumIterations() const
+{
+  return mLastNumIterations;
+}
+
 #ifndef NDEBUG
 //==============================================================================
 bool PgsBoxedLcpSolver::canSolve(int n, const double* A)
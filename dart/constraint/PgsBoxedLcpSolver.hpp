@@ -77,6 +77,9 @@ public:
       int* findex,
       bool earlyTermination) override;
 
+  // Documentation inherited.
+  int getLastNumIterations() const override;
+
 #ifndef NDEBUG
   // Documentation inherited.
   bool canSolve(int n, const double* A) override;
@@ -97,6 +100,9 @@ protected:
   mutable Eigen::MatrixXd mCachedNormalizedB;
   mutable Eigen::VectorXd mCacheZ;
   mutable Eigen::VectorXd mCacheOldX;
+
+  /// Number of iterations taken by the last call of solve()
+  int mLastNumIterations{0};
 };
 
 } // namespace constraint
@@ -283,6 +283,16 @@ dynamics::SkeletonPtr ServoMotorConstraint::getRootSkeleton() const
   return mJoint->getSkeleton()->mUnionRootSkeleton.lock();
 }
 
+//==============================================================================
+bool ServoMotorConstraint::getCoupledBodyNodes(
+    dynamics::BodyNode*& bodyNode1, dynamics::BodyNode*& bodyNode2) const
+{
+  bodyNode1 = mBodyNode;
+  bodyNode2 = nullptr;
+
+  return true;
+}
+
 //==============================================================================
 bool ServoMotorConstraint::isActive() const
 {
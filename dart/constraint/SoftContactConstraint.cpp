@@ -934,6 +934,16 @@ void SoftContactConstraint::getRelVelocity(double* _vel)
   }
 }
 
+//==============================================================================
+bool SoftContactConstraint::getCoupledBodyNodes(
+    dynamics::BodyNode*& bodyNode1, dynamics::BodyNode*& bodyNode2) const
+{
+  bodyNode1 = mBodyNode1;
+  bodyNode2 = mBodyNode2;
+
+  return true;
+}
+
 //==============================================================================
 bool SoftContactConstraint::isActive() const
 {
@@ -142,6 +142,11 @@ protected:
   // Documentation inherited
   void uniteSkeletons() override;
 
+  // Documentation inherited
+  bool getCoupledBodyNodes(
+      dynamics::BodyNode*& bodyNode1,
+      dynamics::BodyNode*& bodyNode2) const override;
+
   // Documentation inherited
   bool isActive() const override;
 
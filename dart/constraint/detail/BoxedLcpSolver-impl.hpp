@@ -44,6 +44,11 @@ bool BoxedLcpSolver::is() const
   return getType() == BoxedLcpSolverT::getStaticType();
 }
 
+inline int BoxedLcpSolver::getLastNumIterations() const
+{
+  return 0;
+}
+
 } // namespace constraint
 } // namespace dart
 
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/dynamics/BatchInverseKinematics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "dart/dynamics/BodyNode.hpp"
+#include "dart/dynamics/DegreeOfFreedom.hpp"
+#include "dart/dynamics/EndEffector.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+#include "dart/math/Constants.hpp"
+#include "dart/optimizer/GradientDescentSolver.hpp"
+
+namespace dart {
+namespace dynamics {
+
+//==============================================================================
+BatchInverseKinematics::BatchInverseKinematics(
+    const InverseKinematicsPtr& ik, std::size_t numThreads)
+  : mIK(ik),
+    mNumThreads(
+        numThreads > 0u ? numThreads
+                        : common::ThreadPool::getHardwareConcurrency()),
+    mSourceVersion(0u)
+{
+  assert(mIK);
+
+  if (mNumThreads > 1u)
+    mThreadPool.reset(new common::ThreadPool(mNumThreads));
+}
+
+//==============================================================================
+const InverseKinematicsPtr& BatchInverseKinematics::getIK() const
+{
+  return mIK;
+}
+
+//==============================================================================
+std::size_t BatchInverseKinematics::getNumThreads() const
+{
+  return mNumThreads;
+}
+
+//==============================================================================
+std::size_t BatchInverseKinematics::solve(
+    const common::aligned_vector<Eigen::Isometry3d>& targets,
+    Eigen::MatrixXd& solutions,
+    std::vector<char>& successes)
+{
+  updateReplicas();
+
+  const std::size_t numTargets = targets.size();
+  solutions.resize(
+      static_cast<int>(mIK->getDofs().size()), static_cast<int>(numTargets));
+  successes.assign(numTargets, 0);
+
+  parallelFor(numTargets, [&](std::size_t index, std::size_t threadIndex) {
+    Replica& replica = mReplicas[threadIndex];
+    replica.mTarget->setTransform(targets[index]);
+
+    Eigen::VectorXd solution;
+    successes[index] = replica.mIK->findSolution(solution) ? 1 : 0;
+    solutions.col(static_cast<int>(index)) = solution;
+  });
+
+  return static_cast<std::size_t>(
+      std::count(successes.begin(), successes.end(), 1));
+}
+
+//==============================================================================
+bool BatchInverseKinematics::solveWithParallelAttempts(
+    const Eigen::Isometry3d& target,
+    std::size_t numAttempts,
+    Eigen::VectorXd& solution)
+{
+  updateReplicas();
+
+  for (auto& replica : mReplicas)
+  {
+    replica.mTarget->setTransform(target);
+
+    auto solver = std::dynamic_pointer_cast<optimizer::GradientDescentSolver>(
+        replica.mIK->getSolver());
+    if (solver)
+      solver->setMaxAttempts(1u);
+  }
+
+  const auto& seeds = mIK->getProblem()->getSeeds();
+  const Eigen::VectorXd initialPositions = mIK->getPositions();
+  const auto numDofs = static_cast<int>(mIK->getDofs().size());
+  Eigen::MatrixXd solutions(numDofs, static_cast<int>(numAttempts));
+  std::atomic<std::size_t> firstSuccess(numAttempts);
+
+  parallelFor(numAttempts, [&](std::size_t index, std::size_t threadIndex) {
+    if (firstSuccess.load() < index)
+      return;
+
+    Replica& replica = mReplicas[threadIndex];
+    if (index == 0u)
+      replica.mIK->setPositions(initialPositions);
+    else if (index - 1u < seeds.size())
+      replica.mIK->setPositions(seeds[index - 1u]);
+    else
+      randomizePositions(replica);
+
+    Eigen::VectorXd attemptSolution;
+    const bool solved = replica.mIK->findSolution(attemptSolution);
+    replica.mIK->setPositions(initialPositions);
+    solutions.col(static_cast<int>(index)) = attemptSolution;
+
+    if (!solved)
+      return;
+
+    std::size_t current = firstSuccess.load();
+    while (index < current
+           && !firstSuccess.compare_exchange_weak(current, index))
+    {
+      // Retry with the updated value
+    }
+  });
+
+  if (firstSuccess.load() < numAttempts)
+  {
+    solution = solutions.col(static_cast<int>(firstSuccess.load()));
+    return true;
+  }
+
+  if (numAttempts > 0u)
+    solution = solutions.col(static_cast<int>(numAttempts) - 1);
+  else
+    solution = initialPositions;
+
+  return false;
+}
+
+//==============================================================================
+void BatchInverseKinematics::updateReplicas()
+{
+  const SkeletonPtr source = mIK->getNode()->getSkeleton();
+
+  if (mReplicas.size() != mNumThreads
+      || source->getVersion() != mSourceVersion)
+  {
+    std::random_device randomDevice;
+
+    mReplicas.clear();
+    mReplicas.resize(mNumThreads);
+    for (auto& replica : mReplicas)
+    {
+      replica.mSkeleton = source->cloneSkeleton();
+      replica.mTarget = SimpleFrame::createShared(Frame::World());
+      replica.mRandomEngine.seed(randomDevice());
+    }
+
+    mSourceVersion = source->getVersion();
+  }
+
+  const Eigen::VectorXd positions = source->getPositions();
+  for (auto& replica : mReplicas)
+  {
+    replica.mSkeleton->setPositions(positions);
+    replica.mIK = mIK->clone(getReplicaNode(replica.mSkeleton));
+    replica.mIK->setTarget(replica.mTarget);
+  }
+}
+
+//==============================================================================
+JacobianNode* BatchInverseKinematics::getReplicaNode(
+    const SkeletonPtr& replica) const
+{
+  JacobianNode* node = mIK->getNode();
+
+  if (auto* bodyNode = dynamic_cast<BodyNode*>(node))
+    return replica->getBodyNode(bodyNode->getIndexInSkeleton());
+
+  if (auto* endEffector = dynamic_cast<EndEffector*>(node))
+    return replica->getEndEffector(endEffector->getIndexInSkeleton());
+
+  dterr << "[BatchInverseKinematics] The IK module is attached to ["
+        << node->getName() << "], which is neither a BodyNode nor an "
+        << "EndEffector. This is not supported.\n";
+  assert(false);
+  return nullptr;
+}
+
+//==============================================================================
+void BatchInverseKinematics::randomizePositions(Replica& replica) const
+{
+  // Unbounded positions, e.g., of revolute joints without limits, are
+  // randomized around the current positions like GradientDescentSolver does
+  double maxStep = math::constantsd::pi();
+  auto solver = std::dynamic_pointer_cast<optimizer::GradientDescentSolver>(
+      mIK->getSolver());
+  if (solver)
+  {
+    maxStep = std::min(
+        maxStep, solver->getGradientDescentProperties().mMaxRandomizationStep);
+  }
+
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  const std::vector<std::size_t>& dofs = replica.mIK->getDofs();
+  for (const std::size_t index : dofs)
+  {
+    DegreeOfFreedom* dof = replica.mSkeleton->getDof(index);
+    double lower = dof->getPositionLowerLimit();
+    double step = dof->getPositionUpperLimit() - lower;
+    if (step > 2.0 * maxStep)
+    {
+      step = 2.0 * maxStep;
+      lower = dof->getPosition() - maxStep;
+    }
+
+    dof->setPosition(lower + step * distribution(replica.mRandomEngine));
+  }
+}
+
+//==============================================================================
+void BatchInverseKinematics::parallelFor(
+    std::size_t size, const common::ThreadPool::IndexFunction& func)
+{
+  if (mThreadPool)
+  {
+    mThreadPool->parallelFor(size, func);
+    return;
+  }
+
+  for (std::size_t i = 0u; i < size; ++i)
+    func(i, 0u);
+}
+
+} // namespace dynamics
+} // namespace dart
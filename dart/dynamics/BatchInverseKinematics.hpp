@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_DYNAMICS_BATCHINVERSEKINEMATICS_HPP_
+#define DART_DYNAMICS_BATCHINVERSEKINEMATICS_HPP_
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/common/Memory.hpp"
+#include "dart/common/ThreadPool.hpp"
+#include "dart/dynamics/InverseKinematics.hpp"
+#include "dart/dynamics/SimpleFrame.hpp"
+
+namespace dart {
+namespace dynamics {
+
+/// BatchInverseKinematics solves an InverseKinematics module for many targets
+/// concurrently.
+///
+/// InverseKinematics evaluates its objectives by setting the positions of its
+/// Skeleton, so it can't be used by several threads at once. This class keeps a
+/// replica of the Skeleton for each thread, on which the IK module is cloned,
+/// so each thread solves its share of the targets independently. The replicas
+/// are cloned again whenever the version of the source Skeleton changes, e.g.,
+/// when its structure or joint limits change, and the IK module is cloned
+/// again for every call, so changes of the source IK module are always picked
+/// up.
+///
+/// Every solve starts from the positions that the source Skeleton has when
+/// solve() is called. The source Skeleton is never modified.
+class BatchInverseKinematics
+{
+public:
+  /// Constructor. If numThreads is zero, the number of hardware threads is
+  /// used.
+  explicit BatchInverseKinematics(
+      const InverseKinematicsPtr& ik, std::size_t numThreads = 0u);
+
+  /// Return the source IK module
+  const InverseKinematicsPtr& getIK() const;
+
+  /// Return the number of threads, which is the number of the replicas
+  std::size_t getNumThreads() const;
+
+  /// Solve the IK module for each target, which is the desired transform of
+  /// the node of the IK module with respect to the world frame. The attempts
+  /// of each target are made as configured in the solver of the source IK
+  /// module.
+  ///
+  /// \param[in] targets Desired world transforms of the node
+  /// \param[out] solutions Positions of the IK degrees of freedom, one column
+  /// per target. The columns of the failed targets hold the final positions of
+  /// the last attempt.
+  /// \param[out] successes One for each target that was solved, zero otherwise
+  /// \return Number of the solved targets
+  std::size_t solve(
+      const common::aligned_vector<Eigen::Isometry3d>& targets,
+      Eigen::MatrixXd& solutions,
+      std::vector<char>& successes);
+
+  /// Solve the IK module for a single target by running numAttempts attempts
+  /// in parallel, each of which makes a single attempt with the solver. The
+  /// first attempt starts from the current positions of the source Skeleton,
+  /// the following ones from the seeds of the IK problem and then from random
+  /// positions within the position limits.
+  ///
+  /// Attempts that haven't started yet are skipped once an attempt with a
+  /// lower index succeeds, and the solution of the successful attempt with the
+  /// lowest index is returned.
+  ///
+  /// \return True if one of the attempts succeeded
+  bool solveWithParallelAttempts(
+      const Eigen::Isometry3d& target,
+      std::size_t numAttempts,
+      Eigen::VectorXd& solution);
+
+protected:
+  /// Skeleton replica and IK module used by a single thread
+  struct Replica
+  {
+    /// Clone of the source Skeleton
+    SkeletonPtr mSkeleton;
+
+    /// Clone of the source IK module on mSkeleton
+    InverseKinematicsPtr mIK;
+
+    /// Target frame of mIK
+    SimpleFramePtr mTarget;
+
+    /// Random number generator for the random starting positions
+    std::mt19937 mRandomEngine;
+  };
+
+  /// Clone the replicas if the source Skeleton has changed, clone the IK
+  /// module onto them, and copy the positions of the source Skeleton
+  void updateReplicas();
+
+  /// Return the node of a Skeleton replica that corresponds to the node of
+  /// the source IK module
+  JacobianNode* getReplicaNode(const SkeletonPtr& replica) const;
+
+  /// Set random positions to the IK degrees of freedom of a replica
+  void randomizePositions(Replica& replica) const;
+
+  /// Run func for each index in [0, size) on the thread pool, or serially if
+  /// there is a single thread
+  void parallelFor(
+      std::size_t size, const common::ThreadPool::IndexFunction& func);
+
+  /// Source IK module
+  InverseKinematicsPtr mIK;
+
+  /// Number of threads
+  std::size_t mNumThreads;
+
+  /// ThreadPool, which is null if there is a single thread
+  std::unique_ptr<common::ThreadPool> mThreadPool;
+
+  /// Replicas, one per thread
+  std::vector<Replica> mReplicas;
+
+  /// Version of the source Skeleton when the replicas were cloned
+  std::size_t mSourceVersion;
+};
+
+} // namespace dynamics
+} // namespace dart
+
+#endif // DART_DYNAMICS_BATCHINVERSEKINEMATICS_HPP_
@@ -235,7 +235,8 @@ BodyNodeAspectProperties::BodyNodeAspectProperties(
     mIsCollidable(_isCollidable),
     mFrictionCoeff(_frictionCoeff),
     mRestitutionCoeff(_restitutionCoeff),
-    mGravityMode(_gravityMode)
+    mGravityMode(_gravityMode),
+    mEnabledContinuousCollisionCheck(false)
 {
   // Do nothing
 }
@@ -245,13 +246,15 @@ BodyNodeAspectProperties::BodyNodeAspectProperties(
     const std::string& name,
     const Inertia& inertia,
     bool isCollidable,
-    bool gravityMode)
+    bool gravityMode,
+    bool enabledContinuousCollisionCheck)
   : mName(name),
     mInertia(inertia),
     mIsCollidable(isCollidable),
     mFrictionCoeff(DART_DEFAULT_FRICTION_COEFF),
     mRestitutionCoeff(DART_DEFAULT_RESTITUTION_COEFF),
-    mGravityMode(gravityMode)
+    mGravityMode(gravityMode),
+    mEnabledContinuousCollisionCheck(enabledContinuousCollisionCheck)
 {
   // Do nothing
 }
@@ -342,6 +345,7 @@ void BodyNode::setAspectProperties(const AspectProperties& properties)
   setName(properties.mName);
   setInertia(properties.mInertia);
   setGravityMode(properties.mGravityMode);
+  setContinuousCollisionCheck(properties.mEnabledContinuousCollisionCheck);
   DART_SUPPRESS_DEPRECATED_BEGIN
   setFrictionCoeff(properties.mFrictionCoeff);
   setRestitutionCoeff(properties.mRestitutionCoeff);
@@ -490,6 +494,18 @@ void BodyNode::setCollidable(bool _isCollidable)
   mAspectProperties.mIsCollidable = _isCollidable;
 }
 
+//==============================================================================
+void BodyNode::setContinuousCollisionCheck(bool enabled)
+{
+  mAspectProperties.mEnabledContinuousCollisionCheck = enabled;
+}
+
+//==============================================================================
+bool BodyNode::getContinuousCollisionCheck() const
+{
+  return mAspectProperties.mEnabledContinuousCollisionCheck;
+}
+
 //==============================================================================
 void checkMass(const BodyNode& bodyNode, const double mass)
 {
@@ -2037,7 +2053,8 @@ Eigen::Vector3d BodyNode::getAngularMomentum(const Eigen::Vector3d& _pivot)
 bool BodyNode::isReactive() const
 {
   const ConstSkeletonPtr& skel = getSkeleton();
-  if (skel && skel->isMobile() && getNumDependentGenCoords() > 0)
+  if (skel && skel->isMobile() && !skel->isSleeping()
+      && getNumDependentGenCoords() > 0)
   {
     // Check if all the ancestor joints are motion prescribed.
     const BodyNode* body = this;
@@ -171,6 +171,18 @@ public:
   /// \param[in] _isCollidable True to enable collisions
   void setCollidable(bool _isCollidable);
 
+  /// Set whether the collision shapes of this body node are swept along their
+  /// motion within a time step so that the collisions of this body are
+  /// detected even if it passes through thin objects in a single step. This is
+  /// meant for small fast bodies; only the collision detectors that support
+  /// continuous collision checking use it (see
+  /// collision::CollisionOption::continuousCollisionTimeStep).
+  void setContinuousCollisionCheck(bool enabled);
+
+  /// Return true if continuous collision checking is enabled for this body
+  /// node
+  bool getContinuousCollisionCheck() const;
+
   /// Set the mass of the bodynode
   void setMass(double mass);
 
@@ -730,8 +742,8 @@ public:
 
   /// Return true if the body can react to force or constraint impulse.
   ///
-  /// A body node is reactive if the skeleton is mobile and the number of
-  /// dependent generalized coordinates is non zero.
+  /// A body node is reactive if the skeleton is mobile and not sleeping, and
+  /// the number of dependent generalized coordinates is non zero.
   bool isReactive() const;
 
   /// Set constraint impulse
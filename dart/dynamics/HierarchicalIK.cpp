@@ -30,6 +30,9 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <limits>
+
 #include "dart/dynamics/HierarchicalIK.hpp"
 #include "dart/dynamics/BodyNode.hpp"
 #include "dart/dynamics/DegreeOfFreedom.hpp"
@@ -322,13 +325,18 @@ const std::vector<Eigen::MatrixXd>& HierarchicalIK::computeNullSpaces() const
         mJacCache.block<6, 1>(0, k) = J.block<6, 1>(0, d);
       }
 
-      mSVDCache.compute(mJacCache, Eigen::ComputeFullV);
-      math::extractNullSpace(mSVDCache, mPartialNullspaceCache);
+      // The null space projector of the Jacobian is I - V V^T, where the
+      // columns of V are the right singular vectors of its nonzero singular
+      // values, so the thin decomposition is enough
+      mSVDCache.setThreshold(1e-10);
+      mSVDCache.compute(mJacCache, Eigen::ComputeThinV);
+      const int rank = static_cast<int>(mSVDCache.rank());
 
-      if (mPartialNullspaceCache.rows() > 0
-          && mPartialNullspaceCache.cols() > 0)
+      if (rank < static_cast<int>(nDofs))
       {
-        NS *= mPartialNullspaceCache * mPartialNullspaceCache.transpose();
+        const auto V = mSVDCache.matrixV().leftCols(rank);
+        mPartialNullspaceCache.noalias() = NS * V;
+        NS.noalias() -= mPartialNullspaceCache * V.transpose();
       }
       else
       {
@@ -343,6 +351,18 @@ const std::vector<Eigen::MatrixXd>& HierarchicalIK::computeNullSpaces() const
   return mNullSpaceCache;
 }
 
+//==============================================================================
+void HierarchicalIK::setImplicitNullSpaceProjection(bool implicit)
+{
+  mImplicitNullSpaceProjection = implicit;
+}
+
+//==============================================================================
+bool HierarchicalIK::isImplicitNullSpaceProjectionEnabled() const
+{
+  return mImplicitNullSpaceProjection;
+}
+
 //==============================================================================
 Eigen::VectorXd HierarchicalIK::getPositions() const
 {
@@ -456,11 +476,11 @@ void HierarchicalIK::Objective::evalGradient(
 
     hik->setPositions(_x);
 
-    const std::vector<Eigen::MatrixXd>& nullspaces = hik->computeNullSpaces();
-    if (nullspaces.size() > 0)
+    const std::size_t numLevels = hik->updateNullSpaceProjection();
+    if (numLevels > 0)
     {
       // Project through the deepest null space
-      mGradCache = nullspaces.back() * mGradCache;
+      hik->projectToNullSpace(numLevels - 1, mGradCache);
     }
 
     _grad += mGradCache;
@@ -510,12 +530,12 @@ double HierarchicalIK::Constraint::eval(const Eigen::VectorXd& _x)
         continue;
 
       const std::vector<std::size_t>& dofs = ik->getDofs();
-      Eigen::VectorXd q(dofs.size());
+      mPositionCache.resize(dofs.size());
       for (std::size_t k = 0; k < dofs.size(); ++k)
-        q[k] = _x[dofs[k]];
+        mPositionCache[k] = _x[dofs[k]];
 
       InverseKinematics::ErrorMethod& method = ik->getErrorMethod();
-      const Eigen::Vector6d& error = method.evalError(q);
+      const Eigen::Vector6d& error = method.evalError(mPositionCache);
 
       cost += error.dot(error);
     }
@@ -533,7 +553,7 @@ void HierarchicalIK::Constraint::evalGradient(
   const IKHierarchy& hierarchy = hik->getIKHierarchy();
   const SkeletonPtr& skel = hik->getSkeleton();
   const std::size_t nDofs = skel->getNumDofs();
-  const std::vector<Eigen::MatrixXd>& nullspaces = hik->computeNullSpaces();
+  hik->updateNullSpaceProjection();
 
   _grad.setZero();
   for (std::size_t i = 0; i < hierarchy.size(); ++i)
@@ -551,9 +571,9 @@ void HierarchicalIK::Constraint::evalGradient(
 
       // Grab only the dependent coordinates from q
       const std::vector<std::size_t>& dofs = ik->getDofs();
-      Eigen::VectorXd q(dofs.size());
+      mPositionCache.resize(dofs.size());
       for (std::size_t k = 0; k < dofs.size(); ++k)
-        q[k] = _x[dofs[k]];
+        mPositionCache[k] = _x[dofs[k]];
 
       // Compute the gradient of this specific error term
       mTempGradCache.setZero(dofs.size());
@@ -561,7 +581,7 @@ void HierarchicalIK::Constraint::evalGradient(
           mTempGradCache.data(), mTempGradCache.size());
 
       InverseKinematics::GradientMethod& method = ik->getGradientMethod();
-      method.evalGradient(q, gradMap);
+      method.evalGradient(mPositionCache, gradMap);
 
       // Add the components of this gradient into the gradient of this level
       for (std::size_t k = 0; k < dofs.size(); ++k)
@@ -571,15 +591,15 @@ void HierarchicalIK::Constraint::evalGradient(
     // Project this level's gradient through the null spaces of the levels with
     // higher precedence, then add it to the overall gradient
     if (i > 0)
-      _grad += nullspaces[i - 1] * mLevelGradCache;
-    else
-      _grad += mLevelGradCache;
+      hik->projectToNullSpace(i - 1, mLevelGradCache);
+
+    _grad += mLevelGradCache;
   }
 }
 
 //==============================================================================
 HierarchicalIK::HierarchicalIK(const SkeletonPtr& _skeleton)
-  : mSkeleton(_skeleton)
+  : mSkeleton(_skeleton), mImplicitNullSpaceProjection(false)
 {
   // initialize MUST be called immediately after the construction of any
   // directly inheriting classes.
@@ -637,6 +657,114 @@ void HierarchicalIK::copyOverSetup(
         cloneIkFunc(mProblem->getIneqConstraint(i), _otherIK));
 
   newProblem->getSeeds() = mProblem->getSeeds();
+
+  _otherIK->setImplicitNullSpaceProjection(mImplicitNullSpaceProjection);
+}
+
+//==============================================================================
+std::size_t HierarchicalIK::updateNullSpaceProjection() const
+{
+  if (mImplicitNullSpaceProjection)
+    computeRowSpaceBasis();
+  else
+    computeNullSpaces();
+
+  return getIKHierarchy().size();
+}
+
+//==============================================================================
+void HierarchicalIK::computeRowSpaceBasis() const
+{
+  const IKHierarchy& hierarchy = getIKHierarchy();
+  const ConstSkeletonPtr& skel = getSkeleton();
+  const int nDofs = static_cast<int>(skel->getNumDofs());
+
+  // The rank can't exceed the number of DOFs, so the basis never needs to be
+  // reallocated while the Skeleton keeps its DOFs
+  if (mRowSpaceBasisCache.rows() != nDofs)
+  {
+    mRowSpaceBasisCache.resize(nDofs, nDofs);
+    mRowSpaceComponentsCache.resize(nDofs);
+  }
+
+  mRowSpaceRanks.resize(hierarchy.size());
+
+  // Rows of the Jacobians are added to the basis by Gram-Schmidt
+  // orthogonalization against the rows with higher precedence. Rows whose
+  // remainder is negligible compared to the largest row are linearly
+  // dependent on the basis and are skipped.
+  int rank = 0;
+  double maxRowNorm = 0.0;
+  for (std::size_t i = 0; i < hierarchy.size(); ++i)
+  {
+    const std::vector<std::shared_ptr<InverseKinematics> >& level
+        = hierarchy[i];
+
+    for (std::size_t j = 0; j < level.size() && rank < nDofs; ++j)
+    {
+      const std::shared_ptr<InverseKinematics>& ik = level[j];
+
+      if (!ik->isActive())
+        continue;
+
+      const math::Jacobian& J = ik->computeJacobian();
+      const std::vector<std::size_t>& dofs = ik->getDofs();
+
+      for (int r = 0; r < J.rows() && rank < nDofs; ++r)
+      {
+        auto row = mRowSpaceBasisCache.col(rank);
+        row.setZero();
+        for (std::size_t d = 0; d < dofs.size(); ++d)
+          row[static_cast<int>(dofs[d])] = J(r, static_cast<int>(d));
+
+        maxRowNorm = std::max(maxRowNorm, row.norm());
+
+        // Orthogonalize twice for numerical robustness
+        const auto basis = mRowSpaceBasisCache.leftCols(rank);
+        auto components = mRowSpaceComponentsCache.head(rank);
+        for (std::size_t k = 0; k < 2; ++k)
+        {
+          components.noalias() = basis.transpose() * row;
+          row.noalias() -= basis * components;
+        }
+
+        const double norm = row.norm();
+        if (norm <= std::max(
+                maxRowNorm * 1e-10, std::numeric_limits<double>::min()))
+          continue;
+
+        row /= norm;
+        ++rank;
+      }
+    }
+
+    mRowSpaceRanks[i] = static_cast<std::size_t>(rank);
+  }
+}
+
+//==============================================================================
+void HierarchicalIK::projectToNullSpace(
+    std::size_t level, Eigen::VectorXd& vector) const
+{
+  if (!mImplicitNullSpaceProjection)
+  {
+    mNullSpaceProjectionCache.noalias() = mNullSpaceCache[level] * vector;
+    vector = mNullSpaceProjectionCache;
+    return;
+  }
+
+  const int rank = static_cast<int>(mRowSpaceRanks[level]);
+  if (rank == vector.size())
+  {
+    // There is no null space left
+    vector.setZero();
+    return;
+  }
+
+  const auto basis = mRowSpaceBasisCache.leftCols(rank);
+  auto components = mRowSpaceComponentsCache.head(rank);
+  components.noalias() = basis.transpose() * vector;
+  vector.noalias() -= basis * components;
 }
 
 //==============================================================================
@@ -198,6 +198,23 @@ public:
   /// Compute the null spaces of each level of the hierarchy
   const std::vector<Eigen::MatrixXd>& computeNullSpaces() const;
 
+  /// Set whether the gradients of the lower levels of the hierarchy should be
+  /// projected implicitly. Instead of forming an n x n null space matrix for
+  /// each level, the implicit projection builds an orthonormal basis of the
+  /// rows of the Jacobians with higher precedence, and subtracts the
+  /// components of each gradient along that basis. This is much cheaper for
+  /// Skeletons with many degrees of freedom.
+  ///
+  /// The implicit projection uses the null space of all the Jacobians with
+  /// higher precedence combined, whereas computeNullSpaces() chains the null
+  /// space projections of the individual Jacobians. The two are equal when
+  /// each level has a single active IK module. By default, the gradients are
+  /// projected through the matrices of computeNullSpaces().
+  void setImplicitNullSpaceProjection(bool implicit);
+
+  /// Returns true if the gradients are projected implicitly
+  bool isImplicitNullSpaceProjectionEnabled() const;
+
   /// Get the current joint positions of the Skeleton associated with this
   /// IK module.
   Eigen::VectorXd getPositions() const;
@@ -292,6 +309,9 @@ protected:
 
     /// Cache for temporary gradients
     Eigen::VectorXd mTempGradCache;
+
+    /// Cache for the positions of the dependent coordinates of a module
+    Eigen::VectorXd mPositionCache;
   };
 
   /// Constructor
@@ -304,6 +324,20 @@ protected:
   /// module
   void copyOverSetup(const std::shared_ptr<HierarchicalIK>& _otherIK) const;
 
+  /// Compute the null spaces, or the row space basis if the projection is
+  /// implicit, for the current positions. Returns the number of levels of the
+  /// hierarchy.
+  std::size_t updateNullSpaceProjection() const;
+
+  /// Compute an orthonormal basis of the rows of the Jacobians of the
+  /// hierarchy. The first mRowSpaceRanks[i] columns of mRowSpaceBasisCache
+  /// span the rows of the Jacobians of the levels up to i.
+  void computeRowSpaceBasis() const;
+
+  /// Project a vector through the null space of the levels up to \c level.
+  /// updateNullSpaceProjection() must be called before.
+  void projectToNullSpace(std::size_t level, Eigen::VectorXd& vector) const;
+
   /// Pointer to the Skeleton that this IK is tied to
   WeakSkeletonPtr mSkeleton;
 
@@ -340,6 +374,21 @@ protected:
   /// Cache for Jacobians
   mutable math::Jacobian mJacCache;
 
+  /// True if the gradients are projected implicitly
+  bool mImplicitNullSpaceProjection;
+
+  /// Cache for the orthonormal basis of the rows of the Jacobians
+  mutable Eigen::MatrixXd mRowSpaceBasisCache;
+
+  /// Rank of the Jacobians of the levels up to each level
+  mutable std::vector<std::size_t> mRowSpaceRanks;
+
+  /// Cache for the components of a vector along the row space basis
+  mutable Eigen::VectorXd mRowSpaceComponentsCache;
+
+  /// Cache for the projection of a vector through a null space matrix
+  mutable Eigen::VectorXd mNullSpaceProjectionCache;
+
 public:
   // To get byte-aligned Eigen vectors
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -465,6 +465,219 @@ Eigen::Isometry3d IkFast::computeFk(const Eigen::VectorXd& parameters)
   return tf;
 }
 
+//==============================================================================
+void IkFast::computeBatchSolutions(
+    const common::aligned_vector<Eigen::Isometry3d>& desiredBodyTfs,
+    BatchSolutions& solutions,
+    std::size_t numThreads,
+    const BatchFilter& filter)
+{
+  solutions.mOffsets.assign(desiredBodyTfs.size() + 1u, 0u);
+
+  if (!mConfigured)
+  {
+    configure();
+
+    if (!mConfigured)
+    {
+      dtwarn << "[IkFast::computeBatchSolutions] This analytical IK was not "
+             << "able to configure properly, so it will not be able to "
+             << "compute solutions. Returning no solutions.\n";
+      solutions.mConfigs.resize(static_cast<int>(mDofs.size()), 0);
+      return;
+    }
+  }
+
+  if (numThreads == 0u)
+    numThreads = common::ThreadPool::getHardwareConcurrency();
+
+  if (numThreads > 1u
+      && (!mBatchThreadPool || mBatchThreadPool->getNumThreads() != numThreads))
+  {
+    mBatchThreadPool = std::make_shared<common::ThreadPool>(numThreads);
+  }
+
+  // Everything that computeSolutions() reads from the Skeleton is read once
+  // here, so the threads don't access the Skeleton
+  const auto skel = mIK->getNode()->getSkeleton();
+  const int numJoints = getNumJoints();
+  const int numFreeParams = getNumFreeParameters();
+  const int* freeParams = getFreeParameters();
+  const auto numDofs = mDofs.size();
+
+  std::vector<double> freeValues(static_cast<std::size_t>(numFreeParams));
+  for (int i = 0; i < numFreeParams; ++i)
+    freeValues[i] = skel->getDof(freeParams[i])->getPosition();
+
+  // The values of the free parameters of the solutions themselves, which are
+  // zero like in computeSolutions()
+  const std::vector<IkReal> solutionFreeValues(
+      static_cast<std::size_t>(numFreeParams), 0.0);
+
+  const auto freeJointFlags
+      = getFreeJointFlags(numJoints, numFreeParams, freeParams);
+
+  std::vector<double> lowerLimits(numDofs);
+  std::vector<double> upperLimits(numDofs);
+  std::vector<double> currentValues(numDofs);
+  std::vector<char> isRevolute(numDofs);
+  for (std::size_t i = 0u; i < numDofs; ++i)
+  {
+    const DegreeOfFreedom* dof = skel->getDof(mDofs[i]);
+    lowerLimits[i] = dof->getPositionLowerLimit();
+    upperLimits[i] = dof->getPositionUpperLimit();
+    currentValues[i] = dof->getPosition();
+    isRevolute[i]
+        = dof->getJoint()->getType() == RevoluteJoint::getStaticType();
+  }
+
+  const std::size_t numBuffers = mBatchThreadPool && numThreads > 1u
+                                     ? mBatchThreadPool->getNumThreads()
+                                     : 1u;
+  if (mBatchBuffers.size() < numBuffers)
+    mBatchBuffers.resize(numBuffers);
+
+  for (auto& buffer : mBatchBuffers)
+  {
+    buffer.mJointValues.resize(static_cast<std::size_t>(numJoints));
+    buffer.mConfigs.clear();
+    buffer.mTargets.clear();
+  }
+
+  const auto solveTarget = [&](std::size_t index, std::size_t threadIndex) {
+    BatchBuffer& buffer = mBatchBuffers[threadIndex];
+
+    std::array<IkReal, 3> eetrans;
+    std::array<IkReal, 9> eerot;
+    convertTransform(desiredBodyTfs[index], eetrans, eerot);
+
+    buffer.mIkFastSolutions.Clear();
+    const std::size_t first
+        = numDofs > 0u ? buffer.mConfigs.size() / numDofs : 0u;
+    std::size_t numSolutions = 0u;
+    if (computeIk(
+            eetrans.data(),
+            eerot.data(),
+            freeValues.empty() ? nullptr : freeValues.data(),
+            buffer.mIkFastSolutions))
+    {
+      const auto numIkFastSolutions = buffer.mIkFastSolutions.GetNumSolutions();
+      for (std::size_t i = 0u; i < numIkFastSolutions; ++i)
+      {
+        buffer.mIkFastSolutions.GetSolution(i).GetSolution(
+            buffer.mJointValues.data(),
+            solutionFreeValues.empty() ? nullptr : solutionFreeValues.data());
+
+        const std::size_t begin = buffer.mConfigs.size();
+        buffer.mConfigs.resize(begin + numDofs);
+
+        bool valid = true;
+        std::size_t dofIndex = 0u;
+        for (int j = 0; j < numJoints && valid; ++j)
+        {
+          if (freeJointFlags[j])
+            continue;
+
+          double value = buffer.mJointValues[j];
+          if (isRevolute[dofIndex])
+          {
+            valid = wrapCyclicSolution(
+                currentValues[dofIndex],
+                lowerLimits[dofIndex],
+                upperLimits[dofIndex],
+                value);
+          }
+          else
+          {
+            valid = lowerLimits[dofIndex] <= value
+                    && value <= upperLimits[dofIndex];
+          }
+
+          buffer.mConfigs[begin + dofIndex] = value;
+          ++dofIndex;
+        }
+
+        if (valid)
+          ++numSolutions;
+        else
+          buffer.mConfigs.resize(begin);
+      }
+    }
+
+    buffer.mTargets.push_back({{index, first, numSolutions}});
+  };
+
+  if (numBuffers > 1u)
+  {
+    mBatchThreadPool->parallelFor(desiredBodyTfs.size(), solveTarget);
+  }
+  else
+  {
+    for (std::size_t i = 0u; i < desiredBodyTfs.size(); ++i)
+      solveTarget(i, 0u);
+  }
+
+  // Gather the solutions of the threads in the order of the desired
+  // transforms
+  for (const auto& buffer : mBatchBuffers)
+  {
+    for (const auto& target : buffer.mTargets)
+      solutions.mOffsets[target[0] + 1u] = target[2];
+  }
+
+  for (std::size_t i = 0u; i < desiredBodyTfs.size(); ++i)
+    solutions.mOffsets[i + 1u] += solutions.mOffsets[i];
+
+  const auto numRows = static_cast<int>(numDofs);
+  solutions.mConfigs.resize(
+      numRows, static_cast<int>(solutions.mOffsets.back()));
+  for (const auto& buffer : mBatchBuffers)
+  {
+    for (const auto& target : buffer.mTargets)
+    {
+      solutions.mConfigs.middleCols(
+          static_cast<int>(solutions.mOffsets[target[0]]),
+          static_cast<int>(target[2]))
+          = Eigen::Map<const Eigen::MatrixXd>(
+              buffer.mConfigs.data() + target[1] * numDofs,
+              numRows,
+              static_cast<int>(target[2]));
+    }
+  }
+
+  if (!filter || solutions.mConfigs.cols() == 0)
+    return;
+
+  std::vector<char> valid(
+      static_cast<std::size_t>(solutions.mConfigs.cols()), 1);
+  filter(solutions.mConfigs, valid);
+
+  // Remove the filtered solutions in place
+  int numValid = 0;
+  std::size_t begin = 0u;
+  for (std::size_t i = 0u; i < desiredBodyTfs.size(); ++i)
+  {
+    const std::size_t end = solutions.mOffsets[i + 1u];
+    for (std::size_t j = begin; j < end; ++j)
+    {
+      if (!valid[j])
+        continue;
+
+      if (numValid != static_cast<int>(j))
+      {
+        solutions.mConfigs.col(numValid)
+            = solutions.mConfigs.col(static_cast<int>(j));
+      }
+      ++numValid;
+    }
+
+    begin = end;
+    solutions.mOffsets[i + 1u] = static_cast<std::size_t>(numValid);
+  }
+
+  solutions.mConfigs.conservativeResize(Eigen::NoChange, numValid);
+}
+
 //==============================================================================
 bool wrapCyclicSolution(
     double currentValue, double lb, double ub, double& solutionValue)
@@ -34,10 +34,15 @@
 #define DART_DYNAMICS_IKFAST_HPP_
 
 #include <array>
+#include <functional>
+#include <memory>
+#include <vector>
 
 #define IKFAST_HAS_LIBRARY
 #include "dart/external/ikfast/ikfast.h"
 
+#include "dart/common/Memory.hpp"
+#include "dart/common/ThreadPool.hpp"
 #include "dart/dynamics/InverseKinematics.hpp"
 
 namespace dart {
@@ -129,6 +134,25 @@ public:
     UNKNOWN,
   };
 
+  /// The valid solutions of many desired transforms, computed by
+  /// computeBatchSolutions(), in flat arrays
+  struct BatchSolutions
+  {
+    /// Positions of the DOFs of getDofs(), one column per solution
+    Eigen::MatrixXd mConfigs;
+
+    /// The solutions of the ith desired transform are the columns
+    /// [mOffsets[i], mOffsets[i + 1]) of mConfigs
+    std::vector<std::size_t> mOffsets;
+  };
+
+  /// Checks the columns of configs, which are positions of the DOFs of
+  /// getDofs(), at once, e.g., for collisions, and sets valid[i] to zero if
+  /// the ith column is invalid. valid has as many elements as configs has
+  /// columns, all of which are one when the filter is called.
+  using BatchFilter = std::function<void(
+      const Eigen::MatrixXd& configs, std::vector<char>& valid)>;
+
   /// Constructor
   ///
   /// \param[in] ik The parent InverseKinematics solver that is associated with
@@ -156,6 +180,32 @@ public:
   /// the same as getNumJoints2().
   Eigen::Isometry3d computeFk(const Eigen::VectorXd& parameters);
 
+  /// Computes the solutions for many desired transforms of the body at once,
+  /// and keeps only the valid ones.
+  ///
+  /// The solutions are wrapped into and checked against the position limits
+  /// like computeSolutions() does, but the limits, the current positions and
+  /// the free parameters are read from the Skeleton once for the whole batch,
+  /// so the desired transforms can be solved by numThreads threads, and the
+  /// buffers of the threads are reused across calls. The solutions within the
+  /// limits are then passed to the filter, if any, in a single call.
+  ///
+  /// The solutions of each desired transform are in the order that IkFast
+  /// returns them, regardless of the number of threads. Unlike getSolutions(),
+  /// they are not sorted by the quality comparison function.
+  ///
+  /// \param[in] desiredBodyTfs Desired transforms, like the one of
+  /// computeSolutions()
+  /// \param[out] solutions The valid solutions
+  /// \param[in] numThreads Number of threads. If it is zero, the number of
+  /// hardware threads is used.
+  /// \param[in] filter Additional check of the solutions within the limits
+  void computeBatchSolutions(
+      const common::aligned_vector<Eigen::Isometry3d>& desiredBodyTfs,
+      BatchSolutions& solutions,
+      std::size_t numThreads = 1u,
+      const BatchFilter& filter = nullptr);
+
   /// Returns the indices of the DegreeOfFreedoms that are part of the joints
   /// that IkFast solves for.
   const std::vector<std::size_t>& getDofs() const override;
@@ -246,6 +296,32 @@ protected:
   /// IkFast.
   mutable std::vector<std::size_t> mFreeDofs;
 
+  /// Buffers of a thread of computeBatchSolutions()
+  struct BatchBuffer
+  {
+    /// Solutions computed by IkFast for the current desired transform
+    ikfast::IkSolutionList<IkReal> mIkFastSolutions;
+
+    /// Positions of all the joints of a solution
+    std::vector<IkReal> mJointValues;
+
+    /// Positions of the DOFs of getDofs() of the valid solutions, one
+    /// solution after another
+    std::vector<double> mConfigs;
+
+    /// For each desired transform solved by the thread, its index, the index
+    /// of its first solution in mConfigs, and its number of solutions
+    std::vector<std::array<std::size_t, 3>> mTargets;
+  };
+
+  /// Thread pool of computeBatchSolutions(), which is null until more than
+  /// one thread is requested. It is shared by the copies of this IkFast, which
+  /// keeps IkFast copyable.
+  std::shared_ptr<common::ThreadPool> mBatchThreadPool;
+
+  /// Buffers of computeBatchSolutions(), one per thread
+  std::vector<BatchBuffer> mBatchBuffers;
+
 private:
   /// Cache data for the target rotation used by IKFast.
   std::array<IkReal, 9> mTargetRotation;
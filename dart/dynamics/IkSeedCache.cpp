@@ -0,0 +1,618 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/dynamics/IkSeedCache.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#include "dart/common/Console.hpp"
+#include "dart/dynamics/DegreeOfFreedom.hpp"
+#include "dart/dynamics/InverseKinematics.hpp"
+#include "dart/dynamics/JacobianNode.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+#include "dart/math/Constants.hpp"
+#include "dart/math/Random.hpp"
+
+namespace dart {
+namespace dynamics {
+
+namespace {
+
+constexpr char FileMagic[8] = {'D', 'A', 'R', 'T', 'I', 'K', 'S', 'C'};
+constexpr std::uint32_t FileVersion = 1u;
+
+/// Largest fraction of the nodes of a subtree that one of its children may
+/// hold before an insertion into it rebuilds it
+constexpr double kBalanceFactor = 0.75;
+
+//==============================================================================
+Eigen::Vector4d toQuaternionCoeffs(const Eigen::Isometry3d& pose)
+{
+  const Eigen::Quaterniond quaternion(pose.linear());
+  Eigen::Vector4d coeffs(
+      quaternion.w(), quaternion.x(), quaternion.y(), quaternion.z());
+  coeffs.normalize();
+
+  // q and -q are the same orientation
+  if (coeffs[0] < 0.0)
+    coeffs = -coeffs;
+
+  return coeffs;
+}
+
+//==============================================================================
+/// Returns the number of bytes from the current position to the end of the
+/// stream, or the largest size if the stream is not seekable
+std::size_t getNumRemainingBytes(std::istream& stream)
+{
+  const std::istream::pos_type current = stream.tellg();
+  if (current < 0)
+    return std::numeric_limits<std::size_t>::max();
+
+  stream.seekg(0, std::ios::end);
+  const std::istream::pos_type end = stream.tellg();
+  stream.seekg(current);
+
+  if (end < current)
+    return 0u;
+
+  return static_cast<std::size_t>(end - current);
+}
+
+//==============================================================================
+template <typename T>
+void writeValue(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//==============================================================================
+template <typename T>
+bool readValue(std::istream& stream, T& value)
+{
+  return static_cast<bool>(
+      stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+//==============================================================================
+IkSeedCache::Option::Option(
+    std::size_t numSeeds,
+    double orientationWeight,
+    std::size_t maxNumEntries,
+    bool recordSolutions)
+  : mNumSeeds(numSeeds),
+    mOrientationWeight(orientationWeight),
+    mMaxNumEntries(maxNumEntries),
+    mRecordSolutions(recordSolutions)
+{
+  // Do nothing
+}
+
+//==============================================================================
+IkSeedCache::IkSeedCache(std::size_t numDofs, const Option& option)
+  : mNumDofs(numDofs), mRoot(-1)
+{
+  setOption(option);
+}
+
+//==============================================================================
+void IkSeedCache::setOption(const Option& option)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  const double previousWeight = mOption.mOrientationWeight;
+  mOption = option;
+
+  if (mOption.mOrientationWeight < 0.0)
+  {
+    dtwarn << "[IkSeedCache::setOption] Attempting to set a negative "
+           << "orientation weight [" << mOption.mOrientationWeight
+           << "]. Using its absolute value.\n";
+    mOption.mOrientationWeight = -mOption.mOrientationWeight;
+  }
+
+  if (mOption.mOrientationWeight != previousWeight)
+  {
+    for (std::size_t i = 0u; i < mKeys.size(); ++i)
+      mKeys[i] = computeKey(mTranslations[i], mQuaternions[i]);
+    rebuildTree();
+  }
+}
+
+//==============================================================================
+IkSeedCache::Option IkSeedCache::getOption() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mOption;
+}
+
+//==============================================================================
+std::size_t IkSeedCache::getNumDofs() const
+{
+  return mNumDofs;
+}
+
+//==============================================================================
+std::size_t IkSeedCache::getNumEntries() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mSolutions.size();
+}
+
+//==============================================================================
+bool IkSeedCache::addEntry(
+    const Eigen::Isometry3d& pose, const Eigen::VectorXd& solution)
+{
+  if (static_cast<std::size_t>(solution.size()) != mNumDofs)
+  {
+    dterr << "[IkSeedCache::addEntry] The size of the solution ["
+          << solution.size() << "] does not match the number of DOFs of the "
+          << "cache [" << mNumDofs << "].\n";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (!addEntryUnlocked(
+          pose.translation(), toQuaternionCoeffs(pose), solution))
+  {
+    return false;
+  }
+
+  insertNode(mSolutions.size() - 1u);
+  return true;
+}
+
+//==============================================================================
+void IkSeedCache::findNearest(
+    const Eigen::Isometry3d& pose,
+    std::vector<Eigen::VectorXd>& solutions) const
+{
+  solutions.clear();
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mRoot < 0 || mOption.mNumSeeds == 0u)
+    return;
+
+  const Eigen::Vector3d translation = pose.translation();
+  const Eigen::Vector4d quaternion = toQuaternionCoeffs(pose);
+
+  std::vector<std::pair<double, std::size_t>> neighbors;
+  neighbors.reserve(mOption.mNumSeeds + 1u);
+  searchSubtree(
+      mRoot, computeKey(translation, quaternion), mOption.mNumSeeds, neighbors);
+
+  // Quaternions with w close to zero are near the stored quaternions of the
+  // opposite sign, so search for those too
+  if (quaternion[0] < 0.5)
+  {
+    searchSubtree(
+        mRoot,
+        computeKey(translation, -quaternion),
+        mOption.mNumSeeds,
+        neighbors);
+  }
+
+  std::sort_heap(neighbors.begin(), neighbors.end());
+  for (const auto& neighbor : neighbors)
+    solutions.push_back(mSolutions[neighbor.second]);
+}
+
+//==============================================================================
+void IkSeedCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mTranslations.clear();
+  mQuaternions.clear();
+  mSolutions.clear();
+  mKeys.clear();
+  mNodes.clear();
+  mRoot = -1;
+}
+
+//==============================================================================
+std::size_t IkSeedCache::generate(InverseKinematics& ik, std::size_t numSamples)
+{
+  const std::vector<std::size_t>& dofs = ik.getDofs();
+  if (dofs.size() != mNumDofs)
+  {
+    dterr << "[IkSeedCache::generate] The number of DOFs of the IK module ["
+          << dofs.size() << "] does not match the number of DOFs of the "
+          << "cache [" << mNumDofs << "].\n";
+    return 0u;
+  }
+
+  const SkeletonPtr skel = ik.getNode()->getSkeleton();
+  const auto numDofs = static_cast<int>(mNumDofs);
+  Eigen::VectorXd lower(numDofs);
+  Eigen::VectorXd upper(numDofs);
+  for (int i = 0; i < numDofs; ++i)
+  {
+    const DegreeOfFreedom* dof = skel->getDof(dofs[i]);
+    lower[i] = std::max(dof->getPositionLowerLimit(), -math::constantsd::pi());
+    upper[i] = std::min(dof->getPositionUpperLimit(), math::constantsd::pi());
+  }
+
+  const Eigen::VectorXd originalPositions = ik.getPositions();
+  const Eigen::Vector3d& offset = ik.getOffset();
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::size_t numAdded = 0u;
+  for (std::size_t i = 0u; i < numSamples; ++i)
+  {
+    const Eigen::VectorXd positions
+        = math::Random::uniform<Eigen::VectorXd>(lower, upper);
+    ik.setPositions(positions);
+
+    Eigen::Isometry3d pose = ik.getNode()->getWorldTransform();
+    pose.translation() = pose * offset;
+    if (!addEntryUnlocked(
+            pose.translation(), toQuaternionCoeffs(pose), positions))
+    {
+      break;
+    }
+
+    ++numAdded;
+  }
+
+  rebuildTree();
+  ik.setPositions(originalPositions);
+
+  return numAdded;
+}
+
+//==============================================================================
+bool IkSeedCache::save(const std::string& path) const
+{
+  std::ofstream file(path, std::ios::binary);
+  if (!file)
+  {
+    dterr << "[IkSeedCache::save] Failed to open [" << path
+          << "] for writing.\n";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  file.write(FileMagic, sizeof(FileMagic));
+  writeValue(file, FileVersion);
+  writeValue(file, static_cast<std::uint64_t>(mNumDofs));
+  writeValue(file, static_cast<std::uint64_t>(mSolutions.size()));
+  for (std::size_t i = 0u; i < mSolutions.size(); ++i)
+  {
+    file.write(
+        reinterpret_cast<const char*>(mTranslations[i].data()),
+        3 * sizeof(double));
+    file.write(
+        reinterpret_cast<const char*>(mQuaternions[i].data()),
+        4 * sizeof(double));
+    file.write(
+        reinterpret_cast<const char*>(mSolutions[i].data()),
+        static_cast<std::streamsize>(mNumDofs * sizeof(double)));
+  }
+
+  if (!file)
+  {
+    dterr << "[IkSeedCache::save] Failed to write [" << path << "].\n";
+    return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool IkSeedCache::load(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+  {
+    dterr << "[IkSeedCache::load] Failed to open [" << path << "].\n";
+    return false;
+  }
+
+  char magic[sizeof(FileMagic)];
+  std::uint32_t version = 0u;
+  std::uint64_t numDofs = 0u;
+  std::uint64_t numEntries = 0u;
+  if (!file.read(magic, sizeof(magic))
+      || std::memcmp(magic, FileMagic, sizeof(FileMagic)) != 0
+      || !readValue(file, version) || version != FileVersion
+      || !readValue(file, numDofs) || !readValue(file, numEntries))
+  {
+    dterr << "[IkSeedCache::load] [" << path << "] is not an IK seed cache "
+          << "file of version " << FileVersion << ".\n";
+    return false;
+  }
+
+  if (numDofs != mNumDofs)
+  {
+    dterr << "[IkSeedCache::load] The number of DOFs of [" << path << "] ["
+          << numDofs << "] does not match the number of DOFs of the cache ["
+          << mNumDofs << "].\n";
+    return false;
+  }
+
+  // Check that the file holds all the entries before allocating them. Each
+  // entry is a translation, a quaternion, and a solution. The division
+  // doesn't overflow.
+  const std::size_t entrySize = (7u + mNumDofs) * sizeof(double);
+  if (numEntries > getNumRemainingBytes(file) / entrySize)
+  {
+    dterr << "[IkSeedCache::load] [" << path << "] is truncated.\n";
+    return false;
+  }
+
+  common::aligned_vector<Eigen::Vector3d> translations(numEntries);
+  common::aligned_vector<Eigen::Vector4d> quaternions(numEntries);
+  std::vector<Eigen::VectorXd> solutions(
+      numEntries, Eigen::VectorXd(static_cast<int>(mNumDofs)));
+  for (std::size_t i = 0u; i < numEntries; ++i)
+  {
+    file.read(
+        reinterpret_cast<char*>(translations[i].data()), 3 * sizeof(double));
+    file.read(
+        reinterpret_cast<char*>(quaternions[i].data()), 4 * sizeof(double));
+    file.read(
+        reinterpret_cast<char*>(solutions[i].data()),
+        static_cast<std::streamsize>(mNumDofs * sizeof(double)));
+  }
+
+  if (!file)
+  {
+    dterr << "[IkSeedCache::load] [" << path << "] is truncated.\n";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  mTranslations.swap(translations);
+  mQuaternions.swap(quaternions);
+  mSolutions.swap(solutions);
+  mKeys.resize(mSolutions.size());
+  for (std::size_t i = 0u; i < mKeys.size(); ++i)
+    mKeys[i] = computeKey(mTranslations[i], mQuaternions[i]);
+  rebuildTree();
+
+  return true;
+}
+
+//==============================================================================
+bool IkSeedCache::addEntryUnlocked(
+    const Eigen::Vector3d& translation,
+    const Eigen::Vector4d& quaternion,
+    const Eigen::VectorXd& solution)
+{
+  if (mOption.mMaxNumEntries > 0u
+      && mSolutions.size() >= mOption.mMaxNumEntries)
+  {
+    return false;
+  }
+
+  mTranslations.push_back(translation);
+  mQuaternions.push_back(quaternion);
+  mSolutions.push_back(solution);
+  mKeys.push_back(computeKey(translation, quaternion));
+
+  return true;
+}
+
+//==============================================================================
+IkSeedCache::Key IkSeedCache::computeKey(
+    const Eigen::Vector3d& translation, const Eigen::Vector4d& quaternion) const
+{
+  Key key;
+  key << translation, mOption.mOrientationWeight * quaternion;
+  return key;
+}
+
+//==============================================================================
+void IkSeedCache::insertNode(std::size_t entry)
+{
+  assert(entry == mNodes.size());
+  const Key& key = mKeys[entry];
+  const int index = static_cast<int>(entry);
+
+  if (mRoot < 0)
+  {
+    mNodes.push_back({-1, -1, 0, 1});
+    mRoot = index;
+    return;
+  }
+
+  // Descend to the leaf whose cell contains the key
+  mPathCache.clear();
+  int current = mRoot;
+  while (true)
+  {
+    mPathCache.push_back(current);
+    Node& node = mNodes[static_cast<std::size_t>(current)];
+    ++node.mSize;
+    int& child = key[node.mAxis] < mKeys[current][node.mAxis] ? node.mLeft
+                                                              : node.mRight;
+    if (child < 0)
+    {
+      child = index;
+      mNodes.push_back({-1, -1, (node.mAxis + 1) % Key::RowsAtCompileTime, 1});
+      break;
+    }
+
+    current = child;
+  }
+
+  // If the entry is deeper than a balanced tree allows, rebuild the lowest
+  // subtree on its path that is unbalanced
+  const std::size_t depth = mPathCache.size() + 1u;
+  const double maxDepth = std::floor(
+      std::log(static_cast<double>(mNodes.size()))
+      / std::log(1.0 / kBalanceFactor));
+  if (static_cast<double>(depth) <= maxDepth + 1.0)
+    return;
+
+  int childSize = 1;
+  for (std::size_t i = mPathCache.size(); i-- > 0u;)
+  {
+    const int size = mNodes[static_cast<std::size_t>(mPathCache[i])].mSize;
+    if (childSize > kBalanceFactor * size)
+    {
+      rebuildSubtree(i);
+      break;
+    }
+    childSize = size;
+  }
+}
+
+//==============================================================================
+void IkSeedCache::rebuildTree()
+{
+  mNodes.resize(mKeys.size());
+  mBuildCache.resize(mKeys.size());
+  std::iota(mBuildCache.begin(), mBuildCache.end(), 0);
+  mRoot = buildSubtree(0u, mBuildCache.size(), 0);
+}
+
+//==============================================================================
+void IkSeedCache::rebuildSubtree(std::size_t pathIndex)
+{
+  const int root = mPathCache[pathIndex];
+
+  // Collect the nodes of the subtree
+  mBuildCache.clear();
+  mBuildCache.push_back(root);
+  for (std::size_t i = 0u; i < mBuildCache.size(); ++i)
+  {
+    const Node& node = mNodes[static_cast<std::size_t>(mBuildCache[i])];
+    if (node.mLeft >= 0)
+      mBuildCache.push_back(node.mLeft);
+    if (node.mRight >= 0)
+      mBuildCache.push_back(node.mRight);
+  }
+
+  const int newRoot = buildSubtree(
+      0u, mBuildCache.size(), mNodes[static_cast<std::size_t>(root)].mAxis);
+
+  if (pathIndex == 0u)
+  {
+    mRoot = newRoot;
+    return;
+  }
+
+  Node& parent = mNodes[static_cast<std::size_t>(mPathCache[pathIndex - 1u])];
+  if (parent.mLeft == root)
+    parent.mLeft = newRoot;
+  else
+    parent.mRight = newRoot;
+}
+
+//==============================================================================
+int IkSeedCache::buildSubtree(std::size_t begin, std::size_t end, int axis)
+{
+  if (begin >= end)
+    return -1;
+
+  const std::size_t middle = begin + (end - begin) / 2u;
+  std::nth_element(
+      mBuildCache.begin() + static_cast<std::ptrdiff_t>(begin),
+      mBuildCache.begin() + static_cast<std::ptrdiff_t>(middle),
+      mBuildCache.begin() + static_cast<std::ptrdiff_t>(end),
+      [&](int a, int b) { return mKeys[a][axis] < mKeys[b][axis]; });
+
+  // Entries equal to the median along the axis may end up on either side,
+  // which the search accounts for by visiting both sides of ties
+  const int index = mBuildCache[middle];
+  const int nextAxis = (axis + 1) % Key::RowsAtCompileTime;
+  Node& node = mNodes[static_cast<std::size_t>(index)];
+  node.mAxis = axis;
+  node.mSize = static_cast<int>(end - begin);
+  const int left = buildSubtree(begin, middle, nextAxis);
+  const int right = buildSubtree(middle + 1u, end, nextAxis);
+  mNodes[static_cast<std::size_t>(index)].mLeft = left;
+  mNodes[static_cast<std::size_t>(index)].mRight = right;
+
+  return index;
+}
+
+//==============================================================================
+void IkSeedCache::searchSubtree(
+    int node,
+    const Key& key,
+    std::size_t numNeighbors,
+    std::vector<std::pair<double, std::size_t>>& neighbors) const
+{
+  if (node < 0)
+    return;
+
+  const auto entry = static_cast<std::size_t>(node);
+  const Node& current = mNodes[entry];
+  const double distance = (mKeys[entry] - key).squaredNorm();
+
+  const bool isNeighbor
+      = std::any_of(neighbors.begin(), neighbors.end(), [&](const auto& n) {
+          return n.second == entry;
+        });
+  if (!isNeighbor)
+  {
+    if (neighbors.size() < numNeighbors)
+    {
+      neighbors.emplace_back(distance, entry);
+      std::push_heap(neighbors.begin(), neighbors.end());
+    }
+    else if (distance < neighbors.front().first)
+    {
+      std::pop_heap(neighbors.begin(), neighbors.end());
+      neighbors.back() = std::make_pair(distance, entry);
+      std::push_heap(neighbors.begin(), neighbors.end());
+    }
+  }
+
+  const double difference
+      = key[current.mAxis] - mKeys[entry][current.mAxis];
+  const int nearChild = difference < 0.0 ? current.mLeft : current.mRight;
+  const int farChild = difference < 0.0 ? current.mRight : current.mLeft;
+
+  searchSubtree(nearChild, key, numNeighbors, neighbors);
+
+  if (neighbors.size() < numNeighbors
+      || difference * difference < neighbors.front().first)
+  {
+    searchSubtree(farChild, key, numNeighbors, neighbors);
+  }
+}
+
+} // namespace dynamics
+} // namespace dart
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_DYNAMICS_IKSEEDCACHE_HPP_
+#define DART_DYNAMICS_IKSEEDCACHE_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/common/Memory.hpp"
+
+namespace dart {
+namespace dynamics {
+
+class InverseKinematics;
+
+/// IkSeedCache stores solutions of an InverseKinematics module together with
+/// the target poses that they reach, and supplies the stored solutions whose
+/// poses are nearest to a new target as the initial guess and seeds of the
+/// solver. Attach it with InverseKinematics::setSeedCache().
+///
+/// The poses are indexed by a k-d tree over the translation and the
+/// (weighted) unit quaternion of the orientation. New entries are attached to
+/// the leaves of the tree, and the lowest unbalanced subtree on the path of an
+/// entry that is inserted too deep is rebuilt, like in a scapegoat tree, so
+/// that correlated entries (e.g., the solutions of a teleoperation loop) keep
+/// the tree balanced. A cache can be filled offline with generate(), which
+/// samples configurations instead of solving, and be persisted with save() and
+/// load().
+///
+/// All functions are thread-safe, so a cache can be shared by the clones of
+/// an IK module, e.g., by BatchInverseKinematics.
+class IkSeedCache
+{
+public:
+  struct Option
+  {
+    /// Number of the nearest stored solutions supplied to each solve. The
+    /// nearest one becomes the initial guess, and the others become seeds.
+    std::size_t mNumSeeds;
+
+    /// Weight of the orientation in the distance between two poses. The
+    /// distance of the orientations is the distance between their unit
+    /// quaternions, which is about half of the angle between them for small
+    /// angles.
+    double mOrientationWeight;
+
+    /// Maximum number of entries. Once the cache is full, no more entries are
+    /// added. Zero means unlimited.
+    std::size_t mMaxNumEntries;
+
+    /// Whether the solutions found by the IK module are added automatically.
+    /// Since every successful solve adds an entry, set mMaxNumEntries as well
+    /// when the IK module is solved in a long-running loop.
+    bool mRecordSolutions;
+
+    /// Constructor
+    Option(
+        std::size_t numSeeds = 3u,
+        double orientationWeight = 0.5,
+        std::size_t maxNumEntries = 0u,
+        bool recordSolutions = false);
+  };
+
+  /// Constructor. numDofs is the number of the DOFs of the IK modules that
+  /// use this cache.
+  explicit IkSeedCache(std::size_t numDofs, const Option& option = Option());
+
+  /// Set the option. Changing the orientation weight re-indexes the entries.
+  void setOption(const Option& option);
+
+  /// Get the option
+  Option getOption() const;
+
+  /// Get the number of the DOFs of the stored solutions
+  std::size_t getNumDofs() const;
+
+  /// Get the number of the stored entries
+  std::size_t getNumEntries() const;
+
+  /// Add a solution that reaches the given world pose. Returns false if the
+  /// solution has the wrong size or the cache is full.
+  bool addEntry(const Eigen::Isometry3d& pose, const Eigen::VectorXd& solution);
+
+  /// Find the stored solutions whose poses are nearest to the given pose,
+  /// nearest first. At most Option::mNumSeeds solutions are returned.
+  void findNearest(
+      const Eigen::Isometry3d& pose,
+      std::vector<Eigen::VectorXd>& solutions) const;
+
+  /// Remove all the entries
+  void clear();
+
+  /// Fill the cache offline with numSamples configurations of the DOFs of
+  /// the IK module, sampled uniformly within their position limits using
+  /// math::Random, and the poses of the IK module's node that they result in.
+  /// Unbounded DOFs are sampled within [-pi, pi]. The positions of the
+  /// Skeleton are restored afterwards. Returns the number of added entries.
+  std::size_t generate(InverseKinematics& ik, std::size_t numSamples);
+
+  /// Save the entries to a binary file in the native byte order. Returns
+  /// false if the file can't be written.
+  bool save(const std::string& path) const;
+
+  /// Replace the entries with the ones of a binary file written by save().
+  /// Returns false, leaving the cache unchanged, if the file can't be read or
+  /// its solutions have a different number of DOFs.
+  bool load(const std::string& path);
+
+protected:
+  /// Point of the k-d tree, which holds the translation and the weighted
+  /// quaternion coefficients of a pose
+  using Key = Eigen::Matrix<double, 7, 1>;
+
+  /// Node of the k-d tree. The node of index i holds the entry of index i.
+  struct Node
+  {
+    /// Index of the child node with smaller coordinates, or -1
+    int mLeft;
+
+    /// Index of the child node with larger coordinates, or -1
+    int mRight;
+
+    /// Coordinate that this node splits
+    int mAxis;
+
+    /// Number of the nodes in the subtree of this node
+    int mSize;
+  };
+
+  /// Add an entry without locking or rebuilding the tree
+  bool addEntryUnlocked(
+      const Eigen::Vector3d& translation,
+      const Eigen::Vector4d& quaternion,
+      const Eigen::VectorXd& solution);
+
+  /// Compute the key of a translation and a quaternion (w, x, y, z)
+  Key computeKey(
+      const Eigen::Vector3d& translation,
+      const Eigen::Vector4d& quaternion) const;
+
+  /// Insert the last entry into the k-d tree. If it is inserted deeper than
+  /// a balanced tree allows, the lowest unbalanced subtree on its path is
+  /// rebuilt.
+  void insertNode(std::size_t entry);
+
+  /// Rebuild a balanced k-d tree of all the entries
+  void rebuildTree();
+
+  /// Rebuild the subtree of the node of mPathCache at the given position
+  void rebuildSubtree(std::size_t pathIndex);
+
+  /// Build a balanced subtree of the nodes in [begin, end) of mBuildCache.
+  /// Returns the index of the root node of the subtree, or -1 if it is empty.
+  int buildSubtree(std::size_t begin, std::size_t end, int axis);
+
+  /// Search the subtree of a node for the entries nearest to a key. The
+  /// neighbors are kept as a max-heap of (squared distance, entry) pairs.
+  void searchSubtree(
+      int node,
+      const Key& key,
+      std::size_t numNeighbors,
+      std::vector<std::pair<double, std::size_t>>& neighbors) const;
+
+  /// Option
+  Option mOption;
+
+  /// Number of the DOFs of the stored solutions
+  std::size_t mNumDofs;
+
+  /// Translations of the stored poses
+  common::aligned_vector<Eigen::Vector3d> mTranslations;
+
+  /// Orientations of the stored poses as quaternion coefficients (w, x, y, z)
+  /// with nonnegative w
+  common::aligned_vector<Eigen::Vector4d> mQuaternions;
+
+  /// Stored solutions
+  std::vector<Eigen::VectorXd> mSolutions;
+
+  /// Keys of the stored poses
+  common::aligned_vector<Key> mKeys;
+
+  /// Nodes of the k-d tree, one per entry
+  std::vector<Node> mNodes;
+
+  /// Index of the root node, or -1 if the tree is empty
+  int mRoot;
+
+  /// Cache of the path of an insertion
+  std::vector<int> mPathCache;
+
+  /// Cache of the nodes of a subtree that is rebuilt
+  std::vector<int> mBuildCache;
+
+  /// Mutex that protects all the members above
+  mutable std::mutex mMutex;
+};
+
+} // namespace dynamics
+} // namespace dart
+
+#endif // DART_DYNAMICS_IKSEEDCACHE_HPP_
@@ -101,6 +101,28 @@ bool InverseKinematics::findSolution(Eigen::VectorXd& positions)
 
   mProblem->setInitialGuess(getPositions());
 
+  // Start from the cached solution nearest to the target, and try the other
+  // cached solutions and the current positions before the Problem's seeds
+  const bool useSeedCache
+      = mSeedCache && mSeedCache->getNumDofs() == mDofs.size();
+  Eigen::Isometry3d targetTf = Eigen::Isometry3d::Identity();
+  std::vector<Eigen::VectorXd> originalSeeds;
+  if (useSeedCache)
+  {
+    targetTf = mTarget->getWorldTransform();
+    mSeedCache->findNearest(targetTf, mCachedSeeds);
+    if (!mCachedSeeds.empty())
+    {
+      std::vector<Eigen::VectorXd>& seeds = mProblem->getSeeds();
+      originalSeeds = seeds;
+
+      mProblem->setInitialGuess(mCachedSeeds.front());
+      seeds.assign(mCachedSeeds.begin() + 1, mCachedSeeds.end());
+      seeds.push_back(getPositions());
+      seeds.insert(seeds.end(), originalSeeds.begin(), originalSeeds.end());
+    }
+  }
+
   const SkeletonPtr& skel = getNode()->getSkeleton();
 
   Eigen::VectorXd bounds(mDofs.size());
@@ -123,6 +145,15 @@ bool InverseKinematics::findSolution(Eigen::VectorXd& positions)
 
   positions = mProblem->getOptimalSolution();
 
+  if (useSeedCache)
+  {
+    if (!mCachedSeeds.empty())
+      mProblem->getSeeds() = originalSeeds;
+
+    if (wasSolved && mSeedCache->getOption().mRecordSolutions)
+      mSeedCache->addEntry(targetTf, positions);
+  }
+
   setPositions(originalPositions);
   skel->setVelocities(originalVelocities);
   return wasSolved;
@@ -171,6 +202,7 @@ InverseKinematicsPtr InverseKinematics::clone(JacobianNode* _newNode) const
   newIK->setDofs(getDofs());
   newIK->setOffset(mOffset);
   newIK->setTarget(mTarget);
+  newIK->setSeedCache(mSeedCache);
 
   newIK->setObjective(cloneIkFunc(mObjective, newIK.get()));
   newIK->setNullSpaceObjective(cloneIkFunc(mNullSpaceObjective, newIK.get()));
@@ -817,22 +849,32 @@ void InverseKinematics::JacobianDLS::computeGradient(
 {
   const math::Jacobian& J = mIK->computeJacobian();
 
-  const double& damping = mDLSProperties.mDamping;
-  int rows = J.rows(), cols = J.cols();
+  // Solve the damped system with an LDLT factorization instead of inverting
+  // it. The system is at most 6x6 when the Jacobian has at least as many
+  // columns as rows, which is the usual case.
+  const double damping2 = mDLSProperties.mDamping * mDLSProperties.mDamping;
+  const int rows = static_cast<int>(J.rows());
+  const int cols = static_cast<int>(J.cols());
   if (rows <= cols)
   {
-    _grad = J.transpose()
-            * (pow(damping, 2) * Eigen::MatrixXd::Identity(rows, rows)
-               + J * J.transpose())
-                  .inverse()
-            * _error;
+    mTaskSpaceSystemCache.noalias() = J * J.transpose();
+    mTaskSpaceSystemCache.diagonal().array() += damping2;
+    mTaskSpaceLDLTCache.compute(mTaskSpaceSystemCache);
+    mTaskSpaceSolutionCache = mTaskSpaceLDLTCache.solve(_error);
+
+    _grad.resize(cols);
+    _grad.noalias() = J.transpose() * mTaskSpaceSolutionCache;
   }
   else
   {
-    _grad = (pow(damping, 2) * Eigen::MatrixXd::Identity(cols, cols)
-             + J.transpose() * J)
-                .inverse()
-            * J.transpose() * _error;
+    mJointSpaceSystemCache.resize(cols, cols);
+    mJointSpaceSystemCache.noalias() = J.transpose() * J;
+    mJointSpaceSystemCache.diagonal().array() += damping2;
+    mJointSpaceLDLTCache.compute(mJointSpaceSystemCache);
+
+    _grad.resize(cols);
+    _grad.noalias() = J.transpose() * _error;
+    mJointSpaceLDLTCache.solveInPlace(_grad);
   }
 
   convertJacobianMethodOutputToGradient(_grad, mIK->getDofs());
@@ -1589,6 +1631,26 @@ std::shared_ptr<const SimpleFrame> InverseKinematics::getTarget() const
   return mTarget;
 }
 
+//==============================================================================
+void InverseKinematics::setSeedCache(const std::shared_ptr<IkSeedCache>& cache)
+{
+  if (cache && cache->getNumDofs() != mDofs.size())
+  {
+    dtwarn << "[InverseKinematics::setSeedCache] The seed cache has ["
+           << cache->getNumDofs() << "] DOFs, but the IK module for ["
+           << mNode->getName() << "] has [" << mDofs.size() << "]. The cache "
+           << "will be ignored while the numbers differ.\n";
+  }
+
+  mSeedCache = cache;
+}
+
+//==============================================================================
+const std::shared_ptr<IkSeedCache>& InverseKinematics::getSeedCache() const
+{
+  return mSeedCache;
+}
+
 //==============================================================================
 JacobianNode* InverseKinematics::getNode()
 {
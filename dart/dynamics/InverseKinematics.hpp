@@ -41,6 +41,7 @@
 #include "dart/common/Signal.hpp"
 #include "dart/common/Subject.hpp"
 #include "dart/common/sub_ptr.hpp"
+#include "dart/dynamics/IkSeedCache.hpp"
 #include "dart/dynamics/JacobianNode.hpp"
 #include "dart/dynamics/SmartPointer.hpp"
 #include "dart/math/Geometry.hpp"
@@ -415,6 +416,16 @@ public:
   /// check whether this is a nullptr, because it cannot ever be set to nullptr.
   std::shared_ptr<const SimpleFrame> getTarget() const;
 
+  /// Set a cache of previous solutions, whose stored solutions nearest to the
+  /// target are used as the initial guess and the first seeds of the solver
+  /// by findSolution(). The cache can be shared by several IK modules with
+  /// the same number of DOFs, and clones of this module share it. Pass in a
+  /// nullptr to stop using a cache.
+  void setSeedCache(const std::shared_ptr<IkSeedCache>& cache);
+
+  /// Get the seed cache of this IK module, which may be a nullptr
+  const std::shared_ptr<IkSeedCache>& getSeedCache() const;
+
   /// Get the JacobianNode that this IK module operates on.
   JacobianNode* getNode();
 
@@ -523,6 +534,12 @@ protected:
   /// Target that this IK module should use
   std::shared_ptr<SimpleFrame> mTarget;
 
+  /// Cache of previous solutions, which may be a nullptr
+  std::shared_ptr<IkSeedCache> mSeedCache;
+
+  /// Cache for the solutions supplied by mSeedCache
+  std::vector<Eigen::VectorXd> mCachedSeeds;
+
   /// JacobianNode that this IK module is associated with
   sub_ptr<JacobianNode> mNode;
 
@@ -992,6 +1009,27 @@ public:
 protected:
   /// Properties of this Damped Least Squares method
   UniqueProperties mDLSProperties;
+
+  /// Cache for the damped task space system, which is solved instead of
+  /// inverting it
+  Eigen::Matrix6d mTaskSpaceSystemCache;
+
+  /// Cache for the factorization of the damped task space system
+  Eigen::LDLT<Eigen::Matrix6d> mTaskSpaceLDLTCache;
+
+  /// Cache for the damped joint space system, which is used when the
+  /// Jacobian has fewer columns than rows
+  Eigen::MatrixXd mJointSpaceSystemCache;
+
+  /// Cache for the factorization of the damped joint space system
+  Eigen::LDLT<Eigen::MatrixXd> mJointSpaceLDLTCache;
+
+  /// Cache for the solution of the damped task space system
+  Eigen::Vector6d mTaskSpaceSolutionCache;
+
+public:
+  // To get byte-aligned Eigen vectors
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
 //==============================================================================
@@ -0,0 +1,791 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/dynamics/SignedDistanceFieldShape.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+
+#include "dart/common/Console.hpp"
+#include "dart/dynamics/BoxShape.hpp"
+#include "dart/dynamics/MeshShape.hpp"
+
+namespace dart {
+namespace dynamics {
+
+namespace {
+
+constexpr char kFileMagic[8] = {'D', 'A', 'R', 'T', 'S', 'D', 'F', '\0'};
+constexpr std::uint32_t kFileVersion = 1u;
+
+//==============================================================================
+/// Returns the number of bytes between the current position of file and its
+/// end, or zero if the position can't be determined
+std::size_t getNumRemainingBytes(std::ifstream& file)
+{
+  const std::streampos current = file.tellg();
+  file.seekg(0, std::ios::end);
+  const std::streampos end = file.tellg();
+  file.seekg(current);
+
+  if (current < 0 || end < current)
+    return 0u;
+
+  return static_cast<std::size_t>(end - current);
+}
+
+//==============================================================================
+/// Returns the closest point on the triangle (a, b, c) to the point p
+Eigen::Vector3d computeClosestPointOnTriangle(
+    const Eigen::Vector3d& p,
+    const Eigen::Vector3d& a,
+    const Eigen::Vector3d& b,
+    const Eigen::Vector3d& c)
+{
+  // Reference: Real-Time Collision Detection by Christer Ericson, 5.1.5
+
+  const Eigen::Vector3d ab = b - a;
+  const Eigen::Vector3d ac = c - a;
+
+  const Eigen::Vector3d ap = p - a;
+  const double d1 = ab.dot(ap);
+  const double d2 = ac.dot(ap);
+  if (d1 <= 0.0 && d2 <= 0.0)
+    return a;
+
+  const Eigen::Vector3d bp = p - b;
+  const double d3 = ab.dot(bp);
+  const double d4 = ac.dot(bp);
+  if (d3 >= 0.0 && d4 <= d3)
+    return b;
+
+  const double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    return a + ab * (d1 / (d1 - d3));
+
+  const Eigen::Vector3d cp = p - c;
+  const double d5 = ab.dot(cp);
+  const double d6 = ac.dot(cp);
+  if (d6 >= 0.0 && d5 <= d6)
+    return c;
+
+  const double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    return a + ac * (d2 / (d2 - d6));
+
+  const double va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+  const double sum = va + vb + vc;
+  if (sum <= 0.0)
+    return a; // Degenerated triangle
+
+  return a + ab * (vb / sum) + ac * (vc / sum);
+}
+
+//==============================================================================
+/// Returns the orientation of the 2D points (x1, y1) and (x2, y2) with respect
+/// to the origin, and computes twice of the signed area of the triangle. Ties
+/// are broken consistently so that a point on an edge shared by two triangles
+/// is considered to be inside of exactly one of them.
+int computeOrientation(
+    double x1, double y1, double x2, double y2, double& twiceSignedArea)
+{
+  twiceSignedArea = y1 * x2 - x1 * y2;
+
+  if (twiceSignedArea > 0.0)
+    return 1;
+  else if (twiceSignedArea < 0.0)
+    return -1;
+  else if (y2 > y1)
+    return 1;
+  else if (y2 < y1)
+    return -1;
+  else if (x1 > x2)
+    return 1;
+  else if (x1 < x2)
+    return -1;
+  else
+    return 0;
+}
+
+//==============================================================================
+/// Returns true if the 2D point (x0, y0) is inside of the triangle, and
+/// computes the barycentric coordinates of the point.
+bool isInsideTriangle2d(
+    double x0,
+    double y0,
+    double x1,
+    double y1,
+    double x2,
+    double y2,
+    double x3,
+    double y3,
+    double& a,
+    double& b,
+    double& c)
+{
+  x1 -= x0;
+  x2 -= x0;
+  x3 -= x0;
+  y1 -= y0;
+  y2 -= y0;
+  y3 -= y0;
+
+  const int signA = computeOrientation(x2, y2, x3, y3, a);
+  if (signA == 0)
+    return false;
+
+  const int signB = computeOrientation(x3, y3, x1, y1, b);
+  if (signB != signA)
+    return false;
+
+  const int signC = computeOrientation(x1, y1, x2, y2, c);
+  if (signC != signA)
+    return false;
+
+  const double sum = a + b + c;
+  if (sum == 0.0)
+    return false;
+
+  a /= sum;
+  b /= sum;
+  c /= sum;
+
+  return true;
+}
+
+} // namespace
+
+//==============================================================================
+SignedDistanceFieldShape::SignedDistanceFieldShape(
+    const Eigen::Vector3d& origin,
+    double resolution,
+    const Eigen::Vector3i& gridSize,
+    std::vector<float> values)
+  : Shape(),
+    mOrigin(origin),
+    mResolution(resolution),
+    mGridSize(gridSize.cwiseMax(2)),
+    mValues(std::move(values))
+{
+  assert(resolution > 0.0);
+  assert((gridSize.array() >= 2).all());
+
+  const std::size_t numSamples = static_cast<std::size_t>(mGridSize[0])
+                                 * static_cast<std::size_t>(mGridSize[1])
+                                 * static_cast<std::size_t>(mGridSize[2]);
+
+  if (mValues.size() != numSamples)
+  {
+    dterr << "[SignedDistanceFieldShape] The number of values ("
+          << mValues.size() << ") doesn't match the grid size ("
+          << mGridSize.transpose() << "). Treating the missing samples as "
+          << "empty space.\n";
+    mValues.resize(numSamples, std::numeric_limits<float>::max());
+  }
+
+  mIsBoundingBoxDirty = true;
+  mIsVolumeDirty = true;
+}
+
+//==============================================================================
+std::shared_ptr<SignedDistanceFieldShape>
+SignedDistanceFieldShape::createFromTriangles(
+    const std::vector<Eigen::Vector3d>& vertices,
+    const std::vector<Eigen::Vector3i>& triangles,
+    double resolution,
+    double padding)
+{
+  if (vertices.empty() || triangles.empty())
+  {
+    dtwarn << "[SignedDistanceFieldShape::createFromTriangles] Attempting to "
+           << "create a signed distance field from an empty mesh. Returning "
+           << "nullptr.\n";
+    return nullptr;
+  }
+
+  if (!(resolution > 0.0))
+  {
+    dtwarn << "[SignedDistanceFieldShape::createFromTriangles] Invalid "
+           << "resolution (" << resolution << "). Returning nullptr.\n";
+    return nullptr;
+  }
+
+  const int numVertices = static_cast<int>(vertices.size());
+  for (const auto& triangle : triangles)
+  {
+    if ((triangle.array() < 0).any() || (triangle.array() >= numVertices).any())
+    {
+      dtwarn << "[SignedDistanceFieldShape::createFromTriangles] Invalid "
+             << "vertex index in triangle (" << triangle.transpose()
+             << "). Returning nullptr.\n";
+      return nullptr;
+    }
+  }
+
+  padding = std::max(padding, 0.0);
+
+  Eigen::Vector3d min = vertices[0];
+  Eigen::Vector3d max = vertices[0];
+  for (const auto& vertex : vertices)
+  {
+    min = min.cwiseMin(vertex);
+    max = max.cwiseMax(vertex);
+  }
+
+  const Eigen::Vector3d origin = min - Eigen::Vector3d::Constant(padding);
+
+  Eigen::Vector3i gridSize;
+  for (auto i = 0u; i < 3u; ++i)
+  {
+    const double extent = max[i] - min[i] + 2.0 * padding;
+    gridSize[i]
+        = std::max(2, static_cast<int>(std::ceil(extent / resolution)) + 1);
+  }
+
+  const int nx = gridSize[0];
+  const int ny = gridSize[1];
+  const int nz = gridSize[2];
+  const std::size_t numSamples = static_cast<std::size_t>(nx)
+                                 * static_cast<std::size_t>(ny)
+                                 * static_cast<std::size_t>(nz);
+
+  const auto getIndex = [&](int x, int y, int z) {
+    const auto sx = static_cast<std::size_t>(nx);
+    const auto sy = static_cast<std::size_t>(ny);
+    return static_cast<std::size_t>(x)
+           + sx
+                 * (static_cast<std::size_t>(y)
+                    + sy * static_cast<std::size_t>(z));
+  };
+
+  const auto getPosition = [&](int x, int y, int z) -> Eigen::Vector3d {
+    return origin + resolution * Eigen::Vector3d(x, y, z);
+  };
+
+  const auto computeDistance = [&](const Eigen::Vector3d& point, int t) {
+    const Eigen::Vector3i& triangle = triangles[static_cast<std::size_t>(t)];
+    return (point
+            - computeClosestPointOnTriangle(
+                point,
+                vertices[static_cast<std::size_t>(triangle[0])],
+                vertices[static_cast<std::size_t>(triangle[1])],
+                vertices[static_cast<std::size_t>(triangle[2])]))
+        .norm();
+  };
+
+  // Any distance in the grid is less than the sum of the grid extents
+  const double farDistance = resolution * (nx + ny + nz);
+  std::vector<double> distances(numSamples, farDistance);
+  std::vector<int> closestTriangles(numSamples, -1);
+
+  // Compute the exact distances of the samples around each triangle
+  for (auto t = 0u; t < triangles.size(); ++t)
+  {
+    const Eigen::Vector3i& triangle = triangles[t];
+    const Eigen::Vector3d& a = vertices[static_cast<std::size_t>(triangle[0])];
+    const Eigen::Vector3d& b = vertices[static_cast<std::size_t>(triangle[1])];
+    const Eigen::Vector3d& c = vertices[static_cast<std::size_t>(triangle[2])];
+
+    const Eigen::Vector3d lower
+        = (a.cwiseMin(b).cwiseMin(c) - origin) / resolution;
+    const Eigen::Vector3d upper
+        = (a.cwiseMax(b).cwiseMax(c) - origin) / resolution;
+
+    Eigen::Vector3i begin;
+    Eigen::Vector3i end;
+    for (auto i = 0u; i < 3u; ++i)
+    {
+      begin[i] = std::max(0, static_cast<int>(std::floor(lower[i])) - 1);
+      end[i] = std::min(
+          gridSize[i] - 1, static_cast<int>(std::ceil(upper[i])) + 1);
+    }
+
+    for (int z = begin[2]; z <= end[2]; ++z)
+    {
+      for (int y = begin[1]; y <= end[1]; ++y)
+      {
+        for (int x = begin[0]; x <= end[0]; ++x)
+        {
+          const std::size_t index = getIndex(x, y, z);
+          const double distance
+              = computeDistance(getPosition(x, y, z), static_cast<int>(t));
+          if (distance < distances[index])
+          {
+            distances[index] = distance;
+            closestTriangles[index] = static_cast<int>(t);
+          }
+        }
+      }
+    }
+  }
+
+  // Propagate the closest triangles to the rest of the grid by sweeping the
+  // grid in all the eight diagonal directions.
+  const auto checkNeighbor = [&](const Eigen::Vector3d& point,
+                                 std::size_t index,
+                                 std::size_t neighborIndex) {
+    const int t = closestTriangles[neighborIndex];
+    if (t < 0)
+      return;
+
+    const double distance = computeDistance(point, t);
+    if (distance < distances[index])
+    {
+      distances[index] = distance;
+      closestTriangles[index] = t;
+    }
+  };
+
+  const auto sweep = [&](int dx, int dy, int dz) {
+    const int x0 = dx > 0 ? 1 : nx - 2;
+    const int x1 = dx > 0 ? nx : -1;
+    const int y0 = dy > 0 ? 1 : ny - 2;
+    const int y1 = dy > 0 ? ny : -1;
+    const int z0 = dz > 0 ? 1 : nz - 2;
+    const int z1 = dz > 0 ? nz : -1;
+
+    for (int z = z0; z != z1; z += dz)
+    {
+      for (int y = y0; y != y1; y += dy)
+      {
+        for (int x = x0; x != x1; x += dx)
+        {
+          const Eigen::Vector3d point = getPosition(x, y, z);
+          const std::size_t index = getIndex(x, y, z);
+
+          checkNeighbor(point, index, getIndex(x - dx, y, z));
+          checkNeighbor(point, index, getIndex(x, y - dy, z));
+          checkNeighbor(point, index, getIndex(x - dx, y - dy, z));
+          checkNeighbor(point, index, getIndex(x, y, z - dz));
+          checkNeighbor(point, index, getIndex(x - dx, y, z - dz));
+          checkNeighbor(point, index, getIndex(x, y - dy, z - dz));
+          checkNeighbor(point, index, getIndex(x - dx, y - dy, z - dz));
+        }
+      }
+    }
+  };
+
+  for (auto pass = 0u; pass < 2u; ++pass)
+  {
+    sweep(+1, +1, +1);
+    sweep(-1, -1, -1);
+    sweep(+1, +1, -1);
+    sweep(-1, -1, +1);
+    sweep(+1, -1, +1);
+    sweep(-1, +1, -1);
+    sweep(+1, -1, -1);
+    sweep(-1, +1, +1);
+  }
+
+  // Determine the signs by counting the crossings of the rays along the x-axis
+  // with the mesh. A sample is inside of the mesh if the ray from the -x side
+  // of the grid crosses the mesh an odd number of times before reaching it.
+  std::vector<int> numCrossings(numSamples, 0);
+  for (const auto& triangle : triangles)
+  {
+    const Eigen::Vector3d a
+        = (vertices[static_cast<std::size_t>(triangle[0])] - origin)
+          / resolution;
+    const Eigen::Vector3d b
+        = (vertices[static_cast<std::size_t>(triangle[1])] - origin)
+          / resolution;
+    const Eigen::Vector3d c
+        = (vertices[static_cast<std::size_t>(triangle[2])] - origin)
+          / resolution;
+
+    const int y0 = std::max(
+        0, static_cast<int>(std::ceil(std::min({a[1], b[1], c[1]}))));
+    const int y1 = std::min(
+        ny - 1, static_cast<int>(std::floor(std::max({a[1], b[1], c[1]}))));
+    const int z0 = std::max(
+        0, static_cast<int>(std::ceil(std::min({a[2], b[2], c[2]}))));
+    const int z1 = std::min(
+        nz - 1, static_cast<int>(std::floor(std::max({a[2], b[2], c[2]}))));
+
+    for (int z = z0; z <= z1; ++z)
+    {
+      for (int y = y0; y <= y1; ++y)
+      {
+        double wa;
+        double wb;
+        double wc;
+        if (!isInsideTriangle2d(
+                y, z, a[1], a[2], b[1], b[2], c[1], c[2], wa, wb, wc))
+        {
+          continue;
+        }
+
+        const double crossing = wa * a[0] + wb * b[0] + wc * c[0];
+        const int x = static_cast<int>(std::ceil(crossing));
+        if (x < 0)
+          ++numCrossings[getIndex(0, y, z)];
+        else if (x < nx)
+          ++numCrossings[getIndex(x, y, z)];
+      }
+    }
+  }
+
+  std::vector<float> values(numSamples);
+  for (int z = 0; z < nz; ++z)
+  {
+    for (int y = 0; y < ny; ++y)
+    {
+      int total = 0;
+      for (int x = 0; x < nx; ++x)
+      {
+        const std::size_t index = getIndex(x, y, z);
+        total += numCrossings[index];
+
+        const double distance = distances[index];
+        values[index] = static_cast<float>(total % 2 ? -distance : distance);
+      }
+    }
+  }
+
+  return std::make_shared<SignedDistanceFieldShape>(
+      origin, resolution, gridSize, std::move(values));
+}
+
+//==============================================================================
+std::shared_ptr<SignedDistanceFieldShape>
+SignedDistanceFieldShape::createFromMesh(
+    const MeshShape& mesh, double resolution, double padding)
+{
+  const aiScene* scene = mesh.getMesh();
+  if (!scene)
+  {
+    dtwarn << "[SignedDistanceFieldShape::createFromMesh] Attempting to create "
+           << "a signed distance field from a MeshShape without mesh. "
+           << "Returning nullptr.\n";
+    return nullptr;
+  }
+
+  const Eigen::Vector3d& scale = mesh.getScale();
+
+  std::vector<Eigen::Vector3d> vertices;
+  std::vector<Eigen::Vector3i> triangles;
+
+  for (auto i = 0u; i < scene->mNumMeshes; ++i)
+  {
+    const aiMesh* subMesh = scene->mMeshes[i];
+    const int offset = static_cast<int>(vertices.size());
+
+    for (auto j = 0u; j < subMesh->mNumVertices; ++j)
+    {
+      const aiVector3D& vertex = subMesh->mVertices[j];
+      vertices.emplace_back(
+          vertex.x * scale[0], vertex.y * scale[1], vertex.z * scale[2]);
+    }
+
+    for (auto j = 0u; j < subMesh->mNumFaces; ++j)
+    {
+      const aiFace& face = subMesh->mFaces[j];
+
+      // Points and lines don't bound any volume
+      if (face.mNumIndices != 3u)
+        continue;
+
+      triangles.emplace_back(
+          offset + static_cast<int>(face.mIndices[0]),
+          offset + static_cast<int>(face.mIndices[1]),
+          offset + static_cast<int>(face.mIndices[2]));
+    }
+  }
+
+  return createFromTriangles(vertices, triangles, resolution, padding);
+}
+
+//==============================================================================
+std::shared_ptr<SignedDistanceFieldShape> SignedDistanceFieldShape::load(
+    const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+  {
+    dtwarn << "[SignedDistanceFieldShape::load] Failed to open file '" << path
+           << "'.\n";
+    return nullptr;
+  }
+
+  char magic[sizeof(kFileMagic)];
+  std::uint32_t version;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+  if (!file || !std::equal(magic, magic + sizeof(magic), kFileMagic)
+      || version != kFileVersion)
+  {
+    dtwarn << "[SignedDistanceFieldShape::load] File '" << path << "' is not "
+           << "a signed distance field of a supported version.\n";
+    return nullptr;
+  }
+
+  Eigen::Vector3d origin;
+  double resolution;
+  std::int32_t gridSize[3];
+  file.read(reinterpret_cast<char*>(origin.data()), 3 * sizeof(double));
+  file.read(reinterpret_cast<char*>(&resolution), sizeof(resolution));
+  file.read(reinterpret_cast<char*>(gridSize), sizeof(gridSize));
+
+  if (!file || !(resolution > 0.0) || gridSize[0] < 2 || gridSize[1] < 2
+      || gridSize[2] < 2)
+  {
+    dtwarn << "[SignedDistanceFieldShape::load] File '" << path << "' has an "
+           << "invalid header.\n";
+    return nullptr;
+  }
+
+  // Check the number of values against the size of the file before
+  // allocating them so that a corrupted header can't request an arbitrarily
+  // large allocation.
+  const std::size_t maxNumValues = getNumRemainingBytes(file) / sizeof(float);
+  std::size_t numValues = 1u;
+  for (const std::int32_t size : gridSize)
+  {
+    if (static_cast<std::size_t>(size) > maxNumValues / numValues)
+    {
+      dtwarn << "[SignedDistanceFieldShape::load] File '" << path << "' is "
+             << "truncated.\n";
+      return nullptr;
+    }
+
+    numValues *= static_cast<std::size_t>(size);
+  }
+
+  std::vector<float> values(numValues);
+  file.read(
+      reinterpret_cast<char*>(values.data()),
+      static_cast<std::streamsize>(values.size() * sizeof(float)));
+
+  if (!file)
+  {
+    dtwarn << "[SignedDistanceFieldShape::load] File '" << path << "' is "
+           << "truncated.\n";
+    return nullptr;
+  }
+
+  return std::make_shared<SignedDistanceFieldShape>(
+      origin,
+      resolution,
+      Eigen::Vector3i(gridSize[0], gridSize[1], gridSize[2]),
+      std::move(values));
+}
+
+//==============================================================================
+bool SignedDistanceFieldShape::save(const std::string& path) const
+{
+  std::ofstream file(path, std::ios::binary);
+  if (!file)
+  {
+    dtwarn << "[SignedDistanceFieldShape::save] Failed to open file '" << path
+           << "'.\n";
+    return false;
+  }
+
+  const std::int32_t gridSize[3] = {mGridSize[0], mGridSize[1], mGridSize[2]};
+
+  file.write(kFileMagic, sizeof(kFileMagic));
+  file.write(
+      reinterpret_cast<const char*>(&kFileVersion), sizeof(kFileVersion));
+  file.write(reinterpret_cast<const char*>(mOrigin.data()), 3 * sizeof(double));
+  file.write(reinterpret_cast<const char*>(&mResolution), sizeof(mResolution));
+  file.write(reinterpret_cast<const char*>(gridSize), sizeof(gridSize));
+  file.write(
+      reinterpret_cast<const char*>(mValues.data()),
+      static_cast<std::streamsize>(mValues.size() * sizeof(float)));
+
+  return static_cast<bool>(file);
+}
+
+//==============================================================================
+const std::string& SignedDistanceFieldShape::getType() const
+{
+  return getStaticType();
+}
+
+//==============================================================================
+const std::string& SignedDistanceFieldShape::getStaticType()
+{
+  static const std::string type("SignedDistanceFieldShape");
+  return type;
+}
+
+//==============================================================================
+const Eigen::Vector3d& SignedDistanceFieldShape::getOrigin() const
+{
+  return mOrigin;
+}
+
+//==============================================================================
+double SignedDistanceFieldShape::getResolution() const
+{
+  return mResolution;
+}
+
+//==============================================================================
+const Eigen::Vector3i& SignedDistanceFieldShape::getGridSize() const
+{
+  return mGridSize;
+}
+
+//==============================================================================
+const std::vector<float>& SignedDistanceFieldShape::getValues() const
+{
+  return mValues;
+}
+
+//==============================================================================
+bool SignedDistanceFieldShape::isInside(const Eigen::Vector3d& point) const
+{
+  const Eigen::Vector3d local = (point - mOrigin) / mResolution;
+
+  return (local.array() >= 0.0).all()
+         && (local.array() <= (mGridSize.array() - 1).cast<double>()).all();
+}
+
+//==============================================================================
+double SignedDistanceFieldShape::getDistance(const Eigen::Vector3d& point) const
+{
+  Eigen::Vector3d gradient;
+  return getDistance(point, gradient);
+}
+
+//==============================================================================
+double SignedDistanceFieldShape::getDistance(
+    const Eigen::Vector3d& point, Eigen::Vector3d& gradient) const
+{
+  const Eigen::Vector3d upper
+      = mOrigin + mResolution * (mGridSize.array() - 1).cast<double>().matrix();
+  const Eigen::Vector3d clamped = point.cwiseMax(mOrigin).cwiseMin(upper);
+  const Eigen::Vector3d local = (clamped - mOrigin) / mResolution;
+
+  const int x = std::min(static_cast<int>(local[0]), mGridSize[0] - 2);
+  const int y = std::min(static_cast<int>(local[1]), mGridSize[1] - 2);
+  const int z = std::min(static_cast<int>(local[2]), mGridSize[2] - 2);
+
+  const double fx = local[0] - x;
+  const double fy = local[1] - y;
+  const double fz = local[2] - z;
+  const double gx = 1.0 - fx;
+  const double gy = 1.0 - fy;
+  const double gz = 1.0 - fz;
+
+  const double c000 = mValues[getIndex(x, y, z)];
+  const double c100 = mValues[getIndex(x + 1, y, z)];
+  const double c010 = mValues[getIndex(x, y + 1, z)];
+  const double c110 = mValues[getIndex(x + 1, y + 1, z)];
+  const double c001 = mValues[getIndex(x, y, z + 1)];
+  const double c101 = mValues[getIndex(x + 1, y, z + 1)];
+  const double c011 = mValues[getIndex(x, y + 1, z + 1)];
+  const double c111 = mValues[getIndex(x + 1, y + 1, z + 1)];
+
+  // Trilinear interpolation
+  const double c00 = gx * c000 + fx * c100;
+  const double c10 = gx * c010 + fx * c110;
+  const double c01 = gx * c001 + fx * c101;
+  const double c11 = gx * c011 + fx * c111;
+  const double c0 = gy * c00 + fy * c10;
+  const double c1 = gy * c01 + fy * c11;
+
+  double distance = gz * c0 + fz * c1;
+
+  const Eigen::Vector3d offset = point - clamped;
+  const double offsetNorm = offset.norm();
+  if (offsetNorm > 0.0)
+  {
+    // The point is outside of the grid
+    gradient = offset / offsetNorm;
+    return distance + offsetNorm;
+  }
+
+  gradient[0] = gz * (gy * (c100 - c000) + fy * (c110 - c010))
+                + fz * (gy * (c101 - c001) + fy * (c111 - c011));
+  gradient[1] = gz * (c10 - c00) + fz * (c11 - c01);
+  gradient[2] = c1 - c0;
+  gradient /= mResolution;
+
+  return distance;
+}
+
+//==============================================================================
+Eigen::Vector3d SignedDistanceFieldShape::getGradient(
+    const Eigen::Vector3d& point) const
+{
+  Eigen::Vector3d gradient;
+  getDistance(point, gradient);
+  return gradient;
+}
+
+//==============================================================================
+Eigen::Matrix3d SignedDistanceFieldShape::computeInertia(double mass) const
+{
+  return BoxShape::computeInertia(
+      getBoundingBox().computeFullExtents(), mass);
+}
+
+//==============================================================================
+void SignedDistanceFieldShape::updateBoundingBox() const
+{
+  mBoundingBox.setMin(mOrigin);
+  mBoundingBox.setMax(
+      mOrigin + mResolution * (mGridSize.array() - 1).cast<double>().matrix());
+  mIsBoundingBoxDirty = false;
+}
+
+//==============================================================================
+void SignedDistanceFieldShape::updateVolume() const
+{
+  const auto numInside = std::count_if(
+      mValues.begin(), mValues.end(), [](float value) { return value < 0.0f; });
+
+  mVolume = static_cast<double>(numInside) * std::pow(mResolution, 3);
+  mIsVolumeDirty = false;
+}
+
+//==============================================================================
+std::size_t SignedDistanceFieldShape::getIndex(int x, int y, int z) const
+{
+  return static_cast<std::size_t>(x)
+         + static_cast<std::size_t>(mGridSize[0])
+               * (static_cast<std::size_t>(y)
+                  + static_cast<std::size_t>(mGridSize[1])
+                        * static_cast<std::size_t>(z));
+}
+
+} // namespace dynamics
+} // namespace dart
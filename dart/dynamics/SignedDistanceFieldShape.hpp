@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_DYNAMICS_SIGNEDDISTANCEFIELDSHAPE_HPP_
+#define DART_DYNAMICS_SIGNEDDISTANCEFIELDSHAPE_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/dynamics/Shape.hpp"
+
+namespace dart {
+namespace dynamics {
+
+class MeshShape;
+
+/// SignedDistanceFieldShape represents a static geometry by a signed distance
+/// field sampled on a regular grid. The distance is negative inside the
+/// geometry and positive outside.
+///
+/// The distance and its gradient at an arbitrary point are computed by
+/// trilinear interpolation of the eight samples around the point, so a query
+/// takes constant time regardless of the complexity of the original geometry.
+/// This makes the shape suitable for large static environments such as
+/// factory cells or terrain scans that are expensive to collide against as
+/// meshes.
+///
+/// The field is usually built once from a MeshShape with createFromMesh() and
+/// then saved to disk with save() to be loaded by load() afterwards.
+class SignedDistanceFieldShape : public Shape
+{
+public:
+  /// Constructor
+  ///
+  /// \param[in] origin Position of the first sample in the shape frame.
+  /// \param[in] resolution Distance between neighboring samples.
+  /// \param[in] gridSize Number of samples along each axis. Must be at least 2
+  /// for every axis.
+  /// \param[in] values Signed distances of the samples where the x index varies
+  /// fastest and the z index slowest. The size must be the product of the
+  /// elements of gridSize.
+  SignedDistanceFieldShape(
+      const Eigen::Vector3d& origin,
+      double resolution,
+      const Eigen::Vector3i& gridSize,
+      std::vector<float> values);
+
+  /// Creates a signed distance field from the triangles of a closed mesh.
+  ///
+  /// \param[in] vertices Vertices of the mesh.
+  /// \param[in] triangles Vertex indices of the triangles of the mesh.
+  /// \param[in] resolution Distance between neighboring samples.
+  /// \param[in] padding Margin added around the bounding box of the mesh.
+  /// Distances are only available inside the padded bounding box, so this
+  /// should be at least the largest penetration expected from the outside.
+  /// \return The created shape or nullptr if the input is invalid.
+  static std::shared_ptr<SignedDistanceFieldShape> createFromTriangles(
+      const std::vector<Eigen::Vector3d>& vertices,
+      const std::vector<Eigen::Vector3i>& triangles,
+      double resolution,
+      double padding);
+
+  /// Creates a signed distance field from a closed MeshShape. The scale of the
+  /// mesh is applied to the field.
+  ///
+  /// \sa createFromTriangles()
+  static std::shared_ptr<SignedDistanceFieldShape> createFromMesh(
+      const MeshShape& mesh, double resolution, double padding);
+
+  /// Loads a signed distance field saved by save().
+  ///
+  /// \return The loaded shape or nullptr if the file cannot be read.
+  static std::shared_ptr<SignedDistanceFieldShape> load(
+      const std::string& path);
+
+  /// Saves this signed distance field to a binary file in the native byte
+  /// order.
+  ///
+  /// \return True if the file is successfully written.
+  bool save(const std::string& path) const;
+
+  // Documentation inherited.
+  const std::string& getType() const override;
+
+  /// Returns shape type for this class
+  static const std::string& getStaticType();
+
+  /// Returns the position of the first sample in the shape frame
+  const Eigen::Vector3d& getOrigin() const;
+
+  /// Returns the distance between neighboring samples
+  double getResolution() const;
+
+  /// Returns the number of samples along each axis
+  const Eigen::Vector3i& getGridSize() const;
+
+  /// Returns the signed distances of the samples
+  const std::vector<float>& getValues() const;
+
+  /// Returns true if the point (in the shape frame) is inside the grid, where
+  /// the distances are known.
+  bool isInside(const Eigen::Vector3d& point) const;
+
+  /// Returns the signed distance at the point in the shape frame. For a point
+  /// outside the grid, the distance is approximated by adding the distance to
+  /// the grid to the signed distance at the nearest point of the grid.
+  double getDistance(const Eigen::Vector3d& point) const;
+
+  /// Returns the signed distance at the point in the shape frame and computes
+  /// the gradient of the distance, which is the unnormalized outward direction
+  /// of the nearest surface.
+  double getDistance(
+      const Eigen::Vector3d& point, Eigen::Vector3d& gradient) const;
+
+  /// Returns the gradient of the signed distance at the point in the shape
+  /// frame.
+  Eigen::Vector3d getGradient(const Eigen::Vector3d& point) const;
+
+  /// Computes the inertia approximated by the inertia of the bounding box.
+  Eigen::Matrix3d computeInertia(double mass) const override;
+
+protected:
+  // Documentation inherited.
+  void updateBoundingBox() const override;
+
+  /// Updates the volume approximated by the number of the samples inside the
+  /// geometry.
+  void updateVolume() const override;
+
+  /// Returns the index of the sample in mValues
+  std::size_t getIndex(int x, int y, int z) const;
+
+private:
+  /// Position of the first sample in the shape frame
+  Eigen::Vector3d mOrigin;
+
+  /// Distance between neighboring samples
+  double mResolution;
+
+  /// Number of samples along each axis
+  Eigen::Vector3i mGridSize;
+
+  /// Signed distances of the samples. Single precision is used to keep large
+  /// fields compact.
+  std::vector<float> mValues;
+};
+
+} // namespace dynamics
+} // namespace dart
+
+#endif // DART_DYNAMICS_SIGNEDDISTANCEFIELDSHAPE_HPP_
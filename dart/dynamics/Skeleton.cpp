@@ -181,13 +181,17 @@ SkeletonAspectProperties::SkeletonAspectProperties(
     const Eigen::Vector3d& _gravity,
     double _timeStep,
     bool _enabledSelfCollisionCheck,
-    bool _enableAdjacentBodyCheck)
+    bool _enableAdjacentBodyCheck,
+    bool _isSleepingAllowed,
+    bool _enabledImplicitIntegration)
   : mName(_name),
     mIsMobile(_isMobile),
     mGravity(_gravity),
     mTimeStep(_timeStep),
     mEnabledSelfCollisionCheck(_enabledSelfCollisionCheck),
-    mEnabledAdjacentBodyCheck(_enableAdjacentBodyCheck)
+    mEnabledAdjacentBodyCheck(_enableAdjacentBodyCheck),
+    mIsSleepingAllowed(_isSleepingAllowed),
+    mEnabledImplicitIntegration(_enabledImplicitIntegration)
 {
   // Do nothing
 }
@@ -648,6 +652,8 @@ void Skeleton::setAspectProperties(const AspectProperties& properties)
   setTimeStep(properties.mTimeStep);
   setSelfCollisionCheck(properties.mEnabledSelfCollisionCheck);
   setAdjacentBodyCheck(properties.mEnabledAdjacentBodyCheck);
+  setSleepingAllowed(properties.mIsSleepingAllowed);
+  setImplicitIntegration(properties.mEnabledImplicitIntegration);
 }
 
 //==============================================================================
@@ -816,6 +822,30 @@ bool Skeleton::isMobile() const
   return mAspectProperties.mIsMobile;
 }
 
+//==============================================================================
+void Skeleton::setSleepingAllowed(bool allowed)
+{
+  mAspectProperties.mIsSleepingAllowed = allowed;
+}
+
+//==============================================================================
+bool Skeleton::isSleepingAllowed() const
+{
+  return mAspectProperties.mIsSleepingAllowed;
+}
+
+//==============================================================================
+void Skeleton::setSleeping(bool sleeping)
+{
+  mIsSleeping = sleeping;
+}
+
+//==============================================================================
+bool Skeleton::isSleeping() const
+{
+  return mIsSleeping;
+}
+
 //==============================================================================
 void Skeleton::setTimeStep(double _timeStep)
 {
@@ -832,6 +862,62 @@ double Skeleton::getTimeStep() const
   return mAspectProperties.mTimeStep;
 }
 
+//==============================================================================
+void Skeleton::setImplicitIntegration(bool enabled)
+{
+  mAspectProperties.mEnabledImplicitIntegration = enabled;
+}
+
+//==============================================================================
+bool Skeleton::isImplicitIntegrationEnabled() const
+{
+  return mAspectProperties.mEnabledImplicitIntegration;
+}
+
+//==============================================================================
+void Skeleton::setForceJacobians(
+    const Eigen::MatrixXd& positionJacobian,
+    const Eigen::MatrixXd& velocityJacobian)
+{
+  const auto dofs = static_cast<int>(getNumDofs());
+  if ((positionJacobian.size() > 0
+       && (positionJacobian.rows() != dofs || positionJacobian.cols() != dofs))
+      || (velocityJacobian.size() > 0
+          && (velocityJacobian.rows() != dofs
+              || velocityJacobian.cols() != dofs)))
+  {
+    dterr << "[Skeleton::setForceJacobians] The Jacobians of Skeleton named ["
+          << getName() << "] must be " << dofs << "x" << dofs
+          << " matrices or empty, but their sizes are "
+          << positionJacobian.rows() << "x" << positionJacobian.cols()
+          << " and " << velocityJacobian.rows() << "x"
+          << velocityJacobian.cols() << ". Ignoring this request.\n";
+    return;
+  }
+
+  mForcePositionJacobian = positionJacobian;
+  mForceVelocityJacobian = velocityJacobian;
+}
+
+//==============================================================================
+void Skeleton::clearForceJacobians()
+{
+  mForcePositionJacobian.resize(0, 0);
+  mForceVelocityJacobian.resize(0, 0);
+}
+
+//==============================================================================
+const Eigen::MatrixXd& Skeleton::getForcePositionJacobian() const
+{
+  return mForcePositionJacobian;
+}
+
+//==============================================================================
+const Eigen::MatrixXd& Skeleton::getForceVelocityJacobian() const
+{
+  return mForceVelocityJacobian;
+}
+
 //==============================================================================
 void Skeleton::setGravity(const Eigen::Vector3d& _gravity)
 {
@@ -2130,7 +2216,11 @@ const Eigen::VectorXd& Skeleton::getConstraintForces() const
 
 //==============================================================================
 Skeleton::Skeleton(const AspectPropertiesData& properties)
-  : mTotalMass(0.0), mIsImpulseApplied(false), mUnionSize(1)
+  : mTotalMass(0.0),
+    mIsImpulseApplied(false),
+    mIsSleeping(false),
+    mUnionSize(1),
+    mUnionIndex(0)
 {
   createAspect<Aspect>(properties);
   createAspect<detail::BodyNodeVectorProxyAspect>();
@@ -3717,6 +3807,13 @@ void Skeleton::computeForwardKinematics(
 //==============================================================================
 void Skeleton::computeForwardDynamics()
 {
+  if (mAspectProperties.mEnabledImplicitIntegration
+      && canIntegrateImplicitly())
+  {
+    computeImplicitForwardDynamics();
+    return;
+  }
+
   // Note: Articulated Inertias will be updated automatically when
   // getArtInertiaImplicit() is called in BodyNode::updateBiasForce()
 
@@ -3735,6 +3832,91 @@ void Skeleton::computeForwardDynamics()
   }
 }
 
+//==============================================================================
+bool Skeleton::canIntegrateImplicitly() const
+{
+  if (getNumDofs() == 0u || !mSoftBodyNodes.empty())
+    return false;
+
+  for (const auto* bodyNode : mSkelCache.mBodyNodes)
+  {
+    if (bodyNode->getParentJoint()->isKinematic())
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+void Skeleton::computeImplicitForwardDynamics()
+{
+  // Linearized backward Euler step of M * ddq = f(q, dq):
+  //
+  //   (M - h * df/ddq - h^2 * df/dq) * dv = h * (f + h * df/dq * dq)
+  //
+  // where dv = h * ddq is the velocity change of the step. The joint springs
+  // and dampers contribute diagonal terms to the Jacobians of f, which gives
+  // the same result as the articulated body algorithm with the implicit joint
+  // terms. The user-provided Jacobians can couple the coordinates.
+  const double h = mAspectProperties.mTimeStep;
+  const auto& dofs = mSkelCache.mDofs;
+  const std::size_t numDofs = dofs.size();
+
+  // Map the commands of the actuators to the joint forces like
+  // GenericJoint::updateTotalForce() does. The joints are all dynamic, which
+  // canIntegrateImplicitly() checks.
+  for (DegreeOfFreedom* dof : dofs)
+  {
+    switch (dof->getJoint()->getActuatorType())
+    {
+      case Joint::FORCE:
+        dof->setForce(math::clip(
+            dof->getCommand(),
+            dof->getForceLowerLimit(),
+            dof->getForceUpperLimit()));
+        break;
+      case Joint::PASSIVE:
+      case Joint::SERVO:
+      case Joint::MIMIC:
+        dof->setForce(0.0);
+        break;
+      default:
+        break;
+    }
+  }
+
+  mImplicitMatrix = getMassMatrix();
+  mImplicitForces = getForces() - getCoriolisAndGravityForces()
+                    + getExternalForces();
+  const Eigen::VectorXd& velocities = getVelocities();
+
+  for (std::size_t i = 0u; i < numDofs; ++i)
+  {
+    const DegreeOfFreedom* dof = dofs[i];
+    const double stiffness = dof->getSpringStiffness();
+    const double damping = dof->getDampingCoefficient();
+    const double velocity = velocities[static_cast<int>(i)];
+
+    const double deflection = dof->getPosition() - dof->getRestPosition();
+
+    mImplicitForces[i]
+        -= stiffness * (deflection + h * velocity) + damping * velocity;
+    mImplicitMatrix(i, i) += h * damping + h * h * stiffness;
+  }
+
+  if (mForceVelocityJacobian.size() > 0)
+    mImplicitMatrix.noalias() -= h * mForceVelocityJacobian;
+
+  if (mForcePositionJacobian.size() > 0)
+  {
+    mImplicitMatrix.noalias() -= h * h * mForcePositionJacobian;
+    mImplicitForces.noalias() += h * mForcePositionJacobian * velocities;
+  }
+
+  // The user-provided Jacobians are not necessarily symmetric
+  setAccelerations(mImplicitMatrix.partialPivLu().solve(mImplicitForces));
+}
+
 //==============================================================================
 void Skeleton::computeInverseDynamics(
     bool _withExternalForces, bool _withDampingForces, bool _withSpringForces)
@@ -302,6 +302,24 @@ public:
   /// \return True if this skeleton is mobile.
   bool isMobile() const;
 
+  /// Set whether World is allowed to put this skeleton to sleep when it comes
+  /// to rest. Sleeping is allowed by default, but only takes effect when it's
+  /// enabled in the World.
+  void setSleepingAllowed(bool allowed);
+
+  /// Get whether World is allowed to put this skeleton to sleep.
+  bool isSleepingAllowed() const;
+
+  /// Set whether this skeleton is sleeping. A sleeping skeleton is not updated
+  /// by forward dynamics and doesn't respond to constraint impulses, like an
+  /// immobile skeleton. This is managed by World, which wakes the skeleton up
+  /// when its state changes, forces are applied to it, or an awake skeleton
+  /// touches it.
+  void setSleeping(bool sleeping);
+
+  /// Get whether this skeleton is sleeping.
+  bool isSleeping() const;
+
   /// Set time step. This timestep is used for implicit joint damping
   /// force.
   void setTimeStep(double _timeStep);
@@ -309,6 +327,46 @@ public:
   /// Get time step.
   double getTimeStep() const;
 
+  /// Set whether computeForwardDynamics() takes a linearized backward Euler
+  /// step instead of running the articulated body algorithm. The accelerations
+  /// are then computed such that integrating the velocities over the time
+  /// step accounts for how the joint springs and dampers and the forces
+  /// described by the force Jacobians (see setForceJacobians()) change within
+  /// the step. This keeps stiff couplings such as high-gain PD controllers
+  /// stable at much larger time steps, at the cost of factorizing a dense
+  /// matrix of the size of the degrees of freedom. Without force Jacobians,
+  /// the result is the same as the articulated body algorithm, which already
+  /// treats the joint springs and dampers implicitly.
+  ///
+  /// Skeletons with kinematic joints or soft bodies always use the
+  /// articulated body algorithm. Disabled by default.
+  void setImplicitIntegration(bool enabled);
+
+  /// Get whether the linearized backward Euler step is enabled.
+  bool isImplicitIntegrationEnabled() const;
+
+  /// Set the Jacobians of the generalized forces applied to this skeleton,
+  /// i.e., the joint forces and the external forces, with respect to the
+  /// positions and the velocities. They are used by the linearized backward
+  /// Euler step (see setImplicitIntegration()). For example, a PD controller
+  /// that applies -Kp * (q - q_d) - Kd * dq has the Jacobians -Kp and -Kd.
+  /// Either matrix can be empty. The Jacobians are kept until they are set or
+  /// cleared again.
+  void setForceJacobians(
+      const Eigen::MatrixXd& positionJacobian,
+      const Eigen::MatrixXd& velocityJacobian);
+
+  /// Clear the force Jacobians
+  void clearForceJacobians();
+
+  /// Get the Jacobian of the applied generalized forces with respect to the
+  /// positions. Empty if not set.
+  const Eigen::MatrixXd& getForcePositionJacobian() const;
+
+  /// Get the Jacobian of the applied generalized forces with respect to the
+  /// velocities. Empty if not set.
+  const Eigen::MatrixXd& getForceVelocityJacobian() const;
+
   /// Set 3-dim gravitational acceleration. The gravity is used for
   /// calculating gravity force vector of the skeleton.
   void setGravity(const Eigen::Vector3d& _gravity);
@@ -1066,6 +1124,13 @@ protected:
   /// Update the computation for total mass
   void updateTotalMass();
 
+  /// Return true if the linearized backward Euler step can be used, i.e., the
+  /// skeleton has degrees of freedom but no kinematic joints or soft bodies
+  bool canIntegrateImplicitly() const;
+
+  /// Compute the accelerations with the linearized backward Euler step
+  void computeImplicitForwardDynamics();
+
   /// Update the dimensions for a specific cache
   void updateCacheDimensions(DataCache& _cache);
 
@@ -1290,6 +1355,22 @@ protected:
   /// Flag for status of impulse testing.
   bool mIsImpulseApplied;
 
+  /// Whether this skeleton is sleeping
+  bool mIsSleeping;
+
+  /// Jacobian of the applied generalized forces with respect to the positions
+  Eigen::MatrixXd mForcePositionJacobian;
+
+  /// Jacobian of the applied generalized forces with respect to the
+  /// velocities
+  Eigen::MatrixXd mForceVelocityJacobian;
+
+  /// Cache data for the matrix of the linearized backward Euler step
+  Eigen::MatrixXd mImplicitMatrix;
+
+  /// Cache data for the right-hand side of the linearized backward Euler step
+  Eigen::VectorXd mImplicitForces;
+
   mutable std::mutex mMutex;
 
 public:
@@ -90,6 +90,11 @@ struct BodyNodeAspectProperties
   /// Gravity will be applied if true
   bool mGravityMode;
 
+  /// Indicates whether the collision shapes of this node are swept along their
+  /// motion within a time step to detect the collisions that a discrete check
+  /// would miss
+  bool mEnabledContinuousCollisionCheck;
+
   /// Constructor
   /// \deprecated Deprecated since DART 6.10 because the friction and
   /// restitution properties shouldn't be included in this constructor since
@@ -108,7 +113,8 @@ struct BodyNodeAspectProperties
       const std::string& name = "BodyNode",
       const Inertia& inertia = Inertia(),
       bool isCollidable = true,
-      bool gravityMode = true);
+      bool gravityMode = true,
+      bool enabledContinuousCollisionCheck = false);
 
   virtual ~BodyNodeAspectProperties() = default;
 };
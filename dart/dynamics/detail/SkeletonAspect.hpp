@@ -75,6 +75,14 @@ struct SkeletonAspectProperties
   /// ignored.
   bool mEnabledAdjacentBodyCheck;
 
+  /// True if the World is allowed to put this skeleton to sleep when it comes
+  /// to rest.
+  bool mIsSleepingAllowed;
+
+  /// True if the velocities are integrated with the linearized backward Euler
+  /// method, see Skeleton::setImplicitIntegration().
+  bool mEnabledImplicitIntegration;
+
   /// Default constructor
   SkeletonAspectProperties(
       const std::string& _name = "Skeleton",
@@ -82,7 +90,9 @@ struct SkeletonAspectProperties
       const Eigen::Vector3d& _gravity = Eigen::Vector3d(0.0, 0.0, -9.81),
       double _timeStep = 0.001,
       bool _enabledSelfCollisionCheck = false,
-      bool _enableAdjacentBodyCheck = false);
+      bool _enableAdjacentBodyCheck = false,
+      bool _isSleepingAllowed = true,
+      bool _enabledImplicitIntegration = false);
 
   virtual ~SkeletonAspectProperties() = default;
 };
@@ -28,7 +28,7 @@ namespace dart {
 namespace external {
 namespace ode {
 
-dReal _dDot (const dReal *a, const dReal *b, int n)
+static dReal dDotScalar (const dReal *a, const dReal *b, int n)
 {  
   dReal p0,q0,m0,p1,q1,m1,sum;
   sum = 0;
@@ -54,6 +54,12 @@ dReal _dDot (const dReal *a, const dReal *b, int n)
   return sum;
 }
 
+dReal _dDot (const dReal *a, const dReal *b, int n)
+{
+  if (_dSimdKernelsEnabled()) return _dDotSimd (a, b, n);
+  return dDotScalar (a, b, n);
+}
+
 
 #undef dDot
 
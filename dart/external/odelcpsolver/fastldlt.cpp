@@ -194,7 +194,7 @@ static void dSolveL1_2 (const dReal *L, dReal *B, int n, int lskip1)
 }
 
 
-void _dFactorLDLT (dReal *A, dReal *d, int n, int nskip1)
+static void dFactorLDLTScalar (dReal *A, dReal *d, int n, int nskip1)
 {  
   int i,j;
   dReal sum,*ell,*dee,dd,p1,p2,q1,q2,Z11,m11,Z21,m21,Z22,m22;
@@ -406,6 +406,13 @@ void _dFactorLDLT (dReal *A, dReal *d, int n, int nskip1)
   }
 }
 
+void _dFactorLDLT (dReal *A, dReal *d, int n, int nskip1)
+{
+  /* the 2-row scalar code is faster for small matrices */
+  if (n >= 96 && _dSimdKernelsEnabled()) _dFactorLDLTSimd (A, d, n, nskip1);
+  else dFactorLDLTScalar (A, d, n, nskip1);
+}
+
 
 #undef dFactorLDLT
 
@@ -36,7 +36,7 @@ namespace ode {
  * this processes blocks of 4.
  */
 
-void _dSolveL1T (const dReal *L, dReal *B, int n, int lskip1)
+static void dSolveL1TScalar (const dReal *L, dReal *B, int n, int lskip1)
 {  
   /* declare variables - Z matrix, p and q vectors, etc */
   dReal Z11,m11,Z21,m21,Z31,m31,Z41,m41,p1,q1,p2,p3,p4,*ex;
@@ -224,6 +224,12 @@ void _dSolveL1T (const dReal *L, dReal *B, int n, int lskip1)
   }
 }
 
+void _dSolveL1T (const dReal *L, dReal *B, int n, int lskip1)
+{
+  if (_dSimdKernelsEnabled()) _dSolveL1TSimd (L, B, n, lskip1);
+  else dSolveL1TScalar (L, B, n, lskip1);
+}
+
 
 #undef dSolveL1T
 
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* SIMD versions of _dDot, _dSolveL1, _dSolveL1T and _dFactorLDLT, and the
+ * per-thread switch that selects them. see matrix.h.
+ *
+ * the kernels use the same storage conventions as the scalar code (row major
+ * L with leading dimension nskip, d holding the reciprocals of the diagonal).
+ * the triangular solves and the factorizer work on blocks of 4 (or 8) rows
+ * so that every row of L that is streamed from memory is used against 4 (or
+ * 8) accumulators instead of 1 or 2.
+ */
+
+#include "dart/external/odelcpsolver/matrix.h"
+
+#if defined(dDOUBLE) && (defined(__x86_64__) || defined(_M_X64)) \
+    && (defined(__GNUC__) || defined(__clang__) || defined(__AVX2__))
+#define dSIMD_AVX2 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define dSIMD_TARGET __attribute__((target("avx2,fma")))
+#else
+#define dSIMD_TARGET
+#endif
+#elif defined(dDOUBLE) && defined(__aarch64__) && defined(__ARM_NEON)
+#define dSIMD_NEON 1
+#include <arm_neon.h>
+#define dSIMD_TARGET
+#endif
+
+#ifndef dSIMD_KERNELS_DEFAULT
+#define dSIMD_KERNELS_DEFAULT 0
+#endif
+
+namespace dart {
+namespace external {
+namespace ode {
+
+#if defined(dSIMD_AVX2) || defined(dSIMD_NEON)
+
+#if defined(dSIMD_AVX2)
+
+typedef __m256d dVec;
+#define dVEC_WIDTH 4
+#define dVecZero() _mm256_setzero_pd()
+#define dVecSet1(s) _mm256_set1_pd(s)
+#define dVecLoad(p) _mm256_loadu_pd(p)
+#define dVecStore(p, v) _mm256_storeu_pd(p, v)
+#define dVecAdd(a, b) _mm256_add_pd(a, b)
+#define dVecMul(a, b) _mm256_mul_pd(a, b)
+/* c + a*b and c - a*b */
+#define dVecMulAdd(c, a, b) _mm256_fmadd_pd(a, b, c)
+#define dVecMulSub(c, a, b) _mm256_fnmadd_pd(a, b, c)
+
+dSIMD_TARGET static inline dReal dVecSum (dVec v)
+{
+  __m128d s = _mm_add_pd (_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+  return _mm_cvtsd_f64 (_mm_add_sd (s, _mm_unpackhi_pd (s, s)));
+}
+
+#else // dSIMD_NEON
+
+typedef float64x2_t dVec;
+#define dVEC_WIDTH 2
+#define dVecZero() vdupq_n_f64(0.0)
+#define dVecSet1(s) vdupq_n_f64(s)
+#define dVecLoad(p) vld1q_f64(p)
+#define dVecStore(p, v) vst1q_f64(p, v)
+#define dVecAdd(a, b) vaddq_f64(a, b)
+#define dVecMul(a, b) vmulq_f64(a, b)
+#define dVecMulAdd(c, a, b) vfmaq_f64(c, a, b)
+#define dVecMulSub(c, a, b) vfmsq_f64(c, a, b)
+
+static inline dReal dVecSum (dVec v)
+{
+  return vaddvq_f64 (v);
+}
+
+#endif
+
+static int dDetectSimdKernels()
+{
+#if defined(dSIMD_AVX2) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+  /* NEON is part of the AArch64 baseline, and MSVC only gets here when the
+   * whole build targets AVX2 already. */
+  return 1;
+#endif
+}
+
+
+/* dot products of 4 rows of L with one vector x, over n elements. */
+
+dSIMD_TARGET static void dDot4Rows (const dReal *l0, const dReal *l1,
+  const dReal *l2, const dReal *l3, const dReal *x, int n, dReal *out)
+{
+  dVec z0 = dVecZero(), z1 = dVecZero(), z2 = dVecZero(), z3 = dVecZero();
+  int j = 0;
+  for (; j <= n-dVEC_WIDTH; j += dVEC_WIDTH) {
+    const dVec q = dVecLoad (x+j);
+    z0 = dVecMulAdd (z0, dVecLoad (l0+j), q);
+    z1 = dVecMulAdd (z1, dVecLoad (l1+j), q);
+    z2 = dVecMulAdd (z2, dVecLoad (l2+j), q);
+    z3 = dVecMulAdd (z3, dVecLoad (l3+j), q);
+  }
+  dReal s0 = dVecSum (z0), s1 = dVecSum (z1), s2 = dVecSum (z2), s3 = dVecSum (z3);
+  for (; j < n; ++j) {
+    const dReal q = x[j];
+    s0 += l0[j]*q;
+    s1 += l1[j]*q;
+    s2 += l2[j]*q;
+    s3 += l3[j]*q;
+  }
+  out[0] = s0;
+  out[1] = s1;
+  out[2] = s2;
+  out[3] = s3;
+}
+
+
+/* dot products of one row of L with NB vectors x[0..NB-1], over n elements. */
+
+template <int NB>
+dSIMD_TARGET static void dDotNVectors (const dReal *l, dReal *const *x, int n,
+  dReal *out)
+{
+  dVec z[NB];
+  for (int r = 0; r < NB; ++r) z[r] = dVecZero();
+  int j = 0;
+  for (; j <= n-dVEC_WIDTH; j += dVEC_WIDTH) {
+    const dVec p = dVecLoad (l+j);
+    for (int r = 0; r < NB; ++r) z[r] = dVecMulAdd (z[r], p, dVecLoad (x[r]+j));
+  }
+  for (int r = 0; r < NB; ++r) {
+    dReal s = dVecSum (z[r]);
+    for (int k = j; k < n; ++k) s += l[k]*x[r][k];
+    out[r] = s;
+  }
+}
+
+
+dSIMD_TARGET dReal _dDotSimd (const dReal *a, const dReal *b, int n)
+{
+  dVec z0 = dVecZero(), z1 = dVecZero();
+  int j = 0;
+  for (; j <= n-2*dVEC_WIDTH; j += 2*dVEC_WIDTH) {
+    z0 = dVecMulAdd (z0, dVecLoad (a+j), dVecLoad (b+j));
+    z1 = dVecMulAdd (z1, dVecLoad (a+j+dVEC_WIDTH), dVecLoad (b+j+dVEC_WIDTH));
+  }
+  dReal sum = dVecSum (dVecAdd (z0, z1));
+  for (; j < n; ++j) sum += a[j]*b[j];
+  return sum;
+}
+
+
+dSIMD_TARGET void _dSolveL1Simd (const dReal *L, dReal *B, int n, int nskip)
+{
+  int i = 0;
+  for (; i <= n-4; i += 4) {
+    const dReal *l0 = L + i*nskip;
+    const dReal *l1 = l0 + nskip;
+    const dReal *l2 = l1 + nskip;
+    const dReal *l3 = l2 + nskip;
+    dReal z[4];
+    dDot4Rows (l0, l1, l2, l3, B, i, z);
+    /* finish the 4 x 4 triangle on the diagonal */
+    const dReal x0 = B[i] - z[0];
+    const dReal x1 = B[i+1] - z[1] - l1[i]*x0;
+    const dReal x2 = B[i+2] - z[2] - l2[i]*x0 - l2[i+1]*x1;
+    const dReal x3 = B[i+3] - z[3] - l3[i]*x0 - l3[i+1]*x1 - l3[i+2]*x2;
+    B[i] = x0;
+    B[i+1] = x1;
+    B[i+2] = x2;
+    B[i+3] = x3;
+  }
+  for (; i < n; ++i) B[i] -= _dDotSimd (L + i*nskip, B, i);
+}
+
+
+dSIMD_TARGET void _dSolveL1TSimd (const dReal *L, dReal *B, int n, int nskip)
+{
+  /* back substitution in axpy form: once x(k) is known, row k of L is
+   * subtracted from B(0..k-1). 4 rows are applied in one pass over B. */
+  int i = n;
+  for (; i >= 4; i -= 4) {
+    const dReal *l0 = L + (i-4)*nskip;
+    const dReal *l1 = l0 + nskip;
+    const dReal *l2 = l1 + nskip;
+    const dReal *l3 = l2 + nskip;
+    const int k = i-4;
+    /* finish the 4 x 4 triangle on the diagonal */
+    const dReal x3 = B[k+3];
+    const dReal x2 = B[k+2] - l3[k+2]*x3;
+    const dReal x1 = B[k+1] - l2[k+1]*x2 - l3[k+1]*x3;
+    const dReal x0 = B[k] - l1[k]*x1 - l2[k]*x2 - l3[k]*x3;
+    B[k] = x0;
+    B[k+1] = x1;
+    B[k+2] = x2;
+    B[k+3] = x3;
+    const dVec q0 = dVecSet1 (x0), q1 = dVecSet1 (x1);
+    const dVec q2 = dVecSet1 (x2), q3 = dVecSet1 (x3);
+    int j = 0;
+    for (; j <= k-dVEC_WIDTH; j += dVEC_WIDTH) {
+      dVec b = dVecLoad (B+j);
+      b = dVecMulSub (b, dVecLoad (l0+j), q0);
+      b = dVecMulSub (b, dVecLoad (l1+j), q1);
+      b = dVecMulSub (b, dVecLoad (l2+j), q2);
+      b = dVecMulSub (b, dVecLoad (l3+j), q3);
+      dVecStore (B+j, b);
+    }
+    for (; j < k; ++j) B[j] -= l0[j]*x0 + l1[j]*x1 + l2[j]*x2 + l3[j]*x3;
+  }
+  for (--i; i > 0; --i) {
+    const dReal *ell = L + i*nskip;
+    const dReal x = B[i];
+    for (int j = 0; j < i; ++j) B[j] -= ell[j]*x;
+  }
+}
+
+
+/* solve L*z = a in place for the NB rows a[] of A over columns k0..k1-1,
+ * given that columns 0..k0-1 are solved already. z is D*l, the unscaled
+ * row. */
+
+template <int NB>
+dSIMD_TARGET static void dSolveRowsL1 (const dReal *A, dReal *const *a,
+  int k0, int k1, int nskip)
+{
+  for (int k = k0; k < k1; ++k) {
+    dReal s[NB];
+    dDotNVectors<NB> (A + k*nskip, a, k, s);
+    for (int r = 0; r < NB; ++r) a[r][k] -= s[r];
+  }
+}
+
+
+/* finish factorizing the NB rows a[] starting at row i once dSolveRowsL1()
+ * has been applied to columns 0..i-1: scale z to l = D^-1 z, and factorize
+ * the NB x NB block on the diagonal. */
+
+template <int NB>
+dSIMD_TARGET static void dFactorLDLTBlock (dReal *d, dReal *const *a, int i)
+{
+  /* accumulate Z = z*l' over the leading block */
+  dVec zv[NB][NB];
+  for (int r = 0; r < NB; ++r)
+    for (int c = 0; c <= r; ++c) zv[r][c] = dVecZero();
+  int k = 0;
+  for (; k <= i-dVEC_WIDTH; k += dVEC_WIDTH) {
+    const dVec dd = dVecLoad (d+k);
+    dVec z[NB], l[NB];
+    for (int r = 0; r < NB; ++r) {
+      z[r] = dVecLoad (a[r]+k);
+      l[r] = dVecMul (z[r], dd);
+      dVecStore (a[r]+k, l[r]);
+    }
+    for (int r = 0; r < NB; ++r)
+      for (int c = 0; c <= r; ++c) zv[r][c] = dVecMulAdd (zv[r][c], z[r], l[c]);
+  }
+  dReal Z[NB][NB];
+  for (int r = 0; r < NB; ++r)
+    for (int c = 0; c <= r; ++c) Z[r][c] = dVecSum (zv[r][c]);
+  for (; k < i; ++k) {
+    dReal z[NB];
+    for (int r = 0; r < NB; ++r) {
+      z[r] = a[r][k];
+      a[r][k] = z[r]*d[k];
+    }
+    for (int r = 0; r < NB; ++r)
+      for (int c = 0; c <= r; ++c) Z[r][c] += z[r]*a[c][k];
+  }
+
+  /* factorize the NB x NB block on the diagonal */
+  dReal u[NB][NB];
+  for (int r = 0; r < NB; ++r) {
+    for (int c = 0; c < r; ++c) {
+      dReal v = a[r][i+c] - Z[r][c];
+      for (int t = 0; t < c; ++t) v -= u[r][t]*a[c][i+t];
+      u[r][c] = v;
+      a[r][i+c] = v*d[i+c];
+    }
+    dReal v = a[r][i+r] - Z[r][r];
+    for (int t = 0; t < r; ++t) v -= u[r][t]*a[r][i+t];
+    d[i+r] = dRecip(v);
+  }
+}
+
+
+template <int NB>
+dSIMD_TARGET static void dFactorLDLTRows (dReal *A, dReal *d, int i, int nskip)
+{
+  dReal *a[NB];
+  for (int r = 0; r < NB; ++r) a[r] = A + (i+r)*nskip;
+  dSolveRowsL1<NB> (A, a, 0, i, nskip);
+  dFactorLDLTBlock<NB> (d, a, i);
+}
+
+
+dSIMD_TARGET void _dFactorLDLTSimd (dReal *A, dReal *d, int n, int nskip)
+{
+  /* the rows are factorized 8 at a time. the forward solve of all 8 rows
+   * shares one pass over the leading rows of L, which is what limits the
+   * speed for large n, and the 4 x 4 blocks on the diagonal are done one
+   * after another. */
+  int i = 0;
+  for (; i <= n-8; i += 8) {
+    dReal *a[8];
+    for (int r = 0; r < 8; ++r) a[r] = A + (i+r)*nskip;
+    dSolveRowsL1<8> (A, a, 0, i, nskip);
+    dFactorLDLTBlock<4> (d, a, i);
+    dSolveRowsL1<4> (A, a+4, i, i+4, nskip);
+    dFactorLDLTBlock<4> (d, a+4, i+4);
+  }
+  for (; i <= n-4; i += 4) dFactorLDLTRows<4> (A, d, i, nskip);
+  switch (n-i) {
+    case 3: dFactorLDLTRows<3> (A, d, i, nskip); break;
+    case 2: dFactorLDLTRows<2> (A, d, i, nskip); break;
+    case 1: dFactorLDLTRows<1> (A, d, i, nskip); break;
+    default: break;
+  }
+}
+
+#else // no SIMD kernels for this target
+
+static int dDetectSimdKernels()
+{
+  return 0;
+}
+
+/* never selected, see dSetSimdKernelsEnabled() */
+dReal _dDotSimd (const dReal *, const dReal *, int) { return 0; }
+void _dSolveL1Simd (const dReal *, dReal *, int, int) {}
+void _dSolveL1TSimd (const dReal *, dReal *, int, int) {}
+void _dFactorLDLTSimd (dReal *, dReal *, int, int) {}
+
+#endif
+
+
+static int dSimdKernelsSupportedImpl()
+{
+  static const int supported = dDetectSimdKernels();
+  return supported;
+}
+
+static thread_local int sSimdKernelsEnabled = -1;
+
+int _dSimdKernelsEnabled()
+{
+  if (sSimdKernelsEnabled < 0)
+    sSimdKernelsEnabled = dSIMD_KERNELS_DEFAULT && dSimdKernelsSupportedImpl();
+  return sSimdKernelsEnabled;
+}
+
+int dSimdKernelsSupported (void)
+{
+  return dSimdKernelsSupportedImpl();
+}
+
+int dSimdKernelsEnabled (void)
+{
+  return _dSimdKernelsEnabled();
+}
+
+int dSetSimdKernelsEnabled (int enabled)
+{
+  const int previous = _dSimdKernelsEnabled();
+  sSimdKernelsEnabled = (enabled && dSimdKernelsSupportedImpl()) ? 1 : 0;
+  return previous;
+}
+
+} // namespace ode
+} // namespace external
+} // namespace dart
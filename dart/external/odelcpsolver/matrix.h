@@ -185,6 +185,25 @@ ODE_API void dLDLTRemove (dReal **A, const int *p, dReal *L, dReal *d,
 ODE_API void dRemoveRowCol (dReal *A, int n, int nskip, int r);
 
 
+/* dDot, dSolveL1, dSolveL1T and dFactorLDLT (and so dSolveLDLT and
+ * dSolveLCP) have SIMD versions that use AVX2/FMA on x86-64 and NEON on
+ * AArch64, and that work on blocks of 4 or 8 rows. they are selected per
+ * thread and only when the CPU supports them (dFactorLDLT only uses them for
+ * matrices with at least 96 rows). the SIMD versions sum in a different
+ * order than the scalar ones, so their results differ by rounding; with the
+ * SIMD kernels disabled (the default unless built with dSIMD_KERNELS_DEFAULT)
+ * results are bitwise identical to the scalar code.
+ *
+ * dSimdKernelsSupported() returns 1 if this build and CPU have the SIMD
+ * kernels. dSetSimdKernelsEnabled() enables or disables them for the calling
+ * thread and returns the previous setting.
+ */
+
+ODE_API int dSimdKernelsSupported (void);
+ODE_API int dSimdKernelsEnabled (void);
+ODE_API int dSetSimdKernelsEnabled (int enabled);
+
+
 //#if defined(__ODE__)
 
 void _dSetZero (dReal *a, size_t n);
@@ -206,6 +225,12 @@ void _dLDLTAddTL (dReal *L, dReal *d, const dReal *a, int n, int nskip, void *tm
 void _dLDLTRemove (dReal **A, const int *p, dReal *L, dReal *d, int n1, int n2, int r, int nskip, void *tmpbuf);
 void _dRemoveRowCol (dReal *A, int n, int nskip, int r);
 
+int _dSimdKernelsEnabled (void);
+dReal _dDotSimd (const dReal *a, const dReal *b, int n);
+void _dFactorLDLTSimd (dReal *A, dReal *d, int n, int nskip);
+void _dSolveL1Simd (const dReal *L, dReal *b, int n, int nskip);
+void _dSolveL1TSimd (const dReal *L, dReal *b, int n, int nskip);
+
 PURE_INLINE size_t _dEstimateFactorCholeskyTmpbufSize(int n)
 {
   return dPAD(n) * sizeof(dReal);
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/lcpsolver/LemkeSolver.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "dart/lcpsolver/Lemke.hpp"
+
+namespace dart {
+namespace lcpsolver {
+
+namespace {
+
+// Bases whose reciprocal condition number is below this are treated as
+// singular, which matches the condition number limit of Lemke().
+constexpr double kMinReciprocalCondition = 1e-16;
+
+} // namespace
+
+//==============================================================================
+LemkeSolver::Option::Option(
+    int maxIterations,
+    double pivotTolerance,
+    double zeroTolerance,
+    int refactorizationInterval)
+  : mMaxIterations(maxIterations),
+    mPivotTolerance(pivotTolerance),
+    mZeroTolerance(zeroTolerance),
+    mRefactorizationInterval(refactorizationInterval)
+{
+  // Do nothing
+}
+
+//==============================================================================
+LemkeSolver::LemkeSolver(const Option& option) : mOption(option)
+{
+  // Do nothing
+}
+
+//==============================================================================
+void LemkeSolver::setOption(const Option& option)
+{
+  mOption = option;
+}
+
+//==============================================================================
+const LemkeSolver::Option& LemkeSolver::getOption() const
+{
+  return mOption;
+}
+
+//==============================================================================
+int LemkeSolver::solve(
+    const Eigen::MatrixXd& M,
+    const Eigen::VectorXd& q,
+    Eigen::VectorXd& z,
+    bool warmStart)
+{
+  const int n = static_cast<int>(q.size());
+  const int artificial = 2 * n;
+  const int maxIterations = mOption.mMaxIterations > 0
+                                ? mOption.mMaxIterations
+                                : std::max(1000, 20 * n);
+  const double pivTol = mOption.mPivotTolerance;
+  const double zerTol = mOption.mZeroTolerance;
+
+  mLastNumIterations = 0;
+  mLastNumFactorizations = 0;
+
+  const bool canWarmStart = warmStart && mLastDimension == n;
+  mLastDimension = n;
+
+  if (n == 0 || q.minCoeff() >= 0)
+  {
+    // Trivial solution
+    z.setZero(n);
+    mLastBasicZ.clear();
+    return SUCCESS;
+  }
+
+  mBasis.resize(n, n);
+  mX.resize(n);
+  mEntering.resize(n);
+  mDirection.resize(n);
+  mEtas.resize(n, std::max(1, mOption.mRefactorizationInterval));
+  mEtaColumns.clear();
+
+  // Initial complementary basis. Position i of the basis holds either z_i or
+  // w_i, so the basis has the column of M for the basic z components and -e_i
+  // for the others.
+  mBasic.resize(n);
+  for (int i = 0; i < n; ++i)
+    mBasic[i] = n + i;
+  mBasis = -Eigen::MatrixXd::Identity(n, n);
+  mX = q;
+
+  if (canWarmStart && !mLastBasicZ.empty())
+  {
+    for (const int i : mLastBasicZ)
+    {
+      mBasic[i] = i;
+      mBasis.col(i) = M.col(i);
+    }
+
+    if (factorize())
+    {
+      mX = -q;
+      solveBasis(mX);
+    }
+    else
+    {
+      // The last basis is singular for this problem, so start over from w = q
+      for (const int i : mLastBasicZ)
+      {
+        mBasic[i] = n + i;
+        mBasis.col(i).setZero();
+        mBasis(i, i) = -1.0;
+      }
+      mX = q;
+    }
+  }
+
+  int err = SUCCESS;
+  int leaving = -1;
+
+  if (mX.minCoeff() < 0)
+  {
+    // Pivot in the artificial variable in place of the most negative basic
+    // variable, with the column -B * u where u_i = 1 for the negative ones.
+    int lvindex;
+    const double tval = (-mX).maxCoeff(&lvindex);
+
+    mEntering.setZero();
+    for (int i = 0; i < n; ++i)
+    {
+      if (mX[i] < 0)
+      {
+        mEntering -= mBasis.col(i);
+        mX[i] += tval;
+      }
+    }
+    mX[lvindex] = tval;
+    mBasis.col(lvindex) = mEntering;
+    leaving = mBasic[lvindex];
+    mBasic[lvindex] = artificial;
+
+    if (!factorize())
+      err = VALIDATION_FAILED;
+
+    while (err == SUCCESS && leaving != artificial)
+    {
+      if (mLastNumIterations >= maxIterations)
+      {
+        err = ITERATION_LIMIT;
+        break;
+      }
+
+      // The complement of the leaving variable enters
+      int entering;
+      if (leaving < n)
+      {
+        entering = n + leaving;
+        mEntering.setZero();
+        mEntering[leaving] = -1.0;
+      }
+      else
+      {
+        entering = leaving - n;
+        mEntering = M.col(entering);
+      }
+
+      mDirection = mEntering;
+      solveBasis(mDirection);
+
+      // Ratio test
+      double theta = std::numeric_limits<double>::infinity();
+      for (int i = 0; i < n; ++i)
+      {
+        if (mDirection[i] > pivTol)
+          theta = std::min(theta, (mX[i] + zerTol) / mDirection[i]);
+      }
+      if (theta == std::numeric_limits<double>::infinity())
+      {
+        // No new pivots
+        err = RAY_TERMINATION;
+        break;
+      }
+
+      // Among the ties, always use the artificial variable if possible and
+      // otherwise the largest pivot
+      lvindex = -1;
+      double maxPivot = 0.0;
+      for (int i = 0; i < n; ++i)
+      {
+        const double d = mDirection[i];
+        if (d <= pivTol || mX[i] / d > theta)
+          continue;
+
+        if (mBasic[i] == artificial)
+        {
+          lvindex = i;
+          break;
+        }
+
+        if (lvindex == -1 || d - maxPivot > pivTol)
+        {
+          maxPivot = d;
+          lvindex = i;
+        }
+      }
+      if (lvindex == -1)
+      {
+        err = NO_LEAVING_VARIABLE;
+        break;
+      }
+
+      // Perform pivot
+      leaving = mBasic[lvindex];
+      const double ratio = mX[lvindex] / mDirection[lvindex];
+      mX -= ratio * mDirection;
+      mX[lvindex] = ratio;
+      mBasis.col(lvindex) = mEntering;
+      mBasic[lvindex] = entering;
+      ++mLastNumIterations;
+
+      if (static_cast<int>(mEtaColumns.size()) < mEtas.cols())
+      {
+        updateBasis(lvindex, mDirection);
+      }
+      else if (factorize())
+      {
+        // Recompute the basic variables from the fresh factorization to drop
+        // the error accumulated by the updates
+        mX = -q;
+        solveBasis(mX);
+      }
+      else
+      {
+        err = VALIDATION_FAILED;
+      }
+    }
+  }
+
+  mLastBasicZ.clear();
+  if (err != SUCCESS)
+  {
+    z.setZero(n); // solve failed, return a 0 vector
+    return err;
+  }
+
+  z.setZero(n);
+  for (int i = 0; i < n; ++i)
+  {
+    if (mBasic[i] < n)
+    {
+      z[mBasic[i]] = mX[i];
+      mLastBasicZ.push_back(mBasic[i]);
+    }
+  }
+
+  if (!validate(M, z, q))
+    return VALIDATION_FAILED;
+
+  return SUCCESS;
+}
+
+//==============================================================================
+int LemkeSolver::getLastNumIterations() const
+{
+  return mLastNumIterations;
+}
+
+//==============================================================================
+int LemkeSolver::getLastNumFactorizations() const
+{
+  return mLastNumFactorizations;
+}
+
+//==============================================================================
+bool LemkeSolver::factorize()
+{
+  mLu.compute(mBasis);
+  mEtaColumns.clear();
+  ++mLastNumFactorizations;
+
+  return mLu.rcond() > kMinReciprocalCondition;
+}
+
+//==============================================================================
+void LemkeSolver::solveBasis(Eigen::VectorXd& rhs) const
+{
+  rhs = mLu.solve(rhs);
+
+  // Apply the eta vectors in the order of the updates. Each one replaces
+  // component r with rhs[r] / d[r] and eliminates it from the others.
+  for (auto k = 0u; k < mEtaColumns.size(); ++k)
+  {
+    const int r = mEtaColumns[k];
+    const auto d = mEtas.col(k);
+    const double yr = rhs[r] / d[r];
+    rhs -= yr * d;
+    rhs[r] = yr;
+  }
+}
+
+//==============================================================================
+void LemkeSolver::updateBasis(int r, const Eigen::VectorXd& d)
+{
+  mEtas.col(static_cast<Eigen::Index>(mEtaColumns.size())) = d;
+  mEtaColumns.push_back(r);
+}
+
+} // namespace lcpsolver
+} // namespace dart
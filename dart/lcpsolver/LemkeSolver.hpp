@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_LCPSOLVER_LEMKESOLVER_HPP_
+#define DART_LCPSOLVER_LEMKESOLVER_HPP_
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace dart {
+namespace lcpsolver {
+
+/// Lemke's complementary pivoting method for the LCP
+///   w = M * z + q, w >= 0, z >= 0, z^T w = 0.
+///
+/// This follows the same pivoting rules as Lemke(), but instead of factorizing
+/// the basis matrix at every pivot, it keeps an LU factorization of the basis
+/// and updates it with one eta vector per pivot (product form of the inverse).
+/// The basis is refactorized every Option::mRefactorizationInterval pivots.
+/// All the workspaces are kept between calls, so solving problems of the same
+/// size doesn't allocate.
+///
+/// The final basis of a solve can be used as the initial basis of the next
+/// one (see solve()), which takes no pivots at all when the set of positive
+/// z components doesn't change, e.g., for a contact configuration at rest.
+class LemkeSolver
+{
+public:
+  /// Return codes of solve(). They match the ones of Lemke().
+  enum Result
+  {
+    SUCCESS = 0,
+    ITERATION_LIMIT = 1,
+    RAY_TERMINATION = 2,
+    VALIDATION_FAILED = 3,
+    NO_LEAVING_VARIABLE = 4
+  };
+
+  struct Option
+  {
+    /// Maximum number of pivots. Zero or negative uses max(1000, 20 * n).
+    int mMaxIterations;
+
+    /// Smallest entry of the entering column that is considered a pivot
+    double mPivotTolerance;
+
+    /// Tolerance on the basic variables in the ratio test
+    double mZeroTolerance;
+
+    /// Number of basis updates after which the basis is refactorized
+    int mRefactorizationInterval;
+
+    Option(
+        int maxIterations = 0,
+        double pivotTolerance = 1e-8,
+        double zeroTolerance = 1e-5,
+        int refactorizationInterval = 50);
+  };
+
+  /// Constructor
+  explicit LemkeSolver(const Option& option = Option());
+
+  /// Sets options
+  void setOption(const Option& option);
+
+  /// Returns options.
+  const Option& getOption() const;
+
+  /// Solves the LCP.
+  ///
+  /// \param[in] M Square matrix of the LCP.
+  /// \param[in] q Vector of the LCP.
+  /// \param[out] z Solution, or zero if the solver failed.
+  /// \param[in] warmStart Whether to start from the final basis of the last
+  /// call of the same dimension. The basis is only used if it is
+  /// nonsingular; otherwise the solver starts from w = q as Lemke() does.
+  /// \return One of Result.
+  int solve(
+      const Eigen::MatrixXd& M,
+      const Eigen::VectorXd& q,
+      Eigen::VectorXd& z,
+      bool warmStart = false);
+
+  /// Returns the number of pivots taken by the last call of solve()
+  int getLastNumIterations() const;
+
+  /// Returns the number of basis factorizations done by the last call of
+  /// solve()
+  int getLastNumFactorizations() const;
+
+protected:
+  /// Factorizes mBasis from scratch and drops the eta vectors
+  bool factorize();
+
+  /// Solves mBasis * x = rhs in place using the LU factorization and the eta
+  /// vectors
+  void solveBasis(Eigen::VectorXd& rhs) const;
+
+  /// Records the replacement of column r of the basis, where d is the entering
+  /// column multiplied by the inverse of the old basis
+  void updateBasis(int r, const Eigen::VectorXd& d);
+
+  Option mOption;
+
+  /// Basis matrix
+  Eigen::MatrixXd mBasis;
+
+  /// LU factorization of the basis at the last refactorization
+  Eigen::PartialPivLU<Eigen::MatrixXd> mLu;
+
+  /// Eta vectors of the basis updates since the last refactorization
+  Eigen::MatrixXd mEtas;
+
+  /// Columns of the basis replaced by the eta vectors
+  std::vector<int> mEtaColumns;
+
+  /// Variable at each position of the basis: z_i is i, w_i is n + i, and the
+  /// artificial variable is 2n.
+  std::vector<int> mBasic;
+
+  /// Basic z components of the last solution, used for warm starting
+  std::vector<int> mLastBasicZ;
+
+  /// Values of the basic variables
+  Eigen::VectorXd mX;
+
+  /// Entering column, and the same column multiplied by the inverse basis
+  Eigen::VectorXd mEntering;
+  Eigen::VectorXd mDirection;
+
+  /// Dimension of the last solved problem
+  int mLastDimension{-1};
+
+  /// Number of pivots taken by the last call of solve()
+  int mLastNumIterations{0};
+
+  /// Number of factorizations done by the last call of solve()
+  int mLastNumFactorizations{0};
+};
+
+} // namespace lcpsolver
+} // namespace dart
+
+#endif // DART_LCPSOLVER_LEMKESOLVER_HPP_
@@ -86,7 +86,14 @@ void Function::evalHessian(
 }
 
 //==============================================================================
-ModularFunction::ModularFunction(const std::string& _name) : Function(_name)
+std::shared_ptr<Function> Function::cloneFunction() const
+{
+  return nullptr;
+}
+
+//==============================================================================
+ModularFunction::ModularFunction(const std::string& _name)
+  : Function(_name), mIsThreadSafe(false)
 {
   clearCostFunction();
   clearGradientFunction();
@@ -120,15 +127,56 @@ void ModularFunction::evalHessian(
   mHessianFunction(_x, _Hess);
 }
 
+//==============================================================================
+FunctionPtr ModularFunction::cloneFunction() const
+{
+  // The functions may share state with the ones of the clone, so only the
+  // users can tell whether the clone can be evaluated concurrently
+  if (!mIsThreadSafe)
+    return nullptr;
+
+  // The default functions refer to the function that they were set for, so
+  // the clone sets its own
+  auto function = std::make_shared<ModularFunction>(mName);
+  function->setThreadSafe(true);
+  if (mIsCostFunctionSet)
+    function->setCostFunction(mCostFunction);
+  else
+    function->clearCostFunction(mPrintCostWarning);
+
+  if (mIsGradientFunctionSet)
+    function->setGradientFunction(mGradientFunction);
+
+  if (mIsHessianFunctionSet)
+    function->setHessianFunction(mHessianFunction);
+
+  return function;
+}
+
+//==============================================================================
+void ModularFunction::setThreadSafe(bool threadSafe)
+{
+  mIsThreadSafe = threadSafe;
+}
+
+//==============================================================================
+bool ModularFunction::isThreadSafe() const
+{
+  return mIsThreadSafe;
+}
+
 //==============================================================================
 void ModularFunction::setCostFunction(CostFunction _cost)
 {
   mCostFunction = _cost;
+  mIsCostFunctionSet = true;
 }
 
 //==============================================================================
 void ModularFunction::clearCostFunction(bool _printWarning)
 {
+  mIsCostFunctionSet = false;
+  mPrintCostWarning = _printWarning;
   mCostFunction = [=](const Eigen::VectorXd&) {
     if (_printWarning)
     {
@@ -144,11 +192,13 @@ void ModularFunction::clearCostFunction(bool _printWarning)
 void ModularFunction::setGradientFunction(GradientFunction _gradient)
 {
   mGradientFunction = _gradient;
+  mIsGradientFunctionSet = true;
 }
 
 //==============================================================================
 void ModularFunction::clearGradientFunction()
 {
+  mIsGradientFunctionSet = false;
   mGradientFunction
       = [&](const Eigen::VectorXd& _x, Eigen::Map<Eigen::VectorXd> _grad) {
           this->Function::evalGradient(_x, _grad);
@@ -159,11 +209,13 @@ void ModularFunction::clearGradientFunction()
 void ModularFunction::setHessianFunction(HessianFunction _hessian)
 {
   mHessianFunction = _hessian;
+  mIsHessianFunctionSet = true;
 }
 
 //==============================================================================
 void ModularFunction::clearHessianFunction()
 {
+  mIsHessianFunctionSet = false;
   mHessianFunction = [&](const Eigen::VectorXd& _x,
                          Eigen::Map<Eigen::VectorXd, Eigen::RowMajor> _Hess) {
     this->Function::evalHessian(_x, _Hess);
@@ -205,6 +257,12 @@ void NullFunction::evalHessian(
   _Hess.setZero();
 }
 
+//==============================================================================
+FunctionPtr NullFunction::cloneFunction() const
+{
+  return std::make_shared<NullFunction>(mName);
+}
+
 //==============================================================================
 MultiFunction::MultiFunction()
 {
@@ -76,6 +76,12 @@ public:
       const Eigen::VectorXd& _x,
       Eigen::Map<Eigen::VectorXd, Eigen::RowMajor> _Hess);
 
+  /// Returns a copy of this Function that can be evaluated concurrently with
+  /// it, or nullptr if it can't be copied. ParallelEvaluator gives each of
+  /// its threads a copy, and serializes the evaluations of the Functions that
+  /// return nullptr, which the default implementation does.
+  virtual std::shared_ptr<Function> cloneFunction() const;
+
 protected:
   /// Name of this function
   std::string mName;
@@ -120,6 +126,23 @@ public:
       const Eigen::VectorXd& _x,
       Eigen::Map<Eigen::VectorXd, Eigen::RowMajor> _Hess) override;
 
+  /// Returns a ModularFunction with copies of the cost, gradient and Hessian
+  /// functions if this function is marked thread-safe, or nullptr otherwise.
+  ///
+  /// \sa setThreadSafe()
+  FunctionPtr cloneFunction() const override;
+
+  /// Marks whether copies of the cost, gradient and Hessian functions can be
+  /// evaluated concurrently with the originals, i.e., whether they don't
+  /// modify state that they share, such as objects captured by reference.
+  /// Only then does cloneFunction() return a clone, which lets
+  /// ParallelEvaluator and PopulationEvaluator evaluate this function on
+  /// several threads at once. False by default.
+  void setThreadSafe(bool threadSafe);
+
+  /// Returns true if this function is marked thread-safe.
+  bool isThreadSafe() const;
+
   /// Set the function that gets called by eval()
   void setCostFunction(CostFunction _cost);
 
@@ -152,6 +175,21 @@ protected:
 
   /// Storage for the Hessian function
   HessianFunction mHessianFunction;
+
+  /// Whether the cost function was set by setCostFunction()
+  bool mIsCostFunctionSet;
+
+  /// Whether the cleared cost function prints a warning
+  bool mPrintCostWarning;
+
+  /// Whether the gradient function was set by setGradientFunction()
+  bool mIsGradientFunctionSet;
+
+  /// Whether the Hessian function was set by setHessianFunction()
+  bool mIsHessianFunctionSet;
+
+  /// Whether copies of the functions can be evaluated concurrently
+  bool mIsThreadSafe;
 };
 
 /// NullFunction is a constant-zero Function
@@ -177,6 +215,9 @@ public:
   void evalHessian(
       const Eigen::VectorXd& _x,
       Eigen::Map<Eigen::VectorXd, Eigen::RowMajor> _Hess) override;
+
+  // Documentation inherited
+  FunctionPtr cloneFunction() const override;
 };
 
 /// class MultiFunction
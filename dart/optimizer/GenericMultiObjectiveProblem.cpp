@@ -288,5 +288,50 @@ Eigen::VectorXd GenericMultiObjectiveProblem::evaluateFitness(
   return f;
 }
 
+//==============================================================================
+static bool cloneFunctions(
+    const std::vector<FunctionPtr>& functions, std::vector<FunctionPtr>& copies)
+{
+  copies.clear();
+  copies.reserve(functions.size());
+  for (const FunctionPtr& function : functions)
+  {
+    FunctionPtr copy = function->cloneFunction();
+    if (!copy)
+      return false;
+
+    copies.push_back(std::move(copy));
+  }
+
+  return true;
+}
+
+//==============================================================================
+std::shared_ptr<MultiObjectiveProblem> GenericMultiObjectiveProblem::clone()
+    const
+{
+  auto problem = std::make_shared<GenericMultiObjectiveProblem>(
+      mDimension, mIntegerDimension);
+  problem->setLowerBounds(mLowerBounds);
+  problem->setUpperBounds(mUpperBounds);
+
+  std::vector<FunctionPtr> copies;
+  if (!cloneFunctions(mObjectiveFunctions, copies))
+    return nullptr;
+  problem->setObjectiveFunctions(copies);
+
+  if (!cloneFunctions(mEqConstraintFunctions, copies))
+    return nullptr;
+  for (FunctionPtr& copy : copies)
+    problem->addEqConstraintFunction(std::move(copy));
+
+  if (!cloneFunctions(mIneqConstraintFunctions, copies))
+    return nullptr;
+  for (FunctionPtr& copy : copies)
+    problem->addIneqConstraintFunction(std::move(copy));
+
+  return problem;
+}
+
 } // namespace optimizer
 } // namespace dart
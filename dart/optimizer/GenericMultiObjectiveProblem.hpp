@@ -146,6 +146,10 @@ public:
 
   /// \}
 
+  /// Returns a problem with copies of the functions of this problem, or
+  /// nullptr if a function can't be copied by Function::cloneFunction().
+  std::shared_ptr<MultiObjectiveProblem> clone() const override;
+
 protected:
   /// Objective functions
   std::vector<FunctionPtr> mObjectiveFunctions;
@@ -182,6 +182,12 @@ Eigen::VectorXd MultiObjectiveProblem::evaluateFitness(
   return f;
 }
 
+//==============================================================================
+std::shared_ptr<MultiObjectiveProblem> MultiObjectiveProblem::clone() const
+{
+  return nullptr;
+}
+
 //==============================================================================
 std::ostream& MultiObjectiveProblem::print(std::ostream& os) const
 {
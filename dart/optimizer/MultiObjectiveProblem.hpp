@@ -34,6 +34,7 @@
 #define DART_OPTIMIZER_MULTIOBJECTIVEPROBLEM_HPP_
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -143,6 +144,12 @@ public:
 
   /// \}
 
+  /// Returns a copy of this problem that can be evaluated concurrently with it,
+  /// or nullptr if it can't be copied, which the default implementation
+  /// returns. PopulationEvaluator gives each of its worker threads a copy, and
+  /// serializes the evaluations of the problems that return nullptr.
+  virtual std::shared_ptr<MultiObjectiveProblem> clone() const;
+
   /// Prints information of this class to a stream.
   virtual std::ostream& print(std::ostream& os) const;
 
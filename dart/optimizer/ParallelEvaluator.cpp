@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/optimizer/ParallelEvaluator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace dart {
+namespace optimizer {
+
+//==============================================================================
+ParallelEvaluator::Option::Option(
+    std::size_t numThreads, double finiteDifferenceStep)
+  : mNumThreads(numThreads), mFiniteDifferenceStep(finiteDifferenceStep)
+{
+  // Do nothing
+}
+
+//==============================================================================
+ParallelEvaluator::ParallelEvaluator(
+    std::shared_ptr<Problem> problem, const Option& option)
+  : mProblem(std::move(problem)), mOption(option), mNumEqConstraints(0u)
+{
+  assert(mProblem);
+  assert(mOption.mFiniteDifferenceStep > 0.0);
+
+  if (mOption.mNumThreads == 0u)
+    mOption.mNumThreads = common::ThreadPool::getHardwareConcurrency();
+
+  if (mOption.mNumThreads > 1u)
+    mThreadPool.reset(new common::ThreadPool(mOption.mNumThreads));
+
+  mPoints.resize(mOption.mNumThreads);
+}
+
+//==============================================================================
+const std::shared_ptr<Problem>& ParallelEvaluator::getProblem() const
+{
+  return mProblem;
+}
+
+//==============================================================================
+const ParallelEvaluator::Option& ParallelEvaluator::getOption() const
+{
+  return mOption;
+}
+
+//==============================================================================
+std::size_t ParallelEvaluator::getNumThreads() const
+{
+  return mOption.mNumThreads;
+}
+
+//==============================================================================
+void ParallelEvaluator::evalFunctions(
+    const Eigen::VectorXd& x,
+    double& objective,
+    Eigen::VectorXd& eqConstraints,
+    Eigen::VectorXd& ineqConstraints)
+{
+  updateFunctions();
+
+  const std::size_t numEq = mNumEqConstraints;
+  const std::size_t numIneq = mSlots.size() - 1u - numEq;
+  eqConstraints.resize(static_cast<int>(numEq));
+  ineqConstraints.resize(static_cast<int>(numIneq));
+
+  parallelFor(mSlots.size(), [&](std::size_t slot, std::size_t threadIndex) {
+    const double value = eval(slot, threadIndex, x);
+    if (slot == 0u)
+      objective = value;
+    else if (slot <= numEq)
+      eqConstraints[static_cast<int>(slot - 1u)] = value;
+    else
+      ineqConstraints[static_cast<int>(slot - 1u - numEq)] = value;
+  });
+}
+
+//==============================================================================
+void ParallelEvaluator::evalGradients(
+    const Eigen::VectorXd& x,
+    Eigen::VectorXd& objectiveGradient,
+    Eigen::MatrixXd& eqJacobian,
+    Eigen::MatrixXd& ineqJacobian)
+{
+  updateFunctions();
+
+  mGradients.resize(mSlots.size());
+  parallelFor(mSlots.size(), [&](std::size_t slot, std::size_t threadIndex) {
+    evalGradient(slot, threadIndex, x, mGradients[slot]);
+  });
+
+  const int numEq = static_cast<int>(mNumEqConstraints);
+  const int numIneq = static_cast<int>(mSlots.size()) - 1 - numEq;
+  objectiveGradient = mGradients[0];
+  eqJacobian.resize(numEq, x.size());
+  for (int i = 0; i < numEq; ++i)
+    eqJacobian.row(i) = mGradients[i + 1].transpose();
+
+  ineqJacobian.resize(numIneq, x.size());
+  for (int i = 0; i < numIneq; ++i)
+    ineqJacobian.row(i) = mGradients[i + 1 + numEq].transpose();
+}
+
+//==============================================================================
+void ParallelEvaluator::computeFiniteDifferenceGradient(
+    const Eigen::VectorXd& x, Eigen::VectorXd& gradient)
+{
+  updateFunctions();
+
+  Eigen::MatrixXd jacobian;
+  computeFiniteDifferences(x, 0u, 1u, jacobian);
+  gradient = jacobian.row(0).transpose();
+}
+
+//==============================================================================
+void ParallelEvaluator::computeFiniteDifferenceJacobians(
+    const Eigen::VectorXd& x,
+    Eigen::MatrixXd& eqJacobian,
+    Eigen::MatrixXd& ineqJacobian)
+{
+  updateFunctions();
+
+  const std::size_t numEq = mNumEqConstraints;
+  const std::size_t numIneq = mSlots.size() - 1u - numEq;
+  computeFiniteDifferences(x, 1u, numEq, eqJacobian);
+  computeFiniteDifferences(x, 1u + numEq, numIneq, ineqJacobian);
+}
+
+//==============================================================================
+void ParallelEvaluator::evalObjectives(
+    const Eigen::MatrixXd& xs, Eigen::VectorXd& values)
+{
+  updateFunctions();
+
+  values.resize(xs.cols());
+  parallelFor(
+      static_cast<std::size_t>(xs.cols()),
+      [&](std::size_t index, std::size_t threadIndex) {
+        const int column = static_cast<int>(index);
+        Eigen::VectorXd& x = mPoints[threadIndex];
+        x = xs.col(column);
+        values[column] = eval(0u, threadIndex, x);
+      });
+}
+
+//==============================================================================
+void ParallelEvaluator::evalFunctions(
+    const Eigen::MatrixXd& xs,
+    Eigen::VectorXd& objectives,
+    Eigen::MatrixXd& eqConstraints,
+    Eigen::MatrixXd& ineqConstraints)
+{
+  updateFunctions();
+
+  const std::size_t numEq = mNumEqConstraints;
+  const std::size_t numIneq = mSlots.size() - 1u - numEq;
+  objectives.resize(xs.cols());
+  eqConstraints.resize(static_cast<int>(numEq), xs.cols());
+  ineqConstraints.resize(static_cast<int>(numIneq), xs.cols());
+
+  // Every thread evaluates all the functions at a point, so the batch is
+  // split into as many tasks as there are points
+  parallelFor(
+      static_cast<std::size_t>(xs.cols()),
+      [&](std::size_t index, std::size_t threadIndex) {
+        const int column = static_cast<int>(index);
+        Eigen::VectorXd& x = mPoints[threadIndex];
+        x = xs.col(column);
+
+        objectives[column] = eval(0u, threadIndex, x);
+        for (std::size_t i = 0u; i < numEq; ++i)
+        {
+          eqConstraints(static_cast<int>(i), column)
+              = eval(1u + i, threadIndex, x);
+        }
+        for (std::size_t i = 0u; i < numIneq; ++i)
+        {
+          ineqConstraints(static_cast<int>(i), column)
+              = eval(1u + numEq + i, threadIndex, x);
+        }
+      });
+}
+
+//==============================================================================
+void ParallelEvaluator::updateFunctions()
+{
+  std::vector<FunctionPtr> functions;
+  functions.reserve(
+      1u + mProblem->getNumEqConstraints()
+      + mProblem->getNumIneqConstraints());
+  functions.push_back(mProblem->getObjective());
+  for (std::size_t i = 0u; i < mProblem->getNumEqConstraints(); ++i)
+    functions.push_back(mProblem->getEqConstraint(i));
+  for (std::size_t i = 0u; i < mProblem->getNumIneqConstraints(); ++i)
+    functions.push_back(mProblem->getIneqConstraint(i));
+
+  const bool changed
+      = functions.size() != mSlots.size()
+        || mNumEqConstraints != mProblem->getNumEqConstraints()
+        || !std::equal(
+               functions.begin(),
+               functions.end(),
+               mSlots.begin(),
+               [](const FunctionPtr& function, const FunctionSlot& slot) {
+                 return function == slot.mFunction;
+               });
+  if (!changed)
+    return;
+
+  // Keep the copies of the functions that are still in the Problem, since
+  // creating a copy can be expensive
+  std::vector<FunctionSlot> slots(functions.size());
+  for (std::size_t i = 0u; i < functions.size(); ++i)
+  {
+    FunctionSlot& slot = slots[i];
+    slot.mFunction = functions[i];
+
+    const auto found = std::find_if(
+        mSlots.begin(), mSlots.end(), [&](const FunctionSlot& oldSlot) {
+          return oldSlot.mFunction == slot.mFunction && oldSlot.mMutex;
+        });
+    if (found != mSlots.end())
+    {
+      slot = std::move(*found);
+      continue;
+    }
+
+    slot.mCopies.assign(mOption.mNumThreads, slot.mFunction);
+    slot.mIsShared = false;
+    slot.mMutex.reset(new std::mutex);
+    if (!slot.mFunction)
+      continue;
+
+    for (std::size_t j = 1u; j < slot.mCopies.size(); ++j)
+    {
+      slot.mCopies[j] = slot.mFunction->cloneFunction();
+      if (!slot.mCopies[j])
+      {
+        slot.mCopies.assign(mOption.mNumThreads, slot.mFunction);
+        slot.mIsShared = true;
+        break;
+      }
+    }
+  }
+
+  mSlots = std::move(slots);
+  mNumEqConstraints = mProblem->getNumEqConstraints();
+}
+
+//==============================================================================
+double ParallelEvaluator::eval(
+    std::size_t slot, std::size_t threadIndex, const Eigen::VectorXd& x)
+{
+  FunctionSlot& functionSlot = mSlots[slot];
+  if (!functionSlot.mFunction)
+    return 0.0;
+
+  if (!functionSlot.mIsShared)
+    return functionSlot.mCopies[threadIndex]->eval(x);
+
+  std::lock_guard<std::mutex> lock(*functionSlot.mMutex);
+  return functionSlot.mFunction->eval(x);
+}
+
+//==============================================================================
+void ParallelEvaluator::evalGradient(
+    std::size_t slot,
+    std::size_t threadIndex,
+    const Eigen::VectorXd& x,
+    Eigen::VectorXd& gradient)
+{
+  gradient = Eigen::VectorXd::Zero(x.size());
+
+  FunctionSlot& functionSlot = mSlots[slot];
+  if (!functionSlot.mFunction)
+    return;
+
+  Eigen::Map<Eigen::VectorXd> map(gradient.data(), gradient.size());
+  if (!functionSlot.mIsShared)
+  {
+    functionSlot.mCopies[threadIndex]->evalGradient(x, map);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(*functionSlot.mMutex);
+  functionSlot.mFunction->evalGradient(x, map);
+}
+
+//==============================================================================
+void ParallelEvaluator::computeFiniteDifferences(
+    const Eigen::VectorXd& x,
+    std::size_t first,
+    std::size_t num,
+    Eigen::MatrixXd& jacobian)
+{
+  const int dim = static_cast<int>(x.size());
+  jacobian.resize(static_cast<int>(num), dim);
+  if (num == 0u || dim == 0)
+    return;
+
+  // The values at x + h_i e_i are the rows 2i and the values at x - h_i e_i
+  // are the rows 2i + 1
+  mDifferenceValues.resize(2 * dim, static_cast<int>(num));
+  parallelFor(
+      static_cast<std::size_t>(2 * dim),
+      [&](std::size_t index, std::size_t threadIndex) {
+        const int point = static_cast<int>(index);
+        const int i = point / 2;
+        const double step = mOption.mFiniteDifferenceStep
+                            * std::max(1.0, std::abs(x[i]));
+
+        Eigen::VectorXd& perturbed = mPoints[threadIndex];
+        perturbed = x;
+        perturbed[i] += (point % 2 == 0) ? step : -step;
+
+        for (std::size_t j = 0u; j < num; ++j)
+        {
+          mDifferenceValues(point, static_cast<int>(j))
+              = eval(first + j, threadIndex, perturbed);
+        }
+      });
+
+  for (int i = 0; i < dim; ++i)
+  {
+    const double step
+        = mOption.mFiniteDifferenceStep * std::max(1.0, std::abs(x[i]));
+    jacobian.col(i) = (mDifferenceValues.row(2 * i)
+                       - mDifferenceValues.row(2 * i + 1))
+                          .transpose()
+                      / (2.0 * step);
+  }
+}
+
+//==============================================================================
+void ParallelEvaluator::parallelFor(
+    std::size_t size, const common::ThreadPool::IndexFunction& func)
+{
+  if (mThreadPool)
+  {
+    mThreadPool->parallelFor(size, func);
+    return;
+  }
+
+  for (std::size_t i = 0u; i < size; ++i)
+    func(i, 0u);
+}
+
+} // namespace optimizer
+} // namespace dart
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_OPTIMIZER_PARALLELEVALUATOR_HPP_
+#define DART_OPTIMIZER_PARALLELEVALUATOR_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/common/ThreadPool.hpp"
+#include "dart/optimizer/Problem.hpp"
+
+namespace dart {
+namespace optimizer {
+
+/// ParallelEvaluator evaluates the objective and the constraint functions of a
+/// Problem on multiple threads.
+///
+/// The functions of a Problem are independent of each other, so the objective
+/// and all the constraints can be evaluated concurrently at a point, and the
+/// central differences of a function that doesn't provide its gradient need
+/// 2n evaluations at independent points, which are made concurrently too.
+/// Population-based solvers can evaluate a batch of points at once.
+///
+/// Every thread other than the calling one evaluates its own copy of each
+/// function, which is created by Function::cloneFunction() and re-created
+/// whenever the functions of the Problem are replaced. A function that can't
+/// be copied is shared by all the threads, and its evaluations are serialized.
+///
+/// Every evaluation writes its own entry of the results, so the results don't
+/// depend on the number of threads or on the scheduling of the threads.
+class ParallelEvaluator
+{
+public:
+  struct Option
+  {
+    /// Number of threads. If it is zero, the number of hardware threads is
+    /// used.
+    std::size_t mNumThreads;
+
+    /// Relative step of the central differences. The step for the ith
+    /// variable is mFiniteDifferenceStep * max(1, |x[i]|).
+    double mFiniteDifferenceStep;
+
+    /// Constructor
+    Option(std::size_t numThreads = 0u, double finiteDifferenceStep = 1e-6);
+  };
+
+  /// Constructor
+  explicit ParallelEvaluator(
+      std::shared_ptr<Problem> problem, const Option& option = Option());
+
+  /// Get the Problem
+  const std::shared_ptr<Problem>& getProblem() const;
+
+  /// Get the options
+  const Option& getOption() const;
+
+  /// Get the number of threads
+  std::size_t getNumThreads() const;
+
+  /// Evaluate the objective, the equality constraints and the inequality
+  /// constraints at the point x concurrently. The objective is zero if the
+  /// Problem has none.
+  void evalFunctions(
+      const Eigen::VectorXd& x,
+      double& objective,
+      Eigen::VectorXd& eqConstraints,
+      Eigen::VectorXd& ineqConstraints);
+
+  /// Evaluate the gradient of the objective and the Jacobians of the equality
+  /// and inequality constraints, whose rows are the gradients of the
+  /// constraints, at the point x concurrently. The gradients are provided by
+  /// Function::evalGradient().
+  void evalGradients(
+      const Eigen::VectorXd& x,
+      Eigen::VectorXd& objectiveGradient,
+      Eigen::MatrixXd& eqJacobian,
+      Eigen::MatrixXd& ineqJacobian);
+
+  /// Compute the gradient of the objective at the point x by central
+  /// differences, whose evaluations are made concurrently
+  void computeFiniteDifferenceGradient(
+      const Eigen::VectorXd& x, Eigen::VectorXd& gradient);
+
+  /// Compute the Jacobians of the equality and inequality constraints at the
+  /// point x by central differences, whose evaluations are made concurrently
+  void computeFiniteDifferenceJacobians(
+      const Eigen::VectorXd& x,
+      Eigen::MatrixXd& eqJacobian,
+      Eigen::MatrixXd& ineqJacobian);
+
+  /// Evaluate the objective at the points that are the columns of xs, and set
+  /// the ith element of values to the objective at the ith point
+  void evalObjectives(const Eigen::MatrixXd& xs, Eigen::VectorXd& values);
+
+  /// Evaluate the objective and the constraints at the points that are the
+  /// columns of xs. The ith element of objectives and the ith columns of
+  /// eqConstraints and ineqConstraints are the values at the ith point.
+  void evalFunctions(
+      const Eigen::MatrixXd& xs,
+      Eigen::VectorXd& objectives,
+      Eigen::MatrixXd& eqConstraints,
+      Eigen::MatrixXd& ineqConstraints);
+
+protected:
+  /// A function of the Problem and its copies
+  struct FunctionSlot
+  {
+    /// The function of the Problem
+    FunctionPtr mFunction;
+
+    /// The function evaluated by each thread. The entry of the calling thread
+    /// is mFunction.
+    std::vector<FunctionPtr> mCopies;
+
+    /// Whether the function can't be copied, in which case all the threads
+    /// evaluate mFunction
+    bool mIsShared;
+
+    /// Serializes the evaluations of a function that can't be copied
+    std::unique_ptr<std::mutex> mMutex;
+  };
+
+  /// Re-create the slots if the functions of the Problem have changed. The
+  /// slot of the objective is followed by the slots of the equality and the
+  /// inequality constraints.
+  void updateFunctions();
+
+  /// Evaluate the function of the slot on a thread
+  double eval(
+      std::size_t slot, std::size_t threadIndex, const Eigen::VectorXd& x);
+
+  /// Evaluate the gradient of the function of the slot on a thread
+  void evalGradient(
+      std::size_t slot,
+      std::size_t threadIndex,
+      const Eigen::VectorXd& x,
+      Eigen::VectorXd& gradient);
+
+  /// Compute the gradients of the functions of the slots [first, first + num)
+  /// by central differences, and write them to the rows of jacobian
+  void computeFiniteDifferences(
+      const Eigen::VectorXd& x,
+      std::size_t first,
+      std::size_t num,
+      Eigen::MatrixXd& jacobian);
+
+  /// Run func for each index in [0, size) on the thread pool, or serially if
+  /// there is a single thread
+  void parallelFor(
+      std::size_t size, const common::ThreadPool::IndexFunction& func);
+
+  /// The Problem
+  std::shared_ptr<Problem> mProblem;
+
+  /// Options
+  Option mOption;
+
+  /// The thread pool, which is nullptr if there is a single thread
+  std::unique_ptr<common::ThreadPool> mThreadPool;
+
+  /// The objective, the equality constraints and the inequality constraints
+  std::vector<FunctionSlot> mSlots;
+
+  /// The number of the equality constraints of the slots
+  std::size_t mNumEqConstraints;
+
+  /// The points evaluated by each thread
+  std::vector<Eigen::VectorXd> mPoints;
+
+  /// The gradients of the functions of the slots
+  std::vector<Eigen::VectorXd> mGradients;
+
+  /// The function values at the points of the central differences
+  Eigen::MatrixXd mDifferenceValues;
+};
+
+} // namespace optimizer
+} // namespace dart
+
+#endif // DART_OPTIMIZER_PARALLELEVALUATOR_HPP_
@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/optimizer/PopulationEvaluator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <limits>
+#include <new>
+
+#include "dart/common/Console.hpp"
+#include "dart/common/Platform.hpp"
+#include "dart/math/Random.hpp"
+
+#if DART_OS_LINUX || DART_OS_MACOS
+#  include <sys/mman.h>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#if DART_OS_LINUX
+#  include <dirent.h>
+#elif DART_OS_MACOS
+#  include <mach/mach.h>
+#endif
+
+namespace dart {
+namespace optimizer {
+
+namespace {
+
+//==============================================================================
+/// Returns the number of the threads of the calling process, or zero if it
+/// can't be determined
+std::size_t getNumProcessThreads()
+{
+#if DART_OS_LINUX
+  DIR* directory = opendir("/proc/self/task");
+  if (!directory)
+    return 0u;
+
+  std::size_t count = 0u;
+  while (const dirent* entry = readdir(directory))
+  {
+    if (entry->d_name[0] != '.')
+      ++count;
+  }
+  closedir(directory);
+
+  return count;
+#elif DART_OS_MACOS
+  thread_act_array_t threads;
+  mach_msg_type_number_t count = 0;
+  if (task_threads(mach_task_self(), &threads, &count) != KERN_SUCCESS)
+    return 0u;
+
+  for (mach_msg_type_number_t i = 0; i < count; ++i)
+    mach_port_deallocate(mach_task_self(), threads[i]);
+  vm_deallocate(
+      mach_task_self(),
+      reinterpret_cast<vm_address_t>(threads),
+      count * sizeof(thread_act_t));
+
+  return static_cast<std::size_t>(count);
+#else
+  return 0u;
+#endif
+}
+
+} // namespace
+
+//==============================================================================
+PopulationEvaluator::Option::Option(
+    std::size_t numWorkers, Parallelism parallelism)
+  : mNumWorkers(numWorkers), mParallelism(parallelism)
+{
+  // Do nothing
+}
+
+//==============================================================================
+PopulationEvaluator::PopulationEvaluator(
+    std::shared_ptr<MultiObjectiveProblem> problem, const Option& option)
+  : mProblem(std::move(problem)),
+    mOption(option),
+    mIsShared(false),
+    mWarnedAboutThreads(false)
+{
+  assert(mProblem);
+
+  if (mOption.mNumWorkers == 0u)
+    mOption.mNumWorkers = common::ThreadPool::getHardwareConcurrency();
+
+#if !(DART_OS_LINUX || DART_OS_MACOS)
+  if (mOption.mParallelism == Parallelism::Processes)
+  {
+    dtwarn << "[PopulationEvaluator::PopulationEvaluator] Child processes "
+           << "aren't supported on this platform. Using threads instead.\n";
+    mOption.mParallelism = Parallelism::Threads;
+  }
+#endif
+
+  if (mOption.mParallelism == Parallelism::Threads && mOption.mNumWorkers > 1u)
+    mThreadPool.reset(new common::ThreadPool(mOption.mNumWorkers));
+
+  mPoints.resize(mOption.mNumWorkers);
+  updateClones();
+}
+
+//==============================================================================
+const std::shared_ptr<MultiObjectiveProblem>& PopulationEvaluator::getProblem()
+    const
+{
+  return mProblem;
+}
+
+//==============================================================================
+const PopulationEvaluator::Option& PopulationEvaluator::getOption() const
+{
+  return mOption;
+}
+
+//==============================================================================
+std::size_t PopulationEvaluator::getNumWorkers() const
+{
+  return mOption.mNumWorkers;
+}
+
+//==============================================================================
+void PopulationEvaluator::updateClones()
+{
+  mClones.assign(mOption.mNumWorkers, mProblem);
+  mIsShared = false;
+
+  // The child processes evaluate their own copies of the problem
+  if (!mThreadPool)
+    return;
+
+  for (std::size_t i = 1u; i < mClones.size(); ++i)
+  {
+    mClones[i] = mProblem->clone();
+    if (!mClones[i])
+    {
+      mClones.assign(mOption.mNumWorkers, mProblem);
+      mIsShared = true;
+      return;
+    }
+  }
+}
+
+//==============================================================================
+void PopulationEvaluator::evaluate(
+    const Eigen::MatrixXd& xs, Eigen::MatrixXd& fitness)
+{
+  const auto numRows = static_cast<int>(mProblem->getSolutionDimension());
+  if (xs.rows() != numRows)
+  {
+    dtwarn << "[PopulationEvaluator::evaluate] The dimension of the decision "
+           << "vectors '" << xs.rows() << "' should be '" << numRows
+           << "'.\n";
+    fitness.resize(0, 0);
+    return;
+  }
+
+  fitness.resize(
+      static_cast<int>(mProblem->getFitnessDimension()), xs.cols());
+  if (xs.cols() == 0)
+    return;
+
+  if (mOption.mParallelism == Parallelism::Processes
+      && mOption.mNumWorkers > 1u)
+  {
+    evaluateOnProcesses(xs, fitness);
+    return;
+  }
+
+  evaluateOnThreads(xs, fitness);
+}
+
+//==============================================================================
+Population PopulationEvaluator::createPopulation(std::size_t populationSize)
+{
+  const Eigen::VectorXd& lb = mProblem->getLowerBounds();
+  const Eigen::VectorXd& ub = mProblem->getUpperBounds();
+
+  Eigen::MatrixXd xs(lb.size(), static_cast<int>(populationSize));
+  for (int i = 0; i < xs.cols(); ++i)
+    xs.col(i) = math::Random::uniform(lb, ub);
+
+  Eigen::MatrixXd fitness;
+  evaluate(xs, fitness);
+
+  Population population(mProblem);
+  for (int i = 0; i < xs.cols(); ++i)
+    population.pushBack(xs.col(i), fitness.col(i));
+
+  return population;
+}
+
+//==============================================================================
+void PopulationEvaluator::evaluateOnThreads(
+    const Eigen::MatrixXd& xs, Eigen::MatrixXd& fitness)
+{
+  const auto evaluateColumn = [&](std::size_t index, std::size_t threadIndex) {
+    const auto column = static_cast<int>(index);
+    Eigen::VectorXd& x = mPoints[threadIndex];
+    x = xs.col(column);
+
+    if (!mIsShared)
+    {
+      fitness.col(column) = mClones[threadIndex]->evaluateFitness(x);
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    fitness.col(column) = mProblem->evaluateFitness(x);
+  };
+
+  if (mThreadPool)
+  {
+    mThreadPool->parallelFor(
+        static_cast<std::size_t>(xs.cols()), evaluateColumn);
+    return;
+  }
+
+  for (int i = 0; i < xs.cols(); ++i)
+    evaluateColumn(static_cast<std::size_t>(i), 0u);
+}
+
+//==============================================================================
+void PopulationEvaluator::evaluateOnProcesses(
+    const Eigen::MatrixXd& xs, Eigen::MatrixXd& fitness)
+{
+#if DART_OS_LINUX || DART_OS_MACOS
+  const std::size_t numColumns = static_cast<std::size_t>(xs.cols());
+  const std::size_t fitnessSize = static_cast<std::size_t>(fitness.size());
+  const std::size_t fitnessBytes = fitnessSize * sizeof(double);
+
+  // The shared memory holds the fitness vectors, the index of the next
+  // decision vector, and whether each decision vector was evaluated
+  const std::size_t counterOffset
+      = (fitnessBytes + alignof(std::atomic<std::size_t>) - 1u)
+        / alignof(std::atomic<std::size_t>) * alignof(std::atomic<std::size_t>);
+  const std::size_t flagsOffset
+      = counterOffset + sizeof(std::atomic<std::size_t>);
+  const std::size_t numBytes = flagsOffset + numColumns;
+
+  void* memory = mmap(
+      nullptr,
+      numBytes,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (memory == MAP_FAILED)
+  {
+    dtwarn << "[PopulationEvaluator::evaluateOnProcesses] Failed to map "
+           << "shared memory. Evaluating on the calling thread instead.\n";
+    evaluateOnThreads(xs, fitness);
+    return;
+  }
+
+  char* bytes = static_cast<char*>(memory);
+  double* values = reinterpret_cast<double*>(bytes);
+  auto* nextColumn = new (bytes + counterOffset) std::atomic<std::size_t>(0u);
+  char* evaluated = bytes + flagsOffset;
+  assert(nextColumn->is_lock_free());
+
+  // The children only have a copy of this thread, so the locks held by the
+  // other threads stay locked in them
+  const std::size_t numThreads = getNumProcessThreads();
+  if (numThreads > 1u && !mWarnedAboutThreads)
+  {
+    dtwarn << "[PopulationEvaluator::evaluateOnProcesses] Forking a process "
+           << "with " << numThreads << " threads. The child processes "
+           << "deadlock if the problem uses a lock or a thread pool of the "
+           << "other threads. See PopulationEvaluator::Parallelism::"
+           << "Processes.\n";
+    mWarnedAboutThreads = true;
+  }
+
+  const int fitnessDim = static_cast<int>(fitness.rows());
+  const std::size_t numProcesses = std::min(mOption.mNumWorkers, numColumns);
+  std::vector<pid_t> children;
+  children.reserve(numProcesses);
+  for (std::size_t i = 0u; i < numProcesses; ++i)
+  {
+    const pid_t pid = fork();
+    if (pid < 0)
+      break;
+
+    if (pid == 0)
+    {
+      // The child leaves with _exit() so that it doesn't run the exit handlers
+      // or flush the buffers of the parent
+      Eigen::VectorXd x;
+      for (;;)
+      {
+        const std::size_t index = nextColumn->fetch_add(1u);
+        if (index >= numColumns)
+          break;
+
+        x = xs.col(static_cast<int>(index));
+        const Eigen::VectorXd f = mProblem->evaluateFitness(x);
+        if (f.size() != fitnessDim)
+          continue;
+
+        Eigen::Map<Eigen::VectorXd>(
+            values + index * static_cast<std::size_t>(fitnessDim), fitnessDim)
+            = f;
+        evaluated[index] = 1;
+      }
+
+      _exit(0);
+    }
+
+    children.push_back(pid);
+  }
+
+  for (const pid_t child : children)
+  {
+    int status;
+    while (waitpid(child, &status, 0) < 0 && errno == EINTR)
+      continue;
+  }
+
+  if (children.empty())
+  {
+    dtwarn << "[PopulationEvaluator::evaluateOnProcesses] Failed to fork. "
+           << "Evaluating on the calling thread instead.\n";
+    munmap(memory, numBytes);
+    evaluateOnThreads(xs, fitness);
+    return;
+  }
+
+  std::size_t numFailures = 0u;
+  fitness = Eigen::Map<const Eigen::MatrixXd>(
+      values, fitnessDim, static_cast<int>(numColumns));
+  for (std::size_t i = 0u; i < numColumns; ++i)
+  {
+    if (evaluated[i])
+      continue;
+
+    fitness.col(static_cast<int>(i))
+        .setConstant(std::numeric_limits<double>::quiet_NaN());
+    ++numFailures;
+  }
+
+  munmap(memory, numBytes);
+
+  if (numFailures > 0u)
+  {
+    dtwarn << "[PopulationEvaluator::evaluateOnProcesses] The child processes "
+           << "failed to evaluate " << numFailures << " of " << numColumns
+           << " decision vectors, whose fitness vectors are set to NaN.\n";
+  }
+#else
+  evaluateOnThreads(xs, fitness);
+#endif
+}
+
+} // namespace optimizer
+} // namespace dart
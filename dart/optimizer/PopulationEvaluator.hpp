@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_OPTIMIZER_POPULATIONEVALUATOR_HPP_
+#define DART_OPTIMIZER_POPULATIONEVALUATOR_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/common/ThreadPool.hpp"
+#include "dart/optimizer/MultiObjectiveProblem.hpp"
+#include "dart/optimizer/Population.hpp"
+
+namespace dart {
+namespace optimizer {
+
+/// PopulationEvaluator evaluates the fitness of a MultiObjectiveProblem at a
+/// batch of decision vectors on multiple workers, which are either threads or
+/// child processes.
+///
+/// Every worker thread other than the calling one evaluates its own clone of
+/// the problem, which is created by MultiObjectiveProblem::clone() at the
+/// construction and by updateClones(). If the problem can't be cloned, the
+/// evaluations are serialized, and the child processes should be used
+/// instead.
+///
+/// The child processes are forked for every batch, so each of them evaluates
+/// its own copy of the problem without cloning it, at the cost of forking.
+/// This suits problems whose evaluations take much longer than forking, e.g.,
+/// a physics rollout per decision vector, and problems that aren't thread
+/// safe. The fitness vectors are written to memory shared with the children.
+/// The child processes are only available on Linux and macOS, and they have
+/// the restrictions of fork() in a multithreaded process, which are described
+/// at Parallelism::Processes.
+///
+/// The workers take the decision vectors dynamically, but every fitness vector
+/// is written to the column of its decision vector, so the results don't
+/// depend on the number of workers or on their scheduling.
+class PopulationEvaluator
+{
+public:
+  /// The kind of the workers
+  enum class Parallelism
+  {
+    /// Threads of the calling process
+    Threads,
+
+    /// Child processes forked for every batch. A forked child only has a
+    /// copy of the calling thread, so the locks that the other threads held
+    /// at the fork are never released in the child, and the threads of the
+    /// thread pools created before the fork don't exist there. A child
+    /// deadlocks if the problem uses such a lock or thread pool, e.g., the
+    /// thread pool of a CollisionDetector that was used with parallel
+    /// narrowphase (CollisionOption::numThreads) or the one of a
+    /// planning::MotionValidator with multiple threads. Use processes only if
+    /// the process has no other threads while evaluating, or if the problem
+    /// uses nothing that is shared with them. A warning is printed when the
+    /// process has other threads at the fork.
+    Processes
+  };
+
+  struct Option
+  {
+    /// Number of workers. If it is zero, the number of hardware threads is
+    /// used.
+    std::size_t mNumWorkers;
+
+    /// The kind of the workers
+    Parallelism mParallelism;
+
+    /// Constructor
+    Option(
+        std::size_t numWorkers = 0u,
+        Parallelism parallelism = Parallelism::Threads);
+  };
+
+  /// Constructor
+  explicit PopulationEvaluator(
+      std::shared_ptr<MultiObjectiveProblem> problem,
+      const Option& option = Option());
+
+  /// Get the problem
+  const std::shared_ptr<MultiObjectiveProblem>& getProblem() const;
+
+  /// Get the options
+  const Option& getOption() const;
+
+  /// Get the number of workers
+  std::size_t getNumWorkers() const;
+
+  /// Clone the problem again for the worker threads. This must be called after
+  /// the problem is modified.
+  void updateClones();
+
+  /// Evaluate the fitness at the decision vectors that are the columns of xs,
+  /// and set the ith column of fitness to the fitness at the ith decision
+  /// vector. A column of fitness is NaN if a child process failed to evaluate
+  /// it.
+  void evaluate(const Eigen::MatrixXd& xs, Eigen::MatrixXd& fitness);
+
+  /// Create a population of random decision vectors within the bounds of the
+  /// problem, whose fitness vectors are evaluated by evaluate(). The decision
+  /// vectors are sampled on the calling thread, in the same order as the
+  /// constructor of Population does.
+  Population createPopulation(std::size_t populationSize);
+
+protected:
+  /// Evaluate the batch on the threads
+  void evaluateOnThreads(const Eigen::MatrixXd& xs, Eigen::MatrixXd& fitness);
+
+  /// Evaluate the batch on the child processes
+  void evaluateOnProcesses(
+      const Eigen::MatrixXd& xs, Eigen::MatrixXd& fitness);
+
+  /// The problem
+  std::shared_ptr<MultiObjectiveProblem> mProblem;
+
+  /// Options
+  Option mOption;
+
+  /// The thread pool, which is nullptr if there is a single thread or the
+  /// workers are child processes
+  std::unique_ptr<common::ThreadPool> mThreadPool;
+
+  /// The problem evaluated by each thread. The entry of the calling thread is
+  /// mProblem.
+  std::vector<std::shared_ptr<MultiObjectiveProblem>> mClones;
+
+  /// Whether the problem can't be cloned, in which case all the threads
+  /// evaluate mProblem
+  bool mIsShared;
+
+  /// Serializes the evaluations of a problem that can't be cloned
+  std::mutex mMutex;
+
+  /// The decision vectors evaluated by each thread
+  std::vector<Eigen::VectorXd> mPoints;
+
+  /// Whether the warning about forking a multithreaded process was printed
+  bool mWarnedAboutThreads;
+};
+
+} // namespace optimizer
+} // namespace dart
+
+#endif // DART_OPTIMIZER_POPULATIONEVALUATOR_HPP_
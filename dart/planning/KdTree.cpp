@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/planning/KdTree.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace dart {
+namespace planning {
+
+namespace {
+
+// A subtree is unbalanced if one of its children holds more than this
+// fraction of its nodes
+constexpr double kBalanceFactor = 0.75;
+
+} // namespace
+
+//==============================================================================
+KdTree::KdTree(std::size_t dimension)
+{
+  reset(dimension);
+}
+
+//==============================================================================
+void KdTree::reset(std::size_t dimension)
+{
+  mDimension = dimension;
+  clear();
+}
+
+//==============================================================================
+void KdTree::clear()
+{
+  mPoints.clear();
+  mNodes.clear();
+  mRoot = -1;
+  mDepth = 0u;
+  mNumRemoved = 0u;
+}
+
+//==============================================================================
+void KdTree::reserve(std::size_t numPoints)
+{
+  mPoints.reserve(numPoints * mDimension);
+  mNodes.reserve(numPoints);
+}
+
+//==============================================================================
+std::size_t KdTree::getDimension() const
+{
+  return mDimension;
+}
+
+//==============================================================================
+std::size_t KdTree::getSize() const
+{
+  return mNodes.size();
+}
+
+//==============================================================================
+std::size_t KdTree::getDepth() const
+{
+  return mDepth;
+}
+
+//==============================================================================
+std::size_t KdTree::addPoint(const Eigen::VectorXd& point)
+{
+  assert(mDimension > 0u);
+  assert(static_cast<std::size_t>(point.size()) == mDimension);
+
+  const int index = static_cast<int>(mNodes.size());
+  mPoints.insert(mPoints.end(), point.data(), point.data() + mDimension);
+
+  if (mRoot < 0)
+  {
+    mNodes.push_back({-1, -1, 0, 1, false});
+    mRoot = index;
+    mDepth = 1u;
+    return index;
+  }
+
+  // Descend to the leaf whose cell contains the point
+  mPathCache.clear();
+  int current = mRoot;
+  while (true)
+  {
+    mPathCache.push_back(current);
+    Node& node = mNodes[current];
+    ++node.mSize;
+    const double split = mPoints[current * mDimension + node.mAxis];
+    int& child = (point[node.mAxis] < split) ? node.mLeft : node.mRight;
+    if (child < 0)
+    {
+      child = index;
+      const int axis = static_cast<int>((node.mAxis + 1) % mDimension);
+      mNodes.push_back({-1, -1, axis, 1, false});
+      break;
+    }
+    current = child;
+  }
+
+  // If the point is deeper than a balanced tree allows, rebuild the lowest
+  // subtree on its path that is unbalanced
+  const std::size_t depth = mPathCache.size() + 1u;
+  const double maxDepth = std::floor(
+      std::log(static_cast<double>(mNodes.size()))
+      / std::log(1.0 / kBalanceFactor));
+  if (static_cast<double>(depth) <= maxDepth + 1.0)
+  {
+    mDepth = std::max(mDepth, depth);
+    return index;
+  }
+
+  int childSize = 1;
+  for (std::size_t i = mPathCache.size(); i-- > 0u;)
+  {
+    const int size = mNodes[mPathCache[i]].mSize;
+    if (childSize > kBalanceFactor * size)
+    {
+      rebuildSubtree(i);
+      break;
+    }
+    childSize = size;
+  }
+
+  return index;
+}
+
+//==============================================================================
+Eigen::Map<const Eigen::VectorXd> KdTree::getPoint(std::size_t index) const
+{
+  assert(index < mNodes.size());
+  return Eigen::Map<const Eigen::VectorXd>(
+      mPoints.data() + index * mDimension, mDimension);
+}
+
+//==============================================================================
+void KdTree::removePoint(std::size_t index)
+{
+  assert(index < mNodes.size());
+  if (mNodes[index].mRemoved)
+    return;
+
+  mNodes[index].mRemoved = true;
+  ++mNumRemoved;
+}
+
+//==============================================================================
+bool KdTree::isRemoved(std::size_t index) const
+{
+  assert(index < mNodes.size());
+  return mNodes[index].mRemoved;
+}
+
+//==============================================================================
+std::size_t KdTree::getNumRemoved() const
+{
+  return mNumRemoved;
+}
+
+//==============================================================================
+int KdTree::getNearest(
+    const Eigen::VectorXd& query, double* squaredDistance) const
+{
+  int nearest = -1;
+  double best = std::numeric_limits<double>::infinity();
+
+  if (mRoot >= 0)
+  {
+    Eigen::VectorXd offsets = Eigen::VectorXd::Zero(mDimension);
+    searchNearest(mRoot, query, 0.0, offsets, nearest, best);
+  }
+
+  if (squaredDistance)
+    *squaredDistance = best;
+
+  return nearest;
+}
+
+//==============================================================================
+void KdTree::getNearestK(
+    const Eigen::VectorXd& query,
+    std::size_t k,
+    std::vector<std::size_t>& indices) const
+{
+  indices.clear();
+  if (k == 0u || mRoot < 0)
+    return;
+
+  std::vector<std::pair<double, std::size_t>> heap;
+  heap.reserve(k + 1u);
+  Eigen::VectorXd offsets = Eigen::VectorXd::Zero(mDimension);
+  searchNearestK(mRoot, query, 0.0, offsets, k, heap);
+
+  std::sort_heap(heap.begin(), heap.end());
+  indices.reserve(heap.size());
+  for (const auto& candidate : heap)
+    indices.push_back(candidate.second);
+}
+
+//==============================================================================
+void KdTree::getWithinRadius(
+    const Eigen::VectorXd& query,
+    double radius,
+    std::vector<std::size_t>& indices) const
+{
+  indices.clear();
+  if (radius < 0.0 || mRoot < 0)
+    return;
+
+  Eigen::VectorXd offsets = Eigen::VectorXd::Zero(mDimension);
+  searchWithinRadius(mRoot, query, 0.0, offsets, radius * radius, indices);
+}
+
+//==============================================================================
+void KdTree::rebuild()
+{
+  mBuildCache.resize(mNodes.size());
+  std::iota(mBuildCache.begin(), mBuildCache.end(), 0);
+
+  mDepth = 0u;
+  mRoot = buildSubtree(0u, mBuildCache.size(), 1u);
+}
+
+//==============================================================================
+void KdTree::rebuildSubtree(std::size_t pathIndex)
+{
+  const int root = mPathCache[pathIndex];
+
+  // Collect the nodes of the subtree
+  mBuildCache.clear();
+  mBuildCache.push_back(root);
+  for (std::size_t i = 0u; i < mBuildCache.size(); ++i)
+  {
+    const Node& node = mNodes[mBuildCache[i]];
+    if (node.mLeft >= 0)
+      mBuildCache.push_back(node.mLeft);
+    if (node.mRight >= 0)
+      mBuildCache.push_back(node.mRight);
+  }
+
+  const int newRoot = buildSubtree(0u, mBuildCache.size(), pathIndex + 1u);
+
+  if (pathIndex == 0u)
+  {
+    mRoot = newRoot;
+    return;
+  }
+
+  Node& parent = mNodes[mPathCache[pathIndex - 1u]];
+  if (parent.mLeft == root)
+    parent.mLeft = newRoot;
+  else
+    parent.mRight = newRoot;
+}
+
+//==============================================================================
+double KdTree::computeSquaredDistance(
+    const Eigen::VectorXd& query, std::size_t index) const
+{
+  return (query - getPoint(index)).squaredNorm();
+}
+
+//==============================================================================
+void KdTree::searchNearest(
+    int node,
+    const Eigen::VectorXd& query,
+    double bound,
+    Eigen::VectorXd& offsets,
+    int& nearest,
+    double& best) const
+{
+  const Node& current = mNodes[node];
+  if (!current.mRemoved)
+  {
+    const double distance = computeSquaredDistance(query, node);
+    if (distance < best)
+    {
+      best = distance;
+      nearest = node;
+    }
+  }
+
+  const int axis = current.mAxis;
+  const double diff = query[axis] - mPoints[node * mDimension + axis];
+  const int nearChild = (diff < 0.0) ? current.mLeft : current.mRight;
+  const int farChild = (diff < 0.0) ? current.mRight : current.mLeft;
+
+  if (nearChild >= 0)
+    searchNearest(nearChild, query, bound, offsets, nearest, best);
+
+  if (farChild < 0)
+    return;
+
+  const double offset = offsets[axis];
+  const double farBound = bound - offset * offset + diff * diff;
+  if (farBound < best)
+  {
+    offsets[axis] = diff;
+    searchNearest(farChild, query, farBound, offsets, nearest, best);
+    offsets[axis] = offset;
+  }
+}
+
+//==============================================================================
+void KdTree::searchNearestK(
+    int node,
+    const Eigen::VectorXd& query,
+    double bound,
+    Eigen::VectorXd& offsets,
+    std::size_t k,
+    std::vector<std::pair<double, std::size_t>>& heap) const
+{
+  const Node& current = mNodes[node];
+  if (!current.mRemoved)
+  {
+    const double distance = computeSquaredDistance(query, node);
+    if (heap.size() < k || distance < heap.front().first)
+    {
+      heap.emplace_back(distance, node);
+      std::push_heap(heap.begin(), heap.end());
+      if (heap.size() > k)
+      {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.pop_back();
+      }
+    }
+  }
+
+  const int axis = current.mAxis;
+  const double diff = query[axis] - mPoints[node * mDimension + axis];
+  const int nearChild = (diff < 0.0) ? current.mLeft : current.mRight;
+  const int farChild = (diff < 0.0) ? current.mRight : current.mLeft;
+
+  if (nearChild >= 0)
+    searchNearestK(nearChild, query, bound, offsets, k, heap);
+
+  if (farChild < 0)
+    return;
+
+  const double offset = offsets[axis];
+  const double farBound = bound - offset * offset + diff * diff;
+  if (heap.size() < k || farBound < heap.front().first)
+  {
+    offsets[axis] = diff;
+    searchNearestK(farChild, query, farBound, offsets, k, heap);
+    offsets[axis] = offset;
+  }
+}
+
+//==============================================================================
+void KdTree::searchWithinRadius(
+    int node,
+    const Eigen::VectorXd& query,
+    double bound,
+    Eigen::VectorXd& offsets,
+    double squaredRadius,
+    std::vector<std::size_t>& indices) const
+{
+  const Node& current = mNodes[node];
+  if (!current.mRemoved
+      && computeSquaredDistance(query, node) <= squaredRadius)
+  {
+    indices.push_back(node);
+  }
+
+  const int axis = current.mAxis;
+  const double diff = query[axis] - mPoints[node * mDimension + axis];
+  const int nearChild = (diff < 0.0) ? current.mLeft : current.mRight;
+  const int farChild = (diff < 0.0) ? current.mRight : current.mLeft;
+
+  if (nearChild >= 0)
+  {
+    searchWithinRadius(
+        nearChild, query, bound, offsets, squaredRadius, indices);
+  }
+
+  if (farChild < 0)
+    return;
+
+  const double offset = offsets[axis];
+  const double farBound = bound - offset * offset + diff * diff;
+  if (farBound <= squaredRadius)
+  {
+    offsets[axis] = diff;
+    searchWithinRadius(
+        farChild, query, farBound, offsets, squaredRadius, indices);
+    offsets[axis] = offset;
+  }
+}
+
+//==============================================================================
+int KdTree::buildSubtree(std::size_t begin, std::size_t end, std::size_t depth)
+{
+  if (begin >= end)
+    return -1;
+
+  mDepth = std::max(mDepth, depth);
+
+  // Split along the axis of the largest spread
+  int axis = 0;
+  double largestSpread = -1.0;
+  for (std::size_t i = 0u; i < mDimension; ++i)
+  {
+    double lower = std::numeric_limits<double>::infinity();
+    double upper = -std::numeric_limits<double>::infinity();
+    for (std::size_t j = begin; j < end; ++j)
+    {
+      const double value = mPoints[mBuildCache[j] * mDimension + i];
+      lower = std::min(lower, value);
+      upper = std::max(upper, value);
+    }
+
+    if (upper - lower > largestSpread)
+    {
+      largestSpread = upper - lower;
+      axis = static_cast<int>(i);
+    }
+  }
+
+  const std::size_t middle = begin + (end - begin) / 2u;
+  std::nth_element(
+      mBuildCache.begin() + begin,
+      mBuildCache.begin() + middle,
+      mBuildCache.begin() + end,
+      [this, axis](int a, int b) {
+        return mPoints[a * mDimension + axis] < mPoints[b * mDimension + axis];
+      });
+
+  const int index = mBuildCache[middle];
+  mNodes[index].mAxis = axis;
+  mNodes[index].mSize = static_cast<int>(end - begin);
+  mNodes[index].mLeft = buildSubtree(begin, middle, depth + 1u);
+  mNodes[index].mRight = buildSubtree(middle + 1u, end, depth + 1u);
+
+  return index;
+}
+
+} // namespace planning
+} // namespace dart
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_PLANNING_KDTREE_HPP_
+#define DART_PLANNING_KDTREE_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace dart {
+namespace planning {
+
+/// KdTree is an incremental k-d tree for the nearest neighbor queries of the
+/// sampling-based planners, where the distance is the Euclidean distance
+/// between configurations.
+///
+/// The points are stored contiguously in the insertion order, and the index
+/// of a point is its insertion order, so it can be used to address per-node
+/// data of a planner (e.g., parents and costs). A new point is attached to a
+/// leaf of the tree without moving the others. Since the insertion order of a
+/// tree grown by a planner is far from random (e.g., RRT adds straight chains
+/// of nodes when it connects), the tree is kept balanced like a scapegoat
+/// tree: when a point is inserted too deep, the lowest unbalanced subtree on
+/// its path is rebuilt, which keeps the depth and the amortized insertion cost
+/// logarithmic.
+///
+/// A point can be removed from the searches, e.g., when a lazy planner finds
+/// that it is unreachable. The removed point stays in the tree to keep the
+/// indices of the others, and it is skipped by the searches.
+class KdTree
+{
+public:
+  /// Constructor
+  explicit KdTree(std::size_t dimension = 0u);
+
+  /// Remove all the points and set the dimension of the new points
+  void reset(std::size_t dimension);
+
+  /// Remove all the points
+  void clear();
+
+  /// Reserve the storage for numPoints points
+  void reserve(std::size_t numPoints);
+
+  /// Get the dimension of the points
+  std::size_t getDimension() const;
+
+  /// Get the number of the points
+  std::size_t getSize() const;
+
+  /// Get the depth of the tree, which is zero for an empty tree
+  std::size_t getDepth() const;
+
+  /// Add a point and return its index
+  std::size_t addPoint(const Eigen::VectorXd& point);
+
+  /// Get the point of the given index
+  Eigen::Map<const Eigen::VectorXd> getPoint(std::size_t index) const;
+
+  /// Remove the point of the given index from the searches. The point keeps
+  /// its index, and it is still counted by getSize().
+  void removePoint(std::size_t index);
+
+  /// Returns true if the point of the given index is removed from the searches
+  bool isRemoved(std::size_t index) const;
+
+  /// Get the number of the removed points
+  std::size_t getNumRemoved() const;
+
+  /// Get the index of the nearest point to the query, and its squared distance
+  /// if squaredDistance is not nullptr. Returns -1 if the tree has no points
+  /// that are not removed.
+  int getNearest(
+      const Eigen::VectorXd& query, double* squaredDistance = nullptr) const;
+
+  /// Get the indices of the k nearest points to the query, nearest first
+  void getNearestK(
+      const Eigen::VectorXd& query,
+      std::size_t k,
+      std::vector<std::size_t>& indices) const;
+
+  /// Get the indices of the points whose distances to the query are at most
+  /// radius, in no particular order
+  void getWithinRadius(
+      const Eigen::VectorXd& query,
+      double radius,
+      std::vector<std::size_t>& indices) const;
+
+  /// Rebuild the whole tree into a balanced one
+  void rebuild();
+
+protected:
+  /// Node of the tree. The node of index i splits the space at the
+  /// coordinate mAxis of the point of index i.
+  struct Node
+  {
+    int mLeft;
+    int mRight;
+    int mAxis;
+
+    /// Number of the nodes in the subtree of this node
+    int mSize;
+
+    /// Whether the point of this node is removed from the searches
+    bool mRemoved;
+  };
+
+  /// Squared distance between the query and the point of the given index
+  double computeSquaredDistance(
+      const Eigen::VectorXd& query, std::size_t index) const;
+
+  /// The searches recurse into the subtrees whose cells can hold a closer
+  /// point. bound is the squared distance from the query to the cell of the
+  /// subtree, which is tracked incrementally with the per-axis offsets from
+  /// the query to the cell (Arya and Mount, 1993). The recursion is as deep
+  /// as the tree, which is kept logarithmic.
+  void searchNearest(
+      int node,
+      const Eigen::VectorXd& query,
+      double bound,
+      Eigen::VectorXd& offsets,
+      int& nearest,
+      double& best) const;
+
+  /// Search for the k nearest points, which are kept in a max-heap
+  void searchNearestK(
+      int node,
+      const Eigen::VectorXd& query,
+      double bound,
+      Eigen::VectorXd& offsets,
+      std::size_t k,
+      std::vector<std::pair<double, std::size_t>>& heap) const;
+
+  /// Search for the points within the squared radius
+  void searchWithinRadius(
+      int node,
+      const Eigen::VectorXd& query,
+      double bound,
+      Eigen::VectorXd& offsets,
+      double squaredRadius,
+      std::vector<std::size_t>& indices) const;
+
+  /// Rebuild the subtree of the node of mPathCache at the given position
+  void rebuildSubtree(std::size_t pathIndex);
+
+  /// Build a balanced subtree over indices [begin, end) of mBuildCache, whose
+  /// root is at the given depth, and return its root
+  int buildSubtree(std::size_t begin, std::size_t end, std::size_t depth);
+
+  /// Dimension of the points
+  std::size_t mDimension;
+
+  /// Coordinates of the points, stored contiguously
+  std::vector<double> mPoints;
+
+  /// Nodes of the tree, one per point
+  std::vector<Node> mNodes;
+
+  /// Index of the root node, or -1 if the tree is empty
+  int mRoot;
+
+  /// Depth of the tree
+  std::size_t mDepth;
+
+  /// Number of the removed points
+  std::size_t mNumRemoved;
+
+  /// Cache of the path of an insertion
+  std::vector<int> mPathCache;
+
+  /// Cache of the nodes of a subtree being rebuilt
+  std::vector<int> mBuildCache;
+};
+
+} // namespace planning
+} // namespace dart
+
+#endif // DART_PLANNING_KDTREE_HPP_
@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "dart/planning/MotionValidator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <unordered_map>
+
+#include "dart/collision/CollisionFilter.hpp"
+#include "dart/collision/CollisionObject.hpp"
+#include "dart/constraint/ConstraintSolver.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+
+namespace dart {
+namespace planning {
+
+namespace {
+
+//==============================================================================
+/// CollisionObject that only stands for a ShapeFrame when it is passed to a
+/// collision filter
+class ShapeFrameCollisionObject : public collision::CollisionObject
+{
+public:
+  ShapeFrameCollisionObject(
+      collision::CollisionDetector* detector,
+      const dynamics::ShapeFrame* shapeFrame)
+    : collision::CollisionObject(detector, shapeFrame)
+  {
+    // Do nothing
+  }
+
+protected:
+  // Documentation inherited
+  void updateEngineData() override
+  {
+    // Do nothing
+  }
+};
+
+//==============================================================================
+/// Collision filter of the validator, which applies the rules of
+/// BodyNodeCollisionFilter that don't depend on the simulation state: the
+/// same and non-collidable BodyNodes, the self-collision and adjacent body
+/// checks of the skeletons, and the blacklist of the world. Unlike the filter
+/// of the constraint solver, it doesn't ignore the pairs of immobile
+/// skeletons, so an immobile robot is still checked against the static
+/// obstacles.
+class ValidatorCollisionFilter : public collision::CollisionFilter
+{
+public:
+  explicit ValidatorCollisionFilter(
+      std::shared_ptr<const collision::BodyNodeCollisionFilter> blackList)
+    : mBlackList(std::move(blackList))
+  {
+    // Do nothing
+  }
+
+  // Documentation inherited
+  bool ignoresCollision(
+      const collision::CollisionObject* object1,
+      const collision::CollisionObject* object2) const override
+  {
+    if (object1 == object2)
+      return true;
+
+    const auto shapeNode1 = object1->getShapeFrame()->asShapeNode();
+    const auto shapeNode2 = object2->getShapeFrame()->asShapeNode();
+    if (!shapeNode1 || !shapeNode2)
+      return false;
+
+    const dynamics::BodyNode* bodyNode1 = shapeNode1->getBodyNodePtr();
+    const dynamics::BodyNode* bodyNode2 = shapeNode2->getBodyNodePtr();
+    if (bodyNode1 == bodyNode2)
+      return true;
+
+    if (!bodyNode1->isCollidable() || !bodyNode2->isCollidable())
+      return true;
+
+    const auto skeleton = bodyNode1->getSkeleton();
+    if (skeleton == bodyNode2->getSkeleton())
+    {
+      if (!skeleton->isEnabledSelfCollisionCheck())
+        return true;
+
+      if (!skeleton->isEnabledAdjacentBodyCheck()
+          && (bodyNode1->getParentBodyNode() == bodyNode2
+              || bodyNode2->getParentBodyNode() == bodyNode1))
+      {
+        return true;
+      }
+    }
+
+    return mBlackList && mBlackList->isInBlackList(bodyNode1, bodyNode2);
+  }
+
+private:
+  /// The collision filter of the world whose blacklist is applied, or null
+  std::shared_ptr<const collision::BodyNodeCollisionFilter> mBlackList;
+};
+
+//==============================================================================
+/// Collision filter of a replica of the other threads, which passes the
+/// ShapeFrames of the original skeletons to the filter of the validator in
+/// place of the ones of the clones, so that the blacklist of the world, which
+/// is keyed on BodyNodes, applies to the clones as well
+class ReplicaCollisionFilter : public collision::CollisionFilter
+{
+public:
+  explicit ReplicaCollisionFilter(
+      std::shared_ptr<collision::CollisionFilter> filter)
+    : mFilter(std::move(filter))
+  {
+    // Do nothing
+  }
+
+  /// Map the ShapeNodes of clone to the ones of original
+  void addSkeleton(
+      const dynamics::Skeleton& original,
+      const dynamics::Skeleton& clone,
+      collision::CollisionDetector* detector)
+  {
+    assert(original.getNumBodyNodes() == clone.getNumBodyNodes());
+    for (std::size_t i = 0u; i < clone.getNumBodyNodes(); ++i)
+    {
+      const dynamics::BodyNode* originalBody = original.getBodyNode(i);
+      const dynamics::BodyNode* cloneBody = clone.getBodyNode(i);
+      assert(originalBody->getNumShapeNodes() == cloneBody->getNumShapeNodes());
+      for (std::size_t j = 0u; j < cloneBody->getNumShapeNodes(); ++j)
+      {
+        mOriginals[cloneBody->getShapeNode(j)].reset(
+            new ShapeFrameCollisionObject(
+                detector, originalBody->getShapeNode(j)));
+      }
+    }
+  }
+
+  // Documentation inherited
+  bool ignoresCollision(
+      const collision::CollisionObject* object1,
+      const collision::CollisionObject* object2) const override
+  {
+    return mFilter->ignoresCollision(
+        getOriginal(object1), getOriginal(object2));
+  }
+
+private:
+  /// Returns the object of the original ShapeFrame of the object of a clone
+  const collision::CollisionObject* getOriginal(
+      const collision::CollisionObject* object) const
+  {
+    const auto it = mOriginals.find(object->getShapeFrame());
+    if (it == mOriginals.end())
+      return object;
+
+    return it->second.get();
+  }
+
+  /// The collision filter of the validator
+  std::shared_ptr<collision::CollisionFilter> mFilter;
+
+  /// Objects of the original ShapeFrames of the ones of the clones
+  std::unordered_map<
+      const dynamics::ShapeFrame*,
+      std::unique_ptr<ShapeFrameCollisionObject>>
+      mOriginals;
+};
+
+} // namespace
+
+//==============================================================================
+MotionValidator::Option::Option(double resolution, std::size_t numThreads)
+  : mResolution(resolution), mNumThreads(numThreads)
+{
+  // Do nothing
+}
+
+//==============================================================================
+MotionValidator::MotionValidator(
+    simulation::WorldPtr world,
+    dynamics::SkeletonPtr robot,
+    const std::vector<std::size_t>& dofs,
+    const Option& option)
+  : mWorld(std::move(world)),
+    mRobot(std::move(robot)),
+    mDofs(dofs),
+    mOption(option)
+{
+  assert(mWorld);
+  assert(mRobot);
+  assert(mOption.mResolution > 0.0);
+
+  if (mOption.mNumThreads == 0u)
+    mOption.mNumThreads = common::ThreadPool::getHardwareConcurrency();
+
+  if (mOption.mNumThreads > 1u)
+    mThreadPool.reset(new common::ThreadPool(mOption.mNumThreads));
+
+  const auto& solver = mWorld->getConstraintSolver();
+  mCollisionOption = collision::CollisionOption(
+      false,
+      1u,
+      std::make_shared<ValidatorCollisionFilter>(
+          std::dynamic_pointer_cast<collision::BodyNodeCollisionFilter>(
+              solver->getCollisionOption().collisionFilter)));
+
+  mReplicas.resize(1u);
+  mReplicas[0].mRobot = mRobot;
+  mReplicas[0].mCollisionOption = mCollisionOption;
+  mReplicas[0].mNumQueries = 0u;
+  updateEnvironment();
+}
+
+//==============================================================================
+const MotionValidator::Option& MotionValidator::getOption() const
+{
+  return mOption;
+}
+
+//==============================================================================
+std::size_t MotionValidator::getNumThreads() const
+{
+  return mOption.mNumThreads;
+}
+
+//==============================================================================
+bool MotionValidator::isValid(const Eigen::VectorXd& config)
+{
+  updateEnvironment();
+  return isValid(mReplicas[0], config);
+}
+
+//==============================================================================
+bool MotionValidator::isValid(
+    const Eigen::VectorXd& from, const Eigen::VectorXd& to)
+{
+  updateEnvironment();
+  return isValid(mReplicas[0], from, to);
+}
+
+//==============================================================================
+bool MotionValidator::isPathValid(const std::list<Eigen::VectorXd>& path)
+{
+  if (path.empty())
+    return true;
+
+  if (!isValid(path.front()))
+    return false;
+
+  std::vector<Motion> motions;
+  motions.reserve(path.size() - 1u);
+  for (auto it = std::next(path.begin()); it != path.end(); ++it)
+    motions.emplace_back(*std::prev(it), *it);
+
+  // The end configuration of each motion is checked along with it, so that
+  // the configurations are checked in parallel too
+  std::atomic<bool> valid(true);
+  updateEnvironment();
+  updateReplicas();
+  parallelFor(motions.size(), [&](std::size_t index, std::size_t threadIndex) {
+    if (!valid.load(std::memory_order_relaxed))
+      return;
+
+    Replica& replica = mReplicas[threadIndex];
+    const Motion& motion = motions[index];
+    if (!isValid(replica, motion.second)
+        || !isValid(replica, motion.first, motion.second))
+    {
+      valid.store(false, std::memory_order_relaxed);
+    }
+  });
+
+  return valid.load();
+}
+
+//==============================================================================
+int MotionValidator::findFirstInvalid(const std::vector<Motion>& motions)
+{
+  const int numMotions = static_cast<int>(motions.size());
+  if (numMotions == 0)
+    return -1;
+
+  if (numMotions == 1)
+    return isValid(motions[0].first, motions[0].second) ? -1 : 0;
+
+  std::atomic<int> firstInvalid(numMotions);
+  updateEnvironment();
+  updateReplicas();
+  parallelFor(motions.size(), [&](std::size_t index, std::size_t threadIndex) {
+    const int motionIndex = static_cast<int>(index);
+    if (motionIndex > firstInvalid.load(std::memory_order_relaxed))
+      return;
+
+    const Motion& motion = motions[index];
+    if (isValid(mReplicas[threadIndex], motion.first, motion.second))
+      return;
+
+    int current = firstInvalid.load(std::memory_order_relaxed);
+    while (motionIndex < current
+           && !firstInvalid.compare_exchange_weak(current, motionIndex))
+    {
+      // Retry with the updated value of current
+    }
+  });
+
+  const int result = firstInvalid.load();
+  return (result < numMotions) ? result : -1;
+}
+
+//==============================================================================
+void MotionValidator::validatePaths(
+    const std::vector<Eigen::MatrixXd>& paths, std::vector<char>& valid)
+{
+  valid.assign(paths.size(), 0);
+  if (paths.empty())
+    return;
+
+  updateEnvironment();
+  updateReplicas();
+  parallelFor(paths.size(), [&](std::size_t index, std::size_t threadIndex) {
+    Replica& replica = mReplicas[threadIndex];
+    const Eigen::MatrixXd& path = paths[index];
+    const Eigen::Index numWaypoints = path.cols();
+
+    bool pathValid = true;
+    for (Eigen::Index i = 1; i < numWaypoints && pathValid; ++i)
+    {
+      const Eigen::VectorXd waypoint = path.col(i);
+      if (i + 1 < numWaypoints)
+        pathValid = isValid(replica, waypoint);
+
+      pathValid = pathValid && isValid(replica, path.col(i - 1), waypoint);
+    }
+
+    valid[index] = pathValid;
+  });
+}
+
+//==============================================================================
+void MotionValidator::validateConfigurations(
+    const Eigen::MatrixXd& configs, std::vector<char>& valid)
+{
+  valid.assign(static_cast<std::size_t>(configs.cols()), 0);
+  if (configs.cols() == 0)
+    return;
+
+  updateEnvironment();
+  updateReplicas();
+  parallelFor(valid.size(), [&](std::size_t index, std::size_t threadIndex) {
+    const Eigen::VectorXd config = configs.col(static_cast<int>(index));
+    valid[index] = isValid(mReplicas[threadIndex], config);
+  });
+}
+
+//==============================================================================
+std::size_t MotionValidator::getNumQueries() const
+{
+  std::size_t numQueries = 0u;
+  for (const auto& replica : mReplicas)
+    numQueries += replica.mNumQueries;
+
+  return numQueries;
+}
+
+//==============================================================================
+void MotionValidator::resetNumQueries()
+{
+  for (auto& replica : mReplicas)
+    replica.mNumQueries = 0u;
+}
+
+//==============================================================================
+void MotionValidator::createGroups(
+    Replica& replica, const collision::CollisionDetectorPtr& detector) const
+{
+  replica.mDetector = detector;
+
+  replica.mRobotGroup = detector->createCollisionGroupAsSharedPtr();
+  replica.mRobotGroup->subscribeTo(replica.mRobot);
+
+  replica.mEnvironmentGroup = detector->createCollisionGroupAsSharedPtr();
+  for (const auto& skeleton : replica.mEnvironment)
+    replica.mEnvironmentGroup->subscribeTo(skeleton);
+}
+
+//==============================================================================
+void MotionValidator::updateEnvironment()
+{
+  // The groups subscribe to the skeletons, so they only need to be rebuilt
+  // when skeletons are added to or removed from the world
+  Replica& replica = mReplicas[0];
+  const std::size_t numSkeletons = mWorld->getNumSkeletons();
+  std::size_t count = 0u;
+  bool changed = !replica.mRobotGroup;
+  for (std::size_t i = 0u; i < numSkeletons && !changed; ++i)
+  {
+    const dynamics::SkeletonPtr skeleton = mWorld->getSkeleton(i);
+    if (skeleton == mRobot)
+      continue;
+
+    if (count >= replica.mEnvironment.size()
+        || replica.mEnvironment[count] != skeleton)
+    {
+      changed = true;
+    }
+    ++count;
+  }
+
+  if (!changed && count == replica.mEnvironment.size())
+    return;
+
+  replica.mEnvironment.clear();
+  for (std::size_t i = 0u; i < numSkeletons; ++i)
+  {
+    const dynamics::SkeletonPtr skeleton = mWorld->getSkeleton(i);
+    if (skeleton != mRobot)
+      replica.mEnvironment.push_back(skeleton);
+  }
+
+  createGroups(
+      replica, mWorld->getConstraintSolver()->getCollisionDetector());
+
+  // Force the replicas of the other threads to be cloned again
+  mVersions.clear();
+}
+
+//==============================================================================
+void MotionValidator::updateReplicas()
+{
+  const std::size_t numThreads = mOption.mNumThreads;
+  if (numThreads < 2u)
+    return;
+
+  const std::vector<dynamics::SkeletonPtr>& environment
+      = mReplicas[0].mEnvironment;
+
+  bool changed = mReplicas.size() != numThreads
+                 || mVersions.size() != environment.size() + 1u
+                 || mVersions[0] != mRobot->getVersion();
+  for (std::size_t i = 0u; i < environment.size() && !changed; ++i)
+    changed = mVersions[i + 1u] != environment[i]->getVersion();
+
+  if (changed)
+  {
+    mReplicas.resize(1u);
+    mReplicas.resize(numThreads);
+  }
+
+  // The vector of the replicas may have been reallocated
+  const Replica& source = mReplicas[0];
+  if (changed)
+  {
+    for (std::size_t i = 1u; i < numThreads; ++i)
+    {
+      Replica& replica = mReplicas[i];
+      replica.mRobot = mRobot->cloneSkeleton();
+      for (const auto& skeleton : source.mEnvironment)
+        replica.mEnvironment.push_back(skeleton->cloneSkeleton());
+      replica.mNumQueries = 0u;
+
+      // The collision detectors may not be thread-safe, so every replica gets
+      // its own
+      createGroups(replica, source.mDetector->cloneWithoutCollisionObjects());
+
+      // The blacklist of the world refers to the skeletons of the world, so
+      // the clones are mapped back to them
+      auto filter = std::make_shared<ReplicaCollisionFilter>(
+          mCollisionOption.collisionFilter);
+      filter->addSkeleton(*mRobot, *replica.mRobot, source.mDetector.get());
+      for (std::size_t j = 0u; j < source.mEnvironment.size(); ++j)
+      {
+        filter->addSkeleton(
+            *source.mEnvironment[j],
+            *replica.mEnvironment[j],
+            source.mDetector.get());
+      }
+      replica.mCollisionOption = mCollisionOption;
+      replica.mCollisionOption.collisionFilter = std::move(filter);
+    }
+
+    mVersions.clear();
+    mVersions.push_back(mRobot->getVersion());
+    for (const auto& skeleton : source.mEnvironment)
+      mVersions.push_back(skeleton->getVersion());
+  }
+
+  const Eigen::VectorXd robotPositions = mRobot->getPositions();
+  for (std::size_t i = 1u; i < numThreads; ++i)
+  {
+    Replica& replica = mReplicas[i];
+    replica.mRobot->setPositions(robotPositions);
+    for (std::size_t j = 0u; j < source.mEnvironment.size(); ++j)
+    {
+      replica.mEnvironment[j]->setPositions(
+          source.mEnvironment[j]->getPositions());
+    }
+  }
+}
+
+//==============================================================================
+bool MotionValidator::isValid(Replica& replica, const Eigen::VectorXd& config)
+{
+  replica.mRobot->setPositions(mDofs, config);
+
+  ++replica.mNumQueries;
+  if (replica.mRobotGroup->collide(
+          replica.mEnvironmentGroup.get(), replica.mCollisionOption))
+  {
+    return false;
+  }
+
+  if (!replica.mRobot->isEnabledSelfCollisionCheck())
+    return true;
+
+  ++replica.mNumQueries;
+  return !replica.mRobotGroup->collide(replica.mCollisionOption);
+}
+
+//==============================================================================
+bool MotionValidator::isValid(
+    Replica& replica, const Eigen::VectorXd& from, const Eigen::VectorXd& to)
+{
+  // The tolerance keeps the motions that are a whole multiple of the
+  // resolution long, like the steps of the planners, from getting an extra
+  // segment due to round-off errors
+  const double length = (to - from).norm();
+  const int numSegments
+      = static_cast<int>(std::ceil(length / mOption.mResolution - 1e-9));
+  if (numSegments < 2)
+    return true;
+
+  // Visit the interior configurations i / numSegments in bisection order: the
+  // ones at odd multiples of stride are visited for decreasing powers of two
+  // stride, so every level halves the gaps between the checked configurations
+  int stride = 1;
+  while (2 * stride < numSegments)
+    stride *= 2;
+
+  for (; stride > 0; stride /= 2)
+  {
+    for (int i = stride; i < numSegments; i += 2 * stride)
+    {
+      const double t = static_cast<double>(i) / numSegments;
+      if (!isValid(replica, from + t * (to - from)))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+//==============================================================================
+void MotionValidator::parallelFor(
+    std::size_t size, const common::ThreadPool::IndexFunction& func)
+{
+  if (mThreadPool)
+  {
+    mThreadPool->parallelFor(size, func);
+    return;
+  }
+
+  for (std::size_t i = 0u; i < size; ++i)
+    func(i, 0u);
+}
+
+} // namespace planning
+} // namespace dart
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_PLANNING_MOTIONVALIDATOR_HPP_
+#define DART_PLANNING_MOTIONVALIDATOR_HPP_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dart/collision/CollisionDetector.hpp"
+#include "dart/collision/CollisionGroup.hpp"
+#include "dart/collision/CollisionOption.hpp"
+#include "dart/common/ThreadPool.hpp"
+#include "dart/simulation/World.hpp"
+
+namespace dart {
+namespace planning {
+
+/// MotionValidator checks whether configurations of some DOFs of a robot, and
+/// the straight motions between them, are free of collisions.
+///
+/// World::checkCollision() collides every pair of objects of the world and
+/// collects the contacts. The planners only need to know whether the robot
+/// hits the environment or itself, so this class builds a collision group of
+/// the robot and another one of the other skeletons of the world once, and
+/// collides the two groups with binary queries, which stop at the first
+/// contact without computing the contact information. The robot is collided
+/// with itself too if its self-collision check is enabled. The pairs that
+/// BodyNodeCollisionFilter ignores regardless of the simulation state are
+/// ignored: the adjacent bodies if the adjacent body check of the robot is
+/// disabled, and the blacklist of the collision filter of the constraint
+/// solver of the world if it is a BodyNodeCollisionFilter. The pairs of
+/// immobile skeletons are checked, so an immobile robot collides with the
+/// static obstacles. World::checkCollision() collides all the pairs.
+///
+/// A motion is checked at configurations at most the resolution apart, in
+/// bisection order: the midpoint is checked first, then the quarter points,
+/// and so on, so a colliding motion is usually rejected after a few queries.
+///
+/// The configurations and the single motions are checked on the robot of the
+/// world, whose positions are changed. Paths and batches of motions are
+/// checked in parallel, in which case every thread other than the calling one
+/// uses its own replica of the robot and the environment, which is cloned
+/// again whenever the version of a skeleton or the set of the skeletons of
+/// the world changes. The replicas copy the positions of the skeletons of the
+/// world at every parallel check.
+class MotionValidator
+{
+public:
+  /// A straight motion from the first configuration to the second one
+  using Motion = std::pair<Eigen::VectorXd, Eigen::VectorXd>;
+
+  struct Option
+  {
+    /// Largest distance between the configurations checked along a motion
+    double mResolution;
+
+    /// Number of threads for the parallel checks. If it is zero, the number
+    /// of hardware threads is used.
+    std::size_t mNumThreads;
+
+    /// Constructor
+    Option(double resolution = 0.02, std::size_t numThreads = 1u);
+  };
+
+  /// Constructor
+  MotionValidator(
+      simulation::WorldPtr world,
+      dynamics::SkeletonPtr robot,
+      const std::vector<std::size_t>& dofs,
+      const Option& option = Option());
+
+  /// Get the options
+  const Option& getOption() const;
+
+  /// Get the number of threads of the parallel checks
+  std::size_t getNumThreads() const;
+
+  /// Returns true if the configuration is free of collisions
+  bool isValid(const Eigen::VectorXd& config);
+
+  /// Returns true if the straight motion between the two configurations is
+  /// free of collisions. The two configurations themselves are not checked.
+  bool isValid(const Eigen::VectorXd& from, const Eigen::VectorXd& to);
+
+  /// Returns true if the configurations of the path and the motions between
+  /// the consecutive ones are free of collisions. The segments of the path
+  /// are checked in parallel.
+  bool isPathValid(const std::list<Eigen::VectorXd>& path);
+
+  /// Check the motions in parallel, excluding their end configurations, and
+  /// return the index of the first invalid one, or -1 if all of them are
+  /// valid. Once a motion is found to be invalid, the motions after it are
+  /// skipped, but all the motions before it are checked, so the result
+  /// doesn't depend on the scheduling of the threads.
+  int findFirstInvalid(const std::vector<Motion>& motions);
+
+  /// Check the paths in parallel, whose waypoints are the columns of the
+  /// matrices, and set valid[i] to one if the ith path is valid and to zero
+  /// otherwise. Like the end configurations of a motion, the first and the
+  /// last waypoints of a path are not checked. This is meant for batches of
+  /// candidate modifications of a path, which are checked independently.
+  void validatePaths(
+      const std::vector<Eigen::MatrixXd>& paths, std::vector<char>& valid);
+
+  /// Check the configurations that are the columns of configs in parallel, and
+  /// set valid[i] to one if the ith configuration is free of collisions and
+  /// to zero otherwise. This is meant for batches of candidate configurations,
+  /// e.g., the solutions of IkFast::computeBatchSolutions().
+  void validateConfigurations(
+      const Eigen::MatrixXd& configs, std::vector<char>& valid);
+
+  /// Get the number of the collision queries made since the construction or
+  /// the last call to resetNumQueries()
+  std::size_t getNumQueries() const;
+
+  /// Reset the number of the collision queries
+  void resetNumQueries();
+
+protected:
+  /// The robot, the environment, and their collision groups used by a thread
+  struct Replica
+  {
+    /// The robot, which is the robot of the world for the calling thread
+    dynamics::SkeletonPtr mRobot;
+
+    /// The other skeletons
+    std::vector<dynamics::SkeletonPtr> mEnvironment;
+
+    /// Collision detector of the groups
+    collision::CollisionDetectorPtr mDetector;
+
+    /// Collision group of the robot
+    std::shared_ptr<collision::CollisionGroup> mRobotGroup;
+
+    /// Collision group of the environment
+    std::shared_ptr<collision::CollisionGroup> mEnvironmentGroup;
+
+    /// Binary query option, whose collision filter refers to the skeletons of
+    /// the replica
+    collision::CollisionOption mCollisionOption;
+
+    /// Number of the collision queries
+    std::size_t mNumQueries;
+  };
+
+  /// Build the collision groups of a replica
+  void createGroups(
+      Replica& replica, const collision::CollisionDetectorPtr& detector) const;
+
+  /// Rebuild the collision groups of the calling thread if the set of the
+  /// skeletons of the world has changed
+  void updateEnvironment();
+
+  /// Clone the replicas of the other threads if a skeleton has changed, and
+  /// copy the positions of the skeletons of the world to them
+  void updateReplicas();
+
+  /// Returns true if the configuration is free of collisions on the replica
+  bool isValid(Replica& replica, const Eigen::VectorXd& config);
+
+  /// Returns true if the motion is free of collisions on the replica
+  bool isValid(
+      Replica& replica, const Eigen::VectorXd& from, const Eigen::VectorXd& to);
+
+  /// Run func for each index in [0, size) on the thread pool, or serially if
+  /// there is a single thread
+  void parallelFor(
+      std::size_t size, const common::ThreadPool::IndexFunction& func);
+
+  /// The world that the robot is in
+  simulation::WorldPtr mWorld;
+
+  /// The robot
+  dynamics::SkeletonPtr mRobot;
+
+  /// The DOFs of the robot that the configurations are given for
+  std::vector<std::size_t> mDofs;
+
+  /// Options
+  Option mOption;
+
+  /// Binary query option with the collision filter of the validator
+  collision::CollisionOption mCollisionOption;
+
+  /// ThreadPool, which is null if there is a single thread
+  std::unique_ptr<common::ThreadPool> mThreadPool;
+
+  /// Replicas, one per thread. The first one is used by the calling thread,
+  /// and it holds the skeletons of the world.
+  std::vector<Replica> mReplicas;
+
+  /// Versions of the robot and the environment when the replicas of the other
+  /// threads were cloned
+  std::vector<std::size_t> mVersions;
+};
+
+} // namespace planning
+} // namespace dart
+
+#endif // DART_PLANNING_MOTIONVALIDATOR_HPP_
@@ -339,7 +339,7 @@ bool PathPlanner<R>::planBidirectionalRrt(
     // functions return true if rrt2 can add the given node in the tree. In this
     // case, this would imply that the two trees meet.
     bool treesMet = false;
-    const Eigen::VectorXd& rrt2target = *(rrt1->configVector[rrt1->activeNode]);
+    const Eigen::VectorXd rrt2target = rrt1->getConfig(rrt1->activeNode);
     if (connect)
       treesMet = rrt2->connect(rrt2target);
     else
@@ -359,13 +359,13 @@ bool PathPlanner<R>::planBidirectionalRrt(
     // Print the gap between the trees in debug mode
     if (debug)
     {
-      double gap = rrt2->getGap(*(rrt1->configVector[rrt1->activeNode]));
+      double gap = rrt2->getGap(rrt1->getConfig(rrt1->activeNode));
       if (gap < smallestGap)
       {
         smallestGap = gap;
         std::cout << "Gap: " << smallestGap
-                  << "  Sizes: " << start_rrt->configVector.size() << "/"
-                  << goal_rrt->configVector.size() << std::endl;
+                  << "  Sizes: " << start_rrt->getSize() << "/"
+                  << goal_rrt->getSize() << std::endl;
       }
     }
   }
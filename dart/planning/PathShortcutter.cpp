@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/planning/PathShortcutter.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace dart {
+namespace planning {
+
+//==============================================================================
+PathShortcutter::Option::Option(
+    std::size_t numRounds,
+    std::size_t batchSize,
+    double partialShortcutProbability,
+    double minImprovement,
+    std::size_t numSmoothingSegments,
+    unsigned int seed)
+  : mNumRounds(numRounds),
+    mBatchSize(batchSize),
+    mPartialShortcutProbability(partialShortcutProbability),
+    mMinImprovement(minImprovement),
+    mNumSmoothingSegments(numSmoothingSegments),
+    mSeed(seed)
+{
+  // Do nothing
+}
+
+//==============================================================================
+PathShortcutter::PathShortcutter(
+    std::shared_ptr<MotionValidator> validator, const Option& option)
+  : mValidator(std::move(validator)),
+    mOption(option),
+    mRandomEngine(option.mSeed)
+{
+  assert(mValidator);
+  assert(mOption.mNumSmoothingSegments > 0u);
+}
+
+//==============================================================================
+const std::shared_ptr<MotionValidator>&
+PathShortcutter::getMotionValidator() const
+{
+  return mValidator;
+}
+
+//==============================================================================
+const PathShortcutter::Option& PathShortcutter::getOption() const
+{
+  return mOption;
+}
+
+//==============================================================================
+void PathShortcutter::setSeed(unsigned int seed)
+{
+  mOption.mSeed = seed;
+  mRandomEngine.seed(seed);
+}
+
+//==============================================================================
+std::size_t PathShortcutter::shortcut(Eigen::MatrixXd& path)
+{
+  std::size_t numApplied = 0u;
+  std::vector<std::size_t> order;
+  std::vector<std::size_t> applied;
+
+  for (std::size_t round = 0u; round < mOption.mNumRounds; ++round)
+  {
+    const Eigen::Index numWaypoints = path.cols();
+    if (numWaypoints < 3)
+      break;
+
+    mArcLengths.resize(numWaypoints);
+    mArcLengths[0] = 0.0;
+    for (Eigen::Index i = 1; i < numWaypoints; ++i)
+    {
+      mArcLengths[i]
+          = mArcLengths[i - 1] + (path.col(i) - path.col(i - 1)).norm();
+    }
+
+    // Draw the whole batch before checking it, so that the candidates only
+    // depend on the random engine and not on the number of threads
+    mCandidates.clear();
+    mCandidateWaypoints.clear();
+    Candidate candidate;
+    Eigen::MatrixXd waypoints;
+    for (std::size_t i = 0u; i < mOption.mBatchSize; ++i)
+    {
+      if (drawCandidate(path, candidate, waypoints))
+      {
+        mCandidates.push_back(candidate);
+        mCandidateWaypoints.push_back(waypoints);
+      }
+    }
+
+    if (mCandidates.empty())
+      continue;
+
+    mValidator->validatePaths(mCandidateWaypoints, mValid);
+
+    order.clear();
+    for (std::size_t i = 0u; i < mCandidates.size(); ++i)
+    {
+      if (mValid[i])
+        order.push_back(i);
+    }
+
+    // The ties are broken by the order of the draws to keep the result
+    // deterministic
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+      if (mCandidates[a].mImprovement != mCandidates[b].mImprovement)
+        return mCandidates[a].mImprovement > mCandidates[b].mImprovement;
+
+      return a < b;
+    });
+
+    // Apply the best candidates that don't overlap, where two candidates may
+    // share a waypoint since both of them keep it
+    applied.clear();
+    for (const std::size_t index : order)
+    {
+      const Candidate& current = mCandidates[index];
+      const bool overlaps = std::any_of(
+          applied.begin(), applied.end(), [&](std::size_t other) {
+            return current.mStart < mCandidates[other].mEnd
+                   && mCandidates[other].mStart < current.mEnd;
+          });
+
+      if (!overlaps)
+        applied.push_back(index);
+    }
+
+    applyCandidates(path, applied);
+    numApplied += applied.size();
+  }
+
+  return numApplied;
+}
+
+//==============================================================================
+std::size_t PathShortcutter::shortcut(std::list<Eigen::VectorXd>& path)
+{
+  Eigen::MatrixXd matrix = toMatrix(path);
+  const std::size_t numApplied = shortcut(matrix);
+  toList(matrix, path);
+
+  return numApplied;
+}
+
+//==============================================================================
+std::size_t PathShortcutter::smooth(Eigen::MatrixXd& path)
+{
+  const Eigen::Index numWaypoints = path.cols();
+  if (numWaypoints < 3)
+    return 0u;
+
+  // The corner at the kth waypoint is replaced by the quadratic B-spline
+  // segment from the middle of the previous motion to the middle of the next
+  // one. The segments of different corners don't overlap, so they are checked
+  // independently. The middles of the motions may not have been checked with
+  // the motions, so each segment is checked along with the waypoints before
+  // and after it.
+  const Eigen::Index numSegments
+      = static_cast<Eigen::Index>(mOption.mNumSmoothingSegments);
+  std::vector<Eigen::Index> corners;
+  mCandidateWaypoints.clear();
+  for (Eigen::Index k = 1; k + 1 < numWaypoints; ++k)
+  {
+    const Eigen::VectorXd start = 0.5 * (path.col(k - 1) + path.col(k));
+    const Eigen::VectorXd end = 0.5 * (path.col(k) + path.col(k + 1));
+    const double cornerLength
+        = (path.col(k) - start).norm() + (end - path.col(k)).norm();
+    if (cornerLength - (end - start).norm() < mOption.mMinImprovement)
+      continue;
+
+    Eigen::MatrixXd segment(path.rows(), numSegments + 3);
+    segment.col(0) = path.col(k - 1);
+    for (Eigen::Index i = 0; i <= numSegments; ++i)
+    {
+      const double t = static_cast<double>(i) / numSegments;
+      segment.col(i + 1) = (1.0 - t) * (1.0 - t) * start
+                           + 2.0 * (1.0 - t) * t * path.col(k) + t * t * end;
+    }
+    segment.col(numSegments + 2) = path.col(k + 1);
+
+    corners.push_back(k);
+    mCandidateWaypoints.push_back(segment);
+  }
+
+  if (corners.empty())
+    return 0u;
+
+  mValidator->validatePaths(mCandidateWaypoints, mValid);
+
+  const std::size_t numSmoothed = static_cast<std::size_t>(
+      std::count(mValid.begin(), mValid.end(), static_cast<char>(1)));
+  if (numSmoothed == 0u)
+    return 0u;
+
+  Eigen::MatrixXd smoothed(
+      path.rows(),
+      numWaypoints + static_cast<Eigen::Index>(numSmoothed) * numSegments);
+  Eigen::Index numColumns = 0;
+  smoothed.col(numColumns++) = path.col(0);
+
+  std::size_t next = 0u;
+  bool previousSmoothed = false;
+  for (Eigen::Index k = 1; k + 1 < numWaypoints; ++k)
+  {
+    const bool isCorner = next < corners.size() && corners[next] == k;
+    if (!isCorner || !mValid[next])
+    {
+      smoothed.col(numColumns++) = path.col(k);
+      previousSmoothed = false;
+      next += isCorner ? 1u : 0u;
+      continue;
+    }
+
+    // The segment of the previous corner already ends in the middle of the
+    // motion where this one starts
+    const Eigen::MatrixXd& segment = mCandidateWaypoints[next];
+    const Eigen::Index first = previousSmoothed ? 2 : 1;
+    for (Eigen::Index i = first; i + 1 < segment.cols(); ++i)
+      smoothed.col(numColumns++) = segment.col(i);
+
+    previousSmoothed = true;
+    ++next;
+  }
+
+  smoothed.col(numColumns++) = path.col(numWaypoints - 1);
+  path = smoothed.leftCols(numColumns);
+
+  return numSmoothed;
+}
+
+//==============================================================================
+std::size_t PathShortcutter::smooth(std::list<Eigen::VectorXd>& path)
+{
+  Eigen::MatrixXd matrix = toMatrix(path);
+  const std::size_t numSmoothed = smooth(matrix);
+  toList(matrix, path);
+
+  return numSmoothed;
+}
+
+//==============================================================================
+double PathShortcutter::computeLength(const Eigen::MatrixXd& path)
+{
+  double length = 0.0;
+  for (Eigen::Index i = 1; i < path.cols(); ++i)
+    length += (path.col(i) - path.col(i - 1)).norm();
+
+  return length;
+}
+
+//==============================================================================
+bool PathShortcutter::drawCandidate(
+    const Eigen::MatrixXd& path,
+    Candidate& candidate,
+    Eigen::MatrixXd& waypoints)
+{
+  const Eigen::Index numWaypoints = path.cols();
+  std::uniform_int_distribution<Eigen::Index> indexDistribution(
+      0, numWaypoints - 1);
+
+  // Draw two waypoints with at least one waypoint between them
+  Eigen::Index start;
+  Eigen::Index end;
+  do
+  {
+    start = indexDistribution(mRandomEngine);
+    end = indexDistribution(mRandomEngine);
+    if (start > end)
+      std::swap(start, end);
+  } while (end - start < 2);
+
+  candidate.mStart = start;
+  candidate.mEnd = end;
+  candidate.mDof = -1;
+
+  const double length = mArcLengths[end] - mArcLengths[start];
+  std::uniform_real_distribution<double> unitDistribution(0.0, 1.0);
+  if (unitDistribution(mRandomEngine) < mOption.mPartialShortcutProbability)
+  {
+    std::uniform_int_distribution<int> dofDistribution(
+        0, static_cast<int>(path.rows()) - 1);
+    candidate.mDof = dofDistribution(mRandomEngine);
+  }
+
+  if (candidate.mDof < 0)
+  {
+    waypoints.resize(path.rows(), 2);
+    waypoints.col(0) = path.col(start);
+    waypoints.col(1) = path.col(end);
+    candidate.mImprovement
+        = length - (path.col(end) - path.col(start)).norm();
+
+    return candidate.mImprovement > mOption.mMinImprovement;
+  }
+
+  if (length <= 0.0)
+    return false;
+
+  // Interpolate the DOF linearly in the arc length of the path, and keep the
+  // other DOFs of the waypoints
+  const Eigen::Index dof = candidate.mDof;
+  const double from = path(dof, start);
+  const double to = path(dof, end);
+  waypoints = path.middleCols(start, end - start + 1);
+  for (Eigen::Index i = 1; i < waypoints.cols() - 1; ++i)
+  {
+    const double s = (mArcLengths[start + i] - mArcLengths[start]) / length;
+    waypoints(dof, i) = from + s * (to - from);
+  }
+  candidate.mImprovement = length - computeLength(waypoints);
+
+  return candidate.mImprovement > mOption.mMinImprovement;
+}
+
+//==============================================================================
+void PathShortcutter::applyCandidates(
+    Eigen::MatrixXd& path, const std::vector<std::size_t>& applied) const
+{
+  if (applied.empty())
+    return;
+
+  std::vector<std::size_t> sorted = applied;
+  std::sort(sorted.begin(), sorted.end(), [&](std::size_t a, std::size_t b) {
+    return mCandidates[a].mStart < mCandidates[b].mStart;
+  });
+
+  Eigen::Index numColumns = path.cols();
+  for (const std::size_t index : sorted)
+  {
+    const Candidate& candidate = mCandidates[index];
+    numColumns += mCandidateWaypoints[index].cols()
+                  - (candidate.mEnd - candidate.mStart + 1);
+  }
+
+  // The waypoints of a candidate start and end with the waypoints of the
+  // path that it connects, so the last one is copied with the rest of the
+  // path
+  Eigen::MatrixXd result(path.rows(), numColumns);
+  Eigen::Index position = 0;
+  Eigen::Index column = 0;
+  for (const std::size_t index : sorted)
+  {
+    const Candidate& candidate = mCandidates[index];
+    const Eigen::MatrixXd& waypoints = mCandidateWaypoints[index];
+
+    const Eigen::Index numKept = candidate.mStart - position;
+    result.middleCols(column, numKept) = path.middleCols(position, numKept);
+    column += numKept;
+
+    result.middleCols(column, waypoints.cols() - 1)
+        = waypoints.leftCols(waypoints.cols() - 1);
+    column += waypoints.cols() - 1;
+    position = candidate.mEnd;
+  }
+
+  const Eigen::Index numKept = path.cols() - position;
+  result.middleCols(column, numKept) = path.middleCols(position, numKept);
+  assert(column + numKept == numColumns);
+
+  path = result;
+}
+
+//==============================================================================
+Eigen::MatrixXd PathShortcutter::toMatrix(
+    const std::list<Eigen::VectorXd>& path)
+{
+  if (path.empty())
+    return Eigen::MatrixXd();
+
+  Eigen::MatrixXd matrix(path.front().size(), path.size());
+  Eigen::Index column = 0;
+  for (const auto& waypoint : path)
+    matrix.col(column++) = waypoint;
+
+  return matrix;
+}
+
+//==============================================================================
+void PathShortcutter::toList(
+    const Eigen::MatrixXd& matrix, std::list<Eigen::VectorXd>& path)
+{
+  path.clear();
+  for (Eigen::Index i = 0; i < matrix.cols(); ++i)
+    path.push_back(matrix.col(i));
+}
+
+} // namespace planning
+} // namespace dart
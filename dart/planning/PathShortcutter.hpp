@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_PLANNING_PATHSHORTCUTTER_HPP_
+#define DART_PLANNING_PATHSHORTCUTTER_HPP_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dart/planning/MotionValidator.hpp"
+
+namespace dart {
+namespace planning {
+
+/// PathShortcutter shortens and smooths collision-free paths in parallel.
+///
+/// A path is stored contiguously, with one waypoint per column of a matrix.
+/// In every round of shortcut(), a batch of random candidate shortcuts is
+/// drawn, the candidates are checked in parallel by the MotionValidator, and
+/// the valid ones that shorten the path the most are applied as long as they
+/// don't overlap. A candidate either replaces the waypoints between two
+/// waypoints with a straight motion (a full shortcut), or interpolates a
+/// single DOF linearly between them while keeping the others (a partial
+/// shortcut, Geraerts and Overmars, 2007), which removes the detours of a DOF
+/// that a full shortcut can't remove without colliding.
+///
+/// smooth() rounds the corners of the path: every waypoint is replaced by the
+/// segment of the quadratic B-spline whose control polygon is the path, which
+/// goes from the middle of the previous motion to the middle of the next one,
+/// where the segment is collision-free.
+///
+/// The candidates are drawn from a random engine seeded by the options, and
+/// the batches don't depend on the number of threads of the validator, so
+/// the same options and path always give the same result.
+class PathShortcutter
+{
+public:
+  struct Option
+  {
+    /// Number of the rounds of shortcut()
+    std::size_t mNumRounds;
+
+    /// Number of the candidate shortcuts of each round
+    std::size_t mBatchSize;
+
+    /// Probability that a candidate is a partial shortcut of a single DOF
+    /// instead of a full shortcut
+    double mPartialShortcutProbability;
+
+    /// Smallest decrease of the length of the path for a candidate to be
+    /// checked
+    double mMinImprovement;
+
+    /// Number of the motions of each corner made by smooth()
+    std::size_t mNumSmoothingSegments;
+
+    /// Seed of the random engine
+    unsigned int mSeed;
+
+    /// Constructor
+    Option(
+        std::size_t numRounds = 50u,
+        std::size_t batchSize = 32u,
+        double partialShortcutProbability = 0.0,
+        double minImprovement = 1e-6,
+        std::size_t numSmoothingSegments = 8u,
+        unsigned int seed = 0u);
+  };
+
+  /// Constructor
+  explicit PathShortcutter(
+      std::shared_ptr<MotionValidator> validator,
+      const Option& option = Option());
+
+  /// Get the validator
+  const std::shared_ptr<MotionValidator>& getMotionValidator() const;
+
+  /// Get the options
+  const Option& getOption() const;
+
+  /// Reset the random engine with the given seed
+  void setSeed(unsigned int seed);
+
+  /// Shorten the path, whose waypoints are the columns, and return the number
+  /// of the applied shortcuts. The first and the last waypoints are kept.
+  std::size_t shortcut(Eigen::MatrixXd& path);
+
+  /// Shorten the path, given as a list of waypoints
+  std::size_t shortcut(std::list<Eigen::VectorXd>& path);
+
+  /// Round the corners of the path, whose waypoints are the columns, and
+  /// return the number of the rounded corners
+  std::size_t smooth(Eigen::MatrixXd& path);
+
+  /// Round the corners of the path, given as a list of waypoints
+  std::size_t smooth(std::list<Eigen::VectorXd>& path);
+
+  /// Returns the length of the path, whose waypoints are the columns
+  static double computeLength(const Eigen::MatrixXd& path);
+
+protected:
+  /// A candidate shortcut between the waypoints mStart and mEnd
+  struct Candidate
+  {
+    /// Index of the first waypoint
+    Eigen::Index mStart;
+
+    /// Index of the last waypoint
+    Eigen::Index mEnd;
+
+    /// The DOF of a partial shortcut, or -1 for a full shortcut
+    int mDof;
+
+    /// Decrease of the length of the path
+    double mImprovement;
+  };
+
+  /// Draw a candidate shortcut of the path, and fill its waypoints from the
+  /// first to the last one. Returns false if it doesn't shorten the path.
+  bool drawCandidate(
+      const Eigen::MatrixXd& path,
+      Candidate& candidate,
+      Eigen::MatrixXd& waypoints);
+
+  /// Replace the waypoints of the applied candidates in the path
+  void applyCandidates(
+      Eigen::MatrixXd& path, const std::vector<std::size_t>& applied) const;
+
+  /// Convert a list of waypoints to a matrix
+  static Eigen::MatrixXd toMatrix(const std::list<Eigen::VectorXd>& path);
+
+  /// Convert a matrix to a list of waypoints
+  static void toList(
+      const Eigen::MatrixXd& matrix, std::list<Eigen::VectorXd>& path);
+
+  /// The validator of the candidates
+  std::shared_ptr<MotionValidator> mValidator;
+
+  /// Options
+  Option mOption;
+
+  /// Random engine of the candidates
+  std::mt19937 mRandomEngine;
+
+  /// Length of the path up to each waypoint
+  Eigen::VectorXd mArcLengths;
+
+  /// Candidates of the current round
+  std::vector<Candidate> mCandidates;
+
+  /// Waypoints of the candidates of the current round
+  std::vector<Eigen::MatrixXd> mCandidateWaypoints;
+
+  /// Validity of the candidates of the current round
+  std::vector<char> mValid;
+};
+
+} // namespace planning
+} // namespace dart
+
+#endif // DART_PLANNING_PATHSHORTCUTTER_HPP_
@@ -34,6 +34,7 @@
 
 #include <cstdio>
 #include <ctime>
+#include <utility>
 
 #include "dart/collision/CollisionDetector.hpp"
 #include "dart/dynamics/Skeleton.hpp"
@@ -148,9 +149,19 @@ bool PathShortener::segmentCollisionFree(
   VectorXd midpoint
       = (double)n2 / (double)n * config1 + (double)n1 / (double)n * config2;
   list<VectorXd> intermediatePoints1, intermediatePoints2;
-  // TODO(JS): What kinematic values should be updated here?
-  robot->setPositions(dofs, midpoint);
-  if (!world->checkCollision()
+  bool collision;
+  if (motionValidator)
+  {
+    collision = !motionValidator->isValid(midpoint);
+  }
+  else
+  {
+    // TODO(JS): What kinematic values should be updated here?
+    robot->setPositions(dofs, midpoint);
+    collision = world->checkCollision();
+  }
+
+  if (!collision
       && segmentCollisionFree(intermediatePoints1, config1, midpoint)
       && segmentCollisionFree(intermediatePoints2, midpoint, config2))
   {
@@ -166,5 +177,11 @@ bool PathShortener::segmentCollisionFree(
   }
 }
 
+void PathShortener::setMotionValidator(
+    std::shared_ptr<MotionValidator> validator)
+{
+  motionValidator = std::move(validator);
+}
+
 } // namespace planning
 } // namespace dart
@@ -34,9 +34,11 @@
 #define DART_PLANNING_PATHSHORTENER_HPP_
 
 #include <list>
+#include <memory>
 #include <vector>
 #include <Eigen/Core>
 
+#include "dart/planning/MotionValidator.hpp"
 #include "dart/simulation/World.hpp"
 
 namespace dart {
@@ -58,11 +60,16 @@ public:
       const Eigen::VectorXd& config1,
       const Eigen::VectorXd& config2);
 
+  /// Set the validator that checks the intermediate configurations instead of
+  /// the collision detection of the whole world
+  void setMotionValidator(std::shared_ptr<MotionValidator> validator);
+
 protected:
   simulation::WorldPtr world;
   dynamics::SkeletonPtr robot;
   std::vector<std::size_t> dofs;
   double stepSize;
+  std::shared_ptr<MotionValidator> motionValidator;
   virtual bool localPlanner(
       std::list<Eigen::VectorXd>& waypoints,
       std::list<Eigen::VectorXd>::const_iterator it1,
@@ -46,7 +46,8 @@
 
 #include "dart/planning/RRT.hpp"
 
-#include <flann/flann.hpp>
+#include <algorithm>
+#include <utility>
 
 #include "dart/dynamics/Skeleton.hpp"
 #include "dart/simulation/World.hpp"
@@ -73,11 +74,11 @@ RRT::RRT(
     world(world),
     robot(robot),
     dofs(dofs),
-    index(
-        new flann::Index<flann::L2<double> >(flann::KDTreeSingleIndexParams()))
+    index(dofs.size()),
+    lazyEdgeValidation(false)
 {
   // Reset the random number generator and add the given start configuration to
-  // the flann structure
+  // the tree
   srand(time(nullptr));
   addNode(root, -1);
 }
@@ -95,11 +96,11 @@ RRT::RRT(
     world(world),
     robot(robot),
     dofs(dofs),
-    index(
-        new flann::Index<flann::L2<double> >(flann::KDTreeSingleIndexParams()))
+    index(dofs.size()),
+    lazyEdgeValidation(false)
 {
   // Reset the random number generator and add the given start configurations to
-  // the flann structure
+  // the tree
   srand(time(nullptr));
   for (std::size_t i = 0; i < roots.size(); i++)
   {
@@ -128,7 +129,7 @@ bool RRT::connect(const VectorXd& target)
   while (result == STEP_PROGRESS)
   {
     result = tryStepFromNode(target, NNidx);
-    NNidx = configVector.size() - 1;
+    NNidx = index.getSize() - 1;
   }
   return (result == STEP_REACHED);
 }
@@ -155,7 +156,7 @@ RRT::StepResult RRT::tryStepFromNode(const VectorXd& qtry, int NNidx)
 {
 
   // Get the configuration of the nearest neighbor and check if already reached
-  const VectorXd& qnear = *(configVector[NNidx]);
+  const VectorXd qnear = getConfig(NNidx);
   if ((qtry - qnear).norm() < stepSize)
   {
     return STEP_REACHED;
@@ -186,10 +187,16 @@ RRT::StepResult RRT::tryStepFromNode(const VectorXd& qtry, int NNidx)
 bool RRT::newConfig(
     list<VectorXd>& /*intermediatePoints*/,
     VectorXd& qnew,
-    const VectorXd& /*qnear*/,
+    const VectorXd& qnear,
     const VectorXd& /*qtarget*/)
 {
-  return !checkCollisions(qnew);
+  if (checkCollisions(qnew))
+    return false;
+
+  if (motionValidator && !lazyEdgeValidation)
+    return motionValidator->isValid(qnear, qnew);
+
+  return true;
 }
 
 /* *********************************************************************************************
@@ -197,19 +204,10 @@ bool RRT::newConfig(
 int RRT::addNode(const VectorXd& qnew, int parentId)
 {
 
-  // Update the graph vector
-  VectorXd* temp = new VectorXd(qnew);
-  configVector.push_back(temp);
+  // Update the graph vector and the kdtree
+  const int id = static_cast<int>(index.addPoint(qnew));
   parentVector.push_back(parentId);
-
-  // Update the underlying flann structure (the kdtree)
-  unsigned int id = configVector.size() - 1;
-  if (id == 0)
-    index->buildIndex(
-        flann::Matrix<double>((double*)temp->data(), 1, temp->size()));
-  else
-    index->addPoints(
-        flann::Matrix<double>((double*)temp->data(), 1, temp->size()));
+  validatedEdges.push_back(parentId < 0 || !lazyEdgeValidation);
 
   activeNode = id;
   return id;
@@ -219,18 +217,7 @@ int RRT::addNode(const VectorXd& qnew, int parentId)
  */
 inline int RRT::getNearestNeighbor(const VectorXd& qsamp)
 {
-  int nearest;
-  double distance;
-  const flann::Matrix<double> queryMatrix(
-      (double*)qsamp.data(), 1, qsamp.size());
-  flann::Matrix<int> nearestMatrix(&nearest, 1, 1);
-  flann::Matrix<double> distanceMatrix(flann::Matrix<double>(&distance, 1, 1));
-  index->knnSearch(
-      queryMatrix,
-      nearestMatrix,
-      distanceMatrix,
-      1,
-      flann::SearchParams(flann::FLANN_CHECKS_UNLIMITED));
+  const int nearest = index.getNearest(qsamp);
   activeNode = nearest;
   return nearest;
 }
@@ -268,7 +255,7 @@ VectorXd RRT::getRandomConfig()
  */
 double RRT::getGap(const VectorXd& target)
 {
-  return (target - *(configVector[activeNode])).norm();
+  return (target - getConfig(activeNode)).norm();
 }
 
 /* *********************************************************************************************
@@ -281,9 +268,9 @@ void RRT::tracePath(int node, std::list<VectorXd>& path, bool reverse)
   while (x != -1)
   {
     if (!reverse)
-      path.push_front(*(configVector[x]));
+      path.push_front(getConfig(x));
     else
-      path.push_back(*(configVector[x]));
+      path.push_back(getConfig(x));
     x = parentVector[x];
   }
 }
@@ -292,15 +279,110 @@ void RRT::tracePath(int node, std::list<VectorXd>& path, bool reverse)
  */
 bool RRT::checkCollisions(const VectorXd& c)
 {
+  if (motionValidator)
+    return !motionValidator->isValid(c);
+
   robot->setPositions(dofs, c);
   return world->checkCollision();
 }
 
+/* *********************************************************************************************
+ */
+void RRT::setMotionValidator(
+    std::shared_ptr<MotionValidator> validator, bool lazy)
+{
+  motionValidator = std::move(validator);
+  lazyEdgeValidation = motionValidator && lazy;
+}
+
+/* *********************************************************************************************
+ */
+const std::shared_ptr<MotionValidator>& RRT::getMotionValidator() const
+{
+  return motionValidator;
+}
+
+/* *********************************************************************************************
+ */
+bool RRT::isLazyEdgeValidationEnabled() const
+{
+  return lazyEdgeValidation;
+}
+
+/* *********************************************************************************************
+ */
+bool RRT::validateBranch(int node)
+{
+  if (!motionValidator)
+    return true;
+
+  // Collect the nodes whose motions from their parents are not validated yet,
+  // from the root down
+  vector<int> branch;
+  for (int x = node; parentVector[x] != -1; x = parentVector[x])
+  {
+    if (!validatedEdges[x])
+      branch.push_back(x);
+  }
+  std::reverse(branch.begin(), branch.end());
+
+  if (branch.empty())
+    return true;
+
+  vector<MotionValidator::Motion> motions;
+  motions.reserve(branch.size());
+  for (const int x : branch)
+    motions.emplace_back(getConfig(parentVector[x]), getConfig(x));
+
+  // The motions before the first invalid one are all checked
+  const int invalid = motionValidator->findFirstInvalid(motions);
+  const std::size_t numValid
+      = (invalid < 0) ? branch.size() : static_cast<std::size_t>(invalid);
+  for (std::size_t i = 0; i < numValid; ++i)
+    validatedEdges[branch[i]] = true;
+
+  if (invalid < 0)
+    return true;
+
+  removeSubtree(branch[invalid]);
+  return false;
+}
+
+/* *********************************************************************************************
+ */
+void RRT::removeSubtree(int node)
+{
+  // The parents of the nodes can change (e.g., when RRT* rewires the tree), so
+  // the children are collected from the parent vector
+  vector<vector<int>> children(parentVector.size());
+  for (std::size_t i = 0; i < parentVector.size(); ++i)
+  {
+    if (parentVector[i] >= 0)
+      children[parentVector[i]].push_back(static_cast<int>(i));
+  }
+
+  vector<int> stack(1, node);
+  while (!stack.empty())
+  {
+    const int x = stack.back();
+    stack.pop_back();
+    index.removePoint(x);
+    stack.insert(stack.end(), children[x].begin(), children[x].end());
+  }
+}
+
 /* *********************************************************************************************
  */
 std::size_t RRT::getSize()
 {
-  return configVector.size();
+  return index.getSize();
+}
+
+/* *********************************************************************************************
+ */
+Eigen::Map<const VectorXd> RRT::getConfig(int node) const
+{
+  return index.getPoint(node);
 }
 
 } // namespace planning
@@ -48,19 +48,15 @@
 #define DART_PLANNING_RRT_HPP_
 
 #include <list>
+#include <memory>
 #include <vector>
 #include <Eigen/Core>
 
 #include "dart/dynamics/SmartPointer.hpp"
+#include "dart/planning/KdTree.hpp"
+#include "dart/planning/MotionValidator.hpp"
 #include "dart/simulation/World.hpp"
 
-namespace flann {
-template <class A>
-class L2;
-template <class A>
-class Index;
-} // namespace flann
-
 namespace dart {
 
 namespace simulation {
@@ -96,14 +92,9 @@ public:
   const double stepSize; ///< Step size at each node creation
 
   int activeNode; ///< Last added node or the nearest node found after a search
-  std::vector<int> parentVector; ///< The ith node in configVector has parent
+  std::vector<int> parentVector; ///< The ith node in the tree has parent
                                  ///< with index pV[i]
 
-  /// All visited configs
-  // NOTE We are using pointers for the VectorXd's because flann copies the
-  // pointers for the data points and we give it the copies made in the heap
-  std::vector<const Eigen::VectorXd*> configVector;
-
 public:
   //// Constructor with a single root
   RRT(dart::simulation::WorldPtr world,
@@ -167,9 +158,38 @@ public:
   /// Returns the number of nodes in the tree.
   std::size_t getSize();
 
+  /// Returns the configuration of the given node. The map points into the
+  /// storage of the tree, so it is invalidated when a node is added.
+  Eigen::Map<const Eigen::VectorXd> getConfig(int node) const;
+
   /// Implementation-specific function for checking collisions
   virtual bool checkCollisions(const Eigen::VectorXd& c);
 
+  /// Set the validator of the configurations and the motions. If it is set,
+  /// checkCollisions() uses it instead of the collision detection of the whole
+  /// world, and newConfig() also validates the motion from the nearest node to
+  /// the new one. If lazy is true, the motions are not validated when the
+  /// nodes are added, but only when validateBranch() is called for a path
+  /// that is going to be returned.
+  void setMotionValidator(
+      std::shared_ptr<MotionValidator> validator, bool lazy = false);
+
+  /// Returns the validator of the configurations and the motions, if any
+  const std::shared_ptr<MotionValidator>& getMotionValidator() const;
+
+  /// Returns true if the motions are validated lazily
+  bool isLazyEdgeValidationEnabled() const;
+
+  /// Validates the motions on the branch from the root to the given node that
+  /// haven't been validated yet, in parallel. If one of them is invalid, the
+  /// subtree below it is removed from the tree and false is returned.
+  bool validateBranch(int node);
+
+  /// Removes the given node and its descendants from the nearest neighbor
+  /// searches, so that the tree doesn't grow from them any more. The nodes
+  /// keep their indices and are still counted by getSize().
+  void removeSubtree(int node);
+
   /// Returns a random configuration with the specified node IDs
   virtual Eigen::VectorXd getRandomConfig();
 
@@ -180,8 +200,18 @@ protected:
   std::vector<std::size_t>
       dofs; ///< The dofs of the robot the planner can manipulate
 
-  /// The underlying flann data structure for fast nearest neighbor searches
-  flann::Index<flann::L2<double> >* index;
+  /// The k-d tree for fast nearest neighbor searches, which also stores the
+  /// configurations of the nodes
+  KdTree index;
+
+  /// The validator of the configurations and the motions, if any
+  std::shared_ptr<MotionValidator> motionValidator;
+
+  /// Whether the motions are validated lazily
+  bool lazyEdgeValidation;
+
+  /// Whether the motion from the parent of the ith node to it is validated
+  std::vector<char> validatedEdges;
 
   /// Returns a random value between the given minimum and maximum value
   double randomInRange(double min, double max);
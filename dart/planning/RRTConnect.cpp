@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/planning/RRTConnect.hpp"
+
+#include <utility>
+
+#include "dart/common/Console.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+
+namespace dart {
+namespace planning {
+
+//==============================================================================
+RRTConnect::RRTConnect(
+    simulation::WorldPtr world,
+    dynamics::SkeletonPtr robot,
+    const std::vector<std::size_t>& dofs,
+    double stepSize)
+  : mWorld(std::move(world)),
+    mRobot(std::move(robot)),
+    mDofs(dofs),
+    mStepSize(stepSize),
+    mLazyEdgeValidation(false)
+{
+  // Do nothing
+}
+
+//==============================================================================
+bool RRTConnect::plan(
+    const Eigen::VectorXd& start,
+    const Eigen::VectorXd& goal,
+    std::list<Eigen::VectorXd>& path,
+    std::size_t maxNodes)
+{
+  path.clear();
+
+  const Eigen::VectorXd savedPositions = mRobot->getPositions(mDofs);
+
+  mStartTree = createTree(start);
+  mGoalTree = createTree(goal);
+
+  bool found = false;
+  if (mStartTree->checkCollisions(start))
+  {
+    dtwarn << "[RRTConnect::plan] The start configuration is in collision.\n";
+  }
+  else if (mGoalTree->checkCollisions(goal))
+  {
+    dtwarn << "[RRTConnect::plan] The goal configuration is in collision.\n";
+  }
+  else
+  {
+    RRT* extendTree = mStartTree.get();
+    RRT* connectTree = mGoalTree.get();
+    while (getSize() < maxNodes)
+    {
+      // Extend a tree by a single step towards a random configuration, and
+      // let the other tree connect to the new node
+      const Eigen::VectorXd target = extendTree->getRandomConfig();
+      if (extendTree->tryStep(target) == RRT::STEP_PROGRESS)
+      {
+        const Eigen::VectorXd newConfig
+            = extendTree->getConfig(extendTree->activeNode);
+        if (connectTree->connect(newConfig)
+            && validateConnection(extendTree, connectTree))
+        {
+          found = true;
+          break;
+        }
+      }
+
+      std::swap(extendTree, connectTree);
+    }
+  }
+
+  if (found)
+  {
+    mStartTree->tracePath(mStartTree->activeNode, path);
+    mGoalTree->tracePath(mGoalTree->activeNode, path, true);
+  }
+
+  mRobot->setPositions(mDofs, savedPositions);
+
+  return found;
+}
+
+//==============================================================================
+void RRTConnect::setMotionValidator(
+    std::shared_ptr<MotionValidator> validator, bool lazy)
+{
+  mMotionValidator = std::move(validator);
+  mLazyEdgeValidation = mMotionValidator && lazy;
+}
+
+//==============================================================================
+const std::shared_ptr<MotionValidator>& RRTConnect::getMotionValidator() const
+{
+  return mMotionValidator;
+}
+
+//==============================================================================
+std::size_t RRTConnect::getSize() const
+{
+  std::size_t size = 0u;
+  if (mStartTree)
+    size += mStartTree->getSize();
+  if (mGoalTree)
+    size += mGoalTree->getSize();
+
+  return size;
+}
+
+//==============================================================================
+RRT* RRTConnect::getStartTree()
+{
+  return mStartTree.get();
+}
+
+//==============================================================================
+RRT* RRTConnect::getGoalTree()
+{
+  return mGoalTree.get();
+}
+
+//==============================================================================
+std::unique_ptr<RRT> RRTConnect::createTree(const Eigen::VectorXd& root)
+{
+  std::unique_ptr<RRT> tree(new RRT(mWorld, mRobot, mDofs, root, mStepSize));
+  tree->setMotionValidator(mMotionValidator, mLazyEdgeValidation);
+
+  return tree;
+}
+
+//==============================================================================
+bool RRTConnect::validateConnection(RRT* extendTree, RRT* connectTree)
+{
+  if (!mMotionValidator)
+    return true;
+
+  // The connecting tree stops within the step size of the node, so the
+  // motion between them is not validated by the trees
+  const Eigen::VectorXd from = connectTree->getConfig(connectTree->activeNode);
+  const Eigen::VectorXd to = extendTree->getConfig(extendTree->activeNode);
+  if (!mMotionValidator->isValid(from, to))
+    return false;
+
+  if (!mLazyEdgeValidation)
+    return true;
+
+  // Both branches are validated even if the first one is invalid, so that the
+  // invalid subtrees of both trees are removed
+  const bool extendBranchValid
+      = extendTree->validateBranch(extendTree->activeNode);
+  const bool connectBranchValid
+      = connectTree->validateBranch(connectTree->activeNode);
+
+  return extendBranchValid && connectBranchValid;
+}
+
+} // namespace planning
+} // namespace dart
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_PLANNING_RRTCONNECT_HPP_
+#define DART_PLANNING_RRTCONNECT_HPP_
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dart/planning/RRT.hpp"
+
+namespace dart {
+namespace planning {
+
+/// RRTConnect is the bidirectional planner of Kuffner and LaValle (2000). A
+/// tree is grown from the start and another one from the goal. In every
+/// iteration, one tree takes a single step towards a random configuration,
+/// and the other tree tries to connect to the new node by stepping towards it
+/// until it reaches it or collides. Then the trees swap their roles.
+///
+/// The trees are RRT instances, so collision checking and sampling can be
+/// customized by overriding createTree() to return a subclass of RRT.
+///
+/// If a motion validator is set, the trees use it, and the motion where the
+/// trees meet is validated too. With lazy edge validation, the motions are
+/// only validated when the trees meet, for the branches of the path; if one
+/// of them is invalid, the subtree below it is removed and the planning goes
+/// on.
+class RRTConnect
+{
+public:
+  /// Constructor
+  RRTConnect(
+      simulation::WorldPtr world,
+      dynamics::SkeletonPtr robot,
+      const std::vector<std::size_t>& dofs,
+      double stepSize = 0.02);
+
+  /// Destructor
+  virtual ~RRTConnect() = default;
+
+  /// Plan a path of the DOFs from the start configuration to the goal
+  /// configuration, replacing the contents of path. The consecutive
+  /// configurations of the path are at most the step size apart. Returns
+  /// false if the start or the goal is in collision, or if the trees didn't
+  /// meet before they had maxNodes nodes in total. The positions of the robot
+  /// are restored afterwards.
+  bool plan(
+      const Eigen::VectorXd& start,
+      const Eigen::VectorXd& goal,
+      std::list<Eigen::VectorXd>& path,
+      std::size_t maxNodes = 100000u);
+
+  /// Set the validator of the configurations and the motions of the trees
+  /// that are created by the following plans. See RRT::setMotionValidator().
+  void setMotionValidator(
+      std::shared_ptr<MotionValidator> validator, bool lazy = false);
+
+  /// Get the validator of the configurations and the motions, if any
+  const std::shared_ptr<MotionValidator>& getMotionValidator() const;
+
+  /// Get the total number of the nodes in the trees of the last plan
+  std::size_t getSize() const;
+
+  /// Get the tree grown from the start in the last plan
+  RRT* getStartTree();
+
+  /// Get the tree grown from the goal in the last plan
+  RRT* getGoalTree();
+
+protected:
+  /// Create a tree rooted at the given configuration
+  virtual std::unique_ptr<RRT> createTree(const Eigen::VectorXd& root);
+
+  /// Returns true if the path through the last nodes of the trees is valid,
+  /// after the connecting tree has reached the last node of the extending
+  /// tree. This validates the motion between the two nodes, and the branches
+  /// of both trees with lazy edge validation.
+  bool validateConnection(RRT* extendTree, RRT* connectTree);
+
+  /// The world that the robot is in
+  simulation::WorldPtr mWorld;
+
+  /// The robot for which a plan is generated
+  dynamics::SkeletonPtr mRobot;
+
+  /// The DOFs of the robot the planner can manipulate
+  std::vector<std::size_t> mDofs;
+
+  /// Step size at each node creation
+  double mStepSize;
+
+  /// The validator of the configurations and the motions, if any
+  std::shared_ptr<MotionValidator> mMotionValidator;
+
+  /// Whether the motions are validated lazily
+  bool mLazyEdgeValidation;
+
+  /// The tree grown from the start
+  std::unique_ptr<RRT> mStartTree;
+
+  /// The tree grown from the goal
+  std::unique_ptr<RRT> mGoalTree;
+};
+
+} // namespace planning
+} // namespace dart
+
+#endif // DART_PLANNING_RRTCONNECT_HPP_
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/planning/RRTStar.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+#include "dart/dynamics/Skeleton.hpp"
+
+namespace dart {
+namespace planning {
+
+//==============================================================================
+RRTStar::RRTStar(
+    simulation::WorldPtr world,
+    dynamics::SkeletonPtr robot,
+    const std::vector<std::size_t>& dofs,
+    const Eigen::VectorXd& root,
+    double stepSize)
+  : RRT(std::move(world), std::move(robot), dofs, root, stepSize),
+    mCosts(getSize(), 0.0),
+    mChildren(getSize()),
+    mRewireFactor(1.0)
+{
+  // The roots were added by the constructor of RRT, which doesn't dispatch to
+  // our addNode(), so their costs and children are initialized here.
+}
+
+//==============================================================================
+RRTStar::RRTStar(
+    simulation::WorldPtr world,
+    dynamics::SkeletonPtr robot,
+    const std::vector<std::size_t>& dofs,
+    const std::vector<Eigen::VectorXd>& roots,
+    double stepSize)
+  : RRT(std::move(world), std::move(robot), dofs, roots, stepSize),
+    mCosts(getSize(), 0.0),
+    mChildren(getSize()),
+    mRewireFactor(1.0)
+{
+  // Do nothing
+}
+
+//==============================================================================
+RRT::StepResult RRTStar::tryStepFromNode(const Eigen::VectorXd& qtry, int NNidx)
+{
+  // Steer from the nearest node
+  const Eigen::VectorXd qnear = getConfig(NNidx);
+  const double gap = (qtry - qnear).norm();
+  if (gap == 0.0)
+    return STEP_REACHED;
+
+  Eigen::VectorXd qnew
+      = (gap < stepSize) ? qtry : qnear + (stepSize / gap) * (qtry - qnear);
+
+  std::list<Eigen::VectorXd> intermediatePoints;
+  if (!newConfig(intermediatePoints, qnew, qnear, qtry))
+    return STEP_COLLISION;
+
+  int parent = NNidx;
+  for (const Eigen::VectorXd& point : intermediatePoints)
+    parent = addNode(point, parent);
+
+  // Choose the neighbor that gives the lowest cost as the parent. The
+  // candidates are sorted so that the motions are only checked until the
+  // first collision-free one.
+  index.getNearestK(qnew, getNumNeighbors(), mNeighbors);
+
+  double bestCost = mCosts[parent] + (qnew - getConfig(parent)).norm();
+  mCandidates.clear();
+  for (const std::size_t neighbor : mNeighbors)
+  {
+    const int node = static_cast<int>(neighbor);
+    const double cost = mCosts[node] + (qnew - getConfig(node)).norm();
+    if (node != parent && cost < bestCost)
+      mCandidates.emplace_back(cost, node);
+  }
+  std::sort(mCandidates.begin(), mCandidates.end());
+
+  bool checked = false;
+  for (const auto& candidate : mCandidates)
+  {
+    if (checkMotion(getConfig(candidate.second), qnew))
+    {
+      bestCost = candidate.first;
+      parent = candidate.second;
+      checked = true;
+      break;
+    }
+  }
+
+  // With lazy edge validation, only the motion from the nearest node is left
+  // to validateBranch(), since the one from the chosen parent is checked
+  const int newNode = addNode(qnew, parent);
+  if (checked)
+    validatedEdges[newNode] = true;
+
+  // Rewire the neighbors through the new node where that lowers their costs.
+  // Since the costs strictly decrease, this can't create a cycle.
+  for (const std::size_t neighbor : mNeighbors)
+  {
+    const int node = static_cast<int>(neighbor);
+    if (node == parent || parentVector[node] < 0)
+      continue;
+
+    const double cost = bestCost + (getConfig(node) - qnew).norm();
+    if (cost < mCosts[node] && checkMotion(qnew, getConfig(node)))
+      changeParent(node, newNode, cost);
+  }
+
+  activeNode = newNode;
+  return STEP_PROGRESS;
+}
+
+//==============================================================================
+bool RRTStar::plan(
+    const Eigen::VectorXd& goal,
+    std::list<Eigen::VectorXd>& path,
+    std::size_t numIterations,
+    double goalBias)
+{
+  path.clear();
+
+  const Eigen::VectorXd savedPositions = robot->getPositions(dofs);
+
+  for (std::size_t i = 0u; i < numIterations; ++i)
+  {
+    const double randomValue = static_cast<double>(rand()) / RAND_MAX;
+    const StepResult result
+        = tryStep((randomValue < goalBias) ? goal : getRandomConfig());
+
+    // With lazy edge validation, a branch is validated as soon as it reaches
+    // the goal, so that the tree can grow again if it is invalid
+    if (lazyEdgeValidation && result == STEP_PROGRESS
+        && (getConfig(activeNode) - goal).norm() <= stepSize)
+    {
+      validateBranch(activeNode);
+    }
+  }
+
+  // Connect the goal to the node within the step size that gives the lowest
+  // cost. With lazy edge validation, the branches of the candidates are
+  // validated in the order of their costs until a valid one is found.
+  index.getWithinRadius(goal, stepSize, mNeighbors);
+
+  mCandidates.clear();
+  for (const std::size_t neighbor : mNeighbors)
+  {
+    const int node = static_cast<int>(neighbor);
+    mCandidates.emplace_back(
+        mCosts[node] + (goal - getConfig(node)).norm(), node);
+  }
+  std::sort(mCandidates.begin(), mCandidates.end());
+
+  int best = -1;
+  for (const auto& candidate : mCandidates)
+  {
+    const int node = candidate.second;
+    if (index.isRemoved(node) || !checkMotion(getConfig(node), goal))
+      continue;
+
+    if (!lazyEdgeValidation || validateBranch(node))
+    {
+      best = node;
+      break;
+    }
+  }
+
+  robot->setPositions(dofs, savedPositions);
+
+  if (best < 0)
+    return false;
+
+  tracePath(best, path);
+  if (path.back() != goal)
+    path.push_back(goal);
+
+  return true;
+}
+
+//==============================================================================
+double RRTStar::getCost(int node) const
+{
+  return mCosts[node];
+}
+
+//==============================================================================
+void RRTStar::setRewireFactor(double factor)
+{
+  mRewireFactor = factor;
+}
+
+//==============================================================================
+double RRTStar::getRewireFactor() const
+{
+  return mRewireFactor;
+}
+
+//==============================================================================
+std::size_t RRTStar::getNumNeighbors() const
+{
+  const std::size_t size = index.getSize();
+  if (size < 2u)
+    return size;
+
+  const double dimension = static_cast<double>(ndim);
+  const double k = mRewireFactor * std::exp(1.0) * (1.0 + 1.0 / dimension)
+                   * std::log(static_cast<double>(size));
+
+  return std::min(size, static_cast<std::size_t>(std::ceil(k)));
+}
+
+//==============================================================================
+bool RRTStar::checkMotion(
+    const Eigen::VectorXd& from, const Eigen::VectorXd& to)
+{
+  if (motionValidator)
+    return motionValidator->isValid(from, to);
+
+  const double length = (to - from).norm();
+  const int numSegments = static_cast<int>(std::ceil(length / stepSize));
+
+  for (int i = 1; i < numSegments; ++i)
+  {
+    const double t = static_cast<double>(i) / numSegments;
+    if (checkCollisions(from + t * (to - from)))
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+int RRTStar::addNode(const Eigen::VectorXd& qnew, int parentId)
+{
+  const double cost
+      = (parentId < 0)
+            ? 0.0
+            : mCosts[parentId] + (qnew - getConfig(parentId)).norm();
+
+  const int id = RRT::addNode(qnew, parentId);
+  mCosts.push_back(cost);
+  mChildren.emplace_back();
+  if (parentId >= 0)
+    mChildren[parentId].push_back(id);
+
+  return id;
+}
+
+//==============================================================================
+void RRTStar::changeParent(int node, int newParent, double newCost)
+{
+  std::vector<int>& siblings = mChildren[parentVector[node]];
+  const auto it = std::find(siblings.begin(), siblings.end(), node);
+  *it = siblings.back();
+  siblings.pop_back();
+
+  parentVector[node] = newParent;
+  validatedEdges[node] = true;
+  mChildren[newParent].push_back(node);
+
+  // Shift the costs of the subtree
+  const double delta = newCost - mCosts[node];
+  mUpdateStack.clear();
+  mUpdateStack.push_back(node);
+  while (!mUpdateStack.empty())
+  {
+    const int current = mUpdateStack.back();
+    mUpdateStack.pop_back();
+    mCosts[current] += delta;
+    mUpdateStack.insert(
+        mUpdateStack.end(),
+        mChildren[current].begin(),
+        mChildren[current].end());
+  }
+}
+
+} // namespace planning
+} // namespace dart
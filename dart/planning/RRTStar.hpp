@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_PLANNING_RRTSTAR_HPP_
+#define DART_PLANNING_RRTSTAR_HPP_
+
+#include <list>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dart/planning/RRT.hpp"
+
+namespace dart {
+namespace planning {
+
+/// RRTStar is the asymptotically optimal variant of RRT by Karaman and
+/// Frazzoli (2011), which minimizes the length of the path. Every new node is
+/// connected to the neighbor that gives it the lowest cost, and then the
+/// neighbors are rewired through the new node where that lowers their costs.
+///
+/// This is the k-nearest variant, where the neighbors are the
+/// k = rewireFactor * e * (1 + 1/d) * log(n) nearest nodes, which doesn't need
+/// a connection radius tuned to the configuration space.
+///
+/// Since the edges to the neighbors can be longer than the step size, they are
+/// validated by checkMotion(), which checks the configurations along the edge
+/// at the resolution of the step size, or with the motion validator if one is
+/// set. Lazy edge validation only skips the motions from the nearest nodes,
+/// since the rewiring needs the costs of valid edges.
+class RRTStar : public RRT
+{
+public:
+  /// Constructor with a single root
+  RRTStar(
+      simulation::WorldPtr world,
+      dynamics::SkeletonPtr robot,
+      const std::vector<std::size_t>& dofs,
+      const Eigen::VectorXd& root,
+      double stepSize = 0.02);
+
+  /// Constructor with multiple roots
+  RRTStar(
+      simulation::WorldPtr world,
+      dynamics::SkeletonPtr robot,
+      const std::vector<std::size_t>& dofs,
+      const std::vector<Eigen::VectorXd>& roots,
+      double stepSize = 0.02);
+
+  /// Extend the tree from the given node towards the given configuration by
+  /// a single step, choosing the best parent for the new node and rewiring
+  /// its neighbors. Unlike RRT, a configuration within the step size is added
+  /// itself, so that the tree keeps getting denser and the paths keep
+  /// improving. STEP_REACHED is only returned if the node is at the
+  /// configuration.
+  StepResult tryStepFromNode(const Eigen::VectorXd& qtry, int NNidx) override;
+
+  /// Take numIterations steps towards random configurations, or towards the
+  /// goal with the probability goalBias, and then set path to the lowest cost
+  /// path from a root to the goal. Returns false if no node got within the
+  /// step size of the goal with a valid motion to it, or if none of their
+  /// branches is valid with lazy edge validation. The positions of the robot
+  /// are restored afterwards.
+  bool plan(
+      const Eigen::VectorXd& goal,
+      std::list<Eigen::VectorXd>& path,
+      std::size_t numIterations = 10000u,
+      double goalBias = 0.05);
+
+  /// Get the cost of the given node, which is the length of the path from its
+  /// root to it
+  double getCost(int node) const;
+
+  /// Set the factor of the number of the neighbors. Values smaller than one
+  /// trade the asymptotic optimality for speed.
+  void setRewireFactor(double factor);
+
+  /// Get the factor of the number of the neighbors
+  double getRewireFactor() const;
+
+  /// Get the number of the neighbors that are considered for the next node
+  std::size_t getNumNeighbors() const;
+
+  /// Returns true if the straight motion between the two configurations is
+  /// free of collisions. The end configurations are not checked. The motion
+  /// validator is used if one is set.
+  virtual bool checkMotion(
+      const Eigen::VectorXd& from, const Eigen::VectorXd& to);
+
+protected:
+  /// Adds a new node to the tree and records its cost
+  int addNode(const Eigen::VectorXd& qnew, int parentId) override;
+
+  /// Make newParent the parent of the given node, and update the costs of the
+  /// node and its descendants
+  void changeParent(int node, int newParent, double newCost);
+
+  /// Cost of each node
+  std::vector<double> mCosts;
+
+  /// Children of each node
+  std::vector<std::vector<int>> mChildren;
+
+  /// Factor of the number of the neighbors
+  double mRewireFactor;
+
+  /// Cache of the neighbors of a new node
+  std::vector<std::size_t> mNeighbors;
+
+  /// Cache of the neighbors sorted by the cost of the new node through them
+  std::vector<std::pair<double, int>> mCandidates;
+
+  /// Cache of the descendants whose costs are being updated
+  std::vector<int> mUpdateStack;
+};
+
+} // namespace planning
+} // namespace dart
+
+#endif // DART_PLANNING_RRTSTAR_HPP_
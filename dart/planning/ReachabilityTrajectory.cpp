@@ -0,0 +1,606 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/planning/ReachabilityTrajectory.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+#include "dart/dynamics/DegreeOfFreedom.hpp"
+#include "dart/dynamics/Skeleton.hpp"
+
+namespace dart {
+namespace planning {
+
+namespace {
+
+/// Coefficients of u below this magnitude are treated as zero
+constexpr double kControlEpsilon = 1e-12;
+
+/// Tolerance of the round-off errors of the state and control ranges
+constexpr double kRangeTolerance = 1e-9;
+
+/// Distance before a segment boundary at which the previous segment is
+/// evaluated
+constexpr double kBoundaryOffset = 1e-9;
+
+} // namespace
+
+//==============================================================================
+ReachabilityTrajectory::Option::Option(
+    double maxGridStep,
+    dynamics::SkeletonPtr skeleton,
+    const std::vector<std::size_t>& dofs)
+  : mMaxGridStep(maxGridStep), mSkeleton(std::move(skeleton)), mDofs(dofs)
+{
+  // Do nothing
+}
+
+//==============================================================================
+ReachabilityTrajectory::ReachabilityTrajectory(
+    const Path& path,
+    const Eigen::VectorXd& maxVelocity,
+    const Eigen::VectorXd& maxAcceleration,
+    const Option& option)
+  : mPath(path),
+    mMaxVelocity(maxVelocity),
+    mMaxAcceleration(maxAcceleration),
+    mOption(option),
+    mValid(false)
+{
+  assert(mOption.mMaxGridStep > 0.0);
+  assert(mMaxVelocity.size() == mMaxAcceleration.size());
+  assert(
+      !mOption.mSkeleton
+      || mOption.mDofs.size()
+             == static_cast<std::size_t>(mMaxVelocity.size()));
+
+  if (mPath.getLength() <= 0.0)
+    return;
+
+  createGrid();
+  const std::size_t numGridPoints = mGrid.size();
+
+  // The inverse dynamics overwrites the state of the skeleton
+  Eigen::VectorXd positions;
+  Eigen::VectorXd velocities;
+  Eigen::VectorXd accelerations;
+  Eigen::VectorXd forces;
+  const auto& skeleton = mOption.mSkeleton;
+  if (skeleton)
+  {
+    positions = skeleton->getPositions();
+    velocities = skeleton->getVelocities();
+    accelerations = skeleton->getAccelerations();
+    forces = skeleton->getForces();
+  }
+
+  std::vector<Constraints> constraints(numGridPoints);
+  for (std::size_t i = 0u; i < numGridPoints; ++i)
+    computeConstraints(i, constraints[i]);
+
+  if (skeleton)
+  {
+    skeleton->setPositions(positions);
+    skeleton->setVelocities(velocities);
+    skeleton->setAccelerations(accelerations);
+    skeleton->setForces(forces);
+  }
+
+  // Backward pass: the controllable set of the states at each grid point is
+  // the interval of the states from which a control satisfying the
+  // constraints reaches the controllable set of the next grid point. The path
+  // ends at rest.
+  std::vector<double> lowerStates(numGridPoints, 0.0);
+  std::vector<double> upperStates(numGridPoints, 0.0);
+  Constraints step;
+  for (std::size_t i = numGridPoints - 1u; i-- > 0u;)
+  {
+    createStepConstraints(
+        i, constraints, lowerStates[i + 1u], upperStates[i + 1u], step);
+    if (!computeStateRange(step, lowerStates[i], upperStates[i])
+        || !std::isfinite(upperStates[i]))
+    {
+      return;
+    }
+  }
+
+  if (lowerStates[0] > kRangeTolerance)
+    return;
+
+  // Forward pass: from rest, take the largest control that keeps the next
+  // state in its controllable set
+  mStates.assign(numGridPoints, 0.0);
+  mControls.assign(numGridPoints - 1u, 0.0);
+  mTimes.assign(numGridPoints, 0.0);
+  for (std::size_t i = 0u; i + 1u < numGridPoints; ++i)
+  {
+    const double twiceStep = 2.0 * (mGrid[i + 1u] - mGrid[i]);
+    createStepConstraints(
+        i, constraints, lowerStates[i + 1u], upperStates[i + 1u], step);
+
+    // The state is in its controllable set, so the control range is only
+    // empty due to round-off errors, which the clamping absorbs
+    double lowerControl;
+    double upperControl;
+    computeControlRange(step, mStates[i], lowerControl, upperControl);
+    const double control = std::max(lowerControl, upperControl);
+
+    double nextState = mStates[i] + twiceStep * control;
+    nextState = std::min(
+        std::max(nextState, lowerStates[i + 1u]), upperStates[i + 1u]);
+    nextState = std::max(nextState, 0.0);
+    mStates[i + 1u] = nextState;
+    mControls[i] = (nextState - mStates[i]) / twiceStep;
+
+    // The path acceleration is constant between the grid points, so the path
+    // velocity changes linearly
+    const double velocitySum = std::sqrt(mStates[i]) + std::sqrt(nextState);
+    if (velocitySum <= 0.0)
+      return;
+
+    mTimes[i + 1u] = mTimes[i] + twiceStep / velocitySum;
+  }
+
+  mValid = true;
+}
+
+//==============================================================================
+bool ReachabilityTrajectory::isValid() const
+{
+  return mValid;
+}
+
+//==============================================================================
+double ReachabilityTrajectory::getDuration() const
+{
+  return mValid ? mTimes.back() : 0.0;
+}
+
+//==============================================================================
+Eigen::VectorXd ReachabilityTrajectory::getPosition(double time) const
+{
+  // An invalid trajectory stays at the start of the path. A path of zero
+  // length can't be evaluated, so it stays at zero.
+  if (!mValid)
+  {
+    if (mPath.getLength() > 0.0)
+      return mPath.getConfig(0.0);
+
+    return Eigen::VectorXd::Zero(mMaxVelocity.size());
+  }
+
+  const std::size_t i = getGridSegment(time);
+  const double dt = std::max(time - mTimes[i], 0.0);
+  double pathPos = mGrid[i] + std::sqrt(mStates[i]) * dt
+                   + 0.5 * mControls[i] * dt * dt;
+  pathPos = std::min(std::max(pathPos, mGrid[i]), mGrid[i + 1u]);
+
+  return mPath.getConfig(pathPos);
+}
+
+//==============================================================================
+Eigen::VectorXd ReachabilityTrajectory::getVelocity(double time) const
+{
+  if (!mValid)
+    return Eigen::VectorXd::Zero(mMaxVelocity.size());
+
+  const std::size_t i = getGridSegment(time);
+  const double dt = std::max(time - mTimes[i], 0.0);
+  const double pathVel
+      = std::max(std::sqrt(mStates[i]) + mControls[i] * dt, 0.0);
+  double pathPos = mGrid[i] + std::sqrt(mStates[i]) * dt
+                   + 0.5 * mControls[i] * dt * dt;
+  pathPos = std::min(std::max(pathPos, mGrid[i]), mGrid[i + 1u]);
+
+  return mPath.getTangent(pathPos) * pathVel;
+}
+
+//==============================================================================
+std::size_t ReachabilityTrajectory::getNumGridPoints() const
+{
+  return mGrid.size();
+}
+
+//==============================================================================
+void ReachabilityTrajectory::createGrid()
+{
+  const double length = mPath.getLength();
+  const std::size_t numSteps = static_cast<std::size_t>(
+      std::max(std::ceil(length / mOption.mMaxGridStep), 1.0));
+
+  std::vector<std::pair<double, bool>> points;
+  points.reserve(numSteps + 1u);
+  for (std::size_t i = 0u; i <= numSteps; ++i)
+    points.emplace_back(length * i / numSteps, false);
+
+  for (const auto& switchingPoint : mPath.getSwitchingPoints())
+  {
+    if (switchingPoint.second)
+      points.emplace_back(switchingPoint.first, true);
+  }
+
+  // The boundaries come after the uniform points at the same position, so
+  // they replace the points that are too close to them
+  std::sort(points.begin(), points.end());
+
+  mGrid.clear();
+  mSegmentBoundaries.clear();
+  for (const auto& point : points)
+  {
+    if (!mGrid.empty() && point.first - mGrid.back() < kBoundaryOffset)
+    {
+      if (!point.second || mGrid.size() == 1u)
+        continue;
+
+      mGrid.pop_back();
+      mSegmentBoundaries.pop_back();
+    }
+
+    mGrid.push_back(point.first);
+    mSegmentBoundaries.push_back(point.second);
+  }
+
+  // The end of the path is always a grid point
+  if (length - mGrid.back() >= kBoundaryOffset)
+  {
+    mGrid.push_back(length);
+    mSegmentBoundaries.push_back(false);
+  }
+  else
+  {
+    mGrid.back() = length;
+    mSegmentBoundaries.back() = false;
+  }
+}
+
+//==============================================================================
+void ReachabilityTrajectory::computeConstraints(
+    std::size_t index, Constraints& constraints)
+{
+  const Eigen::Index numDofs = mMaxVelocity.size();
+  const Eigen::Index numRowsPerSide = (mOption.mSkeleton ? 5 : 3) * numDofs;
+  constraints.resize(2 * numRowsPerSide + 1, 3);
+  Eigen::Index numRows = 0;
+
+  const double pathPos = mGrid[index];
+  const Eigen::VectorXd tangent = mPath.getTangent(pathPos);
+  appendConstraints(
+      pathPos, tangent, mPath.getCurvature(pathPos), constraints, numRows);
+
+  if (mSegmentBoundaries[index])
+  {
+    const double beforePathPos = pathPos - kBoundaryOffset;
+    const Eigen::VectorXd beforeTangent = mPath.getTangent(beforePathPos);
+    appendConstraints(
+        pathPos,
+        beforeTangent,
+        mPath.getCurvature(beforePathPos),
+        constraints,
+        numRows);
+
+    // The path velocity has to be zero where the tangent jumps
+    if ((tangent - beforeTangent).norm() > 1e-6)
+      constraints.row(numRows++) << 0.0, 1.0, 0.0;
+  }
+
+  constraints.conservativeResize(numRows, 3);
+}
+
+//==============================================================================
+void ReachabilityTrajectory::appendConstraints(
+    double pathPos,
+    const Eigen::VectorXd& tangent,
+    const Eigen::VectorXd& curvature,
+    Constraints& constraints,
+    Eigen::Index& numRows)
+{
+  // The joint velocities are q' s' and the joint accelerations are
+  // q' s'' + q'' s'^2 = q' u + q'' x
+  for (Eigen::Index i = 0; i < tangent.size(); ++i)
+  {
+    if (std::isfinite(mMaxVelocity[i]) && tangent[i] != 0.0)
+    {
+      constraints.row(numRows++) << 0.0, tangent[i] * tangent[i],
+          mMaxVelocity[i] * mMaxVelocity[i];
+    }
+
+    if (std::isfinite(mMaxAcceleration[i]))
+    {
+      constraints.row(numRows++) << tangent[i], curvature[i],
+          mMaxAcceleration[i];
+      constraints.row(numRows++) << -tangent[i], -curvature[i],
+          mMaxAcceleration[i];
+    }
+  }
+
+  const auto& skeleton = mOption.mSkeleton;
+  if (!skeleton)
+    return;
+
+  // The torques are affine in (u, x): tau = a u + b x + c, where c is the
+  // torque at rest, a is the torque of the joint accelerations q' minus c,
+  // and b is the torque of the joint velocities and accelerations q' and q''
+  // minus c
+  const auto& dofs = mOption.mDofs;
+  skeleton->setPositions(dofs, mPath.getConfig(pathPos));
+  skeleton->resetVelocities();
+  skeleton->resetAccelerations();
+  skeleton->computeInverseDynamics();
+  const Eigen::VectorXd restTorques = skeleton->getForces(dofs);
+
+  skeleton->setAccelerations(dofs, tangent);
+  skeleton->computeInverseDynamics();
+  const Eigen::VectorXd controlTorques
+      = skeleton->getForces(dofs) - restTorques;
+
+  skeleton->setVelocities(dofs, tangent);
+  skeleton->setAccelerations(dofs, curvature);
+  skeleton->computeInverseDynamics();
+  const Eigen::VectorXd stateTorques = skeleton->getForces(dofs) - restTorques;
+
+  for (std::size_t i = 0u; i < dofs.size(); ++i)
+  {
+    const auto* dof = skeleton->getDof(dofs[i]);
+    const double upper = dof->getForceUpperLimit();
+    const double lower = dof->getForceLowerLimit();
+    if (std::isfinite(upper))
+    {
+      constraints.row(numRows++) << controlTorques[i], stateTorques[i],
+          upper - restTorques[i];
+    }
+
+    if (std::isfinite(lower))
+    {
+      constraints.row(numRows++) << -controlTorques[i], -stateTorques[i],
+          restTorques[i] - lower;
+    }
+  }
+}
+
+//==============================================================================
+void ReachabilityTrajectory::createStepConstraints(
+    std::size_t index,
+    const std::vector<Constraints>& constraints,
+    double lowerNextState,
+    double upperNextState,
+    Constraints& step) const
+{
+  // The constraints of the next grid point a u + b x' <= c apply to the next
+  // state x' = x + 2 d u too, which is the first-order interpolation scheme
+  // of Pham and Pham. It keeps the limits from being exceeded much between
+  // the grid points where the path bends quickly.
+  const double twiceStep = 2.0 * (mGrid[index + 1u] - mGrid[index]);
+  const Constraints& current = constraints[index];
+  const Constraints& next = constraints[index + 1u];
+  const Eigen::Index numCurrentRows = current.rows();
+  const Eigen::Index numNextRows = next.rows();
+
+  step.resize(numCurrentRows + numNextRows + 2, 3);
+  step.topRows(numCurrentRows) = current;
+  auto nextRows = step.middleRows(numCurrentRows, numNextRows);
+  nextRows = next;
+  nextRows.col(0) += twiceStep * next.col(1);
+
+  const Eigen::Index numRows = numCurrentRows + numNextRows;
+  step.row(numRows) << twiceStep, 1.0, upperNextState;
+  step.row(numRows + 1) << -twiceStep, -1.0, -lowerNextState;
+}
+
+//==============================================================================
+bool ReachabilityTrajectory::computeStateRange(
+    const Constraints& constraints, double& lower, double& upper)
+{
+  lower = 0.0;
+  upper = std::numeric_limits<double>::infinity();
+
+  // Every row with a != 0 bounds u by a line o - s x of the state, from below
+  // if a < 0 and from above if a > 0
+  const Eigen::Index numRows = constraints.rows();
+  Eigen::ArrayX2d lowerLines(numRows, 2);
+  Eigen::ArrayX2d upperLines(numRows, 2);
+  Eigen::Index numLowerLines = 0;
+  Eigen::Index numUpperLines = 0;
+  for (Eigen::Index k = 0; k < numRows; ++k)
+  {
+    const double a = constraints(k, 0);
+    const double b = constraints(k, 1);
+    const double c = constraints(k, 2);
+    if (a > kControlEpsilon)
+    {
+      upperLines.row(numUpperLines++) << c / a, b / a;
+    }
+    else if (a < -kControlEpsilon)
+    {
+      lowerLines.row(numLowerLines++) << c / a, b / a;
+    }
+    else if (b > 0.0)
+    {
+      upper = std::min(upper, c / b);
+    }
+    else if (b < 0.0)
+    {
+      lower = std::max(lower, c / b);
+    }
+    else if (c < -kRangeTolerance)
+    {
+      return false;
+    }
+  }
+
+  const auto checkRange = [&]() {
+    if (lower <= upper)
+      return true;
+
+    if (lower - upper > kRangeTolerance * std::max(1.0, std::abs(upper)))
+      return false;
+
+    lower = upper;
+    return true;
+  };
+
+  if (numLowerLines == 0 || numUpperLines == 0)
+    return checkRange();
+
+  // Some u exists where the gap g(x) = min_j U_j(x) - max_k L_k(x) between
+  // the upper and the lower bounds is nonnegative. The gap is concave and
+  // piecewise linear, and each of its pieces U_j - L_k lies above it, so the
+  // root of the piece that is active at an infeasible state is closer to the
+  // feasible interval. Iterating from both sides finds its ends exactly after
+  // a few pieces, instead of intersecting every pair of bounds.
+  Eigen::Index lowerIndex = 0;
+  Eigen::Index upperIndex = 0;
+  const auto computeGap = [&](double x) {
+    double lowerBound = -std::numeric_limits<double>::infinity();
+    for (Eigen::Index k = 0; k < numLowerLines; ++k)
+    {
+      const double bound = lowerLines(k, 0) - lowerLines(k, 1) * x;
+      if (bound > lowerBound)
+      {
+        lowerBound = bound;
+        lowerIndex = k;
+      }
+    }
+
+    double upperBound = std::numeric_limits<double>::infinity();
+    for (Eigen::Index j = 0; j < numUpperLines; ++j)
+    {
+      const double bound = upperLines(j, 0) - upperLines(j, 1) * x;
+      if (bound < upperBound)
+      {
+        upperBound = bound;
+        upperIndex = j;
+      }
+    }
+
+    const double gap = upperBound - lowerBound;
+    const double scale
+        = std::max({1.0, std::abs(lowerBound), std::abs(upperBound)});
+    return (gap >= -kRangeTolerance * scale) ? 0.0 : gap;
+  };
+
+  // The slope of the piece U_j - L_k is s_k - s_j, and its root is
+  // (o_j - o_k) / (s_j - s_k)
+  const auto computeRoot = [&]() {
+    return (upperLines(upperIndex, 0) - lowerLines(lowerIndex, 0))
+           / (upperLines(upperIndex, 1) - lowerLines(lowerIndex, 1));
+  };
+  const auto computeSlope = [&]() {
+    return lowerLines(lowerIndex, 1) - upperLines(upperIndex, 1);
+  };
+
+  // The largest state: start from the root of the piece that is active as x
+  // goes to infinity, which has the smallest slope, if it is decreasing
+  lowerLines.col(1).head(numLowerLines).minCoeff(&lowerIndex);
+  upperLines.col(1).head(numUpperLines).maxCoeff(&upperIndex);
+  if (computeSlope() < 0.0)
+    upper = std::min(upper, computeRoot());
+
+  // The iterations stop early where the root doesn't move anymore, which
+  // happens when the steep bounds of the DOFs whose tangent is almost zero
+  // leave a gap from round-off errors at the root
+  const Eigen::Index maxNumIterations = numLowerLines * numUpperLines + 1;
+  if (std::isfinite(upper))
+  {
+    for (Eigen::Index i = 0; computeGap(upper) < 0.0; ++i)
+    {
+      if (computeSlope() >= 0.0 || i == maxNumIterations)
+        return false;
+
+      const double root = computeRoot();
+      if (root >= upper)
+        break;
+
+      upper = root;
+      if (upper < lower)
+        return checkRange();
+    }
+  }
+
+  // The smallest state
+  for (Eigen::Index i = 0; computeGap(lower) < 0.0; ++i)
+  {
+    if (computeSlope() <= 0.0 || i == maxNumIterations)
+      return false;
+
+    const double root = computeRoot();
+    if (root <= lower)
+      break;
+
+    lower = root;
+    if (lower > upper)
+      return checkRange();
+  }
+
+  return checkRange();
+}
+
+//==============================================================================
+bool ReachabilityTrajectory::computeControlRange(
+    const Constraints& constraints, double x, double& lower, double& upper)
+{
+  lower = -std::numeric_limits<double>::infinity();
+  upper = std::numeric_limits<double>::infinity();
+
+  bool feasible = true;
+  for (Eigen::Index k = 0; k < constraints.rows(); ++k)
+  {
+    const double a = constraints(k, 0);
+    const double rhs = constraints(k, 2) - constraints(k, 1) * x;
+    if (std::abs(a) <= kControlEpsilon)
+      feasible = feasible && rhs >= -kRangeTolerance;
+    else if (a > 0.0)
+      upper = std::min(upper, rhs / a);
+    else
+      lower = std::max(lower, rhs / a);
+  }
+
+  return feasible && lower <= upper;
+}
+
+//==============================================================================
+std::size_t ReachabilityTrajectory::getGridSegment(double time) const
+{
+  assert(mValid);
+
+  const auto it = std::upper_bound(mTimes.begin(), mTimes.end(), time);
+  const std::size_t index = static_cast<std::size_t>(
+      std::max<std::ptrdiff_t>(std::distance(mTimes.begin(), it) - 1, 0));
+
+  return std::min(index, mTimes.size() - 2u);
+}
+
+} // namespace planning
+} // namespace dart
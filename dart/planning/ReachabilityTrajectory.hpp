@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_PLANNING_REACHABILITYTRAJECTORY_HPP_
+#define DART_PLANNING_REACHABILITYTRAJECTORY_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dart/dynamics/SmartPointer.hpp"
+#include "dart/planning/Path.hpp"
+#include "dart/planning/Trajectory.hpp"
+
+namespace dart {
+namespace planning {
+
+/// ReachabilityTrajectory is the time-optimal trajectory along a Path under
+/// joint velocity and acceleration limits and, optionally, the torque limits
+/// of a skeleton, computed by reachability analysis (Pham and Pham, "A New
+/// Approach to Time-Optimal Path Parameterization Based on Reachability
+/// Analysis", 2018).
+///
+/// The path is discretized into a grid of path positions s_i. The state at
+/// s_i is the squared path velocity x_i, and the control between s_i and
+/// s_{i+1} is the constant path acceleration u_i, so that
+/// x_{i+1} = x_i + 2 (s_{i+1} - s_i) u_i. All the limits are linear
+/// inequalities in (u_i, x_i). A backward pass computes the set of the states
+/// at every grid point from which the end of the path can be reached at rest,
+/// and a forward pass picks the largest control that keeps the next state in
+/// its set. Each step is a linear program in two variables, which is solved
+/// exactly by walking the pieces of the gap between the bounds of u_i.
+///
+/// Unlike PathFollowingTrajectory, which integrates the phase plane with
+/// small time steps and searches the switching points, the cost is linear in
+/// the number of grid points. The limits are only enforced at the grid
+/// points, and the trajectory stops where the tangent of the path is
+/// discontinuous.
+class ReachabilityTrajectory : public Trajectory
+{
+public:
+  struct Option
+  {
+    /// Largest distance between two consecutive grid points. The segment
+    /// boundaries of the path are added to the grid.
+    double mMaxGridStep;
+
+    /// Skeleton whose torque limits are enforced, or nullptr for no torque
+    /// limits. The torques are computed by the inverse dynamics of the
+    /// skeleton, with the DOFs of the path at the configurations of the path
+    /// and the other DOFs at rest where they are.
+    dynamics::SkeletonPtr mSkeleton;
+
+    /// Indices of the DOFs of the skeleton that correspond to the
+    /// coordinates of the path
+    std::vector<std::size_t> mDofs;
+
+    /// Constructor
+    Option(
+        double maxGridStep = 0.01,
+        dynamics::SkeletonPtr skeleton = nullptr,
+        const std::vector<std::size_t>& dofs = std::vector<std::size_t>());
+  };
+
+  /// Constructor. The limits are symmetric, and infinite limits are ignored.
+  ReachabilityTrajectory(
+      const Path& path,
+      const Eigen::VectorXd& maxVelocity,
+      const Eigen::VectorXd& maxAcceleration,
+      const Option& option = Option());
+
+  /// Returns false if the path can't be followed within the limits, in which
+  /// case the trajectory has zero duration and stays at rest at the start of
+  /// the path, or at zero if the path has zero length
+  bool isValid() const;
+
+  // Documentation inherited
+  double getDuration() const override;
+
+  // Documentation inherited
+  Eigen::VectorXd getPosition(double time) const override;
+
+  // Documentation inherited
+  Eigen::VectorXd getVelocity(double time) const override;
+
+  /// Get the number of the grid points
+  std::size_t getNumGridPoints() const;
+
+protected:
+  /// Linear inequalities a u + b x <= c, one per row (a, b, c)
+  using Constraints = Eigen::Matrix<double, Eigen::Dynamic, 3>;
+
+  /// Create the grid of the path positions
+  void createGrid();
+
+  /// Compute the constraints at the ith grid point. Where the path changes
+  /// from one segment to the next, the constraints of both segments are
+  /// added, and the path velocity is forced to zero if the tangent jumps.
+  void computeConstraints(std::size_t index, Constraints& constraints);
+
+  /// Append the constraints of the path derivatives at a path position
+  void appendConstraints(
+      double pathPos,
+      const Eigen::VectorXd& tangent,
+      const Eigen::VectorXd& curvature,
+      Constraints& constraints,
+      Eigen::Index& numRows);
+
+  /// Create the constraints of the step from the ith grid point to the next
+  /// one, which keep the next state between the given bounds
+  void createStepConstraints(
+      std::size_t index,
+      const std::vector<Constraints>& constraints,
+      double lowerNextState,
+      double upperNextState,
+      Constraints& step) const;
+
+  /// Compute the interval of the states x for which some control u satisfies
+  /// the constraints, and x >= 0. Returns false if the interval is empty.
+  static bool computeStateRange(
+      const Constraints& constraints, double& lower, double& upper);
+
+  /// Compute the interval of the controls u that satisfy the constraints at
+  /// the state x. Returns false if the interval is empty.
+  static bool computeControlRange(
+      const Constraints& constraints, double x, double& lower, double& upper);
+
+  /// Returns the index of the grid segment of the time
+  std::size_t getGridSegment(double time) const;
+
+  /// Path
+  Path mPath;
+
+  /// Velocity limits
+  Eigen::VectorXd mMaxVelocity;
+
+  /// Acceleration limits
+  Eigen::VectorXd mMaxAcceleration;
+
+  /// Options
+  Option mOption;
+
+  /// Whether the path can be followed within the limits
+  bool mValid;
+
+  /// Path positions of the grid points
+  std::vector<double> mGrid;
+
+  /// Whether each grid point is a boundary between two segments of the path
+  std::vector<char> mSegmentBoundaries;
+
+  /// Squared path velocities at the grid points
+  std::vector<double> mStates;
+
+  /// Path accelerations between the grid points
+  std::vector<double> mControls;
+
+  /// Times at the grid points
+  std::vector<double> mTimes;
+};
+
+} // namespace planning
+} // namespace dart
+
+#endif // DART_PLANNING_REACHABILITYTRAJECTORY_HPP_
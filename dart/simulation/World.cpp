@@ -39,19 +39,49 @@
 #include "dart/simulation/World.hpp"
 
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <vector>
 
 #include "dart/collision/CollisionGroup.hpp"
+#include "dart/collision/CollisionObject.hpp"
 #include "dart/common/Console.hpp"
 #include "dart/constraint/BoxedLcpConstraintSolver.hpp"
 #include "dart/constraint/ConstrainedGroup.hpp"
+#include "dart/dynamics/BodyNode.hpp"
+#include "dart/dynamics/ShapeNode.hpp"
 #include "dart/dynamics/Skeleton.hpp"
 #include "dart/integration/SemiImplicitEulerIntegrator.hpp"
 
 namespace dart {
 namespace simulation {
 
+namespace {
+
+//==============================================================================
+/// Returns true if the skeleton is driven by the dynamics, which is the
+/// condition for it to fall asleep
+bool isDynamic(const dynamics::Skeleton& skeleton)
+{
+  return skeleton.isMobile() && skeleton.getNumDofs() > 0u;
+}
+
+} // namespace
+
+//==============================================================================
+World::SleepingOption::SleepingOption(
+    bool enabled,
+    double linearVelocityThreshold,
+    double angularVelocityThreshold,
+    double timeToSleep)
+  : mEnabled(enabled),
+    mLinearVelocityThreshold(linearVelocityThreshold),
+    mAngularVelocityThreshold(angularVelocityThreshold),
+    mTimeToSleep(timeToSleep)
+{
+  // Do nothing
+}
+
 //==============================================================================
 std::shared_ptr<World> World::create(const std::string& name)
 {
@@ -67,6 +97,7 @@ World::World(const std::string& _name)
     mTimeStep(0.001),
     mTime(0.0),
     mFrame(0),
+    mNumSleepIslands(0u),
     mRecording(new Recording(mSkeletons)),
     onNameChanged(mNameChangedSignal)
 {
@@ -95,6 +126,7 @@ WorldPtr World::clone() const
 
   worldClone->setGravity(mGravity);
   worldClone->setTimeStep(mTimeStep);
+  worldClone->setSleepingOption(mSleepingOption);
 
   auto cd = getConstraintSolver()->getCollisionDetector();
   worldClone->getConstraintSolver()->setCollisionDetector(
@@ -166,10 +198,13 @@ void World::reset()
 //==============================================================================
 void World::step(bool _resetCommand)
 {
+  if (mSleepingOption.mEnabled)
+    wakeDisturbedSkeletons();
+
   // Integrate velocity for unconstrained skeletons
   for (auto& skel : mSkeletons)
   {
-    if (!skel->isMobile())
+    if (!skel->isMobile() || skel->isSleeping())
       continue;
 
     skel->computeForwardDynamics();
@@ -182,7 +217,7 @@ void World::step(bool _resetCommand)
   // Compute velocity changes given constraint impulses
   for (auto& skel : mSkeletons)
   {
-    if (!skel->isMobile())
+    if (!skel->isMobile() || skel->isSleeping())
       continue;
 
     if (skel->isImpulseApplied())
@@ -201,6 +236,9 @@ void World::step(bool _resetCommand)
     }
   }
 
+  if (mSleepingOption.mEnabled)
+    updateSleepStates();
+
   mTime += mTimeStep;
   mFrame++;
 }
@@ -223,6 +261,50 @@ int World::getSimFrames() const
   return mFrame;
 }
 
+//==============================================================================
+void World::setSleepingOption(const SleepingOption& option)
+{
+  mSleepingOption = option;
+
+  if (mSleepingOption.mEnabled)
+    return;
+
+  for (std::size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    mSkeletons[i]->setSleeping(false);
+    mSleepStates[i].mRestTime = 0.0;
+  }
+}
+
+//==============================================================================
+const World::SleepingOption& World::getSleepingOption() const
+{
+  return mSleepingOption;
+}
+
+//==============================================================================
+void World::wakeSkeleton(const dynamics::SkeletonPtr& skeleton)
+{
+  const auto it = mSkeletonIndices.find(skeleton.get());
+  if (it == mSkeletonIndices.end() || !skeleton->isSleeping())
+    return;
+
+  wakeIsland(mSleepStates[it->second].mIsland);
+}
+
+//==============================================================================
+std::size_t World::getNumSleepingSkeletons() const
+{
+  std::size_t count = 0u;
+  for (const auto& skel : mSkeletons)
+  {
+    if (skel->isSleeping())
+      ++count;
+  }
+
+  return count;
+}
+
 //==============================================================================
 const std::string& World::setName(const std::string& _newName)
 {
@@ -320,6 +402,10 @@ std::string World::addSkeleton(const dynamics::SkeletonPtr& _skeleton)
   mIndices.push_back(mIndices.back() + _skeleton->getNumDofs());
   mConstraintSolver->addSkeleton(_skeleton);
 
+  _skeleton->setSleeping(false);
+  mSkeletonIndices[_skeleton.get()] = mSleepStates.size();
+  mSleepStates.emplace_back();
+
   // Update recording
   mRecording->updateNumGenCoords(mSkeletons);
 
@@ -370,6 +456,13 @@ void World::removeSkeleton(const dynamics::SkeletonPtr& _skeleton)
       remove(mSkeletons.begin(), mSkeletons.end(), _skeleton),
       mSkeletons.end());
 
+  // Remove the sleeping state of _skeleton
+  _skeleton->setSleeping(false);
+  mSleepStates.erase(mSleepStates.begin() + index);
+  mSkeletonIndices.erase(_skeleton.get());
+  for (std::size_t i = index; i < mSkeletons.size(); ++i)
+    mSkeletonIndices[mSkeletons[i].get()] = i;
+
   // Disconnect the name change monitor
   mNameConnectionsForSkeletons[index].disconnect();
   mNameConnectionsForSkeletons.erase(
@@ -662,6 +755,240 @@ void World::handleSkeletonNameChange(
   }
 }
 
+//==============================================================================
+void World::wakeDisturbedSkeletons()
+{
+  for (std::size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    const auto& skel = mSkeletons[i];
+    if (!skel->isSleeping())
+      continue;
+
+    const SleepState& state = mSleepStates[i];
+    const auto numDofs = skel->getNumDofs();
+    bool disturbed
+        = !skel->isMobile() || !skel->isSleepingAllowed()
+          || numDofs != static_cast<std::size_t>(state.mPositions.size());
+
+    for (std::size_t j = 0; j < numDofs && !disturbed; ++j)
+    {
+      disturbed = skel->getPosition(j) != state.mPositions[j]
+                  || skel->getVelocity(j) != 0.0 || skel->getForce(j) != 0.0
+                  || skel->getCommand(j) != 0.0;
+    }
+
+    for (std::size_t j = 0; j < skel->getNumBodyNodes() && !disturbed; ++j)
+    {
+      disturbed = skel->getBodyNode(j)->getExternalForceLocal()
+                  != Eigen::Vector6d::Zero();
+    }
+
+    if (disturbed)
+      wakeIsland(state.mIsland);
+  }
+}
+
+//==============================================================================
+void World::updateSleepStates()
+{
+  const std::size_t numSkeletons = mSkeletons.size();
+
+  // Sleeping skeletons are woken up by awake dynamic skeletons, and by the
+  // skeletons not driven by the dynamics, i.e., immobile or without DOFs, whose
+  // poses were changed since the last step, e.g., by setPositions()
+  mSleepMovingFlags.resize(numSkeletons);
+  for (std::size_t i = 0; i < numSkeletons; ++i)
+  {
+    const auto& skel = mSkeletons[i];
+    if (isDynamic(*skel))
+      mSleepMovingFlags[i] = !skel->isSleeping();
+    else
+      mSleepMovingFlags[i] = updateKinematicPose(i);
+  }
+
+  // Wake up the sleeping skeletons touched by the moving skeletons. The
+  // moving skeletons saw them as immobile in this step, and they respond from
+  // the next step.
+  const auto& result = mConstraintSolver->getLastCollisionResult();
+  for (const auto& contact : result.getContacts())
+  {
+    const auto shapeNode1
+        = contact.collisionObject1->getShapeFrame()->asShapeNode();
+    const auto shapeNode2
+        = contact.collisionObject2->getShapeFrame()->asShapeNode();
+    if (!shapeNode1 || !shapeNode2 || contact.penetrationDepth < 0.0)
+      continue;
+
+    const auto it1 = mSkeletonIndices.find(shapeNode1->getSkeleton().get());
+    const auto it2 = mSkeletonIndices.find(shapeNode2->getSkeleton().get());
+    if (it1 == mSkeletonIndices.end() || it2 == mSkeletonIndices.end())
+      continue;
+
+    const std::size_t index1 = it1->second;
+    const std::size_t index2 = it2->second;
+    if (mSkeletons[index1]->isSleeping() && mSleepMovingFlags[index2])
+      wakeIsland(mSleepStates[index1].mIsland);
+    else if (mSkeletons[index2]->isSleeping() && mSleepMovingFlags[index1])
+      wakeIsland(mSleepStates[index2].mIsland);
+  }
+
+  // Accumulate the rest time of the awake skeletons
+  for (std::size_t i = 0; i < numSkeletons; ++i)
+  {
+    const auto& skel = mSkeletons[i];
+    if (!isDynamic(*skel) || skel->isSleeping())
+      continue;
+
+    SleepState& state = mSleepStates[i];
+    if (skel->isSleepingAllowed() && isAtRest(skel.get()))
+      state.mRestTime += mTimeStep;
+    else
+      state.mRestTime = 0.0;
+  }
+
+  // Build the islands of the skeletons coupled by the constrained groups of
+  // this step
+  mSleepIslandParents.resize(numSkeletons);
+  std::iota(mSleepIslandParents.begin(), mSleepIslandParents.end(), 0u);
+  const std::size_t numGroups = mConstraintSolver->getNumConstrainedGroups();
+  for (std::size_t i = 0; i < numGroups; ++i)
+  {
+    const auto& group = mConstraintSolver->getConstrainedGroup(i);
+    std::size_t root = numSkeletons;
+    for (std::size_t j = 0; j < group.getNumSkeletons(); ++j)
+    {
+      const auto it = mSkeletonIndices.find(group.getSkeleton(j).get());
+      if (it == mSkeletonIndices.end())
+        continue;
+
+      const std::size_t other = findSleepIsland(it->second);
+      if (root == numSkeletons)
+        root = other;
+      else if (other != root)
+        mSleepIslandParents[other] = root;
+    }
+  }
+
+  // An island falls asleep only if all of its skeletons have been at rest for
+  // long enough
+  mSleepIslandRestFlags.assign(numSkeletons, true);
+  for (std::size_t i = 0; i < numSkeletons; ++i)
+  {
+    const auto& skel = mSkeletons[i];
+    if (!isDynamic(*skel) || skel->isSleeping())
+      continue;
+
+    if (mSleepStates[i].mRestTime < mSleepingOption.mTimeToSleep)
+      mSleepIslandRestFlags[findSleepIsland(i)] = false;
+  }
+
+  for (std::size_t i = 0; i < numSkeletons; ++i)
+  {
+    const auto& skel = mSkeletons[i];
+    if (!isDynamic(*skel) || skel->isSleeping())
+      continue;
+
+    const std::size_t root = findSleepIsland(i);
+    if (mSleepIslandRestFlags[root])
+      sleepSkeleton(i, mNumSleepIslands + root);
+  }
+
+  mNumSleepIslands += numSkeletons;
+}
+
+//==============================================================================
+bool World::updateKinematicPose(std::size_t index)
+{
+  const auto& skel = mSkeletons[index];
+  SleepState& state = mSleepStates[index];
+  const std::size_t numTrees = skel->getNumTrees();
+
+  bool moved = state.mKinematicPositions.size()
+                   != static_cast<Eigen::Index>(skel->getNumDofs())
+               || state.mKinematicRootTransforms.size() != numTrees
+               || state.mKinematicPositions != skel->getPositions();
+
+  for (std::size_t i = 0; i < numTrees && !moved; ++i)
+  {
+    moved = skel->getRootBodyNode(i)->getWorldTransform().matrix()
+            != state.mKinematicRootTransforms[i].matrix();
+  }
+
+  if (moved)
+  {
+    state.mKinematicPositions = skel->getPositions();
+    state.mKinematicRootTransforms.resize(numTrees);
+    for (std::size_t i = 0; i < numTrees; ++i)
+    {
+      state.mKinematicRootTransforms[i]
+          = skel->getRootBodyNode(i)->getWorldTransform();
+    }
+  }
+
+  return moved;
+}
+
+//==============================================================================
+bool World::isAtRest(const dynamics::Skeleton* skeleton) const
+{
+  const double linearThreshold = mSleepingOption.mLinearVelocityThreshold;
+  const double angularThreshold = mSleepingOption.mAngularVelocityThreshold;
+
+  for (std::size_t i = 0; i < skeleton->getNumBodyNodes(); ++i)
+  {
+    const dynamics::BodyNode* bodyNode = skeleton->getBodyNode(i);
+    if (bodyNode->getLinearVelocity().squaredNorm()
+            > linearThreshold * linearThreshold
+        || bodyNode->getAngularVelocity().squaredNorm()
+               > angularThreshold * angularThreshold)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//==============================================================================
+void World::wakeIsland(std::size_t island)
+{
+  for (std::size_t i = 0; i < mSkeletons.size(); ++i)
+  {
+    if (!mSkeletons[i]->isSleeping() || mSleepStates[i].mIsland != island)
+      continue;
+
+    mSkeletons[i]->setSleeping(false);
+    mSleepStates[i].mRestTime = 0.0;
+  }
+}
+
+//==============================================================================
+void World::sleepSkeleton(std::size_t index, std::size_t island)
+{
+  const auto& skel = mSkeletons[index];
+  SleepState& state = mSleepStates[index];
+
+  for (std::size_t i = 0; i < skel->getNumDofs(); ++i)
+    skel->setVelocity(i, 0.0);
+
+  state.mPositions = skel->getPositions();
+  state.mIsland = island;
+  skel->setSleeping(true);
+}
+
+//==============================================================================
+std::size_t World::findSleepIsland(std::size_t index)
+{
+  while (mSleepIslandParents[index] != index)
+  {
+    mSleepIslandParents[index]
+        = mSleepIslandParents[mSleepIslandParents[index]];
+    index = mSleepIslandParents[index];
+  }
+
+  return index;
+}
+
 //==============================================================================
 void World::handleSimpleFrameNameChange(const dynamics::Entity* _entity)
 {
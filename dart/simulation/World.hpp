@@ -41,11 +41,13 @@
 
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <Eigen/Dense>
 
 #include "dart/collision/CollisionOption.hpp"
+#include "dart/common/Memory.hpp"
 #include "dart/common/NameManager.hpp"
 #include "dart/common/SmartPointer.hpp"
 #include "dart/common/Subject.hpp"
@@ -85,6 +87,32 @@ public:
   using NameChangedSignal = common::Signal<void(
       const std::string& _oldName, const std::string& _newName)>;
 
+  /// Options for putting resting skeletons to sleep. A skeleton is at rest
+  /// when the velocities of all its BodyNodes are below the thresholds. The
+  /// skeletons coupled by constraints form an island, which falls asleep once
+  /// all of its skeletons have been at rest for mTimeToSleep.
+  struct SleepingOption
+  {
+    /// Whether resting skeletons are put to sleep
+    bool mEnabled;
+
+    /// Linear velocity threshold of the BodyNodes [m/s]
+    double mLinearVelocityThreshold;
+
+    /// Angular velocity threshold of the BodyNodes [rad/s]
+    double mAngularVelocityThreshold;
+
+    /// Time that a skeleton needs to stay at rest before falling asleep [s]
+    double mTimeToSleep;
+
+    /// Constructor
+    SleepingOption(
+        bool enabled = false,
+        double linearVelocityThreshold = 0.05,
+        double angularVelocityThreshold = 0.1,
+        double timeToSleep = 0.5);
+  };
+
   /// Creates World as shared_ptr
   template <typename... Args>
   static WorldPtr create(Args&&... args);
@@ -229,6 +257,28 @@ public:
   /// getSimpleFrame()
   int getSimFrames() const;
 
+  //--------------------------------------------------------------------------
+  // Sleeping
+  //--------------------------------------------------------------------------
+
+  /// Sets the options for putting resting skeletons to sleep. Sleeping
+  /// skeletons skip forward dynamics, integration and the constraint solving.
+  /// They are woken up when their state is changed, forces or commands are
+  /// applied to them, or an awake skeleton or a moved kinematic skeleton
+  /// touches them. Disabling sleeping wakes up all the sleeping skeletons.
+  ///
+  /// \sa dynamics::Skeleton::setSleepingAllowed()
+  void setSleepingOption(const SleepingOption& option);
+
+  /// Returns the options for putting resting skeletons to sleep.
+  const SleepingOption& getSleepingOption() const;
+
+  /// Wakes up a skeleton together with the skeletons that fell asleep with it.
+  void wakeSkeleton(const dynamics::SkeletonPtr& skeleton);
+
+  /// Returns the number of sleeping skeletons.
+  std::size_t getNumSleepingSkeletons() const;
+
   //--------------------------------------------------------------------------
   // Constraint
   //--------------------------------------------------------------------------
@@ -259,6 +309,50 @@ protected:
   /// Register when a SimpleFrame's name is changed
   void handleSimpleFrameNameChange(const dynamics::Entity* _entity);
 
+  /// Wakes up the sleeping skeletons whose states, forces or commands were
+  /// changed since they fell asleep
+  void wakeDisturbedSkeletons();
+
+  /// Wakes up the sleeping skeletons touched by awake or moved skeletons, and
+  /// puts the islands that have been at rest long enough to sleep
+  void updateSleepStates();
+
+  /// Returns true if the pose of a skeleton that is not driven by the dynamics
+  /// was changed since the last step, and records its current pose
+  bool updateKinematicPose(std::size_t index);
+
+  /// Returns true if all the BodyNodes of the skeleton are at rest
+  bool isAtRest(const dynamics::Skeleton* skeleton) const;
+
+  /// Wakes up the skeletons that fell asleep in the island
+  void wakeIsland(std::size_t island);
+
+  /// Puts a skeleton to sleep as a part of the island
+  void sleepSkeleton(std::size_t index, std::size_t island);
+
+  /// Finds the root of the island of a skeleton while the islands are built
+  std::size_t findSleepIsland(std::size_t index);
+
+  /// Sleeping state of a skeleton
+  struct SleepState
+  {
+    /// Time that the skeleton has been at rest
+    double mRestTime{0.0};
+
+    /// Island that the skeleton fell asleep with
+    std::size_t mIsland{0u};
+
+    /// Positions of the skeleton when it fell asleep
+    Eigen::VectorXd mPositions;
+
+    /// Positions of a kinematic skeleton at the last step
+    Eigen::VectorXd mKinematicPositions;
+
+    /// Transforms of the root BodyNodes of a kinematic skeleton at the last
+    /// step
+    common::aligned_vector<Eigen::Isometry3d> mKinematicRootTransforms;
+  };
+
   /// Name of this World
   std::string mName;
 
@@ -310,6 +404,28 @@ protected:
   /// Constraint solver
   std::unique_ptr<constraint::ConstraintSolver> mConstraintSolver;
 
+  /// Options for putting resting skeletons to sleep
+  SleepingOption mSleepingOption;
+
+  /// Sleeping states of the skeletons in the same order with mSkeletons
+  std::vector<SleepState> mSleepStates;
+
+  /// Map from the skeletons to their indices in mSkeletons
+  std::unordered_map<const dynamics::Skeleton*, std::size_t> mSkeletonIndices;
+
+  /// Union-find parents of the skeletons used to build the islands
+  std::vector<std::size_t> mSleepIslandParents;
+
+  /// Whether the island of each root skeleton can fall asleep
+  std::vector<bool> mSleepIslandRestFlags;
+
+  /// Whether each skeleton is awake and dynamic, or kinematic and moved, in
+  /// the current step
+  std::vector<bool> mSleepMovingFlags;
+
+  /// Number of the island identifiers issued so far
+  std::size_t mNumSleepIslands;
+
   ///
   Recording* mRecording;
 
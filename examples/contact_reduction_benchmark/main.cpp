@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <dart/dart.hpp>
+
+// Compares the constraint problem size and the step time of a box pile with
+// and without contact manifold reduction (CollisionOption::
+// maxNumContactsPerPair).
+
+using namespace dart;
+
+//==============================================================================
+simulation::WorldPtr createWorld(std::size_t numBoxesPerSide)
+{
+  auto world = simulation::World::create();
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<
+      dynamics::CollisionAspect,
+      dynamics::DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(10.0, 10.0, 0.1)));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = -0.05;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(tf);
+  world->addSkeleton(ground);
+
+  const auto box
+      = std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(0.2, 0.2, 0.2));
+
+  for (auto i = 0u; i < numBoxesPerSide; ++i)
+  {
+    for (auto j = 0u; j < numBoxesPerSide; ++j)
+    {
+      for (auto k = 0u; k < 2u; ++k)
+      {
+        auto skel = dynamics::Skeleton::create(
+            "box_" + std::to_string(i) + "_" + std::to_string(j) + "_"
+            + std::to_string(k));
+        auto body
+            = skel->createJointAndBodyNodePair<dynamics::FreeJoint>().second;
+        body->createShapeNodeWith<
+            dynamics::CollisionAspect,
+            dynamics::DynamicsAspect>(box);
+
+        tf.translation() = Eigen::Vector3d(0.25 * i, 0.25 * j, 0.1 + 0.21 * k);
+        dynamics::FreeJoint::setTransformOf(body, tf);
+        world->addSkeleton(skel);
+      }
+    }
+  }
+
+  return world;
+}
+
+//==============================================================================
+void runBenchmark(
+    const collision::CollisionDetectorPtr& collisionDetector,
+    std::size_t maxNumContactsPerPair,
+    std::size_t numSteps)
+{
+  auto world = createWorld(5u);
+  auto solver = world->getConstraintSolver();
+  if (collisionDetector)
+    solver->setCollisionDetector(collisionDetector);
+  solver->getCollisionOption().maxNumContactsPerPair = maxNumContactsPerPair;
+
+  std::size_t totalContacts = 0u;
+  std::size_t maxContacts = 0u;
+  std::chrono::duration<double> elapsed(0.0);
+
+  for (auto i = 0u; i < numSteps; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    world->step();
+    elapsed += std::chrono::steady_clock::now() - start;
+
+    const auto numContacts = world->getLastCollisionResult().getNumContacts();
+    totalContacts += numContacts;
+    maxContacts = std::max(maxContacts, numContacts);
+  }
+
+  // Each contact becomes a ContactConstraint of three rows (normal and two
+  // friction directions) in the LCP.
+  const auto meanContacts = static_cast<double>(totalContacts) / numSteps;
+
+  std::cout << "maxNumContactsPerPair: " << maxNumContactsPerPair
+            << (0u == maxNumContactsPerPair ? " (no reduction)" : "") << "\n"
+            << "  Contacts per step (mean / max): " << meanContacts << " / "
+            << maxContacts << "\n"
+            << "  LCP size per step (mean / max): " << 3.0 * meanContacts
+            << " / " << 3u * maxContacts << "\n"
+            << "  Step time: " << 1e3 * elapsed.count() / numSteps << " ms\n"
+            << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  // Usage: contact_reduction_benchmark [--dart] [num_steps]
+  collision::CollisionDetectorPtr collisionDetector;
+  std::size_t numSteps = 500u;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--dart")
+      collisionDetector = collision::DARTCollisionDetector::create();
+    else
+      numSteps = static_cast<std::size_t>(std::stoul(argv[i]));
+  }
+
+  for (const auto maxNumContactsPerPair : {0u, 8u, 4u, 3u})
+    runBenchmark(collisionDetector, maxNumContactsPerPair, numSteps);
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include <dart/dart.hpp>
+#include <dart/external/odelcpsolver/matrix.h>
+
+// Compares the scalar and the SIMD kernels of the Dantzig boxed LCP solver
+// on random contact problems with 12 to 600 constraints. For each size it
+// reports the time of the LDL^T factorization and solve alone, the time of
+// the whole DantzigBoxedLcpSolver::solve(), and the largest difference of the
+// two solutions.
+//
+// Usage:
+//   dantzig_kernel_benchmark [repetitions]
+
+using namespace dart;
+
+namespace {
+
+//==============================================================================
+constraint::BoxedLcpProblem createContactProblem(int numContacts)
+{
+  const int n = 3 * numContacts;
+
+  constraint::BoxedLcpProblem problem;
+  const Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+  problem.A = J * J.transpose() + 1e-3 * Eigen::MatrixXd::Identity(n, n);
+  problem.b = Eigen::VectorXd::Random(n).cwiseAbs() * n;
+  problem.lo.resize(n);
+  problem.hi.resize(n);
+  problem.findex.resize(n);
+  for (int i = 0; i < numContacts; ++i)
+  {
+    // Normal direction followed by two friction directions
+    problem.lo.segment<3>(3 * i) << 0.0, -1.0, -1.0;
+    problem.hi.segment<3>(3 * i) << math::constantsd::inf(), 0.5, 0.5;
+    problem.findex.segment<3>(3 * i) << -1, 3 * i, 3 * i;
+  }
+  problem.initialX = Eigen::VectorXd::Zero(n);
+
+  return problem;
+}
+
+//==============================================================================
+double timeFactorization(const Eigen::MatrixXd& A, bool simd, int repetitions)
+{
+  const int n = static_cast<int>(A.rows());
+  const int nskip = dPAD(n);
+  std::vector<double> L(n * nskip);
+  std::vector<double> d(n);
+  std::vector<double> x(n);
+
+  const int previous = external::ode::dSetSimdKernelsEnabled(simd ? 1 : 0);
+  double best = std::numeric_limits<double>::infinity();
+  for (int k = 0; k < repetitions; ++k)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      for (int j = 0; j < n; ++j)
+        L[i * nskip + j] = A(i, j);
+      x[i] = 1.0;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    external::ode::dFactorLDLT(L.data(), d.data(), n, nskip);
+    external::ode::dSolveLDLT(L.data(), d.data(), x.data(), n, nskip);
+    const auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end - start).count());
+  }
+  external::ode::dSetSimdKernelsEnabled(previous);
+
+  return best;
+}
+
+//==============================================================================
+constraint::BoxedLcpReplayResult timeSolve(
+    constraint::DantzigBoxedLcpSolver& solver,
+    const constraint::BoxedLcpProblem& problem,
+    int repetitions)
+{
+  constraint::BoxedLcpReplayResult best;
+  best.time = std::numeric_limits<double>::infinity();
+  for (int k = 0; k < repetitions; ++k)
+  {
+    auto result = constraint::replayBoxedLcpProblem(solver, problem);
+    if (result.time < best.time)
+      best = std::move(result);
+  }
+
+  return best;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  const int repetitions = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+
+  if (!constraint::DantzigBoxedLcpSolver::isSimdKernelSupported())
+  {
+    std::printf("The SIMD kernels are not supported on this machine.\n");
+    return 0;
+  }
+
+  constraint::DantzigBoxedLcpSolver scalar;
+  scalar.setUseSimdKernels(false);
+  constraint::DantzigBoxedLcpSolver simd;
+  simd.setUseSimdKernels(true);
+
+  std::printf(
+      "%5s | %12s %12s %7s | %12s %12s %7s | %9s\n",
+      "n",
+      "LDLT scalar",
+      "LDLT SIMD",
+      "speedup",
+      "LCP scalar",
+      "LCP SIMD",
+      "speedup",
+      "max |dx|");
+
+  for (const int numContacts : {4, 10, 20, 40, 80, 120, 160, 200})
+  {
+    const auto problem = createContactProblem(numContacts);
+
+    const double factorScalar
+        = timeFactorization(problem.A, false, repetitions);
+    const double factorSimd = timeFactorization(problem.A, true, repetitions);
+
+    const auto solveScalar = timeSolve(scalar, problem, repetitions);
+    const auto solveSimd = timeSolve(simd, problem, repetitions);
+
+    std::printf(
+        "%5d | %9.1f us %9.1f us %6.2fx | %9.1f us %9.1f us %6.2fx | %9.2e\n",
+        problem.getDimension(),
+        1e6 * factorScalar,
+        1e6 * factorSimd,
+        factorScalar / factorSimd,
+        1e6 * solveScalar.time,
+        1e6 * solveSimd.time,
+        solveScalar.time / solveSimd.time,
+        (solveScalar.x - solveSimd.x).lpNorm<Eigen::Infinity>());
+  }
+
+  return 0;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include <dart/dart.hpp>
+
+// Compares the explicit null space projection of HierarchicalIK, which forms
+// an n x n null space matrix per level, with the implicit projection, which
+// projects the gradients against an orthonormal basis of the Jacobian rows.
+// The feet of a humanoid have the highest precedence, followed by the hands
+// and then the head.
+//
+// Usage:
+//   hierarchical_ik_benchmark [num_spine_links] [num_evaluations]
+
+using namespace dart;
+
+//==============================================================================
+dynamics::BodyNode* addChain(
+    const dynamics::SkeletonPtr& skel,
+    dynamics::BodyNode* parent,
+    const std::string& name,
+    const Eigen::Vector3d& offset,
+    const std::vector<Eigen::Vector3d>& axes,
+    const Eigen::Vector3d& linkOffset)
+{
+  for (std::size_t i = 0u; i < axes.size(); ++i)
+  {
+    dynamics::RevoluteJoint::Properties properties;
+    properties.mName = name + "_joint_" + std::to_string(i);
+    properties.mAxis = axes[i];
+    properties.mT_ParentBodyToJoint.translation()
+        = (i == 0u) ? offset : linkOffset;
+
+    parent = skel->createJointAndBodyNodePair<dynamics::RevoluteJoint>(
+                     parent,
+                     properties,
+                     dynamics::BodyNode::AspectProperties(
+                         name + "_" + std::to_string(i)))
+                 .second;
+  }
+
+  return parent;
+}
+
+//==============================================================================
+dynamics::SkeletonPtr createHumanoid(std::size_t numSpineLinks)
+{
+  const Eigen::Vector3d x = Eigen::Vector3d::UnitX();
+  const Eigen::Vector3d y = Eigen::Vector3d::UnitY();
+  const Eigen::Vector3d z = Eigen::Vector3d::UnitZ();
+
+  auto skel = dynamics::Skeleton::create("humanoid");
+  dynamics::FreeJoint::Properties rootProperties;
+  rootProperties.mName = "root_joint";
+  auto pelvis = skel->createJointAndBodyNodePair<dynamics::FreeJoint>(
+                        nullptr,
+                        rootProperties,
+                        dynamics::BodyNode::AspectProperties("pelvis"))
+                    .second;
+
+  const std::vector<Eigen::Vector3d> legAxes = {z, x, y, y, y, x};
+  const std::vector<Eigen::Vector3d> armAxes = {y, x, z, y, z, y, x};
+
+  auto leftFoot = addChain(
+      skel, pelvis, "left_leg", Eigen::Vector3d(0.0, 0.1, -0.1), legAxes,
+      Eigen::Vector3d(0.0, 0.0, -0.15));
+  auto rightFoot = addChain(
+      skel, pelvis, "right_leg", Eigen::Vector3d(0.0, -0.1, -0.1), legAxes,
+      Eigen::Vector3d(0.0, 0.0, -0.15));
+
+  std::vector<Eigen::Vector3d> spineAxes;
+  for (std::size_t i = 0u; i < numSpineLinks; ++i)
+    spineAxes.push_back(i % 3u == 0u ? z : (i % 3u == 1u ? x : y));
+  auto chest = addChain(
+      skel, pelvis, "spine", Eigen::Vector3d(0.0, 0.0, 0.1), spineAxes,
+      Eigen::Vector3d(0.0, 0.0, 0.4 / numSpineLinks));
+
+  auto leftHand = addChain(
+      skel, chest, "left_arm", Eigen::Vector3d(0.0, 0.2, 0.1), armAxes,
+      Eigen::Vector3d(0.0, 0.0, -0.1));
+  auto rightHand = addChain(
+      skel, chest, "right_arm", Eigen::Vector3d(0.0, -0.2, 0.1), armAxes,
+      Eigen::Vector3d(0.0, 0.0, -0.1));
+  auto head = addChain(
+      skel, chest, "neck", Eigen::Vector3d(0.0, 0.0, 0.15), {z, y},
+      Eigen::Vector3d(0.0, 0.0, 0.05));
+
+  // Feet first, then the hands, then the head
+  const std::vector<std::pair<dynamics::BodyNode*, std::size_t>> ends
+      = {{leftFoot, 0u},
+         {rightFoot, 0u},
+         {leftHand, 1u},
+         {rightHand, 1u},
+         {head, 2u}};
+  for (const auto& end : ends)
+  {
+    auto ik = end.first->getIK(true);
+    ik->useWholeBody();
+    ik->setHierarchyLevel(end.second);
+    ik->getTarget()->setTransform(end.first->getWorldTransform());
+  }
+
+  return skel;
+}
+
+//==============================================================================
+void moveTargets(const dynamics::SkeletonPtr& skel)
+{
+  // Lift the hands and turn the head, keeping the feet where they are
+  for (const auto& name : {"left_arm_6", "right_arm_6"})
+  {
+    auto target = skel->getBodyNode(name)->getIK()->getTarget();
+    target->setTranslation(
+        target->getWorldTransform().translation()
+        + Eigen::Vector3d(0.15, 0.0, 0.25));
+  }
+
+  auto headTarget = skel->getBodyNode("neck_1")->getIK()->getTarget();
+  Eigen::Isometry3d tf = headTarget->getWorldTransform();
+  tf.rotate(Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitZ()));
+  headTarget->setTransform(tf);
+}
+
+//==============================================================================
+double computeError(const dynamics::SkeletonPtr& skel, std::size_t level)
+{
+  double error = 0.0;
+  for (const auto& module : skel->getIK()->getIKHierarchy()[level])
+    error += module->getErrorMethod().computeError().squaredNorm();
+
+  return std::sqrt(error);
+}
+
+//==============================================================================
+void runBenchmark(std::size_t numSpineLinks, std::size_t numEvaluations)
+{
+  Eigen::VectorXd solutions[2];
+  for (const bool implicit : {false, true})
+  {
+    auto skel = createHumanoid(numSpineLinks);
+    moveTargets(skel);
+
+    auto hik = skel->getIK(true);
+    hik->refreshIKHierarchy();
+    hik->setImplicitNullSpaceProjection(implicit);
+
+    // Time the gradient of the hierarchy constraint, which is where the null
+    // spaces are used
+    const auto constraint = hik->getProblem()->getEqConstraint(0);
+    const Eigen::VectorXd x = skel->getPositions();
+    Eigen::VectorXd grad(x.size());
+    Eigen::Map<Eigen::VectorXd> gradMap(grad.data(), grad.size());
+
+    const auto gradientStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0u; i < numEvaluations; ++i)
+      constraint->evalGradient(x, gradMap);
+    const std::chrono::duration<double> gradientTime
+        = std::chrono::steady_clock::now() - gradientStart;
+
+    // The gradient methods move the positions, so restore them before solving
+    skel->setPositions(x);
+
+    hik->getSolver()->setNumMaxIterations(200);
+    const auto solveStart = std::chrono::steady_clock::now();
+    hik->findSolution(solutions[implicit]);
+    const std::chrono::duration<double> solveTime
+        = std::chrono::steady_clock::now() - solveStart;
+    skel->setPositions(solutions[implicit]);
+
+    std::cout << "Null space projection: "
+              << (implicit ? "implicit" : "explicit") << "\n"
+              << "  DOFs: " << skel->getNumDofs() << "\n"
+              << "  Constraint gradient: "
+              << 1e6 * gradientTime.count() / numEvaluations << " us\n"
+              << "  Solve (200 iterations): " << 1e3 * solveTime.count()
+              << " ms\n"
+              << "  Final errors of the feet, hands, and head: "
+              << computeError(skel, 0u) << ", " << computeError(skel, 1u)
+              << ", " << computeError(skel, 2u) << "\n"
+              << std::endl;
+  }
+
+  // The projections differ when a level holds several modules, since the
+  // implicit projection uses the null space of their combined Jacobian
+  std::cout << "Max position difference: "
+            << (solutions[0] - solutions[1]).cwiseAbs().maxCoeff()
+            << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  std::size_t numSpineLinks = 3u;
+  std::size_t numEvaluations = 1000u;
+  if (argc > 1)
+    numSpineLinks = static_cast<std::size_t>(std::stoul(argv[1]));
+  if (argc > 2)
+    numEvaluations = static_cast<std::size_t>(std::stoul(argv[2]));
+
+  runBenchmark(std::max<std::size_t>(numSpineLinks, 1u), numEvaluations);
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+#include <dart/dart.hpp>
+
+// Measures the success rate and the latency of solving the IK of a 7-DOF arm
+// for random reachable targets with and without an IkSeedCache. The cache is
+// generated offline from sampled configurations, saved to a binary file, and
+// loaded back before it is used.
+//
+// Usage:
+//   ik_seed_cache_benchmark [num_cache_entries] [num_targets]
+
+using namespace dart;
+
+//==============================================================================
+dynamics::SkeletonPtr createArm()
+{
+  auto skel = dynamics::Skeleton::create("arm");
+
+  const std::vector<Eigen::Vector3d> axes = {Eigen::Vector3d::UnitZ(),
+                                             Eigen::Vector3d::UnitY(),
+                                             Eigen::Vector3d::UnitZ(),
+                                             Eigen::Vector3d::UnitY(),
+                                             Eigen::Vector3d::UnitZ(),
+                                             Eigen::Vector3d::UnitY(),
+                                             Eigen::Vector3d::UnitZ()};
+
+  dynamics::BodyNode* parent = nullptr;
+  for (std::size_t i = 0u; i < axes.size(); ++i)
+  {
+    dynamics::RevoluteJoint::Properties properties;
+    properties.mName = "joint_" + std::to_string(i);
+    properties.mAxis = axes[i];
+    properties.mPositionLowerLimits[0] = -0.9 * math::constantsd::pi();
+    properties.mPositionUpperLimits[0] = 0.9 * math::constantsd::pi();
+    if (parent)
+      properties.mT_ParentBodyToJoint.translation().z() = 0.25;
+
+    parent = skel->createJointAndBodyNodePair<dynamics::RevoluteJoint>(
+                     parent,
+                     properties,
+                     dynamics::BodyNode::AspectProperties(
+                         "link_" + std::to_string(i)))
+                 .second;
+  }
+
+  return skel;
+}
+
+//==============================================================================
+void runBenchmark(
+    const dynamics::InverseKinematicsPtr& ik,
+    const common::aligned_vector<Eigen::Isometry3d>& targets,
+    const std::string& name)
+{
+  const auto skel = ik->getNode()->getSkeleton();
+
+  std::size_t numSolved = 0u;
+  std::chrono::duration<double> elapsed(0.0);
+  for (const auto& target : targets)
+  {
+    // Every query starts from the same configuration
+    skel->resetPositions();
+    ik->getTarget()->setTransform(target);
+
+    Eigen::VectorXd solution;
+    const auto start = std::chrono::steady_clock::now();
+    if (ik->findSolution(solution))
+      ++numSolved;
+    elapsed += std::chrono::steady_clock::now() - start;
+  }
+
+  std::cout << name << "\n"
+            << "  Success rate: " << 100.0 * numSolved / targets.size()
+            << " %\n"
+            << "  Latency: " << 1e3 * elapsed.count() / targets.size()
+            << " ms\n"
+            << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  std::size_t numCacheEntries = 20000u;
+  std::size_t numTargets = 500u;
+  if (argc > 1)
+    numCacheEntries = static_cast<std::size_t>(std::stoul(argv[1]));
+  if (argc > 2)
+    numTargets = static_cast<std::size_t>(std::stoul(argv[2]));
+
+  math::Random::setSeed(0u);
+
+  const auto skel = createArm();
+  const auto ik = skel->getBodyNode(skel->getNumBodyNodes() - 1u)->getIK(true);
+  ik->getErrorMethod().setBounds(
+      Eigen::Vector6d::Constant(-1e-6), Eigen::Vector6d::Constant(1e-6));
+  ik->getSolver()->setNumMaxIterations(100);
+
+  // Reachable targets are the poses of random configurations
+  const Eigen::VectorXd lower = skel->getPositionLowerLimits();
+  const Eigen::VectorXd upper = skel->getPositionUpperLimits();
+  common::aligned_vector<Eigen::Isometry3d> targets;
+  for (std::size_t i = 0u; i < numTargets; ++i)
+  {
+    skel->setPositions(math::Random::uniform<Eigen::VectorXd>(lower, upper));
+    targets.push_back(ik->getNode()->getWorldTransform());
+  }
+
+  const auto solver
+      = std::dynamic_pointer_cast<optimizer::GradientDescentSolver>(
+          ik->getSolver());
+  dynamics::IkSeedCache::Option option;
+  option.mRecordSolutions = false;
+
+  runBenchmark(ik, targets, "Without seed cache, single attempt");
+  solver->setMaxAttempts(option.mNumSeeds);
+  runBenchmark(ik, targets, "Without seed cache, random restarts");
+  solver->setMaxAttempts(1u);
+
+  // Generate the cache offline, and persist it
+  auto cache = std::make_shared<dynamics::IkSeedCache>(
+      ik->getDofs().size(), option);
+
+  auto start = std::chrono::steady_clock::now();
+  cache->generate(*ik, numCacheEntries);
+  const std::chrono::duration<double> generateTime
+      = std::chrono::steady_clock::now() - start;
+
+  const std::string path = "ik_seed_cache_benchmark.bin";
+  cache->save(path);
+  cache->clear();
+
+  start = std::chrono::steady_clock::now();
+  cache->load(path);
+  const std::chrono::duration<double> loadTime
+      = std::chrono::steady_clock::now() - start;
+  std::remove(path.c_str());
+
+  std::cout << "Seed cache: " << cache->getNumEntries() << " entries\n"
+            << "  Generation: " << 1e3 * generateTime.count() << " ms\n"
+            << "  Loading: " << 1e3 * loadTime.count() << " ms\n"
+            << std::endl;
+
+  ik->setSeedCache(cache);
+  runBenchmark(ik, targets, "With seed cache, single attempt");
+
+  // The further attempts start from the other cached solutions
+  solver->setMaxAttempts(option.mNumSeeds);
+  runBenchmark(ik, targets, "With seed cache, one attempt per cached seed");
+
+  return 0;
+}
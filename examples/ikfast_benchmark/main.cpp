@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dart/dart.hpp>
+#include <dart/planning/planning.hpp>
+#include <dart/utils/urdf/urdf.hpp>
+
+// Measures the throughput of the analytical inverse kinematics of the WAM arm
+// from data/ with the IkFast solver that the unit tests generate, solving the
+// targets one at a time with getSolutions() and at once with
+// IkFast::computeBatchSolutions() for several numbers of threads. Then the
+// solutions are also checked for collisions with a shelf in front of the arm,
+// one by one with planning::MotionValidator::isValid() and in bulk with
+// planning::MotionValidator::validateConfigurations() as the batch filter.
+//
+// Usage:
+//   ikfast_benchmark [num_targets] [ikfast_library]
+//
+// The default library is GeneratedWamIkFast, which is built with the unit
+// tests, and is found in the library search path.
+
+using namespace dart;
+
+using Analytical = dynamics::InverseKinematics::Analytical;
+
+//==============================================================================
+std::string getDefaultLibraryName()
+{
+  std::stringstream ss;
+  ss << DART_SHARED_LIB_PREFIX << "GeneratedWamIkFast";
+#if (DART_OS_LINUX || DART_OS_MACOS) && !NDEBUG
+  ss << "d";
+#endif
+  ss << "." << DART_SHARED_LIB_EXTENSION;
+  return ss.str();
+}
+
+//==============================================================================
+void addShelf(const simulation::WorldPtr& world)
+{
+  auto shelf = dynamics::Skeleton::create("shelf");
+  auto body = shelf->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation() = Eigen::Vector3d(0.55, 0.0, 0.7);
+  body->getParentJoint()->setTransformFromParentBodyNode(tf);
+  body->createShapeNodeWith<
+      dynamics::CollisionAspect,
+      dynamics::DynamicsAspect>(std::make_shared<dynamics::BoxShape>(
+      Eigen::Vector3d(0.3, 0.8, 0.04)));
+  world->addSkeleton(shelf);
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  std::size_t numTargets = 10000u;
+  std::string library = getDefaultLibraryName();
+  if (argc > 1)
+    numTargets = static_cast<std::size_t>(std::stoul(argv[1]));
+  if (argc > 2)
+    library = argv[2];
+
+  utils::DartLoader loader;
+  loader.addPackageDirectory("herb_description", DART_DATA_PATH "/urdf/wam");
+  auto wam = loader.parseSkeleton(DART_DATA_PATH "/urdf/wam/wam.urdf");
+  if (!wam)
+    return 1;
+
+  auto world = simulation::World::create();
+  world->addSkeleton(wam);
+  addShelf(world);
+
+  auto ee = wam->getBodyNode("/wam7")->createEndEffector("ee");
+  auto ik = ee->createIK();
+  auto& ikfast = ik->setGradientMethod<dynamics::SharedLibraryIkFast>(
+      library,
+      std::vector<std::size_t>{0, 1, 3, 4, 5, 6},
+      std::vector<std::size_t>{2});
+  if (!ikfast.isConfigured())
+  {
+    std::cerr << "Failed to load " << library << "\n";
+    return 1;
+  }
+  const std::vector<std::size_t> dofs = ikfast.getDofs();
+
+  // Reachable targets of random positions within the limits, where the free
+  // DOF keeps its initial position
+  math::Random::setSeed(0u);
+  const Eigen::VectorXd initialPositions = wam->getPositions();
+  common::aligned_vector<Eigen::Isometry3d> targets;
+  targets.reserve(numTargets);
+  for (std::size_t i = 0u; i < numTargets; ++i)
+  {
+    wam->setPositions(math::Random::uniform<Eigen::VectorXd>(
+        wam->getPositionLowerLimits(), wam->getPositionUpperLimits()));
+    wam->setPosition(2u, initialPositions[2]);
+    targets.push_back(ee->getWorldTransform());
+  }
+  wam->setPositions(initialPositions);
+
+  std::cout << "WAM IkFast, " << numTargets << " targets" << std::endl;
+
+  // One target at a time, keeping the valid solutions
+  std::size_t numSolutions = 0u;
+  auto begin = std::chrono::steady_clock::now();
+  for (const auto& target : targets)
+  {
+    for (const auto& solution : ikfast.getSolutions(target))
+      numSolutions += solution.mValidity == Analytical::VALID;
+  }
+  std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now() - begin;
+  std::cout << "  getSolutions(): " << 1e6 * elapsed.count() / numTargets
+            << " us/target, " << numSolutions << " solutions" << std::endl;
+
+  std::vector<std::size_t> threadCounts{1u, 2u, 4u};
+  const std::size_t numHardwareThreads = std::thread::hardware_concurrency();
+  if (numHardwareThreads > 4u)
+    threadCounts.push_back(numHardwareThreads);
+
+  dynamics::IkFast::BatchSolutions solutions;
+  for (const std::size_t numThreads : threadCounts)
+  {
+    begin = std::chrono::steady_clock::now();
+    ikfast.computeBatchSolutions(targets, solutions, numThreads);
+    elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << "  computeBatchSolutions(), " << numThreads << " threads: "
+              << 1e6 * elapsed.count() / numTargets << " us/target, "
+              << solutions.mConfigs.cols() << " solutions" << std::endl;
+  }
+
+  // The same, keeping the solutions free of collisions
+  auto serialValidator = std::make_shared<planning::MotionValidator>(
+      world, wam, dofs, planning::MotionValidator::Option(0.02, 1u));
+  numSolutions = 0u;
+  begin = std::chrono::steady_clock::now();
+  for (const auto& target : targets)
+  {
+    for (const auto& solution : ikfast.getSolutions(target))
+    {
+      if (solution.mValidity == Analytical::VALID
+          && serialValidator->isValid(solution.mConfig))
+      {
+        ++numSolutions;
+      }
+    }
+  }
+  elapsed = std::chrono::steady_clock::now() - begin;
+  std::cout << "  getSolutions() and isValid(): "
+            << 1e6 * elapsed.count() / numTargets << " us/target, "
+            << numSolutions << " solutions" << std::endl;
+
+  for (const std::size_t numThreads : threadCounts)
+  {
+    auto validator = std::make_shared<planning::MotionValidator>(
+        world, wam, dofs, planning::MotionValidator::Option(0.02, numThreads));
+    begin = std::chrono::steady_clock::now();
+    ikfast.computeBatchSolutions(
+        targets,
+        solutions,
+        numThreads,
+        [&](const Eigen::MatrixXd& configs, std::vector<char>& valid) {
+          validator->validateConfigurations(configs, valid);
+        });
+    elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << "  computeBatchSolutions() and validateConfigurations(), "
+              << numThreads << " threads: "
+              << 1e6 * elapsed.count() / numTargets << " us/target, "
+              << solutions.mConfigs.cols() << " solutions" << std::endl;
+  }
+
+  return 0;
+}
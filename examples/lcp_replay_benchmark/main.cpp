@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dart/dart.hpp>
+
+// Re-solves recorded boxed LCP corpora with the Dantzig and PGS solvers and
+// reports the solve time, iterations, residual and complementarity error.
+//
+// Usage:
+//   lcp_replay_benchmark [corpus.lcp ...]
+//     Replays the given corpus files, or the checked-in corpus in data/lcp/.
+//   lcp_replay_benchmark --record <directory>
+//     Simulates the stacking, grasping and walking scenes and writes a corpus
+//     file for each of them to the directory.
+
+using namespace dart;
+
+namespace {
+
+const char* const kSceneNames[] = {"stacking", "grasping", "walking"};
+
+//==============================================================================
+dynamics::BodyNode* addBox(
+    const dynamics::SkeletonPtr& skel,
+    dynamics::BodyNode* parent,
+    const std::string& name,
+    const Eigen::Vector3d& size,
+    double mass)
+{
+  const dynamics::BodyNode::AspectProperties properties(name);
+
+  dynamics::BodyNode* body;
+  if (parent)
+  {
+    dynamics::RevoluteJoint::Properties jointProperties;
+    jointProperties.mName = name + "_joint";
+    jointProperties.mAxis = Eigen::Vector3d::UnitY();
+    body = skel->createJointAndBodyNodePair<dynamics::RevoluteJoint>(
+                   parent, jointProperties, properties)
+               .second;
+  }
+  else
+  {
+    dynamics::FreeJoint::Properties jointProperties;
+    jointProperties.mName = name + "_joint";
+    body = skel->createJointAndBodyNodePair<dynamics::FreeJoint>(
+                   nullptr, jointProperties, properties)
+               .second;
+  }
+
+  body->createShapeNodeWith<
+      dynamics::CollisionAspect,
+      dynamics::DynamicsAspect>(std::make_shared<dynamics::BoxShape>(size));
+
+  dynamics::Inertia inertia;
+  inertia.setMass(mass);
+  inertia.setMoment(dynamics::BoxShape::computeInertia(size, mass));
+  body->setInertia(inertia);
+
+  return body;
+}
+
+//==============================================================================
+simulation::WorldPtr createWorld()
+{
+  auto world = simulation::World::create();
+  world->getConstraintSolver()->setCollisionDetector(
+      collision::DARTCollisionDetector::create());
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<
+      dynamics::CollisionAspect,
+      dynamics::DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(4.0, 4.0, 0.1)));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = -0.05;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(tf);
+  world->addSkeleton(ground);
+
+  return world;
+}
+
+//==============================================================================
+/// A stack of boxes resting on the ground
+simulation::WorldPtr createStackingWorld()
+{
+  auto world = createWorld();
+
+  for (auto i = 0u; i < 4u; ++i)
+  {
+    auto skel = dynamics::Skeleton::create("box_" + std::to_string(i));
+    auto body
+        = addBox(skel, nullptr, "box", Eigen::Vector3d::Constant(0.2), 1.0);
+
+    Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+    tf.translation() = Eigen::Vector3d(0.01 * i, 0.0, 0.1 + 0.2 * i);
+    dynamics::FreeJoint::setTransformOf(body, tf);
+    world->addSkeleton(skel);
+  }
+
+  return world;
+}
+
+//==============================================================================
+/// A two-finger gripper squeezing a box on the ground and lifting it
+simulation::WorldPtr createGraspingWorld(
+    dynamics::SkeletonPtr& gripper, std::vector<double>& fingerForces)
+{
+  auto world = createWorld();
+
+  auto object = dynamics::Skeleton::create("object");
+  auto objectBody
+      = addBox(object, nullptr, "object", Eigen::Vector3d::Constant(0.1), 0.5);
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = 0.05;
+  dynamics::FreeJoint::setTransformOf(objectBody, tf);
+  world->addSkeleton(object);
+
+  gripper = dynamics::Skeleton::create("gripper");
+
+  // The base moves vertically with a velocity servo
+  dynamics::PrismaticJoint::Properties baseProperties;
+  baseProperties.mName = "base_joint";
+  baseProperties.mAxis = Eigen::Vector3d::UnitZ();
+  baseProperties.mT_ParentBodyToJoint.translation().z() = 0.2;
+  auto base = gripper
+                  ->createJointAndBodyNodePair<dynamics::PrismaticJoint>(
+                      nullptr,
+                      baseProperties,
+                      dynamics::BodyNode::AspectProperties("base"))
+                  .second;
+  base->setMass(1.0);
+  base->getParentJoint()->setActuatorType(dynamics::Joint::SERVO);
+
+  // The fingers slide along the x-axis and are driven by forces
+  const Eigen::Vector3d fingerSize(0.02, 0.05, 0.08);
+  for (const double side : {-1.0, 1.0})
+  {
+    const std::string name = side < 0.0 ? "left_finger" : "right_finger";
+    dynamics::PrismaticJoint::Properties fingerProperties;
+    fingerProperties.mName = name + "_joint";
+    fingerProperties.mAxis = Eigen::Vector3d::UnitX();
+    fingerProperties.mT_ParentBodyToJoint.translation()
+        = Eigen::Vector3d(0.08 * side, 0.0, -0.15);
+    auto finger = gripper
+                      ->createJointAndBodyNodePair<dynamics::PrismaticJoint>(
+                          base,
+                          fingerProperties,
+                          dynamics::BodyNode::AspectProperties(name))
+                      .second;
+    finger->createShapeNodeWith<
+        dynamics::CollisionAspect,
+        dynamics::DynamicsAspect>(
+        std::make_shared<dynamics::BoxShape>(fingerSize));
+    finger->setMass(0.1);
+    fingerForces.push_back(-20.0 * side);
+  }
+  world->addSkeleton(gripper);
+
+  return world;
+}
+
+//==============================================================================
+/// A box biped swinging its legs with servo-driven hip, knee and ankle joints
+simulation::WorldPtr createWalkingWorld(dynamics::SkeletonPtr& biped)
+{
+  auto world = createWorld();
+
+  biped = dynamics::Skeleton::create("biped");
+  auto pelvis
+      = addBox(biped, nullptr, "pelvis", Eigen::Vector3d(0.15, 0.3, 0.1), 5.0);
+
+  const Eigen::Vector3d limbSize(0.08, 0.08, 0.35);
+  const Eigen::Vector3d footSize(0.2, 0.1, 0.04);
+  for (const double side : {-1.0, 1.0})
+  {
+    const std::string prefix = side < 0.0 ? "right_" : "left_";
+    auto thigh = addBox(biped, pelvis, prefix + "thigh", limbSize, 2.0);
+    auto shin = addBox(biped, thigh, prefix + "shin", limbSize, 1.5);
+    auto foot = addBox(biped, shin, prefix + "foot", footSize, 0.5);
+
+    Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+    tf.translation() = Eigen::Vector3d(0.0, 0.1 * side, -0.05);
+    thigh->getParentJoint()->setTransformFromParentBodyNode(tf);
+    tf.translation() = Eigen::Vector3d(0.0, 0.0, -0.175);
+    shin->getParentJoint()->setTransformFromParentBodyNode(tf);
+    foot->getParentJoint()->setTransformFromParentBodyNode(tf);
+
+    tf.translation() = Eigen::Vector3d(0.0, 0.0, 0.175);
+    thigh->getParentJoint()->setTransformFromChildBodyNode(tf);
+    shin->getParentJoint()->setTransformFromChildBodyNode(tf);
+    tf.translation() = Eigen::Vector3d(-0.04, 0.0, 0.02);
+    foot->getParentJoint()->setTransformFromChildBodyNode(tf);
+  }
+
+  for (auto i = 6u; i < biped->getNumDofs(); ++i)
+  {
+    auto joint = biped->getDof(i)->getJoint();
+    joint->setActuatorType(dynamics::Joint::SERVO);
+    joint->setForceUpperLimit(0, 200.0);
+    joint->setForceLowerLimit(0, -200.0);
+  }
+
+  // Place the feet slightly above the ground
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = 0.8;
+  dynamics::FreeJoint::setTransformOf(pelvis, tf);
+  world->addSkeleton(biped);
+
+  return world;
+}
+
+//==============================================================================
+/// Simulates the scene and records every recordPeriod-th step
+void recordScene(
+    const std::string& scene,
+    const std::string& path,
+    std::size_t numSteps,
+    std::size_t recordPeriod)
+{
+  simulation::WorldPtr world;
+  dynamics::SkeletonPtr robot;
+  std::vector<double> fingerForces;
+  if (scene == "stacking")
+    world = createStackingWorld();
+  else if (scene == "grasping")
+    world = createGraspingWorld(robot, fingerForces);
+  else
+    world = createWalkingWorld(robot);
+
+  auto solver = dynamic_cast<constraint::BoxedLcpConstraintSolver*>(
+      world->getConstraintSolver());
+  auto recorder = std::make_shared<constraint::BoxedLcpRecorder>(path);
+  if (!solver || !recorder->isOpen())
+  {
+    std::cerr << "Failed to record the '" << scene << "' scene.\n";
+    return;
+  }
+
+  for (auto i = 0u; i < numSteps; ++i)
+  {
+    const double time = world->getTime();
+    if (scene == "grasping")
+    {
+      // Squeeze first, and then lift the object
+      robot->setCommand(0, time < 0.3 ? 0.0 : 0.2);
+      robot->setForce(1, fingerForces[0]);
+      robot->setForce(2, fingerForces[1]);
+    }
+    else if (scene == "walking")
+    {
+      // Sinusoidal gait with the legs in the opposite phase. The hips and the
+      // ankles compensate the pitch of the pelvis to keep the legs upright
+      // and the feet flat.
+      const double phase = 2.0 * math::constantsd::pi() * time;
+      const double pitch = robot->getPosition(1);
+      for (auto leg = 0u; leg < 2u; ++leg)
+      {
+        const double swing = std::sin(phase + math::constantsd::pi() * leg);
+        const double hip = -0.3 * swing - pitch;
+        const double knee = 0.6 * std::max(swing, 0.0);
+        const double targets[] = {hip, knee, -(hip + knee) - pitch};
+        for (auto j = 0u; j < 3u; ++j)
+        {
+          const auto index = 6u + 3u * leg + j;
+          robot->setCommand(
+              index, 10.0 * (targets[j] - robot->getPosition(index)));
+        }
+      }
+    }
+
+    solver->setLcpRecorder(i % recordPeriod == 0u ? recorder : nullptr);
+    world->step();
+  }
+
+  recorder->flush();
+  std::cout << "Recorded " << recorder->getNumRecords() << " problems of the '"
+            << scene << "' scene to " << path << "\n";
+}
+
+//==============================================================================
+void replay(
+    const std::string& name,
+    constraint::BoxedLcpSolver& solver,
+    const std::vector<constraint::BoxedLcpProblem>& problems)
+{
+  std::size_t numSuccesses = 0u;
+  double totalTime = 0.0;
+  double totalIterations = 0.0;
+  double maxResidual = 0.0;
+  double maxComplementarityError = 0.0;
+
+  for (const auto& problem : problems)
+  {
+    const auto result = constraint::replayBoxedLcpProblem(solver, problem);
+    if (result.success)
+      ++numSuccesses;
+    totalTime += result.time;
+    totalIterations += result.numIterations;
+    maxResidual = std::max(maxResidual, result.residual);
+    maxComplementarityError
+        = std::max(maxComplementarityError, result.complementarityError);
+  }
+
+  const auto numProblems = static_cast<double>(problems.size());
+  std::cout << "  " << name << "\n"
+            << "    Success: " << numSuccesses << " / " << problems.size()
+            << "\n"
+            << "    Solve time (mean): " << 1e6 * totalTime / numProblems
+            << " us\n"
+            << "    Iterations (mean): " << totalIterations / numProblems
+            << "\n"
+            << "    Residual (max): " << maxResidual << "\n"
+            << "    Complementarity error (max): " << maxComplementarityError
+            << "\n";
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--record" && i + 1 < argc)
+    {
+      const std::string directory = argv[i + 1];
+      for (const auto scene : kSceneNames)
+        recordScene(scene, directory + "/" + scene + ".lcp", 1000u, 100u);
+      return 0;
+    }
+
+    paths.push_back(argv[i]);
+  }
+
+  if (paths.empty())
+  {
+    for (const auto scene : kSceneNames)
+      paths.push_back(std::string(DART_DATA_PATH "lcp/") + scene + ".lcp");
+  }
+
+  constraint::DantzigBoxedLcpSolver dantzig;
+  dantzig.setUseSimdKernels(false);
+  constraint::DantzigBoxedLcpSolver dantzigSimd;
+  dantzigSimd.setUseSimdKernels(true);
+  constraint::PgsBoxedLcpSolver pgs;
+
+  for (const auto& path : paths)
+  {
+    std::vector<constraint::BoxedLcpProblem> problems;
+    if (!constraint::loadBoxedLcpCorpus(path, problems) || problems.empty())
+      continue;
+
+    double meanDimension = 0.0;
+    for (const auto& problem : problems)
+      meanDimension += problem.getDimension();
+    meanDimension /= static_cast<double>(problems.size());
+
+    std::cout << path << "\n"
+              << "  Problems: " << problems.size()
+              << ", dimension (mean): " << meanDimension << "\n";
+    replay("Dantzig", dantzig, problems);
+    if (constraint::DantzigBoxedLcpSolver::isSimdKernelSupported())
+      replay("Dantzig (SIMD kernels)", dantzigSimd, problems);
+    replay("PGS", pgs, problems);
+    std::cout << std::endl;
+  }
+
+  return 0;
+}
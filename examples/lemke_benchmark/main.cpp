@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <string>
+
+#include <dart/dart.hpp>
+
+// Compares lcpsolver::Lemke(), which factorizes the basis from scratch at
+// every pivot, with lcpsolver::LemkeSolver, which updates the factorization.
+// The problems are the 4D and 6D inputs of test_Lemke and random problems with
+// 10 to 400 variables. For LemkeSolver it also reports a warm start from the
+// basis of the same problem, solving it again with q perturbed by 1e-6.
+//
+// Usage:
+//   lemke_benchmark [repetitions]
+
+using namespace dart;
+
+namespace {
+
+//==============================================================================
+double bestTime(
+    const std::function<void()>& function,
+    int repetitions,
+    const std::function<void()>& setup = nullptr)
+{
+  double best = std::numeric_limits<double>::infinity();
+  for (int k = 0; k < repetitions; ++k)
+  {
+    if (setup)
+      setup();
+
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end - start).count());
+  }
+
+  return best;
+}
+
+//==============================================================================
+void benchmark(
+    const std::string& name,
+    const Eigen::MatrixXd& M,
+    const Eigen::VectorXd& q,
+    int repetitions)
+{
+  Eigen::VectorXd z;
+  int lemkeErr = 0;
+  const double lemkeTime = bestTime(
+      [&]() { lemkeErr = lcpsolver::Lemke(M, q, &z); }, repetitions);
+
+  lcpsolver::LemkeSolver solver;
+  int solverErr = 0;
+  const double solverTime = bestTime(
+      [&]() { solverErr = solver.solve(M, q, z); }, repetitions);
+  const int numPivots = solver.getLastNumIterations();
+
+  const Eigen::VectorXd perturbedQ
+      = q + 1e-6 * Eigen::VectorXd::Random(q.size());
+  const double warmTime = bestTime(
+      [&]() { solver.solve(M, perturbedQ, z, true); },
+      repetitions,
+      [&]() { solver.solve(M, q, z); });
+  const int numWarmPivots = solver.getLastNumIterations();
+
+  std::printf(
+      "%-10s | %6d | %3d %11.1f us | %3d %11.1f us | %7.1fx | %6d %9.1f us\n",
+      name.c_str(),
+      numPivots,
+      lemkeErr,
+      1e6 * lemkeTime,
+      solverErr,
+      1e6 * solverTime,
+      lemkeTime / solverTime,
+      numWarmPivots,
+      1e6 * warmTime);
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  const int repetitions = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+
+  std::printf(
+      "%-10s | %6s | %-18s | %-18s | %8s | %-19s\n",
+      "problem",
+      "pivots",
+      "Lemke (err, time)",
+      "LemkeSolver",
+      "speedup",
+      "warm start (pivots)");
+
+  Eigen::MatrixXd M(4, 4);
+  M << 3.999, 0.9985, 1.001, -2, 0.9985, 3.998, -2, 0.9995, 1.001, -2, 4.002,
+      1.001, -2, 0.9995, 1.001, 4.001;
+  Eigen::VectorXd q(4);
+  q << -0.01008, -0.009494, -0.07234, -0.07177;
+  benchmark("Lemke_4D", M, q, repetitions);
+
+  M.resize(6, 6);
+  M << 3.1360, -2.0370, 0.9723, 0.1096, -2.0370, 0.9723, -2.0370, 3.7820,
+      0.8302, -0.0257, 2.4730, 0.0105, 0.9723, 0.8302, 5.1250, -2.2390, -1.9120,
+      3.4080, 0.1096, -0.0257, -2.2390, 3.1010, -0.0257, -2.2390, -2.0370,
+      2.4730, -1.9120, -0.0257, 5.4870, -0.0242, 0.9723, 0.0105, 3.4080,
+      -2.2390, -0.0242, 3.3860;
+  q.resize(6);
+  q << 0.1649, -0.0025, -0.0904, -0.0093, -0.0000, -0.0889;
+  benchmark("Lemke_6D", M, q, repetitions);
+
+  for (const int n : {10, 25, 50, 100, 200, 400})
+  {
+    const Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+    M = J * J.transpose() + 0.1 * Eigen::MatrixXd::Identity(n, n);
+    q = Eigen::VectorXd::Random(n);
+    benchmark("random_" + std::to_string(n), M, q, n < 200 ? repetitions : 1);
+  }
+
+  return 0;
+}
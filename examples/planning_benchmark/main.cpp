@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dart/dart.hpp>
+#include <dart/planning/planning.hpp>
+#include <dart/utils/urdf/urdf.hpp>
+
+// Measures the throughput of the planners of dart-planning on the WAM arm and
+// the left arm of Atlas from data/ among box obstacles, and the scaling of the
+// nearest neighbor queries of planning::KdTree, which the planners use, up to
+// 10^5 nodes. RRT-Connect is run with the collision checks of the whole world
+// and with planning::MotionValidator, which also validates the motions, and
+// the motion checks are compared on their own. The paths of RRT-Connect are
+// shortened by planning::PathShortener and by planning::PathShortcutter.
+//
+// Usage:
+//   planning_benchmark [num_queries] [num_rrt_star_iterations]
+
+using namespace dart;
+
+struct Scenario
+{
+  std::string mName;
+  simulation::WorldPtr mWorld;
+  dynamics::SkeletonPtr mRobot;
+  std::vector<std::size_t> mDofs;
+};
+
+//==============================================================================
+void addBox(
+    const simulation::WorldPtr& world,
+    const std::string& name,
+    const Eigen::Vector3d& size,
+    const Eigen::Vector3d& position)
+{
+  auto box = dynamics::Skeleton::create(name);
+  auto body = box->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation() = position;
+  body->getParentJoint()->setTransformFromParentBodyNode(tf);
+  body->createShapeNodeWith<dynamics::CollisionAspect>(
+      std::make_shared<dynamics::BoxShape>(size));
+  world->addSkeleton(box);
+}
+
+//==============================================================================
+std::vector<std::size_t> getDofIndices(
+    const dynamics::SkeletonPtr& robot, const std::vector<std::string>& names)
+{
+  std::vector<std::size_t> dofs;
+  for (const std::string& name : names)
+    dofs.push_back(robot->getDof(name)->getIndexInSkeleton());
+
+  return dofs;
+}
+
+//==============================================================================
+Scenario createWamScenario()
+{
+  utils::DartLoader loader;
+  loader.addPackageDirectory("herb_description", DART_DATA_PATH "/urdf/wam");
+
+  Scenario scenario;
+  scenario.mName = "WAM (7 DOFs)";
+  scenario.mWorld = simulation::World::create();
+  scenario.mRobot = loader.parseSkeleton(DART_DATA_PATH "/urdf/wam/wam.urdf");
+  scenario.mWorld->addSkeleton(scenario.mRobot);
+  scenario.mDofs = getDofIndices(
+      scenario.mRobot, {"/j1", "/j2", "/j3", "/j4", "/j5", "/j6", "/j7"});
+
+  // A shelf in front of the arm and a pole beside it
+  addBox(
+      scenario.mWorld,
+      "shelf",
+      Eigen::Vector3d(0.3, 0.8, 0.04),
+      Eigen::Vector3d(0.55, 0.0, 0.7));
+  addBox(
+      scenario.mWorld,
+      "pole",
+      Eigen::Vector3d(0.08, 0.08, 1.5),
+      Eigen::Vector3d(0.0, 0.5, 0.75));
+
+  return scenario;
+}
+
+//==============================================================================
+Scenario createAtlasScenario()
+{
+  utils::DartLoader loader;
+
+  Scenario scenario;
+  scenario.mName = "Atlas left arm (6 DOFs)";
+  scenario.mWorld = simulation::World::create();
+  scenario.mRobot = loader.parseSkeleton(
+      "dart://sample/sdf/atlas/atlas_v3_no_head.urdf");
+  scenario.mWorld->addSkeleton(scenario.mRobot);
+  scenario.mDofs = getDofIndices(
+      scenario.mRobot,
+      {"l_arm_shy", "l_arm_shx", "l_arm_ely", "l_arm_elx", "l_arm_wry",
+       "l_arm_wrx"});
+
+  // A table in front of the robot and a wall on its left
+  addBox(
+      scenario.mWorld,
+      "table",
+      Eigen::Vector3d(0.6, 1.0, 0.04),
+      Eigen::Vector3d(0.6, 0.3, 0.1));
+  addBox(
+      scenario.mWorld,
+      "wall",
+      Eigen::Vector3d(1.0, 0.04, 1.0),
+      Eigen::Vector3d(0.3, 0.9, 0.4));
+
+  return scenario;
+}
+
+//==============================================================================
+Eigen::VectorXd sampleFreeConfig(const Scenario& scenario)
+{
+  const auto& robot = scenario.mRobot;
+  Eigen::VectorXd lower(scenario.mDofs.size());
+  Eigen::VectorXd upper(scenario.mDofs.size());
+  for (std::size_t i = 0u; i < scenario.mDofs.size(); ++i)
+  {
+    lower[i] = robot->getPositionLowerLimit(scenario.mDofs[i]);
+    upper[i] = robot->getPositionUpperLimit(scenario.mDofs[i]);
+  }
+
+  Eigen::VectorXd config;
+  do
+  {
+    config = math::Random::uniform<Eigen::VectorXd>(lower, upper);
+    robot->setPositions(scenario.mDofs, config);
+  } while (scenario.mWorld->checkCollision());
+
+  return config;
+}
+
+//==============================================================================
+double computePathLength(const std::list<Eigen::VectorXd>& path)
+{
+  double length = 0.0;
+  for (auto it = path.begin(); it != path.end() && std::next(it) != path.end();
+       ++it)
+    length += (*std::next(it) - *it).norm();
+
+  return length;
+}
+
+//==============================================================================
+void runPlanners(
+    const Scenario& scenario,
+    std::size_t numQueries,
+    std::size_t numRrtStarIterations)
+{
+  std::vector<std::pair<Eigen::VectorXd, Eigen::VectorXd>> queries;
+  for (std::size_t i = 0u; i < numQueries; ++i)
+  {
+    const Eigen::VectorXd start = sampleFreeConfig(scenario);
+    queries.emplace_back(start, sampleFreeConfig(scenario));
+  }
+
+  const double stepSize = 0.05;
+  std::list<Eigen::VectorXd> path;
+
+  std::cout << scenario.mName << "\n";
+
+  // RRT-Connect, with the collision checks of the whole world or with a
+  // motion validator. With longer steps, the validator checks the motions at
+  // its resolution, either when the nodes are added or lazily.
+  const auto runRrtConnect = [&](
+      const std::string& label,
+      double rrtStepSize,
+      std::shared_ptr<planning::MotionValidator> validator,
+      bool lazy) {
+    planning::RRTConnect rrtConnect(
+        scenario.mWorld, scenario.mRobot, scenario.mDofs, rrtStepSize);
+    rrtConnect.setMotionValidator(validator, lazy);
+
+    std::size_t numSolved = 0u;
+    std::size_t numNodes = 0u;
+    double length = 0.0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (const auto& query : queries)
+    {
+      if (rrtConnect.plan(query.first, query.second, path))
+      {
+        ++numSolved;
+        length += computePathLength(path);
+      }
+      numNodes += rrtConnect.getSize();
+    }
+    const std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - begin;
+
+    std::cout << "  RRT-Connect (" << label
+              << "): " << numQueries / elapsed.count() << " plans/s, "
+              << 100.0 * numSolved / numQueries << " % solved, "
+              << numNodes / numQueries << " nodes/plan, path length "
+              << length / std::max<std::size_t>(numSolved, 1u) << "\n";
+  };
+
+  const double resolution = stepSize;
+  auto validator = std::make_shared<planning::MotionValidator>(
+      scenario.mWorld,
+      scenario.mRobot,
+      scenario.mDofs,
+      planning::MotionValidator::Option(resolution, 0u));
+
+  runRrtConnect("world collision checks", stepSize, nullptr, false);
+  runRrtConnect("motion validator", stepSize, validator, false);
+  runRrtConnect("motion validator, 4x step", 4.0 * stepSize, validator, false);
+  runRrtConnect(
+      "lazy motion validator, 4x step", 4.0 * stepSize, validator, true);
+
+  // Motion checks between the query configurations, most of which collide:
+  // the whole world at every resolution step in order, like the planners did
+  // before, and the validator in bisection order. The world is checked with
+  // the collision filter of the validator, so that the results agree.
+  const collision::CollisionOption worldOption(
+      false,
+      1u,
+      scenario.mWorld->getConstraintSolver()
+          ->getCollisionOption()
+          .collisionFilter);
+  std::size_t numValid = 0u;
+  auto begin = std::chrono::steady_clock::now();
+  for (const auto& query : queries)
+  {
+    const Eigen::VectorXd& from = query.first;
+    const Eigen::VectorXd& to = query.second;
+    const int numSegments = static_cast<int>(
+        std::ceil((to - from).norm() / resolution - 1e-9));
+    bool valid = true;
+    for (int i = 1; i < numSegments && valid; ++i)
+    {
+      scenario.mRobot->setPositions(
+          scenario.mDofs,
+          from + (static_cast<double>(i) / numSegments) * (to - from));
+      valid = !scenario.mWorld->checkCollision(worldOption);
+    }
+    numValid += valid;
+  }
+  std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now() - begin;
+
+  std::size_t numValidatorValid = 0u;
+  validator->resetNumQueries();
+  begin = std::chrono::steady_clock::now();
+  for (const auto& query : queries)
+    numValidatorValid += validator->isValid(query.first, query.second);
+  const std::chrono::duration<double> validatorElapsed
+      = std::chrono::steady_clock::now() - begin;
+
+  std::cout << "  Motion checks: world in order "
+            << 1e6 * elapsed.count() / numQueries
+            << " us/motion, validator in bisection order "
+            << 1e6 * validatorElapsed.count() / numQueries << " us/motion ("
+            << validator->getNumQueries() / numQueries << " queries/motion), "
+            << numValid << " / " << numValidatorValid << " valid\n";
+
+  // Path shortening of the RRT-Connect paths: the random shortcuts of
+  // planning::PathShortener one at a time, and the batches of
+  // planning::PathShortcutter checked by one thread or by all of them, with
+  // full or partial shortcuts and followed by smoothing
+  std::vector<std::list<Eigen::VectorXd>> paths;
+  planning::RRTConnect rrtConnect(
+      scenario.mWorld, scenario.mRobot, scenario.mDofs, stepSize);
+  rrtConnect.setMotionValidator(validator);
+  for (const auto& query : queries)
+  {
+    if (rrtConnect.plan(query.first, query.second, path))
+      paths.push_back(path);
+  }
+
+  const auto runShortening
+      = [&](const std::string& label,
+            const std::function<void(std::list<Eigen::VectorXd>&)>& shorten) {
+          double originalLength = 0.0;
+          double shortenedLength = 0.0;
+          const auto shorteningBegin = std::chrono::steady_clock::now();
+          for (const auto& original : paths)
+          {
+            path = original;
+            shorten(path);
+            originalLength += computePathLength(original);
+            shortenedLength += computePathLength(path);
+          }
+          const std::chrono::duration<double> shorteningElapsed
+              = std::chrono::steady_clock::now() - shorteningBegin;
+
+          const double numPaths = std::max<std::size_t>(paths.size(), 1u);
+          std::cout << "  Shortening (" << label
+                    << "): " << 1e3 * shorteningElapsed.count() / numPaths
+                    << " ms/path, path length " << originalLength / numPaths
+                    << " -> " << shortenedLength / numPaths << "\n";
+        };
+
+  planning::PathShortener shortener(
+      scenario.mWorld, scenario.mRobot, scenario.mDofs, resolution);
+  shortener.setMotionValidator(validator);
+  runShortening("PathShortener", [&](std::list<Eigen::VectorXd>& shortened) {
+    shortener.shortenPath(shortened);
+  });
+
+  auto serialValidator = std::make_shared<planning::MotionValidator>(
+      scenario.mWorld,
+      scenario.mRobot,
+      scenario.mDofs,
+      planning::MotionValidator::Option(resolution, 1u));
+  planning::PathShortcutter serialShortcutter(serialValidator);
+  runShortening(
+      "PathShortcutter, 1 thread", [&](std::list<Eigen::VectorXd>& shortened) {
+        serialShortcutter.shortcut(shortened);
+      });
+
+  planning::PathShortcutter shortcutter(validator);
+  runShortening(
+      "PathShortcutter, hardware threads",
+      [&](std::list<Eigen::VectorXd>& shortened) {
+        shortcutter.shortcut(shortened);
+      });
+
+  planning::PathShortcutter partialShortcutter(
+      validator, planning::PathShortcutter::Option(50u, 32u, 0.5));
+  runShortening(
+      "PathShortcutter, partial shortcuts, smoothing",
+      [&](std::list<Eigen::VectorXd>& shortened) {
+        partialShortcutter.shortcut(shortened);
+        partialShortcutter.smooth(shortened);
+      });
+
+  // RRT* with a fixed number of iterations
+  std::size_t numSolved = 0u;
+  std::size_t numNodes = 0u;
+  double length = 0.0;
+  begin = std::chrono::steady_clock::now();
+  for (const auto& query : queries)
+  {
+    planning::RRTStar rrtStar(
+        scenario.mWorld,
+        scenario.mRobot,
+        scenario.mDofs,
+        query.first,
+        stepSize);
+    if (rrtStar.plan(query.second, path, numRrtStarIterations))
+    {
+      ++numSolved;
+      length += computePathLength(path);
+    }
+    numNodes += rrtStar.getSize();
+  }
+  elapsed = std::chrono::steady_clock::now() - begin;
+
+  std::cout << "  RRT* (" << numRrtStarIterations
+            << " iterations): " << numQueries / elapsed.count()
+            << " plans/s, " << 100.0 * numSolved / numQueries << " % solved, "
+            << numNodes / numQueries << " nodes/plan, path length "
+            << length / std::max<std::size_t>(numSolved, 1u) << "\n"
+            << std::endl;
+}
+
+//==============================================================================
+void runNearestNeighbors()
+{
+  const std::size_t dimension = 7u;
+  const std::size_t numQueries = 1000u;
+  const Eigen::VectorXd lower = Eigen::VectorXd::Constant(dimension, -3.0);
+  const Eigen::VectorXd upper = Eigen::VectorXd::Constant(dimension, 3.0);
+
+  std::vector<Eigen::VectorXd> queries;
+  for (std::size_t i = 0u; i < numQueries; ++i)
+    queries.push_back(math::Random::uniform<Eigen::VectorXd>(lower, upper));
+
+  std::cout << "Nearest neighbor in " << dimension << "D" << std::endl;
+  for (std::size_t numPoints : {1000u, 10000u, 100000u})
+  {
+    planning::KdTree tree(dimension);
+    std::vector<Eigen::VectorXd> points;
+    for (std::size_t i = 0u; i < numPoints; ++i)
+      points.push_back(math::Random::uniform<Eigen::VectorXd>(lower, upper));
+
+    auto begin = std::chrono::steady_clock::now();
+    for (const Eigen::VectorXd& point : points)
+      tree.addPoint(point);
+    const std::chrono::duration<double> insertTime
+        = std::chrono::steady_clock::now() - begin;
+
+    std::size_t checksum = 0u;
+    begin = std::chrono::steady_clock::now();
+    for (const Eigen::VectorXd& query : queries)
+      checksum += tree.getNearest(query);
+    const std::chrono::duration<double> treeTime
+        = std::chrono::steady_clock::now() - begin;
+
+    begin = std::chrono::steady_clock::now();
+    for (const Eigen::VectorXd& query : queries)
+    {
+      std::size_t nearest = 0u;
+      double best = std::numeric_limits<double>::infinity();
+      for (std::size_t i = 0u; i < points.size(); ++i)
+      {
+        const double distance = (query - points[i]).squaredNorm();
+        if (distance < best)
+        {
+          best = distance;
+          nearest = i;
+        }
+      }
+      checksum -= nearest;
+    }
+    const std::chrono::duration<double> linearTime
+        = std::chrono::steady_clock::now() - begin;
+
+    std::cout << "  " << numPoints << " points: insertion "
+              << 1e6 * insertTime.count() / numPoints << " us/point, k-d tree "
+              << 1e6 * treeTime.count() / numQueries << " us/query, linear "
+              << 1e6 * linearTime.count() / numQueries << " us/query"
+              << (checksum == 0u ? "" : " (MISMATCH)") << "\n";
+  }
+  std::cout << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  std::size_t numQueries = 50u;
+  std::size_t numRrtStarIterations = 2000u;
+  if (argc > 1)
+    numQueries = static_cast<std::size_t>(std::stoul(argv[1]));
+  if (argc > 2)
+    numRrtStarIterations = static_cast<std::size_t>(std::stoul(argv[2]));
+
+  math::Random::setSeed(0u);
+
+  runNearestNeighbors();
+  runPlanners(createWamScenario(), numQueries, numRrtStarIterations);
+  runPlanners(createAtlasScenario(), numQueries, numRrtStarIterations);
+
+  return 0;
+}
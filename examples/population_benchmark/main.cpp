@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dart/dart.hpp>
+
+// Measures the time to evaluate populations of the ZDT1 problem of
+// test_MultiObjectiveOptimization, scaled up to 30 decision variables, with
+// optimizer::PopulationEvaluator on increasing numbers of threads and child
+// processes. The problem is evaluated as is, which takes microseconds, and
+// with a physics rollout of a pendulum chain per decision vector, like the
+// fitness evaluations of design-space sweeps. The fitness vectors are checked
+// to be identical to the ones evaluated serially.
+//
+// Usage:
+//   population_benchmark [population_size]
+
+using namespace dart;
+
+static const std::size_t dimension = 30u;
+
+//==============================================================================
+double computeZdt1(const Eigen::VectorXd& x)
+{
+  const double g = 1.0 + 9.0 * (x.sum() - x[0]) / (x.size() - 1.0);
+  return g * (1.0 - std::sqrt(x[0] / g));
+}
+
+//==============================================================================
+/// ZDT1 whose second objective also depends on the kinetic energy of a
+/// pendulum chain after a rollout, whose initial positions and joint damping
+/// are given by the decision vector
+class RolloutProblem : public optimizer::MultiObjectiveProblem
+{
+public:
+  explicit RolloutProblem(std::size_t numSteps)
+    : MultiObjectiveProblem(dimension), mNumSteps(numSteps)
+  {
+    setLowerBounds(Eigen::VectorXd::Zero(dimension));
+    setUpperBounds(Eigen::VectorXd::Ones(dimension));
+
+    auto chain = dynamics::Skeleton::create("chain");
+    dynamics::BodyNode* parent = nullptr;
+    for (std::size_t i = 0u; i < 10u; ++i)
+    {
+      dynamics::RevoluteJoint::Properties properties;
+      properties.mName = "joint_" + std::to_string(i);
+      properties.mAxis = Eigen::Vector3d::UnitY();
+      if (parent)
+        properties.mT_ParentBodyToJoint.translation().z() = -0.2;
+
+      parent = chain
+                   ->createJointAndBodyNodePair<dynamics::RevoluteJoint>(
+                       parent,
+                       properties,
+                       dynamics::BodyNode::AspectProperties(
+                           "body_" + std::to_string(i)))
+                   .second;
+      parent->setLocalCOM(Eigen::Vector3d(0.0, 0.0, -0.1));
+    }
+
+    mWorld = simulation::World::create();
+    mWorld->addSkeleton(chain);
+  }
+
+  RolloutProblem(const RolloutProblem& other)
+    : MultiObjectiveProblem(other),
+      mWorld(other.mWorld->clone()),
+      mNumSteps(other.mNumSteps)
+  {
+    // Do nothing
+  }
+
+  std::size_t getObjectiveDimension() const override
+  {
+    return 2u;
+  }
+
+  Eigen::VectorXd evaluateObjectives(const Eigen::VectorXd& x) const override
+  {
+    const dynamics::SkeletonPtr chain = mWorld->getSkeleton(0u);
+    const auto numDofs = static_cast<int>(chain->getNumDofs());
+    chain->setPositions(x.head(numDofs));
+    chain->resetVelocities();
+    for (int i = 0; i < numDofs; ++i)
+      chain->getDof(i)->setDampingCoefficient(x[numDofs + i]);
+
+    mWorld->reset();
+    for (std::size_t i = 0u; i < mNumSteps; ++i)
+      mWorld->step();
+
+    return Eigen::Vector2d(
+        x[0], computeZdt1(x) + 1e-3 * chain->computeKineticEnergy());
+  }
+
+  std::shared_ptr<MultiObjectiveProblem> clone() const override
+  {
+    return std::make_shared<RolloutProblem>(*this);
+  }
+
+protected:
+  /// The rollouts change the world, so every thread needs its own clone
+  mutable simulation::WorldPtr mWorld;
+
+  /// Number of the time steps of a rollout
+  std::size_t mNumSteps;
+};
+
+//==============================================================================
+std::shared_ptr<optimizer::MultiObjectiveProblem> createZdt1()
+{
+  auto problem
+      = std::make_shared<optimizer::GenericMultiObjectiveProblem>(dimension);
+  problem->setLowerBounds(Eigen::VectorXd::Zero(dimension));
+  problem->setUpperBounds(Eigen::VectorXd::Ones(dimension));
+
+  auto f1 = std::make_shared<optimizer::ModularFunction>();
+  f1->setCostFunction([](const Eigen::VectorXd& x) { return x[0]; });
+  auto f2 = std::make_shared<optimizer::ModularFunction>();
+  f2->setCostFunction(computeZdt1);
+  f1->setThreadSafe(true);
+  f2->setThreadSafe(true);
+  problem->setObjectiveFunctions({f1, f2});
+
+  return problem;
+}
+
+//==============================================================================
+void run(
+    const std::string& label,
+    const std::shared_ptr<optimizer::MultiObjectiveProblem>& problem,
+    const Eigen::MatrixXd& xs)
+{
+  using Parallelism = optimizer::PopulationEvaluator::Parallelism;
+
+  std::cout << label << ", " << xs.cols() << " decision vectors\n";
+
+  std::vector<std::size_t> numWorkers{1u, 2u, 4u};
+  const std::size_t hardware = common::ThreadPool::getHardwareConcurrency();
+  if (std::find(numWorkers.begin(), numWorkers.end(), hardware)
+      == numWorkers.end())
+    numWorkers.push_back(hardware);
+
+  Eigen::MatrixXd expected;
+  double serialTime = 0.0;
+  for (const Parallelism parallelism :
+       {Parallelism::Threads, Parallelism::Processes})
+  {
+    for (const std::size_t num : numWorkers)
+    {
+      if (parallelism == Parallelism::Processes && num == 1u)
+        continue;
+
+      optimizer::PopulationEvaluator evaluator(
+          problem, optimizer::PopulationEvaluator::Option(num, parallelism));
+
+      Eigen::MatrixXd fitness;
+      const auto begin = std::chrono::steady_clock::now();
+      evaluator.evaluate(xs, fitness);
+      const std::chrono::duration<double> elapsed
+          = std::chrono::steady_clock::now() - begin;
+
+      if (expected.size() == 0)
+      {
+        expected = fitness;
+        serialTime = elapsed.count();
+      }
+
+      std::cout << "  " << num << " "
+                << (parallelism == Parallelism::Threads ? "threads"
+                                                        : "processes")
+                << ": " << 1e3 * elapsed.count() << " ms, speedup "
+                << serialTime / elapsed.count() << ", "
+                << (fitness == expected ? "identical" : "DIFFERENT")
+                << " fitness\n";
+    }
+  }
+
+  std::cout << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  std::size_t populationSize = 2000u;
+  if (argc > 1)
+    populationSize = static_cast<std::size_t>(std::stoul(argv[1]));
+
+  math::Random::setSeed(0u);
+
+  const Eigen::VectorXd lower = Eigen::VectorXd::Zero(dimension);
+  const Eigen::VectorXd upper = Eigen::VectorXd::Ones(dimension);
+
+  Eigen::MatrixXd xs(dimension, static_cast<int>(populationSize));
+  for (int i = 0; i < xs.cols(); ++i)
+    xs.col(i) = math::Random::uniform<Eigen::VectorXd>(lower, upper);
+
+  run("ZDT1", createZdt1(), xs);
+
+  // The rollouts take much longer, so fewer decision vectors are evaluated
+  const int numRollouts = static_cast<int>(populationSize / 10u);
+  run("ZDT1 with 200-step rollouts",
+      std::make_shared<RolloutProblem>(200u),
+      xs.leftCols(numRollouts));
+
+  return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <dart/dart.hpp>
+
+// Compares the step time of piles of boxes with and without sleeping of
+// resting islands (World::SleepingOption). The piles settle during the first
+// second; the step time is measured over the rest of the simulation.
+//
+// Usage:
+//   sleeping_benchmark [--dart] [num_piles_per_side] [num_steps]
+
+using namespace dart;
+
+//==============================================================================
+simulation::WorldPtr createWorld(std::size_t numPilesPerSide)
+{
+  auto world = simulation::World::create();
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<
+      dynamics::CollisionAspect,
+      dynamics::DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(20.0, 20.0, 0.1)));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = -0.05;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(tf);
+  world->addSkeleton(ground);
+
+  const auto box
+      = std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(0.2, 0.2, 0.2));
+
+  // Each pile is a stack of three boxes, apart from the other piles
+  for (auto i = 0u; i < numPilesPerSide; ++i)
+  {
+    for (auto j = 0u; j < numPilesPerSide; ++j)
+    {
+      for (auto k = 0u; k < 3u; ++k)
+      {
+        auto skel = dynamics::Skeleton::create(
+            "box_" + std::to_string(i) + "_" + std::to_string(j) + "_"
+            + std::to_string(k));
+        auto body
+            = skel->createJointAndBodyNodePair<dynamics::FreeJoint>().second;
+        body->createShapeNodeWith<
+            dynamics::CollisionAspect,
+            dynamics::DynamicsAspect>(box);
+
+        tf.translation() = Eigen::Vector3d(0.5 * i, 0.5 * j, 0.1 + 0.2 * k);
+        dynamics::FreeJoint::setTransformOf(body, tf);
+        world->addSkeleton(skel);
+      }
+    }
+  }
+
+  return world;
+}
+
+//==============================================================================
+simulation::WorldPtr runBenchmark(
+    const collision::CollisionDetectorPtr& collisionDetector,
+    std::size_t numPilesPerSide,
+    std::size_t numSteps,
+    bool sleeping)
+{
+  auto world = createWorld(numPilesPerSide);
+  if (collisionDetector)
+  {
+    world->getConstraintSolver()->setCollisionDetector(
+        collisionDetector->cloneWithoutCollisionObjects());
+  }
+
+  simulation::World::SleepingOption option;
+  option.mEnabled = sleeping;
+  world->setSleepingOption(option);
+
+  const auto numSettlingSteps
+      = static_cast<std::size_t>(1.0 / world->getTimeStep());
+  std::chrono::duration<double> elapsed(0.0);
+  std::size_t numMeasuredSteps = 0u;
+
+  for (auto i = 0u; i < numSteps; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    world->step();
+    if (i < numSettlingSteps)
+      continue;
+
+    elapsed += std::chrono::steady_clock::now() - start;
+    ++numMeasuredSteps;
+  }
+
+  std::cout << "Sleeping: " << (sleeping ? "enabled" : "disabled") << "\n"
+            << "  Sleeping skeletons: " << world->getNumSleepingSkeletons()
+            << " / " << world->getNumSkeletons() - 1u << "\n";
+  if (numMeasuredSteps > 0u)
+  {
+    std::cout << "  Step time after settling: "
+              << 1e3 * elapsed.count() / numMeasuredSteps << " ms\n";
+  }
+  std::cout << std::endl;
+
+  return world;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  collision::CollisionDetectorPtr collisionDetector;
+  std::size_t numPilesPerSide = 6u;
+  std::size_t numSteps = 3000u;
+  bool hasNumPiles = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--dart")
+    {
+      collisionDetector = collision::DARTCollisionDetector::create();
+    }
+    else if (!hasNumPiles)
+    {
+      numPilesPerSide = static_cast<std::size_t>(std::stoul(argv[i]));
+      hasNumPiles = true;
+    }
+    else
+    {
+      numSteps = static_cast<std::size_t>(std::stoul(argv[i]));
+    }
+  }
+
+  const auto awakeWorld
+      = runBenchmark(collisionDetector, numPilesPerSide, numSteps, false);
+  const auto sleepingWorld
+      = runBenchmark(collisionDetector, numPilesPerSide, numSteps, true);
+
+  // The boxes rest where they would without sleeping
+  double maxDifference = 0.0;
+  for (auto i = 1u; i < awakeWorld->getNumSkeletons(); ++i)
+  {
+    const Eigen::VectorXd difference
+        = awakeWorld->getSkeleton(i)->getPositions()
+          - sleepingWorld->getSkeleton(i)->getPositions();
+    maxDifference = std::max(maxDifference, difference.cwiseAbs().maxCoeff());
+  }
+  std::cout << "Max position difference: " << maxDifference << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <chrono>
+#include <iostream>
+
+#include <dart/dart.hpp>
+
+// Compares the throughput and the accuracy of boxes thrown onto the ground
+// and onto each other with and without speculative contacts
+// (ConstraintSolver::setSpeculativeContactMargin()) at increasing time steps.
+// The accuracy is measured by the deepest penetration during the simulation
+// and by the number of boxes that tunneled through the ground.
+//
+// Usage:
+//   speculative_contact_benchmark [num_boxes_per_side] [duration]
+
+using namespace dart;
+
+//==============================================================================
+simulation::WorldPtr createWorld(
+    std::size_t numBoxesPerSide, double timeStep, double speculativeMargin)
+{
+  auto world = simulation::World::create();
+  world->setTimeStep(timeStep);
+
+  auto solver = world->getConstraintSolver();
+  solver->setCollisionDetector(collision::DARTCollisionDetector::create());
+  solver->setSpeculativeContactMargin(speculativeMargin);
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<
+      dynamics::CollisionAspect,
+      dynamics::DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(20.0, 20.0, 0.1)));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = -0.05;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(tf);
+  world->addSkeleton(ground);
+
+  const auto box
+      = std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(0.2, 0.2, 0.2));
+
+  // Two layers of boxes thrown downward; the upper layer lands on the lower
+  // one after it has hit the ground.
+  for (auto i = 0u; i < numBoxesPerSide; ++i)
+  {
+    for (auto j = 0u; j < numBoxesPerSide; ++j)
+    {
+      for (auto k = 0u; k < 2u; ++k)
+      {
+        auto skel = dynamics::Skeleton::create(
+            "box_" + std::to_string(i) + "_" + std::to_string(j) + "_"
+            + std::to_string(k));
+        auto pair = skel->createJointAndBodyNodePair<dynamics::FreeJoint>();
+        pair.second->createShapeNodeWith<
+            dynamics::CollisionAspect,
+            dynamics::DynamicsAspect>(box);
+
+        Eigen::Vector6d positions = Eigen::Vector6d::Zero();
+        positions[3] = 0.5 * i;
+        positions[4] = 0.5 * j;
+        positions[5] = 0.5 + 1.0 * k;
+        pair.first->setPositions(positions);
+        pair.first->setVelocity(5, -10.0 - 2.0 * ((i + j) % 3));
+        world->addSkeleton(skel);
+      }
+    }
+  }
+
+  return world;
+}
+
+//==============================================================================
+void runBenchmark(
+    std::size_t numBoxesPerSide,
+    double duration,
+    double timeStep,
+    double speculativeMargin)
+{
+  auto world = createWorld(numBoxesPerSide, timeStep, speculativeMargin);
+
+  const auto numSteps = static_cast<std::size_t>(duration / timeStep + 0.5);
+  std::chrono::duration<double> elapsed(0.0);
+  double maxPenetration = 0.0;
+
+  for (auto i = 0u; i < numSteps; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    world->step();
+    elapsed += std::chrono::steady_clock::now() - start;
+
+    for (const auto& contact : world->getLastCollisionResult().getContacts())
+      maxPenetration = std::max(maxPenetration, contact.penetrationDepth);
+  }
+
+  std::size_t numTunneled = 0u;
+  for (auto i = 1u; i < world->getNumSkeletons(); ++i)
+  {
+    const auto* body = world->getSkeleton(i)->getBodyNode(0);
+    if (body->getTransform().translation().z() < 0.0)
+      ++numTunneled;
+  }
+
+  std::cout << "Time step: " << 1e3 * timeStep << " ms, speculative contacts: "
+            << (speculativeMargin > 0.0 ? "enabled" : "disabled") << "\n"
+            << "  Wall time: " << 1e3 * elapsed.count() << " ms ("
+            << duration / elapsed.count() << "x real time)\n"
+            << "  Max penetration: " << 1e3 * maxPenetration << " mm\n"
+            << "  Tunneled boxes: " << numTunneled << " / "
+            << world->getNumSkeletons() - 1u << "\n"
+            << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  std::size_t numBoxesPerSide = 6u;
+  double duration = 2.0;
+  if (argc > 1)
+    numBoxesPerSide = static_cast<std::size_t>(std::stoul(argv[1]));
+  if (argc > 2)
+    duration = std::stod(argv[2]);
+
+  // The margin covers the distance the boxes travel in the largest time step
+  const double speculativeMargin = 0.2;
+  const double baseTimeStep = 0.001;
+
+  runBenchmark(numBoxesPerSide, duration, baseTimeStep, 0.0);
+  for (const auto factor : {2.0, 4.0})
+  {
+    runBenchmark(numBoxesPerSide, duration, factor * baseTimeStep, 0.0);
+    runBenchmark(
+        numBoxesPerSide, duration, factor * baseTimeStep, speculativeMargin);
+  }
+
+  return 0;
+}
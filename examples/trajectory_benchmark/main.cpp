@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <dart/dart.hpp>
+#include <dart/planning/planning.hpp>
+
+// Measures the time to parameterize random paths of a 7-DOF arm with
+// planning::PathFollowingTrajectory, which integrates the phase plane with
+// small time steps, and with planning::ReachabilityTrajectory, which solves a
+// linear program in two variables per grid point, for paths of increasing
+// numbers of waypoints. The reachability analysis is also run with coarser
+// grids and with the torque limits of the arm.
+//
+// Usage:
+//   trajectory_benchmark [num_paths]
+
+using namespace dart;
+
+//==============================================================================
+dynamics::SkeletonPtr createArm()
+{
+  auto skel = dynamics::Skeleton::create("arm");
+
+  dynamics::BodyNode* parent = nullptr;
+  for (std::size_t i = 0u; i < 7u; ++i)
+  {
+    dynamics::RevoluteJoint::Properties properties;
+    properties.mName = "joint_" + std::to_string(i);
+    properties.mAxis
+        = (i % 2u == 0u) ? Eigen::Vector3d::UnitZ() : Eigen::Vector3d::UnitY();
+    properties.mForceLowerLimits[0] = -60.0 / (i + 1.0);
+    properties.mForceUpperLimits[0] = 60.0 / (i + 1.0);
+    if (parent)
+      properties.mT_ParentBodyToJoint.translation().z() = 0.25;
+
+    parent = skel->createJointAndBodyNodePair<dynamics::RevoluteJoint>(
+                     parent, properties)
+                 .second;
+    parent->setMass(2.0 / (i + 1.0));
+    parent->setLocalCOM(Eigen::Vector3d(0.0, 0.0, 0.125));
+  }
+
+  return skel;
+}
+
+//==============================================================================
+std::list<Eigen::VectorXd> createRandomPath(std::size_t numWaypoints)
+{
+  const Eigen::VectorXd lower = Eigen::VectorXd::Constant(7, -1.5);
+  const Eigen::VectorXd upper = Eigen::VectorXd::Constant(7, 1.5);
+
+  std::list<Eigen::VectorXd> path;
+  for (std::size_t i = 0u; i < numWaypoints; ++i)
+    path.push_back(math::Random::uniform<Eigen::VectorXd>(lower, upper));
+
+  return path;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  std::size_t numPaths = 10u;
+  if (argc > 1)
+    numPaths = static_cast<std::size_t>(std::stoul(argv[1]));
+
+  math::Random::setSeed(0u);
+
+  const Eigen::VectorXd maxVelocity = Eigen::VectorXd::Constant(7, 1.5);
+  const Eigen::VectorXd maxAcceleration = Eigen::VectorXd::Constant(7, 3.0);
+  const double maxDeviation = 0.1;
+
+  auto arm = createArm();
+  std::vector<std::size_t> dofs;
+  for (std::size_t i = 0u; i < arm->getNumDofs(); ++i)
+    dofs.push_back(i);
+
+  for (std::size_t numWaypoints : {5u, 20u, 80u})
+  {
+    std::vector<planning::Path> paths;
+    double length = 0.0;
+    for (std::size_t i = 0u; i < numPaths; ++i)
+    {
+      paths.emplace_back(createRandomPath(numWaypoints), maxDeviation);
+      length += paths.back().getLength();
+    }
+
+    std::cout << numWaypoints << " waypoints, path length "
+              << length / numPaths << "\n";
+
+    const auto report = [&](const std::string& label,
+                            double elapsed,
+                            double duration,
+                            std::size_t numValid,
+                            std::size_t numGridPoints) {
+      std::cout << "  " << label << ": " << 1e3 * elapsed / numPaths
+                << " ms/path, duration "
+                << duration / std::max<std::size_t>(numValid, 1u) << " s, "
+                << numValid << " / " << numPaths << " valid";
+      if (numGridPoints > 0u)
+        std::cout << ", " << numGridPoints / numPaths << " grid points";
+      std::cout << "\n";
+    };
+
+    double duration = 0.0;
+    std::size_t numValid = 0u;
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& path : paths)
+    {
+      planning::PathFollowingTrajectory trajectory(
+          path, maxVelocity, maxAcceleration);
+      if (trajectory.isValid())
+      {
+        duration += trajectory.getDuration();
+        ++numValid;
+      }
+    }
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - begin;
+    report("PathFollowingTrajectory", elapsed.count(), duration, numValid, 0u);
+
+    const auto runReachability
+        = [&](const std::string& label,
+              const planning::ReachabilityTrajectory::Option& option) {
+            double reachabilityDuration = 0.0;
+            std::size_t numReachabilityValid = 0u;
+            std::size_t numGridPoints = 0u;
+            const auto reachabilityBegin = std::chrono::steady_clock::now();
+            for (const auto& path : paths)
+            {
+              planning::ReachabilityTrajectory trajectory(
+                  path, maxVelocity, maxAcceleration, option);
+              numGridPoints += trajectory.getNumGridPoints();
+              if (trajectory.isValid())
+              {
+                reachabilityDuration += trajectory.getDuration();
+                ++numReachabilityValid;
+              }
+            }
+            const std::chrono::duration<double> reachabilityElapsed
+                = std::chrono::steady_clock::now() - reachabilityBegin;
+            report(
+                label,
+                reachabilityElapsed.count(),
+                reachabilityDuration,
+                numReachabilityValid,
+                numGridPoints);
+          };
+
+    runReachability(
+        "ReachabilityTrajectory, grid step 0.01",
+        planning::ReachabilityTrajectory::Option(0.01));
+    runReachability(
+        "ReachabilityTrajectory, grid step 0.05",
+        planning::ReachabilityTrajectory::Option(0.05));
+    runReachability(
+        "ReachabilityTrajectory, grid step 0.01, torque limits",
+        planning::ReachabilityTrajectory::Option(0.01, arm, dofs));
+
+    std::cout << std::endl;
+  }
+
+  return 0;
+}
@@ -30,6 +30,8 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstdint>
+#include <fstream>
 #include <iostream>
 #include <gtest/gtest.h>
 
@@ -1301,6 +1303,246 @@ TEST_F(Collision, Options)
   testOptions(dart);
 }
 
+//==============================================================================
+void testContactReduction(const std::shared_ptr<CollisionDetector>& cd)
+{
+  auto simpleFrame1 = SimpleFrame::createShared(Frame::World());
+  auto simpleFrame2 = SimpleFrame::createShared(Frame::World());
+
+  ShapePtr shape1(new BoxShape(Eigen::Vector3d(1.0, 1.0, 1.0)));
+  ShapePtr shape2(new BoxShape(Eigen::Vector3d(0.5, 0.5, 0.5)));
+  simpleFrame1->setShape(shape1);
+  simpleFrame2->setShape(shape2);
+
+  // The small box rests on the big box with a slight tilt so that the
+  // penetration depths of the contacts differ
+  simpleFrame1->setTranslation(Eigen::Vector3d(0.0, 0.0, -0.5));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.linear() = Eigen::AngleAxisd(0.01, Eigen::Vector3d::UnitX()).matrix();
+  tf.translation() = Eigen::Vector3d(0.0, 0.0, 0.24);
+  simpleFrame2->setTransform(tf);
+
+  auto group = cd->createCollisionGroup(simpleFrame1.get(), simpleFrame2.get());
+
+  collision::CollisionOption option;
+  collision::CollisionResult result;
+
+  EXPECT_TRUE(group->collide(option, &result));
+  const auto numContacts = result.getNumContacts();
+  EXPECT_GT(numContacts, 2u);
+
+  auto maxDepth = 0.0;
+  for (const auto& contact : result.getContacts())
+    maxDepth = std::max(maxDepth, contact.penetrationDepth);
+
+  option.maxNumContactsPerPair = 2u;
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContacts(), 2u);
+
+  // The deepest contact is kept
+  auto reducedMaxDepth = 0.0;
+  for (const auto& contact : result.getContacts())
+    reducedMaxDepth = std::max(reducedMaxDepth, contact.penetrationDepth);
+  EXPECT_DOUBLE_EQ(reducedMaxDepth, maxDepth);
+
+  // Nothing changes if the pair doesn't have more contacts than the limit
+  option.maxNumContactsPerPair = numContacts;
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContacts(), numContacts);
+}
+
+//==============================================================================
+TEST_F(Collision, ContactReduction)
+{
+  // A 5x5 grid of contacts on the xy-plane, deepest at the center
+  std::vector<collision::Contact> contacts;
+  for (auto i = 0; i < 5; ++i)
+  {
+    for (auto j = 0; j < 5; ++j)
+    {
+      collision::Contact contact;
+      contact.point = Eigen::Vector3d(i, j, 0.0);
+      contact.normal = Eigen::Vector3d::UnitZ();
+      contact.penetrationDepth = (2 == i && 2 == j) ? 0.1 : 0.01;
+      contacts.push_back(contact);
+    }
+  }
+
+  auto reduced = contacts;
+  collision::reduceContacts(reduced, 0u);
+  EXPECT_EQ(reduced.size(), contacts.size());
+
+  // The deepest contact and the three corners spanning the largest area are
+  // kept
+  collision::reduceContacts(reduced, 4u);
+  ASSERT_EQ(reduced.size(), 4u);
+  EXPECT_DOUBLE_EQ(reduced[2].penetrationDepth, 0.1);
+  auto numCorners = 0u;
+  for (const auto& contact : reduced)
+  {
+    if ((0.0 == contact.point.x() || 4.0 == contact.point.x())
+        && (0.0 == contact.point.y() || 4.0 == contact.point.y()))
+    {
+      ++numCorners;
+    }
+  }
+  EXPECT_EQ(numCorners, 3u);
+
+  auto fcl_mesh_dart = FCLCollisionDetector::create();
+  fcl_mesh_dart->setPrimitiveShapeType(FCLCollisionDetector::MESH);
+  fcl_mesh_dart->setContactPointComputationMethod(FCLCollisionDetector::DART);
+  testContactReduction(fcl_mesh_dart);
+
+  auto dart = DARTCollisionDetector::create();
+  testContactReduction(dart);
+}
+
+//==============================================================================
+TEST_F(Collision, SignedDistanceField)
+{
+  // A unit cube centered at the origin
+  std::vector<Eigen::Vector3d> vertices;
+  for (auto i = 0u; i < 8u; ++i)
+  {
+    vertices.emplace_back(
+        (i & 1u) ? 0.5 : -0.5, (i & 2u) ? 0.5 : -0.5, (i & 4u) ? 0.5 : -0.5);
+  }
+  const std::vector<Eigen::Vector3i> triangles
+      = {Eigen::Vector3i(0, 2, 1),
+         Eigen::Vector3i(1, 2, 3),
+         Eigen::Vector3i(4, 5, 6),
+         Eigen::Vector3i(5, 7, 6),
+         Eigen::Vector3i(0, 1, 4),
+         Eigen::Vector3i(1, 5, 4),
+         Eigen::Vector3i(2, 6, 3),
+         Eigen::Vector3i(3, 6, 7),
+         Eigen::Vector3i(0, 4, 2),
+         Eigen::Vector3i(2, 4, 6),
+         Eigen::Vector3i(1, 3, 5),
+         Eigen::Vector3i(3, 7, 5)};
+
+  auto sdf = SignedDistanceFieldShape::createFromTriangles(
+      vertices, triangles, 0.05, 0.3);
+  ASSERT_NE(sdf, nullptr);
+
+  EXPECT_NEAR(sdf->getDistance(Eigen::Vector3d::Zero()), -0.5, 1e-3);
+  EXPECT_NEAR(sdf->getDistance(Eigen::Vector3d(0.7, 0.1, 0.0)), 0.2, 1e-3);
+  EXPECT_NEAR(sdf->getDistance(Eigen::Vector3d(0.0, -0.4, 0.0)), -0.1, 1e-3);
+  EXPECT_TRUE(sdf->getGradient(Eigen::Vector3d(0.7, 0.1, 0.0))
+                  .normalized()
+                  .isApprox(Eigen::Vector3d::UnitX(), 1e-3));
+  EXPECT_NEAR(sdf->getVolume(), 1.0, 0.2);
+
+  // Outside of the grid
+  EXPECT_FALSE(sdf->isInside(Eigen::Vector3d(2.0, 0.0, 0.0)));
+  EXPECT_NEAR(sdf->getDistance(Eigen::Vector3d(2.0, 0.0, 0.0)), 1.5, 1e-3);
+
+  // Save and load
+  const std::string path = "test_signed_distance_field.sdf";
+  EXPECT_TRUE(sdf->save(path));
+  auto loaded = SignedDistanceFieldShape::load(path);
+  std::remove(path.c_str());
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(loaded->getOrigin().isApprox(sdf->getOrigin()));
+  EXPECT_DOUBLE_EQ(loaded->getResolution(), sdf->getResolution());
+  EXPECT_EQ(loaded->getGridSize(), sdf->getGridSize());
+  EXPECT_EQ(loaded->getValues(), sdf->getValues());
+
+  // A header that asks for more values than the file holds is rejected before
+  // the values are allocated
+  EXPECT_TRUE(sdf->save(path));
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    const std::int32_t gridSize[3] = {1 << 20, 1 << 20, 1 << 20};
+    file.seekp(8 + sizeof(std::uint32_t) + 4 * sizeof(double));
+    file.write(reinterpret_cast<const char*>(gridSize), sizeof(gridSize));
+  }
+  EXPECT_EQ(SignedDistanceFieldShape::load(path), nullptr);
+  std::remove(path.c_str());
+
+  // Contacts of the primitive shapes against the field, which is placed at
+  // z = -0.5 so that its top face is on the xy-plane
+  auto cd = DARTCollisionDetector::create();
+
+  auto sdfFrame = SimpleFrame::createShared(Frame::World());
+  sdfFrame->setShape(sdf);
+  sdfFrame->setTranslation(Eigen::Vector3d(0.0, 0.0, -0.5));
+
+  auto frame = SimpleFrame::createShared(Frame::World());
+  frame->setShape(std::make_shared<SphereShape>(0.1));
+  auto group = cd->createCollisionGroup(frame.get(), sdfFrame.get());
+
+  collision::CollisionOption option;
+  collision::CollisionResult result;
+
+  const auto checkContacts = [&](double expectedDepth) {
+    result.clear();
+    EXPECT_TRUE(group->collide(option, &result));
+    ASSERT_GT(result.getNumContacts(), 0u);
+    for (const auto& contact : result.getContacts())
+    {
+      EXPECT_NEAR(contact.penetrationDepth, expectedDepth, 1e-3);
+      if (contact.collisionObject1->getShapeFrame() == frame.get())
+        EXPECT_TRUE(contact.normal.isApprox(Eigen::Vector3d::UnitZ(), 1e-3));
+      else
+        EXPECT_TRUE(contact.normal.isApprox(-Eigen::Vector3d::UnitZ(), 1e-3));
+    }
+  };
+
+  frame->setTranslation(Eigen::Vector3d(0.1, 0.0, 0.08));
+  checkContacts(0.02);
+  EXPECT_EQ(result.getNumContacts(), 1u);
+
+  frame->setTranslation(Eigen::Vector3d(0.1, 0.0, 0.2));
+  EXPECT_FALSE(group->collide());
+
+  frame->setShape(std::make_shared<BoxShape>(Eigen::Vector3d(0.4, 0.4, 0.2)));
+  frame->setTranslation(Eigen::Vector3d(0.0, 0.0, 0.09));
+  checkContacts(0.01);
+  EXPECT_LE(result.getNumContacts(), 8u);
+
+  // A capsule lying on the field
+  frame->setShape(std::make_shared<CapsuleShape>(0.05, 0.4));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.linear()
+      = Eigen::AngleAxisd(0.5 * constantsd::pi(), Eigen::Vector3d::UnitX())
+            .toRotationMatrix();
+  tf.translation() = Eigen::Vector3d(0.0, 0.0, 0.04);
+  frame->setTransform(tf);
+  checkContacts(0.01);
+  EXPECT_GT(result.getNumContacts(), 1u);
+
+  frame->setTranslation(Eigen::Vector3d(0.0, 0.0, 0.06));
+  EXPECT_FALSE(group->collide());
+
+  // A large box resting on a feature of the field that is much smaller than
+  // the box. The box is sampled as densely as the voxels of the field, so the
+  // feature doesn't fall between the samples.
+  std::vector<Eigen::Vector3d> smallVertices;
+  for (const auto& vertex : vertices)
+    smallVertices.push_back(0.1 * vertex);
+  auto smallSdf = SignedDistanceFieldShape::createFromTriangles(
+      smallVertices, triangles, 0.01, 0.05);
+  ASSERT_NE(smallSdf, nullptr);
+  sdfFrame->setShape(smallSdf);
+  sdfFrame->setTranslation(Eigen::Vector3d(0.23, 0.17, 0.0));
+
+  frame->setShape(std::make_shared<BoxShape>(Eigen::Vector3d(4.0, 4.0, 1.0)));
+  frame->setTransform(Eigen::Isometry3d::Identity());
+  frame->setTranslation(Eigen::Vector3d(0.0, 0.0, 0.54));
+
+  result.clear();
+  EXPECT_TRUE(group->collide(option, &result));
+  ASSERT_GT(result.getNumContacts(), 0u);
+  double maxDepth = 0.0;
+  for (const auto& contact : result.getContacts())
+    maxDepth = std::max(maxDepth, contact.penetrationDepth);
+  EXPECT_NEAR(maxDepth, 0.01, 2e-3);
+
+  frame->setTranslation(Eigen::Vector3d(0.0, 0.0, 0.56));
+  EXPECT_FALSE(group->collide());
+}
+
 //==============================================================================
 void testFilter(const std::shared_ptr<CollisionDetector>& cd)
 {
@@ -30,11 +30,15 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <gtest/gtest.h>
 
 #include "dart/config.hpp"
 #include "dart/math/Helpers.hpp"
+#include "dart/optimizer/GradientDescentSolver.hpp"
 #include "TestHelpers.hpp"
 
 using namespace Eigen;
@@ -139,3 +143,466 @@ TEST(InverseKinematics, DoNotApplySolutionOnFailure)
   EXPECT_FALSE(
       equals(skel->getPositions(), Eigen::VectorXd::Zero(dofs).eval()));
 }
+
+//==============================================================================
+SkeletonPtr createArm(std::size_t numDofs)
+{
+  SkeletonPtr skel = Skeleton::create("arm");
+
+  const std::vector<Eigen::Vector3d> axes = {Eigen::Vector3d::UnitZ(),
+                                             Eigen::Vector3d::UnitY(),
+                                             Eigen::Vector3d::UnitY(),
+                                             Eigen::Vector3d::UnitX(),
+                                             Eigen::Vector3d::UnitY(),
+                                             Eigen::Vector3d::UnitX()};
+
+  const double limit = 0.75 * math::constantsd::pi();
+  BodyNode* parent = nullptr;
+  for (std::size_t i = 0u; i < numDofs; ++i)
+  {
+    RevoluteJoint::Properties properties;
+    properties.mName = "joint" + std::to_string(i);
+    properties.mAxis = axes[i % axes.size()];
+    properties.mPositionLowerLimits[0] = -limit;
+    properties.mPositionUpperLimits[0] = limit;
+    if (parent)
+      properties.mT_ParentBodyToJoint.translation() = 0.3 * Vector3d::UnitZ();
+
+    parent = skel->createJointAndBodyNodePair<RevoluteJoint>(
+                     parent,
+                     properties,
+                     BodyNode::AspectProperties("body" + std::to_string(i)))
+                 .second;
+  }
+
+  return skel;
+}
+
+//==============================================================================
+TEST(InverseKinematics, BatchSolve)
+{
+  SkeletonPtr skel = createArm(6u);
+  EndEffector* ee = skel->getBodyNode(5)->createEndEffector("ee");
+  ee->setDefaultRelativeTransform(
+      Eigen::Isometry3d(Eigen::Translation3d(0.0, 0.0, 0.2)), true);
+
+  const std::shared_ptr<InverseKinematics> ik = ee->getIK(true);
+  ik->getErrorMethod().setBounds(
+      Eigen::Vector6d::Constant(-1e-8), Eigen::Vector6d::Constant(1e-8));
+  auto solver = std::dynamic_pointer_cast<optimizer::GradientDescentSolver>(
+      ik->getSolver());
+  ASSERT_TRUE(solver);
+  solver->setNumMaxIterations(200);
+  solver->setMaxAttempts(10);
+
+  // Take the targets from the forward kinematics of random configurations, so
+  // they are all reachable
+  const std::size_t numTargets = 24u;
+  common::aligned_vector<Eigen::Isometry3d> targets;
+  for (std::size_t i = 0u; i < numTargets; ++i)
+  {
+    skel->setPositions(Eigen::VectorXd::Random(6));
+    targets.push_back(ee->getWorldTransform());
+  }
+
+  const Eigen::VectorXd initialPositions = Eigen::VectorXd::Zero(6);
+  skel->setPositions(initialPositions);
+
+  BatchInverseKinematics batch(ik, 4u);
+  EXPECT_EQ(batch.getNumThreads(), 4u);
+
+  Eigen::MatrixXd solutions;
+  std::vector<char> successes;
+  const std::size_t numSolved = batch.solve(targets, solutions, successes);
+
+  // The source Skeleton isn't modified
+  EXPECT_TRUE(equals(skel->getPositions(), initialPositions));
+
+  ASSERT_EQ(solutions.cols(), static_cast<int>(numTargets));
+  ASSERT_EQ(successes.size(), numTargets);
+  EXPECT_GE(numSolved, numTargets * 3u / 4u);
+
+  std::size_t numReached = 0u;
+  for (std::size_t i = 0u; i < numTargets; ++i)
+  {
+    if (!successes[i])
+      continue;
+
+    skel->setPositions(solutions.col(static_cast<int>(i)));
+    EXPECT_TRUE(equals(
+        ee->getWorldTransform().matrix(), targets[i].matrix(), 1e-6));
+    ++numReached;
+  }
+  EXPECT_EQ(numReached, numSolved);
+
+  // Changing the joint limits of the source Skeleton updates the replicas
+  skel->setPositions(initialPositions);
+  skel->getDof(0)->setPositionLimits(-1e-3, 1e-3);
+
+  Eigen::VectorXd solution;
+  if (batch.solveWithParallelAttempts(targets[0], 8u, solution))
+  {
+    EXPECT_LE(std::abs(solution[0]), 1e-3 + 1e-8);
+    skel->setPositions(solution);
+    EXPECT_TRUE(equals(
+        ee->getWorldTransform().matrix(), targets[0].matrix(), 1e-6));
+  }
+
+  // Parallel attempts find the solution of a reachable target
+  skel->getDof(0)->setPositionLimits(
+      -0.75 * math::constantsd::pi(), 0.75 * math::constantsd::pi());
+  skel->setPositions(initialPositions);
+  EXPECT_TRUE(batch.solveWithParallelAttempts(targets[1], 16u, solution));
+  skel->setPositions(solution);
+  EXPECT_TRUE(
+      equals(ee->getWorldTransform().matrix(), targets[1].matrix(), 1e-6));
+}
+
+//==============================================================================
+TEST(InverseKinematics, JacobianDLSGradient)
+{
+  SkeletonPtr skel = createArm(8u);
+  const Eigen::VectorXd positions = Eigen::VectorXd::Random(8);
+
+  // A redundant chain and a chain with fewer DOFs than the task space
+  for (const std::size_t index : {7u, 2u})
+  {
+    const std::shared_ptr<InverseKinematics> ik
+        = skel->getBodyNode(index)->getIK(true);
+    ik->useChain();
+
+    auto& method = ik->getGradientMethod();
+    method.setComponentWiseClamp(std::numeric_limits<double>::infinity());
+    const double damping = static_cast<InverseKinematics::JacobianDLS&>(method)
+                               .getDampingCoefficient();
+
+    Eigen::Vector6d error;
+    error << 0.1, -0.2, 0.05, 0.3, -0.1, 0.2;
+
+    // The gradient method moves the positions along the gradient, so the
+    // Jacobian is taken before
+    skel->setPositions(positions);
+    const math::Jacobian J = ik->computeJacobian();
+
+    Eigen::VectorXd grad;
+    method.computeGradient(error, grad);
+
+    const int rows = static_cast<int>(J.rows());
+    const int cols = static_cast<int>(J.cols());
+    Eigen::VectorXd expected;
+    if (rows <= cols)
+    {
+      expected = J.transpose()
+                 * (damping * damping * Eigen::MatrixXd::Identity(rows, rows)
+                    + J * J.transpose())
+                       .inverse()
+                 * error;
+    }
+    else
+    {
+      expected = (damping * damping * Eigen::MatrixXd::Identity(cols, cols)
+                  + J.transpose() * J)
+                     .inverse()
+                 * J.transpose() * error;
+    }
+
+    ASSERT_EQ(grad.size(), expected.size());
+    EXPECT_TRUE(equals(grad, expected, 1e-10));
+  }
+}
+
+//==============================================================================
+TEST(InverseKinematics, HierarchicalNullSpaceProjection)
+{
+  const std::size_t numDofs = 12u;
+  SkeletonPtr skel = createArm(numDofs);
+
+  // The tip has the highest precedence, and the middle of the arm is
+  // projected through the null space of the tip
+  const std::shared_ptr<InverseKinematics> tipIK
+      = skel->getBodyNode(numDofs - 1u)->getIK(true);
+  const std::shared_ptr<InverseKinematics> middleIK
+      = skel->getBodyNode(numDofs / 2u)->getIK(true);
+  middleIK->setHierarchyLevel(1u);
+
+  const Eigen::VectorXd solvedPositions
+      = Eigen::VectorXd::LinSpaced(static_cast<int>(numDofs), -0.5, 0.5);
+  skel->setPositions(solvedPositions);
+  tipIK->getTarget()->setTransform(
+      skel->getBodyNode(numDofs - 1u)->getWorldTransform());
+  middleIK->getTarget()->setTransform(
+      skel->getBodyNode(numDofs / 2u)->getWorldTransform());
+
+  const std::shared_ptr<WholeBodyIK> hik = skel->getIK(true);
+  hik->refreshIKHierarchy();
+  ASSERT_EQ(hik->getIKHierarchy().size(), 2u);
+
+  const Eigen::VectorXd x
+      = solvedPositions
+        + 0.2
+              * Eigen::VectorXd::LinSpaced(static_cast<int>(numDofs), 0.0, 10.0)
+                    .array()
+                    .sin()
+                    .matrix();
+  skel->setPositions(x);
+
+  // The null space of the first level is the one of the tip Jacobian
+  math::Jacobian J = math::Jacobian::Zero(6, numDofs);
+  const math::Jacobian& tipJ = tipIK->computeJacobian();
+  for (std::size_t i = 0u; i < tipIK->getDofs().size(); ++i)
+    J.col(tipIK->getDofs()[i]) = tipJ.col(i);
+
+  Eigen::MatrixXd N;
+  math::computeNullSpace(J, N);
+  const Eigen::MatrixXd expectedNullSpace = N * N.transpose();
+  EXPECT_TRUE(
+      equals(hik->computeNullSpaces()[0], expectedNullSpace, 1e-10));
+
+  // The implicit projection gives the same gradients, since each level has a
+  // single module
+  const std::shared_ptr<optimizer::Function> constraint
+      = hik->getProblem()->getEqConstraint(0);
+
+  Eigen::VectorXd explicitGrad = Eigen::VectorXd::Zero(numDofs);
+  Eigen::Map<Eigen::VectorXd> explicitMap(explicitGrad.data(), numDofs);
+  constraint->eval(x);
+  constraint->evalGradient(x, explicitMap);
+
+  EXPECT_FALSE(hik->isImplicitNullSpaceProjectionEnabled());
+  hik->setImplicitNullSpaceProjection(true);
+  EXPECT_TRUE(hik->isImplicitNullSpaceProjectionEnabled());
+
+  Eigen::VectorXd implicitGrad = Eigen::VectorXd::Zero(numDofs);
+  Eigen::Map<Eigen::VectorXd> implicitMap(implicitGrad.data(), numDofs);
+  skel->setPositions(x);
+  constraint->eval(x);
+  constraint->evalGradient(x, implicitMap);
+
+  EXPECT_FALSE(equals(explicitGrad, Eigen::VectorXd::Zero(numDofs).eval()));
+  EXPECT_TRUE(equals(explicitGrad, implicitGrad, 1e-8));
+
+  // The setting is kept by clones
+  const SkeletonPtr clonedSkel = skel->cloneSkeleton();
+  EXPECT_TRUE(hik->clone(clonedSkel)->isImplicitNullSpaceProjectionEnabled());
+
+  // Both projections find the same solution. The tip reaches its target
+  // exactly, while the middle of the arm gets close to its target within the
+  // null space of the tip.
+  const double initialMiddleError
+      = middleIK->getErrorMethod().computeError().norm();
+  std::vector<Eigen::VectorXd> solutions;
+  for (const bool implicit : {false, true})
+  {
+    skel->setPositions(x);
+    hik->setImplicitNullSpaceProjection(implicit);
+    hik->getSolver()->setNumMaxIterations(500);
+    Eigen::VectorXd positions;
+    hik->findSolution(positions);
+    skel->setPositions(positions);
+    solutions.push_back(positions);
+
+    EXPECT_TRUE(equals(
+        tipIK->getNode()->getWorldTransform().matrix(),
+        tipIK->getTarget()->getWorldTransform().matrix(),
+        1e-6));
+    EXPECT_LT(
+        middleIK->getErrorMethod().computeError().norm(),
+        0.1 * initialMiddleError);
+  }
+
+  EXPECT_TRUE(equals(solutions[0], solutions[1], 1e-6));
+}
+
+//==============================================================================
+TEST(InverseKinematics, SeedCache)
+{
+  SkeletonPtr skel = createArm(6u);
+  const std::shared_ptr<InverseKinematics> ik
+      = skel->getBodyNode(5)->getIK(true);
+  ik->getErrorMethod().setBounds(
+      Eigen::Vector6d::Constant(-1e-8), Eigen::Vector6d::Constant(1e-8));
+  ik->getSolver()->setNumMaxIterations(100);
+
+  // The solutions are only recorded on request
+  EXPECT_FALSE(IkSeedCache::Option().mRecordSolutions);
+  auto cache = std::make_shared<IkSeedCache>(
+      6u, IkSeedCache::Option(3u, 0.5, 0u, true));
+  EXPECT_EQ(cache->getNumEntries(), 0u);
+  EXPECT_FALSE(
+      cache->addEntry(Eigen::Isometry3d::Identity(), Eigen::VectorXd::Zero(3)));
+
+  math::Random::setSeed(42u);
+  EXPECT_EQ(cache->generate(*ik, 2000u), 2000u);
+  EXPECT_EQ(cache->getNumEntries(), 2000u);
+  EXPECT_TRUE(equals(skel->getPositions(), Eigen::VectorXd::Zero(6).eval()));
+
+  // The k-d tree agrees with a linear search over the same samples
+  const double limit = 0.75 * math::constantsd::pi();
+  const auto computeKey = [&](const Eigen::VectorXd& positions, bool flip) {
+    skel->setPositions(positions);
+    const Eigen::Isometry3d tf = skel->getBodyNode(5)->getWorldTransform();
+    Eigen::Quaterniond quat(tf.linear());
+    if ((quat.w() < 0.0) != flip)
+      quat.coeffs() = -quat.coeffs();
+    Eigen::Matrix<double, 7, 1> key;
+    key << tf.translation(), 0.5 * quat.w(), 0.5 * quat.x(), 0.5 * quat.y(),
+        0.5 * quat.z();
+    return key;
+  };
+
+  math::Random::setSeed(42u);
+  std::vector<Eigen::VectorXd> samples;
+  for (std::size_t i = 0u; i < 2000u; ++i)
+  {
+    samples.push_back(math::Random::uniform<Eigen::VectorXd>(
+        Eigen::VectorXd::Constant(6, -limit),
+        Eigen::VectorXd::Constant(6, limit)));
+  }
+
+  for (std::size_t i = 0u; i < 20u; ++i)
+  {
+    const Eigen::VectorXd query = Eigen::VectorXd::Random(6);
+    skel->setPositions(query);
+    std::vector<Eigen::VectorXd> found;
+    cache->findNearest(skel->getBodyNode(5)->getWorldTransform(), found);
+
+    const Eigen::Matrix<double, 7, 1> key = computeKey(query, false);
+    const Eigen::Matrix<double, 7, 1> flippedKey = computeKey(query, true);
+    std::vector<std::pair<double, std::size_t>> distances;
+    for (std::size_t j = 0u; j < samples.size(); ++j)
+    {
+      const Eigen::Matrix<double, 7, 1> sampleKey
+          = computeKey(samples[j], false);
+      distances.emplace_back(
+          std::min(
+              (sampleKey - key).squaredNorm(),
+              (sampleKey - flippedKey).squaredNorm()),
+          j);
+    }
+    std::sort(distances.begin(), distances.end());
+
+    ASSERT_EQ(found.size(), 3u);
+    for (std::size_t j = 0u; j < found.size(); ++j)
+      EXPECT_TRUE(equals(found[j], samples[distances[j].second]));
+  }
+  skel->resetPositions();
+
+  // The nearest entry of a stored pose is its configuration
+  const Eigen::VectorXd q = Eigen::VectorXd::LinSpaced(6, -1.0, 1.0);
+  skel->setPositions(q);
+  const Eigen::Isometry3d pose = skel->getBodyNode(5)->getWorldTransform();
+  cache->addEntry(pose, q);
+
+  std::vector<Eigen::VectorXd> nearest;
+  cache->findNearest(pose, nearest);
+  ASSERT_EQ(nearest.size(), cache->getOption().mNumSeeds);
+  EXPECT_TRUE(equals(nearest[0], q));
+
+  // Targets near the generated poses are solved from the cached solutions
+  // even with a single attempt and few iterations
+  ik->setSeedCache(cache);
+  EXPECT_EQ(ik->getSeedCache(), cache);
+  ik->getSolver()->setNumMaxIterations(50);
+  skel->resetPositions();
+
+  Eigen::Isometry3d target = pose;
+  target.translation() += Eigen::Vector3d(0.01, -0.01, 0.01);
+  ik->getTarget()->setTransform(target);
+
+  Eigen::VectorXd solution;
+  EXPECT_TRUE(ik->findSolution(solution));
+  EXPECT_TRUE(ik->getProblem()->getSeeds().empty());
+  EXPECT_EQ(cache->getNumEntries(), 2002u);
+  skel->setPositions(solution);
+  EXPECT_TRUE(equals(
+      skel->getBodyNode(5)->getWorldTransform().matrix(),
+      target.matrix(),
+      1e-6));
+
+  // Clones share the cache
+  const SkeletonPtr clonedSkel = skel->cloneSkeleton();
+  EXPECT_EQ(ik->clone(clonedSkel->getBodyNode(5))->getSeedCache(), cache);
+
+  // The cache can be saved and loaded
+  const std::string path = "test_ik_seed_cache.bin";
+  ASSERT_TRUE(cache->save(path));
+
+  IkSeedCache loaded(6u);
+  ASSERT_TRUE(loaded.load(path));
+  EXPECT_EQ(loaded.getNumEntries(), cache->getNumEntries());
+  cache->findNearest(target, nearest);
+  std::vector<Eigen::VectorXd> loadedNearest;
+  loaded.findNearest(target, loadedNearest);
+  ASSERT_EQ(loadedNearest.size(), nearest.size());
+  for (std::size_t i = 0u; i < nearest.size(); ++i)
+    EXPECT_TRUE(equals(loadedNearest[i], nearest[i]));
+
+  IkSeedCache mismatched(7u);
+  EXPECT_FALSE(mismatched.load(path));
+  EXPECT_EQ(mismatched.getNumEntries(), 0u);
+
+  // A corrupted number of entries is rejected before allocating the entries
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    const std::uint64_t numEntries = std::uint64_t(1) << 40;
+    file.seekp(8 + 4 + 8);
+    file.write(reinterpret_cast<const char*>(&numEntries), sizeof(numEntries));
+  }
+  EXPECT_FALSE(loaded.load(path));
+  EXPECT_EQ(loaded.getNumEntries(), cache->getNumEntries());
+
+  std::remove(path.c_str());
+}
+
+//==============================================================================
+// IkSeedCache that exposes the depth of its k-d tree
+class DepthIkSeedCache : public IkSeedCache
+{
+public:
+  using IkSeedCache::IkSeedCache;
+
+  std::size_t getDepth() const
+  {
+    return getDepth(mRoot);
+  }
+
+private:
+  std::size_t getDepth(int node) const
+  {
+    if (node < 0)
+      return 0u;
+
+    const Node& current = mNodes[static_cast<std::size_t>(node)];
+    return 1u + std::max(getDepth(current.mLeft), getDepth(current.mRight));
+  }
+};
+
+//==============================================================================
+TEST(InverseKinematics, SeedCacheBalance)
+{
+  // Entries along a line, like the solutions of a teleoperation loop, would
+  // make a chain of the k-d tree without the rebuilds
+  DepthIkSeedCache cache(1u);
+  const std::size_t numEntries = 10000u;
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  for (std::size_t i = 0u; i < numEntries; ++i)
+  {
+    pose.translation().x() = 1e-3 * static_cast<double>(i);
+    ASSERT_TRUE(cache.addEntry(
+        pose, Eigen::VectorXd::Constant(1, static_cast<double>(i))));
+  }
+
+  // The depth is logarithmic with the base of the inverse of the balance
+  // factor of the tree
+  const double maxDepth = std::floor(
+      std::log(static_cast<double>(numEntries)) / std::log(4.0 / 3.0));
+  EXPECT_LE(static_cast<double>(cache.getDepth()), maxDepth + 1.0);
+
+  pose.translation().x() = 5.0004;
+  std::vector<Eigen::VectorXd> nearest;
+  cache.findNearest(pose, nearest);
+  ASSERT_EQ(nearest.size(), 3u);
+  EXPECT_EQ(nearest[0][0], 5000.0);
+  EXPECT_EQ(nearest[1][0], 5001.0);
+  EXPECT_EQ(nearest[2][0], 4999.0);
+}
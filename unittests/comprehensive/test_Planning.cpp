@@ -0,0 +1,654 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cmath>
+#include <list>
+#include <gtest/gtest.h>
+
+#include "dart/dart.hpp"
+#include "dart/planning/MotionValidator.hpp"
+#include "dart/planning/PathFollowingTrajectory.hpp"
+#include "dart/planning/PathShortcutter.hpp"
+#include "dart/planning/PathShortener.hpp"
+#include "dart/planning/RRTConnect.hpp"
+#include "dart/planning/RRTStar.hpp"
+#include "dart/planning/ReachabilityTrajectory.hpp"
+#include "TestHelpers.hpp"
+
+using namespace Eigen;
+using namespace dart;
+using namespace dart::dynamics;
+
+//==============================================================================
+// A box that translates in the xy-plane within [-1, 1]^2, and a wall at x = 0
+// that blocks it except for a gap above y = 0.6
+simulation::WorldPtr createPlanarWorld(SkeletonPtr& robot)
+{
+  auto world = simulation::World::create();
+
+  robot = Skeleton::create("robot");
+  PrismaticJoint::Properties xJoint;
+  xJoint.mName = "x";
+  xJoint.mAxis = Vector3d::UnitX();
+  auto xBody
+      = robot->createJointAndBodyNodePair<PrismaticJoint>(nullptr, xJoint)
+            .second;
+  PrismaticJoint::Properties yJoint;
+  yJoint.mName = "y";
+  yJoint.mAxis = Vector3d::UnitY();
+  auto yBody
+      = robot->createJointAndBodyNodePair<PrismaticJoint>(xBody, yJoint)
+            .second;
+  yBody->createShapeNodeWith<CollisionAspect>(
+      std::make_shared<BoxShape>(Vector3d::Constant(0.1)));
+  robot->setPositionLowerLimits(Vector2d::Constant(-1.0));
+  robot->setPositionUpperLimits(Vector2d::Constant(1.0));
+  world->addSkeleton(robot);
+
+  auto wall = Skeleton::create("wall");
+  auto wallBody
+      = wall->createJointAndBodyNodePair<WeldJoint>(nullptr).second;
+  wallBody->getParentJoint()->setTransformFromParentBodyNode(
+      Isometry3d(Translation3d(0.0, -0.5, 0.0)));
+  wallBody->createShapeNodeWith<CollisionAspect>(
+      std::make_shared<BoxShape>(Vector3d(0.1, 2.2, 0.5)));
+  world->addSkeleton(wall);
+
+  return world;
+}
+
+//==============================================================================
+// Checks that the path connects the start to the goal, and that its edges are
+// at most maxEdgeLength long and free of collisions at the given resolution
+void checkPath(
+    const std::list<VectorXd>& path,
+    const VectorXd& start,
+    const VectorXd& goal,
+    double maxEdgeLength,
+    double resolution,
+    const SkeletonPtr& robot,
+    const simulation::WorldPtr& world)
+{
+  ASSERT_GE(path.size(), 2u);
+  EXPECT_TRUE(equals(path.front(), start));
+  EXPECT_TRUE(equals(path.back(), goal));
+
+  const VectorXd savedPositions = robot->getPositions();
+  auto previous = path.begin();
+  for (auto it = std::next(path.begin()); it != path.end(); ++it, ++previous)
+  {
+    const double length = (*it - *previous).norm();
+    EXPECT_LE(length, maxEdgeLength + 1e-9);
+
+    const int numSegments
+        = static_cast<int>(std::ceil(length / resolution - 1e-6));
+    for (int i = 0; i <= numSegments; ++i)
+    {
+      const double t = static_cast<double>(i) / std::max(numSegments, 1);
+      robot->setPositions(*previous + t * (*it - *previous));
+      EXPECT_FALSE(world->checkCollision());
+    }
+  }
+  robot->setPositions(savedPositions);
+}
+
+//==============================================================================
+double computePathLength(const std::list<VectorXd>& path)
+{
+  double length = 0.0;
+  auto previous = path.begin();
+  for (auto it = std::next(path.begin()); it != path.end(); ++it, ++previous)
+    length += (*it - *previous).norm();
+
+  return length;
+}
+
+//==============================================================================
+TEST(Planning, RRTConnect)
+{
+  SkeletonPtr robot;
+  auto world = createPlanarWorld(robot);
+
+  const Vector2d start(-0.5, -0.5);
+  const Vector2d goal(0.5, -0.5);
+  const std::vector<std::size_t> dofs{0u, 1u};
+  const double stepSize = 0.05;
+
+  planning::RRTConnect planner(world, robot, dofs, stepSize);
+  std::list<VectorXd> path;
+  ASSERT_TRUE(planner.plan(start, goal, path));
+  EXPECT_EQ(
+      planner.getSize(),
+      planner.getStartTree()->getSize() + planner.getGoalTree()->getSize());
+  checkPath(path, start, goal, stepSize, stepSize, robot, world);
+
+  // The path has to go through the gap
+  bool throughGap = false;
+  for (const VectorXd& config : path)
+    throughGap |= (std::abs(config[0]) < 0.1 && config[1] > 0.6);
+  EXPECT_TRUE(throughGap);
+
+  // The positions of the robot are restored
+  EXPECT_TRUE(equals(robot->getPositions(), VectorXd::Zero(2).eval()));
+
+  // A goal in collision is rejected
+  EXPECT_FALSE(planner.plan(start, Vector2d(0.0, -0.5), path));
+  EXPECT_TRUE(path.empty());
+}
+
+//==============================================================================
+TEST(Planning, RRTStar)
+{
+  SkeletonPtr robot;
+  auto world = createPlanarWorld(robot);
+
+  const Vector2d start(-0.5, -0.5);
+  const Vector2d goal(0.5, -0.5);
+  const std::vector<std::size_t> dofs{0u, 1u};
+  const double stepSize = 0.05;
+
+  planning::RRTStar planner(world, robot, dofs, start, stepSize);
+  std::list<VectorXd> path;
+  ASSERT_TRUE(planner.plan(goal, path, 3000u));
+  EXPECT_LE(planner.getSize(), 3001u);
+  checkPath(path, start, goal, 2.0, stepSize, robot, world);
+
+  // The cost of every node is the cost of its parent plus the length of the
+  // edge, even after rewiring
+  for (std::size_t i = 1u; i < planner.getSize(); ++i)
+  {
+    const int parent = planner.parentVector[i];
+    ASSERT_GE(parent, 0);
+    EXPECT_NEAR(
+        planner.getCost(parent)
+            + (planner.getConfig(i) - planner.getConfig(parent)).norm(),
+        planner.getCost(i),
+        1e-9);
+  }
+
+  // The shortest path around the wall is about 2.5 long, and the path should
+  // be close to it
+  const double length = computePathLength(path);
+  EXPECT_GT(length, 2.4);
+  EXPECT_LT(length, 3.2);
+}
+
+//==============================================================================
+TEST(Planning, MotionValidator)
+{
+  SkeletonPtr robot;
+  auto world = createPlanarWorld(robot);
+
+  const std::vector<std::size_t> dofs{0u, 1u};
+  const double resolution = 0.01;
+  planning::MotionValidator validator(
+      world,
+      robot,
+      dofs,
+      planning::MotionValidator::Option(resolution, 4u));
+  EXPECT_EQ(4u, validator.getNumThreads());
+
+  // The binary queries agree with the collision detection of the world
+  math::Random::setSeed(0u);
+  for (std::size_t i = 0u; i < 200u; ++i)
+  {
+    const VectorXd config
+        = math::Random::uniform<VectorXd>(Vector2d(-1, -1), Vector2d(1, 1));
+    robot->setPositions(config);
+    const bool collision = world->checkCollision();
+    EXPECT_EQ(!collision, validator.isValid(config));
+  }
+
+  // Motions through the wall are rejected, and the ones through the gap
+  // aren't
+  const Vector2d left(-0.5, -0.5);
+  const Vector2d right(0.5, -0.5);
+  const Vector2d upperLeft(-0.5, 0.8);
+  const Vector2d upperRight(0.5, 0.8);
+  EXPECT_FALSE(validator.isValid(left, right));
+  EXPECT_TRUE(validator.isValid(left, upperLeft));
+  EXPECT_TRUE(validator.isValid(upperLeft, upperRight));
+
+  // A motion that only grazes the wall is rejected too, although its
+  // midpoint is free
+  EXPECT_FALSE(validator.isValid(Vector2d(-0.5, 0.0), Vector2d(0.0, 0.5)));
+
+  // The parallel path checks agree with the serial ones
+  EXPECT_FALSE(validator.isPathValid({left, right}));
+  EXPECT_TRUE(validator.isPathValid({left, upperLeft, upperRight, right}));
+  EXPECT_FALSE(validator.isPathValid({left, upperLeft, upperRight, left}));
+  EXPECT_FALSE(validator.isPathValid({Vector2d(0.0, 0.0).eval()}));
+
+  // The first invalid motion is found regardless of the scheduling
+  std::vector<planning::MotionValidator::Motion> motions;
+  for (std::size_t i = 0u; i < 20u; ++i)
+    motions.emplace_back(left, upperLeft);
+  motions[7].second = right;
+  motions[13].second = right;
+  for (std::size_t i = 0u; i < 10u; ++i)
+    EXPECT_EQ(7, validator.findFirstInvalid(motions));
+  motions[7].second = upperLeft;
+  motions[13].second = upperLeft;
+  EXPECT_EQ(-1, validator.findFirstInvalid(motions));
+
+  // The collision filter of the world applies on every thread, although the
+  // other threads check clones of the skeletons
+  auto filter = std::static_pointer_cast<collision::BodyNodeCollisionFilter>(
+      world->getConstraintSolver()->getCollisionOption().collisionFilter);
+  ASSERT_NE(nullptr, filter);
+  filter->addBodyNodePairToBlackList(
+      robot->getBodyNode(1u), world->getSkeleton("wall")->getBodyNode(0u));
+  for (auto& motion : motions)
+    motion.second = right;
+  for (std::size_t i = 0u; i < 10u; ++i)
+    EXPECT_EQ(-1, validator.findFirstInvalid(motions));
+  EXPECT_TRUE(validator.isPathValid({left, right, left, right}));
+  filter->removeAllBodyNodePairsFromBlackList();
+  for (std::size_t i = 0u; i < 10u; ++i)
+    EXPECT_EQ(0, validator.findFirstInvalid(motions));
+
+  // The immobile skeletons, which the simulation doesn't collide with each
+  // other, are checked against each other
+  robot->setMobile(false);
+  world->getSkeleton("wall")->setMobile(false);
+  EXPECT_FALSE(validator.isValid(Vector2d(0.0, 0.0)));
+  EXPECT_FALSE(validator.isValid(left, right));
+  EXPECT_FALSE(validator.isPathValid({left, right}));
+  for (std::size_t i = 0u; i < 10u; ++i)
+    EXPECT_EQ(0, validator.findFirstInvalid(motions));
+  robot->setMobile(true);
+
+  // The replicas follow the changes of the world
+  world->removeSkeleton(world->getSkeleton("wall"));
+  EXPECT_TRUE(validator.isValid(left, right));
+  EXPECT_EQ(-1, validator.findFirstInvalid({{left, right}, {right, left}}));
+  EXPECT_GT(validator.getNumQueries(), 0u);
+  validator.resetNumQueries();
+  EXPECT_EQ(0u, validator.getNumQueries());
+}
+
+//==============================================================================
+TEST(Planning, RRTConnectWithMotionValidator)
+{
+  SkeletonPtr robot;
+  auto world = createPlanarWorld(robot);
+
+  const Vector2d start(-0.5, -0.5);
+  const Vector2d goal(0.5, -0.5);
+  const std::vector<std::size_t> dofs{0u, 1u};
+
+  // The steps are longer than the wall is thick, so the motions have to be
+  // validated
+  const double stepSize = 0.3;
+  const double resolution = 0.02;
+  auto validator = std::make_shared<planning::MotionValidator>(
+      world,
+      robot,
+      dofs,
+      planning::MotionValidator::Option(resolution, 2u));
+
+  for (const bool lazy : {false, true})
+  {
+    planning::RRTConnect planner(world, robot, dofs, stepSize);
+    planner.setMotionValidator(validator, lazy);
+    EXPECT_EQ(validator, planner.getMotionValidator());
+
+    // The validator changes the positions of the robot, and the planner
+    // restores them
+    robot->setPositions(Vector2d(0.1, 0.2));
+    std::list<VectorXd> path;
+    ASSERT_TRUE(planner.plan(start, goal, path));
+    EXPECT_EQ(lazy, planner.getStartTree()->isLazyEdgeValidationEnabled());
+    EXPECT_TRUE(equals(robot->getPositions(), VectorXd(Vector2d(0.1, 0.2))));
+    checkPath(path, start, goal, stepSize, resolution, robot, world);
+    EXPECT_TRUE(validator->isPathValid(path));
+  }
+
+  // The path shortener can use the validator too
+  planning::RRTConnect planner(world, robot, dofs, 0.05);
+  planner.setMotionValidator(validator);
+  std::list<VectorXd> path;
+  ASSERT_TRUE(planner.plan(start, goal, path));
+  planning::PathShortener shortener(world, robot, dofs, resolution);
+  shortener.setMotionValidator(validator);
+  shortener.shortenPath(path);
+  checkPath(path, start, goal, 2.0, resolution, robot, world);
+}
+
+//==============================================================================
+// RRT* that records the motions that checkMotion() finds valid
+class MotionRecordingRRTStar : public planning::RRTStar
+{
+public:
+  using planning::RRTStar::RRTStar;
+
+  bool checkMotion(const VectorXd& from, const VectorXd& to) override
+  {
+    const bool valid = planning::RRTStar::checkMotion(from, to);
+    if (valid)
+      mValidMotions.emplace_back(from, to);
+
+    return valid;
+  }
+
+  // Returns the number of the edges of the tree that have been found valid by
+  // checkMotion() but that are left to validateBranch()
+  std::size_t getNumRecheckedEdges() const
+  {
+    std::size_t count = 0u;
+    for (std::size_t i = 0u; i < parentVector.size(); ++i)
+    {
+      if (parentVector[i] < 0 || validatedEdges[i] || index.isRemoved(i))
+        continue;
+
+      const VectorXd from = getConfig(parentVector[i]);
+      const VectorXd to = getConfig(static_cast<int>(i));
+      for (const auto& motion : mValidMotions)
+      {
+        if (motion.first == from && motion.second == to)
+        {
+          ++count;
+          break;
+        }
+      }
+    }
+
+    return count;
+  }
+
+  std::vector<std::pair<VectorXd, VectorXd>> mValidMotions;
+};
+
+//==============================================================================
+TEST(Planning, RRTStarWithLazyMotionValidator)
+{
+  SkeletonPtr robot;
+  auto world = createPlanarWorld(robot);
+
+  const Vector2d start(-0.5, -0.5);
+  const Vector2d goal(0.5, -0.5);
+  const std::vector<std::size_t> dofs{0u, 1u};
+  // The steps can cross the wall, but RRT* grows back slowly after a crossing
+  // subtree is removed, so they are shorter than for RRT-Connect
+  const double stepSize = 0.15;
+  const double resolution = 0.02;
+  auto validator = std::make_shared<planning::MotionValidator>(
+      world,
+      robot,
+      dofs,
+      planning::MotionValidator::Option(resolution, 2u));
+
+  MotionRecordingRRTStar planner(world, robot, dofs, start, stepSize);
+  planner.setMotionValidator(validator, true);
+  std::list<VectorXd> path;
+  ASSERT_TRUE(planner.plan(goal, path, 4000u, 0.1));
+  checkPath(path, start, goal, 2.0, resolution, robot, world);
+
+  // The motions from the chosen parents and the rewired ones are checked
+  // eagerly, so they aren't validated again
+  EXPECT_FALSE(planner.mValidMotions.empty());
+  EXPECT_EQ(0u, planner.getNumRecheckedEdges());
+}
+
+//==============================================================================
+TEST(Planning, PathShortcutter)
+{
+  SkeletonPtr robot;
+  auto world = createPlanarWorld(robot);
+
+  const Vector2d start(-0.5, -0.5);
+  const Vector2d goal(0.5, -0.5);
+  const std::vector<std::size_t> dofs{0u, 1u};
+  const double resolution = 0.02;
+  auto validator = std::make_shared<planning::MotionValidator>(
+      world,
+      robot,
+      dofs,
+      planning::MotionValidator::Option(resolution, 1u));
+
+  planning::RRTConnect planner(world, robot, dofs, 0.05);
+  planner.setMotionValidator(validator);
+  std::list<VectorXd> path;
+  ASSERT_TRUE(planner.plan(start, goal, path));
+  const double length = computePathLength(path);
+
+  // The shortcuts don't depend on the number of threads
+  const planning::PathShortcutter::Option option(20u, 16u, 0.0, 1e-6, 8u, 7u);
+  std::list<VectorXd> shortened = path;
+  planning::PathShortcutter shortcutter(validator, option);
+  EXPECT_GT(shortcutter.shortcut(shortened), 0u);
+  EXPECT_LT(computePathLength(shortened), length);
+  checkPath(shortened, start, goal, 2.0, resolution, robot, world);
+
+  auto parallelValidator = std::make_shared<planning::MotionValidator>(
+      world,
+      robot,
+      dofs,
+      planning::MotionValidator::Option(resolution, 4u));
+  std::list<VectorXd> parallelShortened = path;
+  planning::PathShortcutter parallelShortcutter(parallelValidator, option);
+  parallelShortcutter.shortcut(parallelShortened);
+  ASSERT_EQ(shortened.size(), parallelShortened.size());
+  EXPECT_TRUE(std::equal(
+      shortened.begin(),
+      shortened.end(),
+      parallelShortened.begin(),
+      [](const VectorXd& a, const VectorXd& b) { return a == b; }));
+
+  // Resetting the seed repeats the shortcuts
+  std::list<VectorXd> repeated = path;
+  parallelShortcutter.setSeed(7u);
+  parallelShortcutter.shortcut(repeated);
+  ASSERT_EQ(shortened.size(), repeated.size());
+  EXPECT_TRUE(std::equal(
+      shortened.begin(),
+      shortened.end(),
+      repeated.begin(),
+      [](const VectorXd& a, const VectorXd& b) { return a == b; }));
+
+  // Partial shortcuts only move one DOF of the waypoints
+  std::list<VectorXd> partial = path;
+  planning::PathShortcutter partialShortcutter(
+      parallelValidator,
+      planning::PathShortcutter::Option(20u, 16u, 0.5, 1e-6, 8u, 7u));
+  EXPECT_GT(partialShortcutter.shortcut(partial), 0u);
+  EXPECT_LT(computePathLength(partial), length);
+  checkPath(partial, start, goal, 2.0, resolution, robot, world);
+
+  // Smoothing rounds the corners that it can without collisions
+  std::list<VectorXd> smoothed = path;
+  const std::size_t numSmoothed = shortcutter.smooth(smoothed);
+  EXPECT_GT(numSmoothed, 0u);
+  EXPECT_GT(smoothed.size(), path.size());
+  EXPECT_LT(computePathLength(smoothed), length);
+  checkPath(smoothed, start, goal, 2.0, resolution, robot, world);
+}
+
+//==============================================================================
+// Checks that the trajectory follows the path from its start to its end within
+// the limits, with the accelerations estimated by finite differences
+void checkTrajectory(
+    const planning::Trajectory& trajectory,
+    const VectorXd& start,
+    const VectorXd& end,
+    const VectorXd& maxVelocity,
+    const VectorXd& maxAcceleration)
+{
+  const double duration = trajectory.getDuration();
+  EXPECT_TRUE(equals(trajectory.getPosition(0.0), start, 1e-9));
+  EXPECT_TRUE(equals(trajectory.getPosition(duration), end, 1e-9));
+  EXPECT_TRUE(equals(
+      trajectory.getVelocity(0.0), VectorXd(VectorXd::Zero(start.size()))));
+
+  const double dt = 1e-4;
+  for (double time = 0.0; time + dt < duration; time += 0.01)
+  {
+    const VectorXd velocity = trajectory.getVelocity(time);
+    const VectorXd acceleration
+        = (trajectory.getVelocity(time + dt) - velocity) / dt;
+    for (Eigen::Index i = 0; i < start.size(); ++i)
+    {
+      EXPECT_LE(std::abs(velocity[i]), maxVelocity[i] + 1e-6);
+      EXPECT_LE(std::abs(acceleration[i]), 1.05 * maxAcceleration[i]);
+    }
+  }
+}
+
+//==============================================================================
+TEST(Planning, ReachabilityTrajectory)
+{
+  const VectorXd maxVelocity = Vector3d(1.0, 0.8, 1.2);
+  const VectorXd maxAcceleration = Vector3d(1.0, 2.0, 1.5);
+
+  // A straight path along the first coordinate, which accelerates to the
+  // velocity limit, cruises and decelerates
+  const VectorXd start = Vector3d::Zero();
+  const VectorXd end = Vector3d(2.0, 0.0, 0.0);
+  const planning::Path line({start, end});
+  const planning::ReachabilityTrajectory lineTrajectory(
+      line, maxVelocity, maxAcceleration);
+  ASSERT_TRUE(lineTrajectory.isValid());
+  EXPECT_NEAR(3.0, lineTrajectory.getDuration(), 1e-6);
+  EXPECT_NEAR(
+      1.0,
+      lineTrajectory.getPosition(0.5 * lineTrajectory.getDuration())[0],
+      1e-6);
+  checkTrajectory(lineTrajectory, start, end, maxVelocity, maxAcceleration);
+
+  // With blends around the waypoints, the duration is within 1 % of the one of
+  // PathFollowingTrajectory
+  const std::list<VectorXd> waypoints{start,
+                                      Vector3d(1.0, 0.5, 0.0),
+                                      Vector3d(1.0, 1.5, 1.0),
+                                      Vector3d(-0.5, 1.0, 0.5),
+                                      end};
+  const planning::Path blended(waypoints, 0.1);
+  const planning::ReachabilityTrajectory trajectory(
+      blended, maxVelocity, maxAcceleration);
+  ASSERT_TRUE(trajectory.isValid());
+  checkTrajectory(trajectory, start, end, maxVelocity, maxAcceleration);
+
+  const planning::PathFollowingTrajectory reference(
+      blended, maxVelocity, maxAcceleration);
+  ASSERT_TRUE(reference.isValid());
+  EXPECT_NEAR(
+      reference.getDuration(),
+      trajectory.getDuration(),
+      0.01 * reference.getDuration());
+
+  // Without blends, the trajectory stops at the waypoints
+  const planning::Path sharp(waypoints);
+  const planning::ReachabilityTrajectory sharpTrajectory(
+      sharp, maxVelocity, maxAcceleration);
+  ASSERT_TRUE(sharpTrajectory.isValid());
+  EXPECT_GT(sharpTrajectory.getDuration(), trajectory.getDuration());
+  checkTrajectory(sharpTrajectory, start, end, maxVelocity, maxAcceleration);
+}
+
+//==============================================================================
+TEST(Planning, ReachabilityTrajectoryTorqueLimits)
+{
+  // A pendulum that swings up from hanging down against gravity
+  auto pendulum = Skeleton::create("pendulum");
+  RevoluteJoint::Properties properties;
+  properties.mAxis = Vector3d::UnitY();
+  auto body
+      = pendulum->createJointAndBodyNodePair<RevoluteJoint>(nullptr, properties)
+            .second;
+  body->setMass(1.0);
+  body->setLocalCOM(Vector3d(0.0, 0.0, -0.5));
+  const std::vector<std::size_t> dofs{0u};
+
+  const VectorXd start = VectorXd::Zero(1);
+  const VectorXd end = VectorXd::Constant(1, 1.5);
+  const planning::Path path({start, end});
+  const VectorXd maxVelocity = VectorXd::Constant(1, 10.0);
+  const VectorXd maxAcceleration = VectorXd::Constant(1, 10.0);
+
+  const planning::ReachabilityTrajectory unlimited(
+      path, maxVelocity, maxAcceleration);
+  ASSERT_TRUE(unlimited.isValid());
+
+  const double maxTorque = 6.0;
+  pendulum->getDof(0)->setForceLowerLimit(-maxTorque);
+  pendulum->getDof(0)->setForceUpperLimit(maxTorque);
+  pendulum->setPosition(0, 0.3);
+  const planning::ReachabilityTrajectory limited(
+      path,
+      maxVelocity,
+      maxAcceleration,
+      planning::ReachabilityTrajectory::Option(0.01, pendulum, dofs));
+  ASSERT_TRUE(limited.isValid());
+  EXPECT_GT(limited.getDuration(), unlimited.getDuration());
+  EXPECT_DOUBLE_EQ(0.3, pendulum->getPosition(0));
+  checkTrajectory(limited, start, end, maxVelocity, maxAcceleration);
+
+  const double dt = 1e-4;
+  for (double time = 0.0; time + dt < limited.getDuration(); time += 0.01)
+  {
+    pendulum->setPositions(limited.getPosition(time));
+    pendulum->setVelocities(limited.getVelocity(time));
+    pendulum->setAccelerations(
+        (limited.getVelocity(time + dt) - limited.getVelocity(time)) / dt);
+    pendulum->computeInverseDynamics();
+    EXPECT_LE(std::abs(pendulum->getForce(0)), 1.05 * maxTorque);
+  }
+
+  // The pendulum can't be held at rest at the end of the path
+  pendulum->getDof(0)->setForceLowerLimit(-3.0);
+  pendulum->getDof(0)->setForceUpperLimit(3.0);
+  const planning::ReachabilityTrajectory infeasible(
+      path,
+      maxVelocity,
+      maxAcceleration,
+      planning::ReachabilityTrajectory::Option(0.01, pendulum, dofs));
+  EXPECT_FALSE(infeasible.isValid());
+
+  // An invalid trajectory stays at rest at the start of the path
+  const VectorXd zero = VectorXd::Zero(1);
+  EXPECT_DOUBLE_EQ(0.0, infeasible.getDuration());
+  for (const double time : {-1.0, 0.0, 0.5, 10.0})
+  {
+    EXPECT_TRUE(equals(infeasible.getPosition(time), start));
+    EXPECT_TRUE(equals(infeasible.getVelocity(time), zero));
+  }
+
+  // A path without segments can't be parameterized either
+  const planning::Path empty({start});
+  const planning::ReachabilityTrajectory emptyTrajectory(
+      empty, maxVelocity, maxAcceleration);
+  EXPECT_FALSE(emptyTrajectory.isValid());
+  EXPECT_DOUBLE_EQ(0.0, emptyTrajectory.getDuration());
+  EXPECT_TRUE(equals(emptyTrajectory.getPosition(1.0), zero));
+  EXPECT_TRUE(equals(emptyTrajectory.getVelocity(1.0), zero));
+}
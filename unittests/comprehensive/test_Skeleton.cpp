@@ -920,3 +920,101 @@ TEST(Skeleton, Updating)
   EXPECT_FALSE(originalMass == newMass);
   EXPECT_TRUE(newMass == originalMass - removedMass);
 }
+
+//==============================================================================
+TEST(Skeleton, ImplicitIntegration)
+{
+  // Without force Jacobians, the linearized backward Euler step agrees with
+  // the articulated body algorithm, which treats the joint springs and
+  // dampers implicitly
+  SkeletonPtr skel = createNLinkPendulum(
+      4u,
+      Eigen::Vector3d(0.1, 0.1, 0.5),
+      DOF_ROLL,
+      Eigen::Vector3d(0, 0, 0.25));
+  skel->setTimeStep(0.01);
+  for (std::size_t i = 0u; i < skel->getNumDofs(); ++i)
+  {
+    skel->getDof(i)->setSpringStiffness(100.0 * (i + 1));
+    skel->getDof(i)->setDampingCoefficient(2.0 * (i + 1));
+    skel->getDof(i)->setRestPosition(0.1 * i);
+  }
+  skel->setPositions(Eigen::VectorXd::Random(skel->getNumDofs()));
+  skel->setVelocities(Eigen::VectorXd::Random(skel->getNumDofs()));
+  skel->setForces(Eigen::VectorXd::Random(skel->getNumDofs()));
+  skel->getBodyNode(3)->addExtForce(Eigen::Vector3d(1.0, 2.0, 3.0));
+
+  skel->computeForwardDynamics();
+  const Eigen::VectorXd expected = skel->getAccelerations();
+
+  skel->setImplicitIntegration(true);
+  EXPECT_TRUE(skel->isImplicitIntegrationEnabled());
+  skel->computeForwardDynamics();
+  EXPECT_TRUE(equals(skel->getAccelerations(), expected, 1e-8));
+
+  // The commands of the actuators become the joint forces as well: clipped to
+  // the force limits for FORCE joints, and ignored for PASSIVE joints, whose
+  // forces are zeroed
+  skel->getJoint(1)->setActuatorType(Joint::PASSIVE);
+  skel->getDof(0)->setForceLimits(-0.2, 0.2);
+  skel->setCommand(0, 1.0);
+  skel->setCommand(2, -0.5);
+  skel->setCommand(3, 0.3);
+  skel->setForce(1, 5.0);
+  skel->computeForwardDynamics();
+  const Eigen::VectorXd implicitAccelerations = skel->getAccelerations();
+  EXPECT_DOUBLE_EQ(skel->getForce(0), 0.2);
+  EXPECT_DOUBLE_EQ(skel->getForce(1), 0.0);
+  EXPECT_DOUBLE_EQ(skel->getForce(2), -0.5);
+
+  skel->setImplicitIntegration(false);
+  skel->setForce(1, 5.0);
+  skel->computeForwardDynamics();
+  EXPECT_TRUE(equals(skel->getAccelerations(), implicitAccelerations, 1e-8));
+  skel->setImplicitIntegration(true);
+
+  // A stiff PD controller that the explicit forces can't keep stable at a
+  // large time step. The explicit case is stopped before it overflows.
+  const double kp = 1e5;
+  const double kd = 10.0;
+  const double target = 0.5;
+  for (const bool implicit : {false, true})
+  {
+    auto world = World::create();
+    world->setTimeStep(0.01);
+    SkeletonPtr pendulum = createNLinkPendulum(
+        1u,
+        Eigen::Vector3d(0.1, 0.1, 0.5),
+        DOF_ROLL,
+        Eigen::Vector3d(0, 0, 0.25));
+    pendulum->getDof(0)->setDampingCoefficient(0.0);
+    world->addSkeleton(pendulum);
+
+    pendulum->setImplicitIntegration(implicit);
+    pendulum->setForceJacobians(
+        -kp * Eigen::MatrixXd::Identity(1, 1),
+        -kd * Eigen::MatrixXd::Identity(1, 1));
+
+    const auto numSteps = implicit ? 200u : 10u;
+    for (auto i = 0u; i < numSteps; ++i)
+    {
+      pendulum->setCommand(
+          0,
+          -kp * (pendulum->getPosition(0) - target)
+              - kd * pendulum->getVelocity(0));
+      world->step();
+    }
+
+    const double error = std::abs(pendulum->getPosition(0) - target);
+    if (implicit)
+      EXPECT_LT(error, 1e-3);
+    else
+      EXPECT_GT(error, 1.0);
+  }
+
+  // Invalid Jacobians are rejected
+  skel->setForceJacobians(Eigen::MatrixXd::Identity(2, 2), Eigen::MatrixXd());
+  EXPECT_EQ(skel->getForcePositionJacobian().size(), 0);
+  skel->clearForceJacobians();
+  EXPECT_EQ(skel->getForceVelocityJacobian().size(), 0);
+}
@@ -396,3 +396,139 @@ TEST(World, SetNewConstraintSolver)
   EXPECT_TRUE(world->getConstraintSolver()->getSkeletons().size() == 1);
   EXPECT_TRUE(world->getConstraintSolver()->getConstraints().size() == 1);
 }
+
+//==============================================================================
+SkeletonPtr createBox(
+    const std::string& name, const Eigen::Vector3d& position, bool mobile)
+{
+  auto skel = Skeleton::create(name);
+  BodyNode* body = nullptr;
+  if (mobile)
+  {
+    auto pair = skel->createJointAndBodyNodePair<FreeJoint>();
+    pair.first->setPositions(
+        FreeJoint::convertToPositions(Eigen::Isometry3d(
+            Eigen::Translation3d(position))));
+    body = pair.second;
+  }
+  else
+  {
+    auto pair = skel->createJointAndBodyNodePair<WeldJoint>();
+    pair.first->setTransformFromParentBodyNode(
+        Eigen::Isometry3d(Eigen::Translation3d(position)));
+    body = pair.second;
+  }
+
+  const Eigen::Vector3d size = mobile ? Eigen::Vector3d::Constant(0.2)
+                                      : Eigen::Vector3d(4.0, 4.0, 0.1);
+  body->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<BoxShape>(size));
+
+  return skel;
+}
+
+//==============================================================================
+TEST(World, Sleeping)
+{
+  auto world = World::create();
+  world->addSkeleton(
+      createBox("ground", Eigen::Vector3d(0.0, 0.0, -0.05), false));
+
+  // A stack of two boxes and a box that is not allowed to sleep
+  auto box1 = createBox("box1", Eigen::Vector3d(0.0, 0.0, 0.1), true);
+  auto box2 = createBox("box2", Eigen::Vector3d(0.0, 0.0, 0.3), true);
+  auto box3 = createBox("box3", Eigen::Vector3d(1.0, 0.0, 0.1), true);
+  box3->setSleepingAllowed(false);
+  world->addSkeleton(box1);
+  world->addSkeleton(box2);
+  world->addSkeleton(box3);
+
+  EXPECT_FALSE(world->getSleepingOption().mEnabled);
+  World::SleepingOption option;
+  option.mEnabled = true;
+  option.mTimeToSleep = 0.2;
+  world->setSleepingOption(option);
+
+  for (auto i = 0u; i < 2000u; ++i)
+    world->step();
+
+  // The stack falls asleep as a whole
+  EXPECT_TRUE(box1->isSleeping());
+  EXPECT_TRUE(box2->isSleeping());
+  EXPECT_FALSE(box3->isSleeping());
+  EXPECT_EQ(world->getNumSleepingSkeletons(), 2u);
+
+  // Sleeping skeletons don't move
+  const Eigen::VectorXd positions1 = box1->getPositions();
+  const Eigen::VectorXd positions2 = box2->getPositions();
+  for (auto i = 0u; i < 100u; ++i)
+    world->step();
+  EXPECT_EQ(box1->getPositions(), positions1);
+  EXPECT_EQ(box2->getPositions(), positions2);
+  EXPECT_EQ(world->getNumSleepingSkeletons(), 2u);
+
+  // Changing the state of a box wakes up the whole stack
+  box2->setVelocity(3, 0.5);
+  world->step();
+  EXPECT_FALSE(box1->isSleeping());
+  EXPECT_FALSE(box2->isSleeping());
+  EXPECT_NE(box2->getPositions(), positions2);
+
+  // Applying a force wakes up a box
+  for (auto i = 0u; i < 2000u; ++i)
+    world->step();
+  EXPECT_TRUE(box1->isSleeping());
+  box1->getBodyNode(0)->addExtForce(Eigen::Vector3d(10.0, 0.0, 0.0));
+  world->step();
+  EXPECT_FALSE(box1->isSleeping());
+
+  // Disabling sleeping wakes up all the skeletons
+  for (auto i = 0u; i < 2000u; ++i)
+    world->step();
+  EXPECT_EQ(world->getNumSleepingSkeletons(), 2u);
+  option.mEnabled = false;
+  world->setSleepingOption(option);
+  EXPECT_EQ(world->getNumSleepingSkeletons(), 0u);
+}
+
+//==============================================================================
+TEST(World, SleepingWokenByKinematicSkeleton)
+{
+  auto world = World::create();
+  world->addSkeleton(
+      createBox("ground", Eigen::Vector3d(0.0, 0.0, -0.05), false));
+
+  auto box = createBox("box", Eigen::Vector3d(0.0, 0.0, 0.1), true);
+  world->addSkeleton(box);
+
+  // A kinematic box that is moved by setting its positions
+  auto pusher = createBox("pusher", Eigen::Vector3d(1.0, 0.0, 0.1), true);
+  pusher->setMobile(false);
+  world->addSkeleton(pusher);
+
+  World::SleepingOption option;
+  option.mEnabled = true;
+  option.mTimeToSleep = 0.2;
+  world->setSleepingOption(option);
+
+  for (auto i = 0u; i < 2000u; ++i)
+    world->step();
+  ASSERT_TRUE(box->isSleeping());
+
+  // Resting on the immobile ground doesn't wake up the box
+  for (auto i = 0u; i < 100u; ++i)
+    world->step();
+  EXPECT_TRUE(box->isSleeping());
+
+  // The kinematic box moved into the sleeping box wakes it up
+  pusher->setPositions(FreeJoint::convertToPositions(
+      Eigen::Isometry3d(Eigen::Translation3d(0.15, 0.0, 0.1))));
+  world->step();
+  EXPECT_FALSE(box->isSleeping());
+
+  // The box is pushed away by the kinematic box
+  for (auto i = 0u; i < 10u; ++i)
+    world->step();
+  EXPECT_LT(box->getPositions()[3], 0.0);
+  EXPECT_FALSE(box->isSleeping());
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "TestHelpers.hpp"
+
+#include "dart/collision/dart/DARTCollisionDetector.hpp"
+#include "dart/config.hpp"
+#include "dart/constraint/constraint.hpp"
+#include "dart/dynamics/dynamics.hpp"
+#include "dart/external/odelcpsolver/matrix.h"
+#include "dart/math/Random.hpp"
+#include "dart/simulation/World.hpp"
+
+using namespace dart;
+
+//==============================================================================
+constraint::BoxedLcpProblem createRandomProblem(int numContacts)
+{
+  const int n = 3 * numContacts;
+
+  constraint::BoxedLcpProblem problem;
+  const Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+  problem.A = J * J.transpose() + 0.1 * Eigen::MatrixXd::Identity(n, n);
+  problem.b = Eigen::VectorXd::Random(n);
+  problem.lo.resize(n);
+  problem.hi.resize(n);
+  problem.findex.resize(n);
+  for (int i = 0; i < numContacts; ++i)
+  {
+    // Normal direction followed by two friction directions
+    problem.lo.segment<3>(3 * i) << 0.0, -1.0, -1.0;
+    problem.hi.segment<3>(3 * i) << math::constantsd::inf(), 0.5, 0.5;
+    problem.findex.segment<3>(3 * i) << -1, 3 * i, 3 * i;
+  }
+  problem.initialX = Eigen::VectorXd::Zero(n);
+  problem.x = Eigen::VectorXd::Random(n);
+  problem.primarySolverType = "Dantzig";
+  problem.secondarySolverType = "PgsBoxedLcpSolver";
+  problem.primarySucceeded = true;
+
+  return problem;
+}
+
+//==============================================================================
+TEST(BoxedLcpCorpus, RecordAndLoad)
+{
+  const std::string path = "test_BoxedLcpCorpus_RecordAndLoad.lcp";
+
+  std::vector<constraint::BoxedLcpProblem> problems;
+  for (int i = 0; i < 5; ++i)
+    problems.push_back(createRandomProblem(i + 1));
+  problems.back().primarySucceeded = false;
+  problems.back().usedSecondary = true;
+
+  {
+    constraint::BoxedLcpRecorder recorder(path);
+    ASSERT_TRUE(recorder.isOpen());
+    for (const auto& problem : problems)
+      recorder.record(problem);
+    EXPECT_EQ(recorder.getNumRecords(), problems.size());
+  }
+
+  std::vector<constraint::BoxedLcpProblem> loaded;
+  ASSERT_TRUE(constraint::loadBoxedLcpCorpus(path, loaded));
+  ASSERT_EQ(loaded.size(), problems.size());
+  for (auto i = 0u; i < problems.size(); ++i)
+  {
+    EXPECT_TRUE(equals(loaded[i].A, problems[i].A));
+    EXPECT_TRUE(equals(loaded[i].b, problems[i].b));
+    EXPECT_TRUE(loaded[i].lo == problems[i].lo);
+    EXPECT_TRUE(loaded[i].hi == problems[i].hi);
+    EXPECT_TRUE(loaded[i].findex == problems[i].findex);
+    EXPECT_TRUE(equals(loaded[i].initialX, problems[i].initialX));
+    EXPECT_TRUE(equals(loaded[i].x, problems[i].x));
+    EXPECT_EQ(loaded[i].primarySolverType, problems[i].primarySolverType);
+    EXPECT_EQ(loaded[i].secondarySolverType, problems[i].secondarySolverType);
+    EXPECT_EQ(loaded[i].primarySucceeded, problems[i].primarySucceeded);
+    EXPECT_EQ(loaded[i].usedSecondary, problems[i].usedSecondary);
+  }
+
+  std::remove(path.c_str());
+
+  // The checked-in corpus should be readable as well
+  loaded.clear();
+  EXPECT_TRUE(constraint::loadBoxedLcpCorpus(
+      DART_DATA_PATH "lcp/stacking.lcp", loaded));
+  EXPECT_FALSE(loaded.empty());
+}
+
+//==============================================================================
+TEST(BoxedLcpCorpus, CorruptedDimension)
+{
+  const std::string path = "test_BoxedLcpCorpus_CorruptedDimension.lcp";
+
+  // The dimension of the first problem follows the magic and the version
+  const std::size_t dimensionOffset = 8u + sizeof(std::uint32_t);
+
+  for (const std::int32_t dimension : {1 << 14, 1 << 30})
+  {
+    {
+      constraint::BoxedLcpRecorder recorder(path);
+      ASSERT_TRUE(recorder.isOpen());
+      recorder.record(createRandomProblem(2));
+    }
+
+    {
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(static_cast<std::streamoff>(dimensionOffset));
+      file.write(reinterpret_cast<const char*>(&dimension), sizeof(dimension));
+    }
+
+    // The dimension doesn't fit in the file, so the problem must be rejected
+    // before its matrix is allocated
+    std::vector<constraint::BoxedLcpProblem> loaded;
+    EXPECT_FALSE(constraint::loadBoxedLcpCorpus(path, loaded));
+    EXPECT_TRUE(loaded.empty());
+  }
+
+  std::remove(path.c_str());
+}
+
+//==============================================================================
+TEST(BoxedLcpCorpus, Replay)
+{
+  constraint::DantzigBoxedLcpSolver dantzig;
+  constraint::PgsBoxedLcpSolver pgs;
+
+  for (int i = 1; i < 10; ++i)
+  {
+    // Dantzig solver solves the problems with fixed bounds exactly but only
+    // approximates the friction cones
+    auto problem = createRandomProblem(i);
+    problem.findex.setConstant(-1);
+
+    const auto result = constraint::replayBoxedLcpProblem(dantzig, problem);
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.x.size(), problem.getDimension());
+    EXPECT_GE(result.time, 0.0);
+    EXPECT_LT(result.residual, 1e-6);
+    EXPECT_LT(result.complementarityError, 1e-6);
+
+    const auto pgsResult = constraint::replayBoxedLcpProblem(pgs, problem);
+    EXPECT_GT(pgsResult.numIterations, 0);
+  }
+}
+
+//==============================================================================
+TEST(BoxedLcpCorpus, RecordFromConstraintSolver)
+{
+  const std::string path = "test_BoxedLcpCorpus_RecordFromSolver.lcp";
+
+  auto world = simulation::World::create();
+  auto solver = std::make_unique<constraint::BoxedLcpConstraintSolver>();
+  solver->setCollisionDetector(collision::DARTCollisionDetector::create());
+  auto recorder = std::make_shared<constraint::BoxedLcpRecorder>(path);
+  solver->setLcpRecorder(recorder);
+  EXPECT_EQ(solver->getLcpRecorder(), recorder);
+  world->setConstraintSolver(std::move(solver));
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(2.0, 2.0, 0.1)));
+  world->addSkeleton(ground);
+
+  auto box = dynamics::Skeleton::create("box");
+  auto boxBody = box->createJointAndBodyNodePair<dynamics::FreeJoint>().second;
+  boxBody->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d::Constant(0.2)));
+  box->setPosition(5, 0.149);
+  world->addSkeleton(box);
+
+  for (auto i = 0u; i < 10u; ++i)
+    world->step();
+
+  EXPECT_GT(recorder->getNumRecords(), 0u);
+  recorder->flush();
+
+  std::vector<constraint::BoxedLcpProblem> problems;
+  ASSERT_TRUE(constraint::loadBoxedLcpCorpus(path, problems));
+  ASSERT_EQ(problems.size(), recorder->getNumRecords());
+
+  constraint::DantzigBoxedLcpSolver dantzig;
+  for (const auto& problem : problems)
+  {
+    EXPECT_GT(problem.getDimension(), 0);
+    EXPECT_EQ(problem.primarySolverType, dantzig.getType());
+    EXPECT_TRUE(problem.primarySucceeded);
+    EXPECT_FALSE(problem.usedSecondary);
+
+    // Replaying with the same solver reproduces the applied solution
+    const auto result = constraint::replayBoxedLcpProblem(dantzig, problem);
+    EXPECT_TRUE(result.success);
+    EXPECT_TRUE(equals(result.x, problem.x, 1e-8));
+  }
+
+  std::remove(path.c_str());
+}
+
+//==============================================================================
+TEST(BoxedLcpCorpus, DantzigSimdKernels)
+{
+  if (!constraint::DantzigBoxedLcpSolver::isSimdKernelSupported())
+    return;
+
+  constraint::DantzigBoxedLcpSolver scalar;
+  scalar.setUseSimdKernels(false);
+  constraint::DantzigBoxedLcpSolver simd;
+  simd.setUseSimdKernels(true);
+  EXPECT_TRUE(simd.getUseSimdKernels());
+
+  // The SIMD factorization is used from 96 rows on. Cover the 8-row and
+  // 4-row blocks and all the left-over rows.
+  for (int n = 96; n < 104; ++n)
+  {
+    const int nskip = dPAD(n);
+    const Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+    const Eigen::MatrixXd A
+        = J * J.transpose() + 0.1 * Eigen::MatrixXd::Identity(n, n);
+    const Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+
+    std::vector<double> L(n * nskip, 0.0);
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+        L[i * nskip + j] = A(i, j);
+    std::vector<double> d(n);
+    Eigen::VectorXd x = b;
+
+    const int previous = external::ode::dSetSimdKernelsEnabled(1);
+    external::ode::dFactorLDLT(L.data(), d.data(), n, nskip);
+    external::ode::dSolveLDLT(L.data(), d.data(), x.data(), n, nskip);
+    external::ode::dSetSimdKernelsEnabled(previous);
+
+    EXPECT_TRUE(equals(Eigen::VectorXd(A * x), b, 1e-10));
+  }
+
+  for (int numContacts : {1, 3, 10, 40, 100})
+  {
+    const auto problem = createRandomProblem(numContacts);
+
+    // The scalar kernels give bitwise identical results
+    const auto expected = constraint::replayBoxedLcpProblem(scalar, problem);
+    const auto repeated = constraint::replayBoxedLcpProblem(scalar, problem);
+    EXPECT_TRUE(repeated.x == expected.x);
+
+    // The SIMD kernels only differ by rounding
+    const auto result = constraint::replayBoxedLcpProblem(simd, problem);
+    EXPECT_EQ(result.success, expected.success);
+    EXPECT_TRUE(equals(result.x, expected.x, 1e-6));
+  }
+
+  // Solving doesn't change the kernel selection of the calling thread
+  const int enabled = external::ode::dSimdKernelsEnabled();
+  constraint::replayBoxedLcpProblem(simd, createRandomProblem(2));
+  EXPECT_EQ(external::ode::dSimdKernelsEnabled(), enabled);
+}
@@ -31,12 +31,14 @@
  */
 
 #include <iostream>
+#include <thread>
 
 #include <gtest/gtest.h>
 
 #include <dart/dynamics/SphereShape.hpp>
 #include "dart/dynamics/BoxShape.hpp"
 #include "dart/dynamics/FreeJoint.hpp"
+#include "dart/dynamics/SimpleFrame.hpp"
 #include "dart/dynamics/Skeleton.hpp"
 
 #include "dart/constraint/ConstraintSolver.hpp"
@@ -264,6 +266,347 @@ TEST_P(CollisionGroupsTest, BodyNodeSubscription)
   EXPECT_FALSE(group->collide());
 }
 
+TEST_P(CollisionGroupsTest, ContactCache)
+{
+  if (!dart::collision::CollisionDetector::getFactory()->canCreate(GetParam()))
+  {
+    std::cout << "Skipping test for [" << GetParam() << "], because it is not "
+              << "available" << std::endl;
+    return;
+  }
+  else
+  {
+    std::cout << "Running CollisionGroups test for [" << GetParam() << "]"
+              << std::endl;
+  }
+
+  // The contact cache is only used by the DART and FCL collision detectors
+  if (std::string(GetParam()) != "dart" && std::string(GetParam()) != "fcl")
+    return;
+
+  auto cd
+      = dart::collision::CollisionDetector::getFactory()->create(GetParam());
+
+  auto group = cd->createCollisionGroup();
+  EXPECT_FALSE(group->isContactCacheEnabled());
+  group->setContactCacheEnabled();
+  EXPECT_TRUE(group->isContactCacheEnabled());
+  ASSERT_NE(group->getContactCache(), nullptr);
+
+  auto skel1 = dart::dynamics::Skeleton::create("skel1");
+  auto skel2 = dart::dynamics::Skeleton::create("skel2");
+
+  auto pair1 = skel1->createJointAndBodyNodePair<dart::dynamics::FreeJoint>();
+  auto pair2 = skel2->createJointAndBodyNodePair<dart::dynamics::FreeJoint>();
+
+  Eigen::Isometry3d tf{Eigen::Translation3d(0.5, 0.0, 0.0)};
+  pair1.first->setTransform(tf);
+  tf.translation()[0] = -0.5;
+  pair2.first->setTransform(tf);
+
+  auto sphere = std::make_shared<dart::dynamics::SphereShape>(0.75);
+  pair1.second->createShapeNodeWith<dart::dynamics::CollisionAspect>(sphere);
+  pair2.second->createShapeNodeWith<dart::dynamics::CollisionAspect>(sphere);
+
+  group->subscribeTo(skel1, skel2);
+
+  dart::collision::CollisionOption option;
+  dart::collision::CollisionResult result;
+
+  // The first query has nothing to reuse
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), 0u);
+  EXPECT_EQ(result.getNumContactCacheMisses(), 1u);
+  const auto numContacts = result.getNumContacts();
+  const Eigen::Vector3d point = result.getContact(0).point;
+  const Eigen::Vector3d normal = result.getContact(0).normal;
+
+  // Nothing has moved, so the contacts should be reused
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), 1u);
+  EXPECT_EQ(result.getNumContactCacheMisses(), 0u);
+  EXPECT_DOUBLE_EQ(result.getContactCacheHitRate(), 1.0);
+  EXPECT_EQ(result.getNumContacts(), numContacts);
+  EXPECT_TRUE(result.getContact(0).point.isApprox(point));
+  EXPECT_TRUE(result.getContact(0).normal.isApprox(normal));
+
+  // Moving both objects together keeps the relative transform, so the cached
+  // contacts should be reused and moved along with the objects.
+  const Eigen::Vector3d offset(0.0, 0.0, 2.0);
+  tf.translation() = Eigen::Vector3d(0.5, 0.0, 0.0) + offset;
+  pair1.first->setTransform(tf);
+  tf.translation() = Eigen::Vector3d(-0.5, 0.0, 0.0) + offset;
+  pair2.first->setTransform(tf);
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), 1u);
+  EXPECT_TRUE(result.getContact(0).point.isApprox(point + offset));
+
+  // Changing the relative transform requires running the narrowphase again
+  tf.translation() = Eigen::Vector3d(-1.2, 0.0, 0.0) + offset;
+  pair2.first->setTransform(tf);
+  EXPECT_FALSE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContactCacheMisses(), 1u);
+
+  // Changing the shape invalidates the cached (empty) result of the pair
+  sphere->setRadius(1.0);
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), 0u);
+
+  // Binary queries don't compute contacts, so they must not evict the cache
+  EXPECT_TRUE(group->collide(option, nullptr));
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), 1u);
+
+  auto skel3 = dart::dynamics::Skeleton::create("skel3");
+  auto pair3 = skel3->createJointAndBodyNodePair<dart::dynamics::FreeJoint>();
+  tf.translation() = Eigen::Vector3d(0.5, 0.0, 3.0);
+  pair3.first->setTransform(tf);
+  pair3.second->createShapeNodeWith<dart::dynamics::CollisionAspect>(
+      std::make_shared<dart::dynamics::SphereShape>(0.5));
+  auto otherGroup = cd->createCollisionGroup(skel3.get());
+
+  // The pairs between two groups are cached regardless of the order of the
+  // groups, and separately from the pairs within the group.
+  EXPECT_TRUE(otherGroup->collide(group.get(), option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), 0u);
+  EXPECT_GT(result.getNumContactCacheMisses(), 0u);
+  const auto numPairs = result.getNumContactCacheMisses();
+
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), 1u);
+  EXPECT_EQ(result.getNumContactCacheMisses(), 0u);
+
+  EXPECT_TRUE(group->collide(otherGroup.get(), option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), numPairs);
+  EXPECT_EQ(result.getNumContactCacheMisses(), 0u);
+
+  group->setContactCacheEnabled(false);
+  EXPECT_TRUE(group->collide(option, &result));
+  EXPECT_EQ(result.getNumContactCacheHits(), 0u);
+  EXPECT_EQ(result.getNumContactCacheMisses(), 0u);
+}
+
+TEST_P(CollisionGroupsTest, ParallelNarrowphase)
+{
+  if (!dart::collision::CollisionDetector::getFactory()->canCreate(GetParam()))
+  {
+    std::cout << "Skipping test for [" << GetParam() << "], because it is not "
+              << "available" << std::endl;
+    return;
+  }
+  else
+  {
+    std::cout << "Running CollisionGroups test for [" << GetParam() << "]"
+              << std::endl;
+  }
+
+  // Only the DART and FCL collision detectors run the narrowphase in parallel
+  if (std::string(GetParam()) != "dart" && std::string(GetParam()) != "fcl")
+    return;
+
+  auto cd
+      = dart::collision::CollisionDetector::getFactory()->create(GetParam());
+  auto group = cd->createCollisionGroup();
+
+  // A row of overlapping spheres
+  auto sphere = std::make_shared<dart::dynamics::SphereShape>(0.3);
+  std::vector<dart::dynamics::SkeletonPtr> skels;
+  for (auto i = 0u; i < 50u; ++i)
+  {
+    auto skel = dart::dynamics::Skeleton::create();
+    auto pair = skel->createJointAndBodyNodePair<dart::dynamics::FreeJoint>();
+    pair.second->createShapeNodeWith<dart::dynamics::CollisionAspect>(sphere);
+
+    Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+    tf.translation()[0] = 0.5 * i;
+    pair.first->setTransform(tf);
+
+    group->subscribeTo(skel);
+    skels.push_back(skel);
+  }
+
+  const auto expectSameContacts = [](
+      const dart::collision::CollisionResult& result1,
+      const dart::collision::CollisionResult& result2) {
+    ASSERT_EQ(result1.getNumContacts(), result2.getNumContacts());
+    for (auto i = 0u; i < result1.getNumContacts(); ++i)
+    {
+      const auto& contact1 = result1.getContact(i);
+      const auto& contact2 = result2.getContact(i);
+      EXPECT_EQ(contact1.collisionObject1, contact2.collisionObject1);
+      EXPECT_EQ(contact1.collisionObject2, contact2.collisionObject2);
+      EXPECT_TRUE(contact1.point.isApprox(contact2.point));
+      EXPECT_TRUE(contact1.normal.isApprox(contact2.normal));
+    }
+  };
+
+  dart::collision::CollisionOption serialOption;
+  dart::collision::CollisionOption parallelOption;
+  parallelOption.numThreads = 4u;
+
+  dart::collision::CollisionResult serialResult;
+  dart::collision::CollisionResult parallelResult;
+
+  EXPECT_TRUE(group->collide(serialOption, &serialResult));
+  EXPECT_TRUE(group->collide(parallelOption, &parallelResult));
+  EXPECT_GE(serialResult.getNumContacts(), 49u);
+  expectSameContacts(serialResult, parallelResult);
+
+  // The maximum number of contacts should be respected
+  serialOption.maxNumContacts = 10u;
+  parallelOption.maxNumContacts = 10u;
+  EXPECT_TRUE(group->collide(serialOption, &serialResult));
+  EXPECT_TRUE(group->collide(parallelOption, &parallelResult));
+  EXPECT_EQ(parallelResult.getNumContacts(), 10u);
+  expectSameContacts(serialResult, parallelResult);
+
+  // Binary check
+  EXPECT_TRUE(group->collide(parallelOption));
+
+  // Concurrent queries that request different numbers of threads must not
+  // destroy the ThreadPool that the other query is still using
+  auto otherGroup = cd->createCollisionGroup();
+  std::vector<dart::dynamics::SkeletonPtr> clones;
+  for (const auto& skel : skels)
+  {
+    clones.push_back(skel->cloneSkeleton());
+    otherGroup->subscribeTo(clones.back());
+  }
+  group->update();
+  otherGroup->update();
+  group->setAutomaticUpdate(false);
+  otherGroup->setAutomaticUpdate(false);
+
+  dart::collision::CollisionResult expectedResult;
+  EXPECT_TRUE(
+      group->collide(dart::collision::CollisionOption(), &expectedResult));
+  const auto expectedNumContacts = 50u * expectedResult.getNumContacts();
+  EXPECT_TRUE(otherGroup->collide());
+
+  std::vector<std::size_t> numContacts(2u, 0u);
+  std::vector<std::thread> threads;
+  for (auto k = 0u; k < 2u; ++k)
+  {
+    threads.emplace_back([&, k]() {
+      auto* queriedGroup = (0u == k) ? group.get() : otherGroup.get();
+      dart::collision::CollisionOption option;
+      option.numThreads = 2u + k;
+      dart::collision::CollisionResult result;
+      for (auto i = 0u; i < 50u; ++i)
+      {
+        queriedGroup->collide(option, &result);
+        numContacts[k] += result.getNumContacts();
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(numContacts[0], expectedNumContacts);
+  EXPECT_EQ(numContacts[1], expectedNumContacts);
+  group->setAutomaticUpdate(true);
+
+  // The cached contacts are merged in the same order
+  group->setContactCacheEnabled();
+  serialOption.maxNumContacts = 1000u;
+  parallelOption.maxNumContacts = 1000u;
+  EXPECT_TRUE(group->collide(serialOption, &serialResult));
+  EXPECT_TRUE(group->collide(parallelOption, &parallelResult));
+  EXPECT_EQ(parallelResult.getNumContactCacheMisses(), 0u);
+  expectSameContacts(serialResult, parallelResult);
+}
+
+TEST_P(CollisionGroupsTest, IncrementalUpdate)
+{
+  if (!dart::collision::CollisionDetector::getFactory()->canCreate(GetParam()))
+  {
+    std::cout << "Skipping test for [" << GetParam() << "], because it is not "
+              << "available" << std::endl;
+    return;
+  }
+  else
+  {
+    std::cout << "Running CollisionGroups test for [" << GetParam() << "]"
+              << std::endl;
+  }
+
+  auto cd
+      = dart::collision::CollisionDetector::getFactory()->create(GetParam());
+  auto group = cd->createCollisionGroup();
+
+  auto sphere = std::make_shared<dart::dynamics::SphereShape>(0.5);
+
+  std::vector<dart::dynamics::SkeletonPtr> skels;
+  std::vector<dart::dynamics::FreeJoint*> joints;
+  for (auto i = 0u; i < 2u; ++i)
+  {
+    auto skel = dart::dynamics::Skeleton::create();
+    auto pair = skel->createJointAndBodyNodePair<dart::dynamics::FreeJoint>();
+    pair.second->createShapeNodeWith<dart::dynamics::CollisionAspect>(sphere);
+
+    Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+    tf.translation()[0] = 5.0 * i;
+    pair.first->setTransform(tf);
+
+    group->subscribeTo(skel);
+    skels.push_back(skel);
+    joints.push_back(pair.first);
+  }
+
+  EXPECT_FALSE(group->collide());
+
+  // Moving a subscribed Skeleton should be picked up by the next check
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation()[0] = 4.5;
+  joints[0]->setTransform(tf);
+  EXPECT_TRUE(group->collide());
+
+  // Reading the transform of the BodyNode in between should not hide the
+  // change of its ShapeNodes
+  tf.translation()[0] = 0.0;
+  joints[0]->setTransform(tf);
+  EXPECT_TRUE(skels[0]->getBodyNode(0)->getWorldTransform().isApprox(tf));
+  EXPECT_FALSE(group->collide());
+
+  // Moving a manually added ShapeFrame should be picked up as well
+  auto frame = dart::dynamics::SimpleFrame::createShared(
+      dart::dynamics::Frame::World());
+  frame->setShape(std::make_shared<dart::dynamics::SphereShape>(0.5));
+  frame->setTranslation(Eigen::Vector3d(-5.0, 0.0, 0.0));
+  group->addShapeFrame(frame.get());
+  EXPECT_FALSE(group->collide());
+
+  frame->setTranslation(Eigen::Vector3d(-0.5, 0.0, 0.0));
+  EXPECT_TRUE(group->collide());
+
+  group->removeShapeFrame(frame.get());
+  EXPECT_FALSE(group->collide());
+
+  // Moving the removed ShapeFrame should not affect the group
+  frame->setTranslation(Eigen::Vector3d(-5.0, 0.0, 0.0));
+  EXPECT_FALSE(group->collide());
+  EXPECT_EQ(group->getNumShapeFrames(), 2u);
+
+  // Changing the shape without moving should be picked up as well
+  sphere->setRadius(3.0);
+  EXPECT_TRUE(group->collide());
+
+  // Removing the first ShapeFrame moves the last one into its place, so the
+  // lookups of the remaining ShapeFrames must follow.
+  group->addShapeFrame(frame.get());
+  const auto* shapeNode0 = skels[0]->getBodyNode(0)->getShapeNode(0);
+  const auto* shapeNode1 = skels[1]->getBodyNode(0)->getShapeNode(0);
+  EXPECT_EQ(group->getShapeFrame(0u), shapeNode0);
+  group->removeShapeFrame(shapeNode0);
+  EXPECT_EQ(group->getNumShapeFrames(), 2u);
+  EXPECT_FALSE(group->hasShapeFrame(shapeNode0));
+  EXPECT_EQ(group->getShapeFrame(0u), frame.get());
+
+  group->removeShapeFrame(frame.get());
+  EXPECT_EQ(group->getNumShapeFrames(), 1u);
+  EXPECT_EQ(group->getShapeFrame(0u), shapeNode1);
+  EXPECT_FALSE(group->collide());
+}
+
 INSTANTIATE_TEST_CASE_P(
     CollisionEngine,
     CollisionGroupsTest,
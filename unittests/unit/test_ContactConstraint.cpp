@@ -34,6 +34,7 @@
 
 #include "TestHelpers.hpp"
 
+#include "dart/collision/dart/DARTCollisionDetector.hpp"
 #include "dart/common/common.hpp"
 #include "dart/constraint/constraint.hpp"
 #include "dart/dynamics/dynamics.hpp"
@@ -43,11 +44,10 @@ using namespace dart;
 
 //==============================================================================
 void testContactWithKinematicJoint(
-    const constraint::BoxedLcpSolverPtr& lcpSolver, double tol)
+    std::unique_ptr<constraint::ConstraintSolver> solver, double tol)
 {
   auto world = std::make_shared<simulation::World>();
-  world->setConstraintSolver(
-      std::make_unique<constraint::BoxedLcpConstraintSolver>(lcpSolver));
+  world->setConstraintSolver(std::move(solver));
 
   auto skeleton1 = dynamics::Skeleton::create("skeleton1");
   auto pair1 = skeleton1->createJointAndBodyNodePair<dynamics::FreeJoint>();
@@ -94,13 +94,395 @@ void testContactWithKinematicJoint(
 TEST(ContactConstraint, ContactWithKinematicJoint)
 {
   testContactWithKinematicJoint(
-      std::make_shared<constraint::DantzigBoxedLcpSolver>(), 1e-6);
+      std::make_unique<constraint::BoxedLcpConstraintSolver>(
+          std::make_shared<constraint::DantzigBoxedLcpSolver>()),
+      1e-6);
 
 #ifdef DART_ARCH_32BITS
   testContactWithKinematicJoint(
-      std::make_shared<constraint::PgsBoxedLcpSolver>(), 1e-3);
+      std::make_unique<constraint::BoxedLcpConstraintSolver>(
+          std::make_shared<constraint::PgsBoxedLcpSolver>()),
+      1e-3);
 #else
   testContactWithKinematicJoint(
-      std::make_shared<constraint::PgsBoxedLcpSolver>(), 1e-4);
+      std::make_unique<constraint::BoxedLcpConstraintSolver>(
+          std::make_shared<constraint::PgsBoxedLcpSolver>()),
+      1e-4);
 #endif
+
+  testContactWithKinematicJoint(
+      std::make_unique<constraint::MatrixFreePgsConstraintSolver>(), 1e-4);
+}
+
+//==============================================================================
+simulation::WorldPtr createStackAndChainWorld(
+    std::unique_ptr<constraint::ConstraintSolver> solver)
+{
+  auto world = simulation::World::create();
+  solver->setCollisionDetector(collision::DARTCollisionDetector::create());
+  world->setConstraintSolver(std::move(solver));
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(4.0, 4.0, 0.1)));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = -0.05;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(tf);
+  world->addSkeleton(ground);
+
+  // A stack of boxes
+  for (auto i = 0u; i < 3u; ++i)
+  {
+    auto box = dynamics::Skeleton::create("box" + std::to_string(i));
+    auto body = box->createJointAndBodyNodePair<dynamics::FreeJoint>().second;
+    body->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+        std::make_shared<dynamics::BoxShape>(Eigen::Vector3d::Constant(0.2)));
+    box->setPosition(5, 0.1 + 0.2 * i);
+    world->addSkeleton(box);
+  }
+
+  // A chain of revolute joints falling to the joint limits
+  auto chain = dynamics::Skeleton::create("chain");
+  dynamics::BodyNode* parent = nullptr;
+  for (auto i = 0u; i < 3u; ++i)
+  {
+    const auto name = "link" + std::to_string(i);
+    dynamics::RevoluteJoint::Properties properties;
+    properties.mName = name + "_joint";
+    properties.mAxis = Eigen::Vector3d::UnitY();
+    properties.mT_ParentBodyToJoint.translation()
+        = parent ? Eigen::Vector3d(0.3, 0.0, 0.0) : Eigen::Vector3d(1, 0, 1);
+    properties.mIsPositionLimitEnforced = true;
+    properties.mPositionLowerLimits[0] = -0.3;
+    properties.mPositionUpperLimits[0] = 0.3;
+    parent = chain
+                 ->createJointAndBodyNodePair<dynamics::RevoluteJoint>(
+                     parent,
+                     properties,
+                     dynamics::BodyNode::AspectProperties(name))
+                 .second;
+    parent->createShapeNodeWith<DynamicsAspect>(
+        std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(0.3, 0.1, 0.1)));
+  }
+  world->addSkeleton(chain);
+
+  return world;
+}
+
+//==============================================================================
+TEST(ContactConstraint, MatrixFreePgsConstraintSolver)
+{
+  auto solver = std::make_unique<constraint::MatrixFreePgsConstraintSolver>();
+  auto option = solver->getOption();
+  option.mMaxIteration = 100;
+  solver->setOption(option);
+  auto pgsSolver = solver.get();
+
+  auto world = createStackAndChainWorld(std::move(solver));
+  auto expectedWorld = createStackAndChainWorld(
+      std::make_unique<constraint::BoxedLcpConstraintSolver>());
+
+  for (auto i = 0u; i < 200u; ++i)
+  {
+    world->step();
+    expectedWorld->step();
+    EXPECT_GT(pgsSolver->getLastNumIterations(), 0);
+  }
+
+  // The results should agree with the ones of the dense LCP formulation
+  for (auto i = 1u; i < world->getNumSkeletons(); ++i)
+  {
+    const auto skeleton = world->getSkeleton(i);
+    const auto expected = expectedWorld->getSkeleton(i);
+    EXPECT_TRUE(
+        equals(skeleton->getPositions(), expected->getPositions(), 1e-3));
+    EXPECT_TRUE(
+        equals(skeleton->getVelocities(), expected->getVelocities(), 1e-2));
+  }
+
+  // The joint limits of the chain are respected
+  const auto chain = world->getSkeleton("chain");
+  for (auto i = 0u; i < chain->getNumDofs(); ++i)
+    EXPECT_LE(std::abs(chain->getPosition(i)), 0.3 + 1e-2);
+}
+
+//==============================================================================
+simulation::WorldPtr createSeparateBoxesWorld(bool splitTrees)
+{
+  auto world = simulation::World::create();
+  auto solver = std::make_unique<constraint::BoxedLcpConstraintSolver>();
+  solver->setCollisionDetector(collision::DARTCollisionDetector::create());
+  solver->setSplitTreesIntoGroups(splitTrees);
+  world->setConstraintSolver(std::move(solver));
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(4.0, 4.0, 0.1)));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = -0.05;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(tf);
+  world->addSkeleton(ground);
+
+  // Two boxes modeled as separate skeletons, and two more boxes modeled as
+  // the trees of a single skeleton. All of them only touch the ground.
+  auto boxes = dynamics::Skeleton::create("boxes");
+  for (auto i = 0u; i < 4u; ++i)
+  {
+    auto skeleton = boxes;
+    if (i < 2u)
+    {
+      skeleton = dynamics::Skeleton::create("box" + std::to_string(i));
+      world->addSkeleton(skeleton);
+    }
+
+    auto pair = skeleton->createJointAndBodyNodePair<dynamics::FreeJoint>();
+    pair.second->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+        std::make_shared<dynamics::BoxShape>(Eigen::Vector3d::Constant(0.2)));
+    pair.first->setPosition(3, -1.5 + 1.0 * i);
+    pair.first->setPosition(5, 0.1);
+    pair.first->setVelocity(3, 0.1 * i);
+  }
+  world->addSkeleton(boxes);
+
+  return world;
+}
+
+//==============================================================================
+TEST(ContactConstraint, ConstrainedGroups)
+{
+  auto world = createSeparateBoxesWorld(false);
+  auto splitWorld = createSeparateBoxesWorld(true);
+  const auto solver = world->getConstraintSolver();
+  const auto splitSolver = splitWorld->getConstraintSolver();
+  EXPECT_FALSE(solver->isSplittingTreesIntoGroups());
+  EXPECT_TRUE(splitSolver->isSplittingTreesIntoGroups());
+
+  for (auto i = 0u; i < 100u; ++i)
+  {
+    world->step();
+    splitWorld->step();
+  }
+
+  // The ground is immobile, so it doesn't couple the boxes
+  ASSERT_EQ(solver->getNumConstrainedGroups(), 3u);
+  for (auto i = 0u; i < solver->getNumConstrainedGroups(); ++i)
+    EXPECT_EQ(solver->getConstrainedGroup(i).getNumSkeletons(), 1u);
+
+  // The trees of the skeleton with two boxes are solved separately
+  ASSERT_EQ(splitSolver->getNumConstrainedGroups(), 4u);
+  for (auto i = 0u; i < splitSolver->getNumConstrainedGroups(); ++i)
+    EXPECT_EQ(splitSolver->getConstrainedGroup(i).getNumSkeletons(), 1u);
+
+  // Splitting the groups doesn't change the results
+  for (auto i = 1u; i < world->getNumSkeletons(); ++i)
+  {
+    const auto skeleton = world->getSkeleton(i);
+    const auto expected = splitWorld->getSkeleton(i);
+    EXPECT_TRUE(
+        equals(skeleton->getPositions(), expected->getPositions(), 1e-5));
+    EXPECT_TRUE(
+        equals(skeleton->getVelocities(), expected->getVelocities(), 1e-5));
+  }
+
+  // The boxes rest on the ground
+  const auto boxes = world->getSkeleton("boxes");
+  for (auto i = 0u; i < boxes->getNumBodyNodes(); ++i)
+  {
+    EXPECT_NEAR(
+        boxes->getBodyNode(i)->getTransform().translation().z(), 0.1, 1e-2);
+  }
+}
+
+//==============================================================================
+simulation::WorldPtr createFastFallingBoxWorld(
+    double speculativeContactMargin, bool continuousCollision)
+{
+  auto world = simulation::World::create();
+  world->setTimeStep(0.01);
+  auto solver = std::make_unique<constraint::BoxedLcpConstraintSolver>();
+  solver->setCollisionDetector(collision::DARTCollisionDetector::create());
+  solver->setSpeculativeContactMargin(speculativeContactMargin);
+  solver->setContinuousCollisionEnabled(continuousCollision);
+  world->setConstraintSolver(std::move(solver));
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(4.0, 4.0, 0.1)));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = -0.05;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(tf);
+  world->addSkeleton(ground);
+
+  // The box moves farther than its size and the thickness of the ground in a
+  // single time step
+  auto box = dynamics::Skeleton::create("box");
+  auto pair = box->createJointAndBodyNodePair<dynamics::FreeJoint>();
+  pair.second->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d::Constant(0.2)));
+  pair.first->setPosition(5, 0.3);
+  pair.first->setVelocity(5, -60.0);
+  pair.second->setContinuousCollisionCheck(continuousCollision);
+  world->addSkeleton(box);
+
+  return world;
+}
+
+//==============================================================================
+TEST(ContactConstraint, SpeculativeContacts)
+{
+  auto world = createFastFallingBoxWorld(0.0, false);
+  auto speculativeWorld = createFastFallingBoxWorld(0.5, false);
+  const auto solver = speculativeWorld->getConstraintSolver();
+  EXPECT_DOUBLE_EQ(solver->getSpeculativeContactMargin(), 0.5);
+  EXPECT_DOUBLE_EQ(solver->getCollisionOption().contactMargin, 0.5);
+
+  // The separated pair is reported with the gap as negative penetration depth
+  collision::CollisionResult result;
+  solver->getCollisionGroup()->collide(solver->getCollisionOption(), &result);
+  ASSERT_TRUE(result.isCollision());
+  for (const auto& contact : result.getContacts())
+    EXPECT_NEAR(contact.penetrationDepth, -0.2, 1e-6);
+
+  // ...but not by the binary check
+  EXPECT_FALSE(solver->getCollisionGroup()->collide(
+      solver->getCollisionOption(), nullptr));
+
+  for (auto i = 0u; i < 50u; ++i)
+  {
+    world->step();
+    speculativeWorld->step();
+  }
+
+  // Without speculative contacts, the box tunnels through the ground
+  const auto box = world->getSkeleton("box")->getBodyNode(0);
+  EXPECT_LT(box->getTransform().translation().z(), 0.0);
+
+  // The speculative contacts stop the box at the surface of the ground
+  const auto speculativeBox
+      = speculativeWorld->getSkeleton("box")->getBodyNode(0);
+  EXPECT_NEAR(speculativeBox->getTransform().translation().z(), 0.1, 1e-2);
+}
+
+//==============================================================================
+TEST(ContactConstraint, ContinuousCollision)
+{
+  auto world = createFastFallingBoxWorld(0.0, true);
+  const auto solver = world->getConstraintSolver();
+  EXPECT_TRUE(solver->isContinuousCollisionEnabled());
+  EXPECT_DOUBLE_EQ(
+      solver->getCollisionOption().continuousCollisionTimeStep,
+      world->getTimeStep());
+
+  // The box hits the ground within the time step, so the contacts at the time
+  // of impact are reported with the remaining gap as negative depth
+  collision::CollisionResult result;
+  solver->getCollisionGroup()->collide(solver->getCollisionOption(), &result);
+  ASSERT_TRUE(result.isCollision());
+  for (const auto& contact : result.getContacts())
+  {
+    EXPECT_NEAR(contact.penetrationDepth, -0.2, 1e-6);
+    EXPECT_NEAR(contact.point.z(), 0.2, 1e-3);
+  }
+
+  // The binary check doesn't sweep the objects
+  EXPECT_FALSE(solver->getCollisionGroup()->collide(
+      solver->getCollisionOption(), nullptr));
+
+  for (auto i = 0u; i < 50u; ++i)
+    world->step();
+
+  // The box stops on the ground instead of tunneling through it
+  const auto box = world->getSkeleton("box")->getBodyNode(0);
+  EXPECT_NEAR(box->getTransform().translation().z(), 0.1, 1e-2);
+}
+
+//==============================================================================
+TEST(ContactConstraint, CompliantContactConstraintSolver)
+{
+  auto solver
+      = std::make_unique<constraint::CompliantContactConstraintSolver>();
+  auto compliantSolver = solver.get();
+  auto world = createStackAndChainWorld(std::move(solver));
+
+  for (auto i = 0u; i < 1000u; ++i)
+    world->step();
+
+  // The contacts of the stack are resolved without the LCP
+  EXPECT_GE(compliantSolver->getLastNumContacts(), 12u);
+
+  // The stack rests on the ground with small penetrations
+  for (auto i = 0u; i < 3u; ++i)
+  {
+    const auto box = world->getSkeleton("box" + std::to_string(i));
+    EXPECT_NEAR(box->getPosition(5), 0.1 + 0.2 * i, 2e-3);
+    EXPECT_LT(box->getVelocities().norm(), 1e-2);
+  }
+
+  // The joint limits of the chain are still respected
+  const auto chain = world->getSkeleton("chain");
+  for (auto i = 0u; i < chain->getNumDofs(); ++i)
+    EXPECT_LE(std::abs(chain->getPosition(i)), 0.3 + 1e-2);
+}
+
+//==============================================================================
+simulation::WorldPtr createSlidingBoxWorld(std::size_t numThreads)
+{
+  auto world = simulation::World::create();
+  constraint::CompliantContactConstraintSolver::Option option;
+  option.mNumThreads = numThreads;
+  auto solver
+      = std::make_unique<constraint::CompliantContactConstraintSolver>(option);
+  solver->setCollisionDetector(collision::DARTCollisionDetector::create());
+  world->setConstraintSolver(std::move(solver));
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundBody
+      = ground->createJointAndBodyNodePair<dynamics::WeldJoint>().second;
+  groundBody->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d(4.0, 4.0, 0.1)));
+  Eigen::Isometry3d tf = Eigen::Isometry3d::Identity();
+  tf.translation().z() = -0.05;
+  groundBody->getParentJoint()->setTransformFromParentBodyNode(tf);
+  world->addSkeleton(ground);
+
+  auto box = dynamics::Skeleton::create("box");
+  auto pair = box->createJointAndBodyNodePair<dynamics::FreeJoint>();
+  pair.second->createShapeNodeWith<CollisionAspect, DynamicsAspect>(
+      std::make_shared<dynamics::BoxShape>(Eigen::Vector3d::Constant(0.2)));
+  pair.first->setPosition(5, 0.1);
+  pair.first->setVelocity(3, 1.0);
+  world->addSkeleton(box);
+
+  return world;
+}
+
+//==============================================================================
+TEST(ContactConstraint, CompliantContactFriction)
+{
+  auto world = createSlidingBoxWorld(1u);
+  auto parallelWorld = createSlidingBoxWorld(4u);
+
+  for (auto i = 0u; i < 500u; ++i)
+  {
+    world->step();
+    parallelWorld->step();
+  }
+
+  // With the unit friction coefficient, the box decelerates at about g and
+  // stops after sliding v^2 / (2 * g)
+  const auto box = world->getSkeleton("box");
+  EXPECT_LT(std::abs(box->getVelocity(3)), 1e-2);
+  EXPECT_NEAR(box->getPosition(3), 1.0 / (2.0 * 9.81), 5e-3);
+
+  // The contact forces don't depend on the number of threads
+  EXPECT_TRUE(equals(
+      parallelWorld->getSkeleton("box")->getPositions(),
+      box->getPositions(),
+      0.0));
 }
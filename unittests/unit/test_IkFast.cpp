@@ -30,6 +30,7 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include <dart/dart.hpp>
@@ -169,3 +170,120 @@ TEST(IkFast, LoadWamArmIk)
     EXPECT_TRUE(equals(targetFrame->getTransform(), newTf, 1e-2));
   }
 }
+
+//==============================================================================
+TEST(IkFast, BatchSolutions)
+{
+  utils::DartLoader urdfParser;
+  urdfParser.addPackageDirectory(
+      "herb_description", DART_DATA_PATH "/urdf/wam");
+  auto wam = urdfParser.parseSkeleton(DART_DATA_PATH "/urdf/wam/wam.urdf");
+  ASSERT_NE(wam, nullptr);
+
+  auto ee = wam->getBodyNode("/wam7")->createEndEffector("ee");
+  auto ik = ee->createIK();
+  std::stringstream ss;
+  ss << DART_SHARED_LIB_PREFIX << "GeneratedWamIkFast";
+#if (DART_OS_LINUX || DART_OS_MACOS) && !NDEBUG
+  ss << "d";
+#endif
+  ss << "." << DART_SHARED_LIB_EXTENSION;
+  auto& ikfast = ik->setGradientMethod<dynamics::SharedLibraryIkFast>(
+      ss.str(), std::vector<std::size_t>{0, 1, 3, 4, 5, 6},
+      std::vector<std::size_t>{2});
+  const auto dofs = ikfast.getDofs();
+  ASSERT_EQ(dofs.size(), 6u);
+
+  // Reachable targets of random positions within the limits, and a target out
+  // of reach
+  math::Random::setSeed(0u);
+  const Eigen::VectorXd initialPositions = wam->getPositions();
+  common::aligned_vector<Eigen::Isometry3d> targets;
+  for (std::size_t i = 0u; i < 50u; ++i)
+  {
+    wam->setPositions(math::Random::uniform<Eigen::VectorXd>(
+        wam->getPositionLowerLimits(), wam->getPositionUpperLimits()));
+    wam->setPosition(2u, initialPositions[2]);
+    targets.push_back(ee->getWorldTransform());
+  }
+  targets.push_back(Eigen::Isometry3d::Identity());
+  targets.back().translation() = Eigen::Vector3d(10.0, 0.0, 0.0);
+  wam->setPositions(initialPositions);
+
+  dynamics::IkFast::BatchSolutions solutions;
+  ikfast.computeBatchSolutions(targets, solutions);
+  ASSERT_EQ(solutions.mOffsets.size(), targets.size() + 1u);
+  EXPECT_EQ(solutions.mOffsets.front(), 0u);
+  EXPECT_EQ(
+      solutions.mOffsets.back(),
+      static_cast<std::size_t>(solutions.mConfigs.cols()));
+  EXPECT_EQ(solutions.mConfigs.rows(), 6);
+  EXPECT_EQ(solutions.mOffsets[targets.size()], solutions.mOffsets[50]);
+
+  for (std::size_t i = 0u; i < targets.size(); ++i)
+  {
+    // The batch solutions are the valid solutions of getSolutions(), which
+    // sorts them by quality
+    std::vector<Eigen::VectorXd> expected;
+    for (const auto& solution : ikfast.getSolutions(targets[i]))
+    {
+      if (solution.mValidity == InverseKinematics::Analytical::VALID)
+        expected.push_back(solution.mConfig);
+    }
+
+    const std::size_t begin = solutions.mOffsets[i];
+    const std::size_t end = solutions.mOffsets[i + 1u];
+    EXPECT_EQ(end - begin, expected.size());
+    if (i < 50u)
+    {
+      EXPECT_GT(end - begin, 0u);
+    }
+
+    for (std::size_t j = begin; j < end; ++j)
+    {
+      const Eigen::VectorXd config = solutions.mConfigs.col(j);
+      EXPECT_TRUE(std::any_of(
+          expected.begin(), expected.end(), [&](const Eigen::VectorXd& q) {
+            return q == config;
+          }));
+
+      wam->setPositions(dofs, config);
+      // The URDF rounds its rotations, hence the tolerance
+      EXPECT_TRUE(equals(targets[i], ee->getWorldTransform(), 1e-4));
+      wam->setPositions(initialPositions);
+    }
+  }
+
+  // The result doesn't depend on the number of threads
+  dynamics::IkFast::BatchSolutions parallelSolutions;
+  ikfast.computeBatchSolutions(targets, parallelSolutions, 4u);
+  EXPECT_TRUE(parallelSolutions.mOffsets == solutions.mOffsets);
+  EXPECT_TRUE(parallelSolutions.mConfigs == solutions.mConfigs);
+
+  // The filter removes solutions from the flat arrays
+  dynamics::IkFast::BatchSolutions filteredSolutions;
+  ikfast.computeBatchSolutions(
+      targets,
+      filteredSolutions,
+      4u,
+      [](const Eigen::MatrixXd& configs, std::vector<char>& valid) {
+        for (int i = 0; i < configs.cols(); ++i)
+          valid[i] = configs(0, i) <= 0.0;
+      });
+  ASSERT_EQ(filteredSolutions.mOffsets.size(), targets.size() + 1u);
+  for (std::size_t i = 0u; i < targets.size(); ++i)
+  {
+    std::vector<Eigen::VectorXd> expected;
+    for (std::size_t j = solutions.mOffsets[i]; j < solutions.mOffsets[i + 1u];
+         ++j)
+    {
+      if (solutions.mConfigs(0, j) <= 0.0)
+        expected.push_back(solutions.mConfigs.col(j));
+    }
+
+    const std::size_t begin = filteredSolutions.mOffsets[i];
+    ASSERT_EQ(filteredSolutions.mOffsets[i + 1u] - begin, expected.size());
+    for (std::size_t j = 0u; j < expected.size(); ++j)
+      EXPECT_TRUE(filteredSolutions.mConfigs.col(begin + j) == expected[j]);
+  }
+}
@@ -32,7 +32,11 @@
 
 #include <gtest/gtest.h>
 
+#include "dart/constraint/LemkeBoxedLcpSolver.hpp"
+#include "dart/external/odelcpsolver/common.h"
 #include "dart/lcpsolver/Lemke.hpp"
+#include "dart/lcpsolver/LemkeSolver.hpp"
+#include "dart/math/Constants.hpp"
 #include "TestHelpers.hpp"
 
 //==============================================================================
@@ -156,6 +160,144 @@ TEST(Lemke, Lemke_12D)
   EXPECT_TRUE(dart::lcpsolver::validate(A, (*f), b));
 }
 
+//==============================================================================
+TEST(Lemke, LemkeSolverMatchesLemke)
+{
+  dart::lcpsolver::LemkeSolver solver;
+
+  for (int n : {1, 2, 6, 12, 40, 100})
+  {
+    const Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+    const Eigen::MatrixXd A
+        = J * J.transpose() + 0.1 * Eigen::MatrixXd::Identity(n, n);
+    const Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+
+    Eigen::VectorXd expected;
+    EXPECT_EQ(dart::lcpsolver::Lemke(A, b, &expected), 0);
+
+    Eigen::VectorXd f;
+    EXPECT_EQ(solver.solve(A, b, f), dart::lcpsolver::LemkeSolver::SUCCESS);
+    EXPECT_TRUE(dart::lcpsolver::validate(A, f, b));
+    EXPECT_TRUE(equals(f, expected, 1e-8));
+  }
+
+  // Refactorize after every pivot and once in a while
+  for (int interval : {1, 3})
+  {
+    const int n = 60;
+    const Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+    const Eigen::MatrixXd A
+        = J * J.transpose() + 0.1 * Eigen::MatrixXd::Identity(n, n);
+    const Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+
+    dart::lcpsolver::LemkeSolver::Option option;
+    option.mRefactorizationInterval = interval;
+    solver.setOption(option);
+
+    Eigen::VectorXd f;
+    EXPECT_EQ(solver.solve(A, b, f), dart::lcpsolver::LemkeSolver::SUCCESS);
+    EXPECT_TRUE(dart::lcpsolver::validate(A, f, b));
+    EXPECT_GE(
+        solver.getLastNumFactorizations(),
+        solver.getLastNumIterations() / (interval + 1));
+  }
+}
+
+//==============================================================================
+TEST(Lemke, LemkeSolverWarmStart)
+{
+  const int n = 30;
+  const Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+  const Eigen::MatrixXd A
+      = J * J.transpose() + 0.1 * Eigen::MatrixXd::Identity(n, n);
+  const Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+
+  dart::lcpsolver::LemkeSolver solver;
+  Eigen::VectorXd f;
+  EXPECT_EQ(solver.solve(A, b, f), dart::lcpsolver::LemkeSolver::SUCCESS);
+  EXPECT_GT(solver.getLastNumIterations(), 0);
+
+  // A slightly perturbed problem with the same active set needs no pivots
+  const Eigen::VectorXd b2 = b + 1e-6 * Eigen::VectorXd::Random(n);
+  Eigen::VectorXd f2;
+  EXPECT_EQ(
+      solver.solve(A, b2, f2, true), dart::lcpsolver::LemkeSolver::SUCCESS);
+  EXPECT_EQ(solver.getLastNumIterations(), 0);
+  EXPECT_TRUE(dart::lcpsolver::validate(A, f2, b2));
+
+  // A different problem still starts from the last basis
+  const Eigen::VectorXd b3 = Eigen::VectorXd::Random(n);
+  Eigen::VectorXd f3;
+  EXPECT_EQ(
+      solver.solve(A, b3, f3, true), dart::lcpsolver::LemkeSolver::SUCCESS);
+  EXPECT_TRUE(dart::lcpsolver::validate(A, f3, b3));
+}
+
+//==============================================================================
+TEST(Lemke, LemkeBoxedLcpSolver)
+{
+  const int n = 12;
+  const int nskip = dPAD(n);
+  const Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+  const Eigen::MatrixXd A
+      = J * J.transpose() + 0.1 * Eigen::MatrixXd::Identity(n, n);
+  const Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+
+  // BoxedLcpSolver solves A * x = b + w
+  Eigen::VectorXd expected;
+  EXPECT_EQ(dart::lcpsolver::Lemke(A, -b, &expected), 0);
+
+  std::vector<double> odeA(n * nskip, 0.0);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      odeA[i * nskip + j] = A(i, j);
+  Eigen::VectorXd odeB = b;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd lo = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd hi
+      = Eigen::VectorXd::Constant(n, dart::math::constantsd::inf());
+  Eigen::VectorXi findex = Eigen::VectorXi::Constant(n, -1);
+
+  dart::constraint::LemkeBoxedLcpSolver solver;
+  EXPECT_TRUE(solver.is<dart::constraint::LemkeBoxedLcpSolver>());
+  EXPECT_TRUE(solver.solve(
+      n,
+      odeA.data(),
+      x.data(),
+      odeB.data(),
+      0,
+      lo.data(),
+      hi.data(),
+      findex.data(),
+      false));
+  EXPECT_TRUE(equals(x, expected, 1e-8));
+
+  // Bounded and friction problems are left to the secondary solver
+  hi[0] = 1.0;
+  EXPECT_FALSE(solver.solve(
+      n,
+      odeA.data(),
+      x.data(),
+      odeB.data(),
+      0,
+      lo.data(),
+      hi.data(),
+      findex.data(),
+      false));
+  hi[0] = dart::math::constantsd::inf();
+  findex[1] = 0;
+  EXPECT_FALSE(solver.solve(
+      n,
+      odeA.data(),
+      x.data(),
+      odeB.data(),
+      0,
+      lo.data(),
+      hi.data(),
+      findex.data(),
+      false));
+}
+
 //==============================================================================
 int main(int argc, char* argv[])
 {
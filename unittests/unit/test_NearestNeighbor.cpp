@@ -2,58 +2,166 @@
  * @file rrts02-nearestNeighbors.cpp
  * @author Can Erdogan
  * @date Feb 04, 2013
- * @brief Checks if the nearest neighbor computation done by flann is correct.
+ * @brief Checks if the nearest neighbor computation done by the k-d tree is
+ * correct.
  */
 
 #include <iostream>
 #include <Eigen/Core>
 #include <dart/dart.hpp>
 #include <gtest/gtest.h>
-#if HAVE_FLANN
-#  include <flann/flann.hpp>
-#endif // HAVE_FLANN
+#include "dart/planning/KdTree.hpp"
 #include "TestHelpers.hpp"
 
-/* *********************************************************************************************
- */
-#if HAVE_FLANN
-TEST(NEAREST_NEIGHBOR, 2D)
+//==============================================================================
+TEST(NEAREST_NEIGHBOR, KdTree2D)
 {
+  dart::planning::KdTree tree(2);
 
-  // Build the index with the first node
-  flann::Index<flann::L2<double> > index(
-      flann::KDTreeSingleIndexParams(10, true));
-  Eigen::VectorXd p1(2);
-  p1 << -3.04159, -3.04159;
-  index.buildIndex(flann::Matrix<double>((double*)p1.data(), 1, p1.size()));
-
-  // Add two more points
+  Eigen::Vector2d p1(-3.04159, -3.04159);
   Eigen::Vector2d p2(-2.96751, -2.97443), p3(-2.91946, -2.88672);
-  index.addPoints(flann::Matrix<double>((double*)p2.data(), 1, p2.size()));
-  index.addPoints(flann::Matrix<double>((double*)p3.data(), 1, p3.size()));
+  EXPECT_EQ(0u, tree.addPoint(p1));
+  EXPECT_EQ(1u, tree.addPoint(p2));
+  EXPECT_EQ(2u, tree.addPoint(p3));
+  EXPECT_EQ(3u, tree.getSize());
 
-  // Check the size of the tree
-  EXPECT_EQ(3, (int)index.size());
-
-  // Get the nearest neighbor index for a sample point
   Eigen::Vector2d sample(-2.26654, 2.2874);
-  int nearest;
   double distance;
-  const flann::Matrix<double> queryMatrix(
-      (double*)sample.data(), 1, sample.size());
-  flann::Matrix<int> nearestMatrix(&nearest, 1, 1);
-  flann::Matrix<double> distanceMatrix(flann::Matrix<double>(&distance, 1, 1));
-  index.knnSearch(
-      queryMatrix,
-      nearestMatrix,
-      distanceMatrix,
-      1,
-      flann::SearchParams(flann::FLANN_CHECKS_UNLIMITED));
+  const int nearest = tree.getNearest(sample, &distance);
   EXPECT_EQ(2, nearest);
+  EXPECT_NEAR((sample - p3).squaredNorm(), distance, 1e-12);
+  EXPECT_TRUE(equals(Eigen::Vector2d(tree.getPoint(nearest)), p3, 1e-12));
+}
+
+//==============================================================================
+TEST(NEAREST_NEIGHBOR, KdTreeMatchesBruteForce)
+{
+  using dart::math::Random;
+
+  const std::size_t dim = 7u;
+  dart::planning::KdTree tree(dim);
+  EXPECT_EQ(-1, tree.getNearest(Eigen::VectorXd::Zero(dim)));
+
+  // Random points, followed by a straight chain like the ones that RRT adds
+  // when it connects, which would degrade an incremental tree to a list
+  Random::setSeed(0u);
+  std::vector<Eigen::VectorXd> points;
+  for (std::size_t i = 0u; i < 2000u; ++i)
+    points.push_back(Random::uniform<Eigen::VectorXd>(
+        Eigen::VectorXd::Constant(dim, -1.0),
+        Eigen::VectorXd::Constant(dim, 1.0)));
+  for (std::size_t i = 0u; i < 2000u; ++i)
+    points.push_back(Eigen::VectorXd::Constant(dim, 1.0 + 0.01 * i));
+
+  for (const Eigen::VectorXd& point : points)
+    tree.addPoint(point);
+  EXPECT_EQ(points.size(), tree.getSize());
+  EXPECT_LT(tree.getDepth(), 100u);
+
+  std::vector<std::size_t> indices;
+  for (std::size_t i = 0u; i < 100u; ++i)
+  {
+    const Eigen::VectorXd query = Random::uniform<Eigen::VectorXd>(
+        Eigen::VectorXd::Constant(dim, -1.5),
+        Eigen::VectorXd::Constant(dim, 3.0));
+
+    std::vector<std::pair<double, std::size_t>> sorted;
+    for (std::size_t j = 0u; j < points.size(); ++j)
+      sorted.emplace_back((query - points[j]).squaredNorm(), j);
+    std::sort(sorted.begin(), sorted.end());
+
+    double distance;
+    EXPECT_EQ(sorted[0].second, tree.getNearest(query, &distance));
+    EXPECT_DOUBLE_EQ(sorted[0].first, distance);
+
+    tree.getNearestK(query, 5u, indices);
+    ASSERT_EQ(5u, indices.size());
+    for (std::size_t j = 0u; j < 5u; ++j)
+      EXPECT_EQ(sorted[j].second, indices[j]);
+
+    const double radius = std::sqrt(sorted[20].first);
+    tree.getWithinRadius(query, radius, indices);
+    std::sort(indices.begin(), indices.end());
+    std::vector<std::size_t> expected;
+    for (const auto& entry : sorted)
+    {
+      if (entry.first <= radius * radius)
+        expected.push_back(entry.second);
+    }
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected, indices);
+  }
+
+  // The indices don't change by rebuilding
+  tree.rebuild();
+  for (std::size_t i = 0u; i < points.size(); i += 97u)
+    EXPECT_EQ(static_cast<int>(i), tree.getNearest(points[i]));
+}
+
+//==============================================================================
+TEST(NEAREST_NEIGHBOR, KdTreeRemovePoints)
+{
+  using dart::math::Random;
+
+  const std::size_t dim = 3u;
+  dart::planning::KdTree tree(dim);
+
+  Random::setSeed(0u);
+  std::vector<Eigen::VectorXd> points;
+  for (std::size_t i = 0u; i < 500u; ++i)
+  {
+    points.push_back(Random::uniform<Eigen::VectorXd>(
+        Eigen::VectorXd::Constant(dim, -1.0),
+        Eigen::VectorXd::Constant(dim, 1.0)));
+    tree.addPoint(points.back());
+  }
+
+  // Remove every third point, twice to check that it is counted once
+  for (std::size_t i = 0u; i < points.size(); i += 3u)
+  {
+    tree.removePoint(i);
+    tree.removePoint(i);
+  }
+  EXPECT_EQ(points.size(), tree.getSize());
+  EXPECT_EQ(167u, tree.getNumRemoved());
+  EXPECT_TRUE(tree.isRemoved(0u));
+  EXPECT_FALSE(tree.isRemoved(1u));
+
+  std::vector<std::size_t> indices;
+  for (std::size_t i = 0u; i < 50u; ++i)
+  {
+    const Eigen::VectorXd query = Random::uniform<Eigen::VectorXd>(
+        Eigen::VectorXd::Constant(dim, -1.0),
+        Eigen::VectorXd::Constant(dim, 1.0));
+
+    std::vector<std::pair<double, std::size_t>> sorted;
+    for (std::size_t j = 0u; j < points.size(); ++j)
+    {
+      if (j % 3u != 0u)
+        sorted.emplace_back((query - points[j]).squaredNorm(), j);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    EXPECT_EQ(sorted[0].second, tree.getNearest(query));
+
+    tree.getNearestK(query, 4u, indices);
+    ASSERT_EQ(4u, indices.size());
+    for (std::size_t j = 0u; j < 4u; ++j)
+      EXPECT_EQ(sorted[j].second, indices[j]);
+
+    const double radius = std::sqrt(0.5 * (sorted[9].first + sorted[10].first));
+    tree.getWithinRadius(query, radius, indices);
+    EXPECT_EQ(10u, indices.size());
+    for (const std::size_t index : indices)
+      EXPECT_NE(0u, index % 3u);
+  }
+
+  // The removed points stay removed when the tree is rebuilt
+  tree.rebuild();
+  EXPECT_NE(0, tree.getNearest(points[0]) % 3);
+  EXPECT_EQ(167u, tree.getNumRemoved());
 
-  // Get the nearest neighbor
-  double* point = index.getPoint(nearest);
-  bool equality = equals(Vector2d(point[0], point[1]), p3, 1e-3);
-  EXPECT_TRUE(equality);
+  for (std::size_t i = 0u; i < points.size(); ++i)
+    tree.removePoint(i);
+  EXPECT_EQ(-1, tree.getNearest(points[0]));
 }
-#endif // HAVE_FLANN
@@ -42,8 +42,12 @@
 #include "dart/dynamics/FreeJoint.hpp"
 #include "dart/dynamics/InverseKinematics.hpp"
 #include "dart/dynamics/Skeleton.hpp"
+#include "dart/math/Random.hpp"
 #include "dart/optimizer/Function.hpp"
+#include "dart/optimizer/GenericMultiObjectiveProblem.hpp"
 #include "dart/optimizer/GradientDescentSolver.hpp"
+#include "dart/optimizer/ParallelEvaluator.hpp"
+#include "dart/optimizer/PopulationEvaluator.hpp"
 #include "dart/optimizer/Problem.hpp"
 #include "TestHelpers.hpp"
 #if HAVE_NLOPT
@@ -150,6 +154,235 @@ TEST(Optimizer, GradientDescent)
   EXPECT_NEAR(optX[1], 0.0, solver.getTolerance());
 }
 
+//==============================================================================
+TEST(Optimizer, ParallelEvaluator)
+{
+  std::shared_ptr<Problem> prob = std::make_shared<Problem>(2);
+
+  // SampleObjFunc and SampleConstFunc can't be copied, so their evaluations
+  // are serialized, whereas every thread evaluates its own ModularFunction
+  prob->setObjective(std::make_shared<SampleObjFunc>());
+  prob->addIneqConstraint(std::make_shared<SampleConstFunc>(2, 0));
+  prob->addIneqConstraint(std::make_shared<SampleConstFunc>(-1, 1));
+
+  auto eq = std::make_shared<ModularFunction>("eq");
+  eq->setCostFunction([](const Eigen::VectorXd& x) {
+    return x[0] * x[0] + std::sin(x[1]) - 1.0;
+  });
+  eq->setGradientFunction(
+      [](const Eigen::VectorXd& x, Eigen::Map<Eigen::VectorXd> grad) {
+        grad[0] = 2.0 * x[0];
+        grad[1] = std::cos(x[1]);
+      });
+  prob->addEqConstraint(eq);
+
+  // The lambdas don't share state, but ModularFunction is only copied once it
+  // is marked thread-safe
+  EXPECT_FALSE(eq->isThreadSafe());
+  EXPECT_EQ(eq->cloneFunction(), nullptr);
+  eq->setThreadSafe(true);
+
+  const FunctionPtr copy = eq->cloneFunction();
+  ASSERT_NE(copy, nullptr);
+  EXPECT_EQ(copy->getName(), "eq");
+  EXPECT_EQ(std::make_shared<SampleObjFunc>()->cloneFunction(), nullptr);
+
+  ParallelEvaluator serial(prob, ParallelEvaluator::Option(1u));
+  ParallelEvaluator parallel(prob, ParallelEvaluator::Option(4u));
+  EXPECT_EQ(serial.getNumThreads(), 1u);
+  EXPECT_EQ(parallel.getNumThreads(), 4u);
+
+  Eigen::MatrixXd xs(2, 20);
+  for (int i = 0; i < xs.cols(); ++i)
+    xs.col(i) = Eigen::Vector2d(0.1 * i - 1.0, 0.3 + 0.2 * i);
+
+  for (int i = 0; i < xs.cols(); ++i)
+  {
+    const Eigen::VectorXd x = xs.col(i);
+    EXPECT_DOUBLE_EQ(copy->eval(x), eq->eval(x));
+
+    double objective;
+    Eigen::VectorXd eqValues, ineqValues;
+    parallel.evalFunctions(x, objective, eqValues, ineqValues);
+    EXPECT_EQ(objective, prob->getObjective()->eval(x));
+    ASSERT_EQ(eqValues.size(), 1);
+    EXPECT_EQ(eqValues[0], eq->eval(x));
+    ASSERT_EQ(ineqValues.size(), 2);
+    EXPECT_EQ(ineqValues[0], prob->getIneqConstraint(0)->eval(x));
+    EXPECT_EQ(ineqValues[1], prob->getIneqConstraint(1)->eval(x));
+
+    Eigen::VectorXd gradient;
+    Eigen::MatrixXd eqJacobian, ineqJacobian;
+    parallel.evalGradients(x, gradient, eqJacobian, ineqJacobian);
+
+    Eigen::VectorXd fdGradient;
+    Eigen::MatrixXd fdEqJacobian, fdIneqJacobian;
+    parallel.computeFiniteDifferenceGradient(x, fdGradient);
+    parallel.computeFiniteDifferenceJacobians(x, fdEqJacobian, fdIneqJacobian);
+    EXPECT_TRUE(equals(fdGradient, gradient, 1e-6));
+    EXPECT_TRUE(equals(fdEqJacobian, eqJacobian, 1e-6));
+    EXPECT_TRUE(equals(fdIneqJacobian, ineqJacobian, 1e-6));
+
+    // The results don't depend on the number of threads
+    Eigen::VectorXd serialGradient;
+    Eigen::MatrixXd serialEqJacobian, serialIneqJacobian;
+    serial.computeFiniteDifferenceGradient(x, serialGradient);
+    serial.computeFiniteDifferenceJacobians(
+        x, serialEqJacobian, serialIneqJacobian);
+    EXPECT_TRUE(serialGradient == fdGradient);
+    EXPECT_TRUE(serialEqJacobian == fdEqJacobian);
+    EXPECT_TRUE(serialIneqJacobian == fdIneqJacobian);
+  }
+
+  Eigen::VectorXd values;
+  parallel.evalObjectives(xs, values);
+  Eigen::VectorXd objectives;
+  Eigen::MatrixXd eqValues, ineqValues;
+  parallel.evalFunctions(xs, objectives, eqValues, ineqValues);
+  ASSERT_EQ(values.size(), xs.cols());
+  ASSERT_EQ(eqValues.rows(), 1);
+  ASSERT_EQ(ineqValues.rows(), 2);
+  for (int i = 0; i < xs.cols(); ++i)
+  {
+    const Eigen::VectorXd x = xs.col(i);
+    EXPECT_EQ(values[i], prob->getObjective()->eval(x));
+    EXPECT_EQ(objectives[i], values[i]);
+    EXPECT_EQ(eqValues(0, i), eq->eval(x));
+    EXPECT_EQ(ineqValues(1, i), prob->getIneqConstraint(1)->eval(x));
+  }
+
+  // The evaluators follow the changes of the functions of the Problem
+  prob->removeAllIneqConstraints();
+  parallel.evalFunctions(xs, objectives, eqValues, ineqValues);
+  EXPECT_EQ(eqValues.rows(), 1);
+  EXPECT_EQ(ineqValues.rows(), 0);
+}
+
+//==============================================================================
+/// The ZDT1 problem, which can't be cloned
+class SampleMultiObjectiveProblem : public MultiObjectiveProblem
+{
+public:
+  SampleMultiObjectiveProblem() : MultiObjectiveProblem(10u)
+  {
+    setLowerBounds(Eigen::VectorXd::Zero(10));
+    setUpperBounds(Eigen::VectorXd::Ones(10));
+  }
+
+  std::size_t getObjectiveDimension() const override
+  {
+    return 2u;
+  }
+
+  Eigen::VectorXd evaluateObjectives(const Eigen::VectorXd& x) const override
+  {
+    const double g = 1.0 + 9.0 * (x.sum() - x[0]) / (x.size() - 1.0);
+    return Eigen::Vector2d(x[0], g * (1.0 - std::sqrt(x[0] / g)));
+  }
+};
+
+//==============================================================================
+TEST(Optimizer, PopulationEvaluator)
+{
+  auto problem = std::make_shared<GenericMultiObjectiveProblem>(10u);
+  problem->setLowerBounds(Eigen::VectorXd::Zero(10));
+  problem->setUpperBounds(Eigen::VectorXd::Ones(10));
+
+  auto f1 = std::make_shared<ModularFunction>();
+  f1->setCostFunction([](const Eigen::VectorXd& x) { return x[0]; });
+  auto f2 = std::make_shared<ModularFunction>();
+  f2->setCostFunction([](const Eigen::VectorXd& x) {
+    const double g = 1.0 + 9.0 * (x.sum() - x[0]) / (x.size() - 1.0);
+    return g * (1.0 - std::sqrt(x[0] / g));
+  });
+  problem->setObjectiveFunctions({f1, f2});
+  auto ineq = std::make_shared<ModularFunction>();
+  ineq->setCostFunction(
+      [](const Eigen::VectorXd& x) { return x.squaredNorm() - 2.0; });
+  problem->addIneqConstraintFunction(ineq);
+
+  EXPECT_EQ(problem->clone(), nullptr);
+  for (const auto& function : {f1, f2, ineq})
+    function->setThreadSafe(true);
+
+  const auto copy = problem->clone();
+  ASSERT_NE(copy, nullptr);
+  EXPECT_EQ(copy->getFitnessDimension(), 3u);
+  EXPECT_TRUE(copy->getUpperBounds() == problem->getUpperBounds());
+
+  const auto sampleProblem = std::make_shared<SampleMultiObjectiveProblem>();
+  EXPECT_EQ(sampleProblem->clone(), nullptr);
+
+  Eigen::MatrixXd xs(10, 50);
+  for (int i = 0; i < xs.cols(); ++i)
+  {
+    xs.col(i) = dart::math::Random::uniform<Eigen::VectorXd>(
+        problem->getLowerBounds(), problem->getUpperBounds());
+  }
+
+  using Parallelism = PopulationEvaluator::Parallelism;
+  for (const auto& prob :
+       std::vector<std::shared_ptr<MultiObjectiveProblem>>{problem,
+                                                           sampleProblem})
+  {
+    for (const auto& option :
+         {PopulationEvaluator::Option(1u),
+          PopulationEvaluator::Option(4u),
+          PopulationEvaluator::Option(3u, Parallelism::Processes)})
+    {
+      PopulationEvaluator evaluator(prob, option);
+      EXPECT_EQ(evaluator.getNumWorkers(), option.mNumWorkers);
+
+      Eigen::MatrixXd fitness;
+      evaluator.evaluate(xs, fitness);
+      ASSERT_EQ(fitness.rows(), static_cast<int>(prob->getFitnessDimension()));
+      ASSERT_EQ(fitness.cols(), xs.cols());
+      for (int i = 0; i < xs.cols(); ++i)
+      {
+        const Eigen::VectorXd x = xs.col(i);
+        EXPECT_TRUE(fitness.col(i) == copy->evaluateFitness(x).head(
+                                          fitness.rows()));
+      }
+
+      // The decision vectors of a wrong dimension are rejected
+      evaluator.evaluate(xs.topRows(5), fitness);
+      EXPECT_EQ(fitness.size(), 0);
+    }
+  }
+
+  // The population is sampled in the same order as the constructor of
+  // Population does
+  PopulationEvaluator evaluator(problem, PopulationEvaluator::Option(4u));
+  dart::math::Random::setSeed(0u);
+  const Population population = evaluator.createPopulation(20u);
+  dart::math::Random::setSeed(0u);
+  const Population expected(problem, 20u);
+  ASSERT_EQ(population.getSize(), 20u);
+  for (std::size_t i = 0u; i < population.getSize(); ++i)
+  {
+    EXPECT_TRUE(
+        population.getDecisionVector(i) == expected.getDecisionVector(i));
+    EXPECT_TRUE(population.getFitnessVector(i) == expected.getFitnessVector(i));
+  }
+
+  // A multithreaded process can be forked if the problem doesn't use the
+  // other threads, which only prints a warning
+  {
+    dart::common::ThreadPool threadPool(2u);
+    PopulationEvaluator processEvaluator(
+        problem, PopulationEvaluator::Option(3u, Parallelism::Processes));
+    Eigen::MatrixXd fitness;
+    processEvaluator.evaluate(xs, fitness);
+    processEvaluator.evaluate(xs, fitness);
+    ASSERT_EQ(fitness.cols(), xs.cols());
+    for (int i = 0; i < xs.cols(); ++i)
+    {
+      const Eigen::VectorXd x = xs.col(i);
+      EXPECT_TRUE(fitness.col(i) == copy->evaluateFitness(x));
+    }
+  }
+}
+
 //==============================================================================
 #if HAVE_NLOPT
 TEST(Optimizer, BasicNlopt)
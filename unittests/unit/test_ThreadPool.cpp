@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dart/common/ThreadPool.hpp"
+
+using namespace dart::common;
+
+//==============================================================================
+TEST(ThreadPool, ParallelFor)
+{
+  for (auto numThreads : {1u, 2u, 4u})
+  {
+    ThreadPool pool(numThreads);
+    EXPECT_EQ(pool.getNumThreads(), numThreads);
+
+    // Every index is processed exactly once, and the thread index is in range
+    std::vector<int> counts(1000, 0);
+    std::atomic<bool> validThreadIndex{true};
+    pool.parallelFor(counts.size(), [&](std::size_t index, std::size_t thread) {
+      ++counts[index];
+      if (thread >= numThreads)
+        validThreadIndex = false;
+    });
+    EXPECT_TRUE(validThreadIndex);
+    EXPECT_EQ(std::accumulate(counts.begin(), counts.end(), 0), 1000);
+    EXPECT_EQ(*std::min_element(counts.begin(), counts.end()), 1);
+
+    // The pool can be reused, including for empty ranges
+    pool.parallelFor(0u, [](std::size_t, std::size_t) { FAIL(); });
+    std::vector<double> sums(numThreads, 0.0);
+    pool.parallelFor(100u, [&](std::size_t index, std::size_t thread) {
+      sums[thread] += static_cast<double>(index);
+    });
+    EXPECT_DOUBLE_EQ(std::accumulate(sums.begin(), sums.end(), 0.0), 4950.0);
+  }
+}
+
+//==============================================================================
+TEST(ThreadPool, DefaultNumThreads)
+{
+  ThreadPool pool;
+  EXPECT_EQ(pool.getNumThreads(), ThreadPool::getHardwareConcurrency());
+  EXPECT_GE(pool.getNumThreads(), 1u);
+}